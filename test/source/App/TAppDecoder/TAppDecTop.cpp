@@ -56,6 +56,10 @@ TAppDecTop::TAppDecTop()
 {
   ::memset (m_abDecFlag, 0, sizeof (m_abDecFlag));
   m_iPOCLastDisplay  = -1;
+#if ROM_CONTEXT
+  // the decoder state set while parsing is kept in the context of m_cTDecTop
+  setRomContext( m_cTDecTop.getRomContext() );
+#endif
 }
 
 Void TAppDecTop::create()
@@ -40,6 +40,9 @@
 #include <cstring>
 #include <string>
 #include "TLibCommon/TComRom.h"
+#if ENABLE_SIMD
+#include "TLibCommon/TComSimd.h"
+#endif
 #include "TAppEncCfg.h"
 #include "TAppCommon/program_options_lite.h"
 
@@ -171,6 +174,15 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("FastSearch", m_iFastSearch, 1, "0:Full search  1:Diamond  2:PMVFAST")
   ("SearchRange,-sr",m_iSearchRange, 96, "motion search range")
   ("BipredSearchRange", m_bipredSearchRange, 4, "motion search range for bipred refinement")
+#if ME_PYRAMID
+  ("MEPyramid", m_bUseMEPyramid, false, "seed the diamond search with a coarse-to-fine search over downscaled references instead of the raster search")
+#endif
+#if ME_SUBPEL_PLANES
+  ("SubPelPlanes", m_bUseSubPelPlanes, false, "interpolate the quarter-sample phases of each reference picture once for the fractional motion search, 15 luma planes per picture marked as reference")
+#endif
+#if ME_TZ_VISITED
+  ("TZStats", m_bPrintTZStats, false, "print the number of TZ search positions and of the repeated positions skipped after encoding")
+#endif
   ("HadamardME", m_bUseHADME, true, "hadamard ME for fractional-pel")
   ("ASR", m_bUseASR, false, "adaptive motion search range")
   
@@ -265,6 +277,19 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
     ("WaveFrontSynchro",            m_iWaveFrontSynchro,             0,          "0: no synchro; 1 synchro with TR; 2 TRR etc")
     ("WaveFrontFlush",              m_iWaveFrontFlush,               0,          "Flush and terminate CABAC coding for each LCU line")
     ("WaveFrontSubstreams",         m_iWaveFrontSubstreams,          1,          "# coded substreams wanted; per tile if TileBoundaryIndependenceIdc is 1, otherwise per frame")
+#endif
+    ("NumWorkerThreads",            m_iNumWorkerThreads,             0,          "Number of worker threads used by the encoder, 0: single-threaded")
+#if REF_SEARCH_THREADS
+    ("ParallelRefSearch",           m_bUseParallelRefSearch,     false,          "Run the motion searches of a prediction unit in its reference pictures on the worker threads")
+#endif
+#if LOOKAHEAD_THREAD
+    ("Lookahead",                   m_bUseLookahead,             false,          "Compute the AQ activity of the input pictures on a lookahead thread (with AdaptiveQP)")
+#endif
+#if ENC_ASYNC_IO
+    ("AsyncIO",                     m_bAsyncIO,                  false,          "Read the input pictures and write the reconstruction and bitstream on an I/O thread")
+#endif
+#if ENABLE_SIMD
+    ("SIMD",                        m_uiSimdLevel,                  3u,          "Highest SIMD instruction set used, 0: C only, 1: SSE2, 2: SSE4.1, 3: AVX2 (limited to what the processor supports)")
 #endif
   /* Misc. */
   ("SEIpictureDigest", m_pictureDigestEnabled, true, "Control generation of picture_digest SEI messages\n"
@@ -430,6 +455,9 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iFastSearch < 0 || m_iFastSearch > 2,                                     "Fast Search Mode is not supported value (0:Full search  1:Diamond  2:PMVFAST)" );
   xConfirmPara( m_iSearchRange < 0 ,                                                        "Search Range must be more than 0" );
   xConfirmPara( m_bipredSearchRange < 0 ,                                                   "Search Range must be more than 0" );
+#if ME_PYRAMID
+  xConfirmPara( m_bUseMEPyramid && m_iFastSearch != 1,                                      "MEPyramid requires FastSearch = 1" );
+#endif
   xConfirmPara( m_iMaxDeltaQP > 7,                                                          "Absolute Delta QP exceeds supported range (0 to 7)" );
 #if SUB_LCU_DQP
   xConfirmPara( m_iMaxCuDQPDepth > m_uiMaxCUDepth - 1,                                          "Absolute depth for a minimum CuDQP exceeds maximum coding unit depth" );
@@ -516,6 +544,10 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iWaveFrontSubstreams > 1 && !m_iWaveFrontSynchro, "Must have WaveFrontSynchro > 0 in order to have WaveFrontSubstreams > 1" );
   xConfirmPara( m_iWaveFrontSynchro > 0 && m_iSymbolMode == 0, "WaveFrontSynchro > 0 requires CABAC" );
 #endif
+  xConfirmPara( m_iNumWorkerThreads < 0, "NumWorkerThreads cannot be negative" );
+#if REF_SEARCH_THREADS
+  xConfirmPara( m_bUseParallelRefSearch && m_iNumWorkerThreads == 0, "ParallelRefSearch requires NumWorkerThreads > 0" );
+#endif
 
 #undef xConfirmPara
   if (check_failed)
@@ -566,6 +598,11 @@ Void TAppEncCfg::xSetGlobal()
   g_uiPCMBitDepthLuma = m_uiPCMBitDepthLuma = ((m_bPCMInputBitDepthFlag)? m_uiInputBitDepth : m_uiInternalBitDepth);
   g_uiPCMBitDepthChroma = ((m_bPCMInputBitDepthFlag)? m_uiInputBitDepth : m_uiInternalBitDepth);
 #endif
+  
+#if ENABLE_SIMD
+  // limit the SIMD kernels to the configured instruction set
+  setSimdLevel( m_uiSimdLevel );
+#endif
 }
 
 Void TAppEncCfg::xPrintParameter()
@@ -634,6 +671,12 @@ Void TAppEncCfg::xPrintParameter()
   printf("RDQ:%d ", m_bUseRDOQ            );
   printf("SQP:%d ", m_uiDeltaQpRD         );
   printf("ASR:%d ", m_bUseASR             );
+#if ME_PYRAMID
+  printf("PYR:%d ", m_bUseMEPyramid       );
+#endif
+#if ME_SUBPEL_PLANES
+  printf("SPP:%d ", m_bUseSubPelPlanes    );
+#endif
   printf("PAD:%d ", m_bUsePAD             );
   printf("LDC:%d ", m_bUseLDC             );
   printf("NRF:%d ", m_bUseNRF             );
@@ -732,6 +775,19 @@ Void TAppEncCfg::xPrintParameter()
   printf(" WaveFrontSynchro:%d WaveFrontFlush:%d WaveFrontSubstreams:%d",
           m_iWaveFrontSynchro, m_iWaveFrontFlush, m_iWaveFrontSubstreams);
 #endif
+  printf(" WorkerThreads:%d", m_iNumWorkerThreads);
+#if REF_SEARCH_THREADS
+  printf(" ParallelRefSearch:%d", m_bUseParallelRefSearch);
+#endif
+#if LOOKAHEAD_THREAD
+  printf(" Lookahead:%d", m_bUseLookahead);
+#endif
+#if ENC_ASYNC_IO
+  printf(" AsyncIO:%d", m_bAsyncIO);
+#endif
+#if ENABLE_SIMD
+  printf(" SIMD:%d", getSimdLevel());
+#endif
 
   printf("\n\n");
   
@@ -751,6 +807,12 @@ Void TAppEncCfg::xPrintUsage()
   printf( "                   BQP - hier-P style QP assignment in low-delay mode\n");
   printf( "                   PAD - automatic source padding of multiple of 16\n");
   printf( "                   ASR - adaptive motion search range\n");
+#if ME_PYRAMID
+  printf( "                   PYR - hierarchical motion search seeding the diamond search\n");
+#endif
+#if ME_SUBPEL_PLANES
+  printf( "                   SPP - sub-sample planes of the references for the fractional motion search\n");
+#endif
   printf( "                   FEN - fast encoder setting\n");  
 #if EARLY_CU_DETERMINATION
   printf( "                   ECU - Early CU setting\n");
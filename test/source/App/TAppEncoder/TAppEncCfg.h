@@ -165,6 +165,15 @@ protected:
   Int       m_iFastSearch;                                    ///< ME mode, 0 = full, 1 = diamond, 2 = PMVFAST
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
+#if ME_PYRAMID
+  Bool      m_bUseMEPyramid;                                  ///< seed the TZ search with a coarse-to-fine search over the reference pyramid
+#endif
+#if ME_SUBPEL_PLANES
+  Bool      m_bUseSubPelPlanes;                               ///< interpolate the sub-sample phases of each reference picture once for the fractional search
+#endif
+#if ME_TZ_VISITED
+  Bool      m_bPrintTZStats;                                  ///< print the number of TZ search positions after encoding
+#endif
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
 #if EARLY_CU_DETERMINATION
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
@@ -219,6 +228,21 @@ protected:
   UInt      m_uiBiPredIdc;                                    ///< Use of Bi-Directional Weighting Prediction (B_SLICE): explicit(1) or implicit(2)
 #endif
 
+  // multi-threading
+  Int       m_iNumWorkerThreads;                              ///< number of worker threads, 0: single-threaded encoding
+#if REF_SEARCH_THREADS
+  Bool      m_bUseParallelRefSearch;                          ///< run the motion searches of the reference pictures of a prediction unit on worker threads
+#endif
+#if LOOKAHEAD_THREAD
+  Bool      m_bUseLookahead;                                  ///< analyze the input pictures on a lookahead thread
+#endif
+#if ENC_ASYNC_IO
+  Bool      m_bAsyncIO;                                       ///< read the input and write the output on an I/O thread
+#endif
+#if ENABLE_SIMD
+  UInt      m_uiSimdLevel;                                    ///< highest SIMD instruction set used by the kernels
+#endif
+
   // internal member functions
   Void  xSetGlobal      ();                                   ///< set global variables
   Void  xCheckParameter ();                                   ///< check validity of configuration values
@@ -59,6 +59,10 @@ TAppEncTop::TAppEncTop()
   m_iFrameRcvd = 0;
   m_totalBytes = 0;
   m_essentialBytes = 0;
+#if ROM_CONTEXT
+  // the LCU geometry and bit depths set by parseCfg() are kept in the context of m_cTEncTop
+  setRomContext( m_cTEncTop.getRomContext() );
+#endif
 }
 
 TAppEncTop::~TAppEncTop()
@@ -108,6 +112,12 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setFastSearch                   ( m_iFastSearch  );
   m_cTEncTop.setSearchRange                  ( m_iSearchRange );
   m_cTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
+#if ME_PYRAMID
+  m_cTEncTop.setUseMEPyramid                 ( m_bUseMEPyramid );
+#endif
+#if ME_SUBPEL_PLANES
+  m_cTEncTop.setUseSubPelPlanes              ( m_bUseSubPelPlanes );
+#endif
 
   //====== Quality control ========
   m_cTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
@@ -230,6 +240,18 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setWaveFrontSynchro           ( m_iWaveFrontSynchro );
   m_cTEncTop.setWaveFrontFlush             ( m_iWaveFrontFlush );
   m_cTEncTop.setWaveFrontSubstreams        ( m_iWaveFrontSubstreams );
+#endif
+  m_cTEncTop.setNumWorkerThreads           ( m_iNumWorkerThreads );
+#if REF_SEARCH_THREADS
+  m_cTEncTop.setUseParallelRefSearch       ( m_bUseParallelRefSearch );
+#endif
+#if LOOKAHEAD_THREAD
+#if QP_ADAPTATION
+  // the lookahead computes the AQ activity only, without adaptive QP it has nothing to do
+  m_cTEncTop.setUseLookahead               ( m_bUseLookahead && m_bUseAdaptiveQP );
+#else
+  m_cTEncTop.setUseLookahead               ( false );
+#endif
 #endif
 }
 
@@ -298,37 +320,95 @@ Void TAppEncTop::encode()
 
   // allocate original YUV buffer
   pcPicYuvOrg->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+#if ENC_ASYNC_IO
+  if ( m_bAsyncIO )
+  {
+    xStartIO( bitstreamFile );
+  }
+#endif
   
   while ( !bEos )
   {
     // get buffers
     xGetBuffer(pcPicYuvRec);
 
+#if ENC_ASYNC_IO
+    // read input YUV file, or take the picture the I/O thread has read
+    TComPicYuv* pcPicYuvIn = pcPicYuvOrg;
+    Bool        bEof;
+    if ( m_bAsyncIO )
+    {
+      pcPicYuvIn = xTakeInput( bEof );
+    }
+    else
+    {
+      m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, m_aiPad );
+      bEof = ( m_cTVideoIOYuvInputFile.isEof() == 1 );
+    }
+#else
     // read input YUV file
     m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, m_aiPad );
+#endif
     
     // increase number of received frames
     m_iFrameRcvd++;
     
     // check end of file
+#if ENC_ASYNC_IO
+    bEos = bEof;
+#else
     bEos = ( m_cTVideoIOYuvInputFile.isEof() == 1 ?   true : false  );
+#endif
     bEos = ( m_iFrameRcvd == m_iFrameToBeEncoded ?    true : bEos   );
     
     // call encoding function for one frame
+#if ENC_ASYNC_IO
+    m_cTEncTop.encode( bEos, pcPicYuvIn, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+    if ( m_bAsyncIO )
+    {
+      xReleaseInput();
+    }
+#else
     m_cTEncTop.encode( bEos, pcPicYuvOrg, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+#endif
     
     // write bistream to file if necessary
     if ( iNumEncoded > 0 )
     {
+#if ENC_ASYNC_IO
+      if ( m_bAsyncIO )
+      {
+        xQueueOutput( iNumEncoded, outputAccessUnits );
+      }
+      else
+#endif
       xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits);
       outputAccessUnits.clear();
     }
   }
+#if ENC_ASYNC_IO
+  if ( m_bAsyncIO )
+  {
+    xFinishIO();
+  }
+#endif
   // delete original YUV buffer
   pcPicYuvOrg->destroy();
   delete pcPicYuvOrg;
   pcPicYuvOrg = NULL;
   
+#if ME_TZ_VISITED
+  if ( m_bPrintTZStats )
+  {
+    UInt64 uiPoints, uiPointsRepeated;
+    m_cTEncTop.getTZSearchCounts( uiPoints, uiPointsRepeated );
+    if ( uiPoints > 0 )
+    {
+      printf( "\nTZ search positions: %.0f, repeated positions skipped: %.0f (%.1f %%)\n", (Double)uiPoints, (Double)uiPointsRepeated, 100.0 * uiPointsRepeated / uiPoints );
+    }
+  }
+#endif
+  
   // delete used buffers in encoder class
   m_cTEncTop.deletePicBuffer();
   
@@ -412,6 +492,203 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
   }
 }
 
+#if ENC_ASYNC_IO
+/** allocate the input and output rings and start the I/O thread, the files are read and written synchronously if the
+ *  thread cannot be started
+ * \param bitstreamFile output bitstream
+ */
+Void TAppEncTop::xStartIO( std::ostream& bitstreamFile )
+{
+  m_cIOThread.create( 1 );
+  if ( m_cIOThread.getNumThreads() == 0 )
+  {
+    m_bAsyncIO = false;
+    return;
+  }
+  
+  // the reader may be a whole GOP ahead while the GOP is compressed
+  m_pcBitstreamFile = &bitstreamFile;
+  m_iNumIOBuffers   = m_iGOPSize + 1;
+  m_apcPicYuvIn     = new TComPicYuv*[ m_iNumIOBuffers ];
+  m_apcPicYuvOut    = new TComPicYuv*[ m_iNumIOBuffers ];
+  m_abInEof         = new Bool       [ m_iNumIOBuffers ];
+  for ( Int i = 0; i < m_iNumIOBuffers; i++ )
+  {
+    m_apcPicYuvIn[i] = new TComPicYuv;
+    m_apcPicYuvIn[i]->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+    m_apcPicYuvOut[i] = NULL;
+    if ( m_pchReconFile )
+    {
+      m_apcPicYuvOut[i] = new TComPicYuv;
+      m_apcPicYuvOut[i]->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+    }
+    m_abInEof[i] = false;
+  }
+  m_iNumInRead     = 0;
+  m_iNumInTaken    = 0;
+  m_bInDone        = false;
+  m_iNumOutQueued  = 0;
+  m_iNumOutWritten = 0;
+  m_bIOTerminate   = false;
+  
+  m_cIOJob.m_pcEncTop = this;
+  m_cIOThread.addJob( &m_cIOJob );
+}
+
+/** wait until the queued output has been written, stop the I/O thread and free the rings
+ */
+Void TAppEncTop::xFinishIO()
+{
+  m_cIOMutex.lock();
+  m_bIOTerminate = true;
+  m_cIOChanged.broadcast();
+  m_cIOMutex.unlock();
+  m_cIOThread.destroy();
+  
+  for ( Int i = 0; i < m_iNumIOBuffers; i++ )
+  {
+    m_apcPicYuvIn[i]->destroy();
+    delete m_apcPicYuvIn[i];
+    if ( m_apcPicYuvOut[i] )
+    {
+      m_apcPicYuvOut[i]->destroy();
+      delete m_apcPicYuvOut[i];
+    }
+  }
+  delete[] m_apcPicYuvIn;
+  delete[] m_apcPicYuvOut;
+  delete[] m_abInEof;
+}
+
+/** wait for the next picture read by the I/O thread
+ * \param rbEof returns true if the end of the input file was reached when the picture was read
+ * \returns input picture, valid until xReleaseInput() is called
+ */
+TComPicYuv* TAppEncTop::xTakeInput( Bool& rbEof )
+{
+  m_cIOMutex.lock();
+  while ( m_iNumInTaken == m_iNumInRead )
+  {
+    m_cIOChanged.wait( m_cIOMutex );
+  }
+  Int iSlot = m_iNumInTaken % m_iNumIOBuffers;
+  rbEof = m_abInEof[iSlot];
+  m_cIOMutex.unlock();
+  
+  return m_apcPicYuvIn[iSlot];
+}
+
+/** hand the buffer of the last picture taken back to the I/O thread
+ */
+Void TAppEncTop::xReleaseInput()
+{
+  m_cIOMutex.lock();
+  m_iNumInTaken++;
+  m_cIOChanged.broadcast();
+  m_cIOMutex.unlock();
+}
+
+/** queue the reconstruction and the access units of the encoded pictures for writing
+ * \param iNumEncoded number of encoded pictures
+ * \param accessUnits access units of the encoded pictures, moved to the queue
+ */
+Void TAppEncTop::xQueueOutput( Int iNumEncoded, std::list<AccessUnit>& accessUnits )
+{
+  Int i;
+  
+  TComList<TComPicYuv*>::iterator iterPicYuvRec = m_cListPicYuvRec.end();
+  
+  for ( i = 0; i < iNumEncoded; i++ )
+  {
+    --iterPicYuvRec;
+  }
+  
+  for ( i = 0; i < iNumEncoded; i++ )
+  {
+    TComPicYuv*  pcPicYuvRec  = *(iterPicYuvRec++);
+    
+    m_cIOMutex.lock();
+    while ( m_iNumOutQueued - m_iNumOutWritten >= m_iNumIOBuffers )
+    {
+      m_cIOChanged.wait( m_cIOMutex );
+    }
+    m_cIOMutex.unlock();
+    
+    // the reconstruction buffer is reused by the next GOP, the I/O thread writes a copy
+    if ( m_pchReconFile )
+    {
+      pcPicYuvRec->copyToPic( m_apcPicYuvOut[ m_iNumOutQueued % m_iNumIOBuffers ] );
+    }
+    
+    m_cIOMutex.lock();
+    m_cOutAccessUnits.splice( m_cOutAccessUnits.end(), accessUnits, accessUnits.begin() );
+    m_iNumOutQueued++;
+    m_cIOChanged.broadcast();
+    m_cIOMutex.unlock();
+  }
+}
+
+/** I/O thread: write the queued output and read the input pictures ahead of the encoder until xFinishIO() is called
+ */
+Void TAppEncTop::xIOLoop()
+{
+  m_cIOMutex.lock();
+  for (;;)
+  {
+    if ( m_iNumOutWritten < m_iNumOutQueued )
+    {
+      TComPicYuv* pcPicYuvRec = m_apcPicYuvOut[ m_iNumOutWritten % m_iNumIOBuffers ];
+      AccessUnit& au          = m_cOutAccessUnits.front();
+      m_cIOMutex.unlock();
+      
+      if (m_pchReconFile)
+        m_cTVideoIOYuvReconFile.write( pcPicYuvRec, m_aiPad );
+      
+      const vector<unsigned>& stats = writeAnnexB(*m_pcBitstreamFile, au);
+      rateStatsAccum(au, stats);
+      
+      m_cIOMutex.lock();
+      m_cOutAccessUnits.pop_front();
+      m_iNumOutWritten++;
+      m_cIOChanged.broadcast();
+    }
+    else if ( m_bIOTerminate )
+    {
+      break;
+    }
+    else if ( !m_bInDone && m_iNumInRead - m_iNumInTaken < m_iNumIOBuffers )
+    {
+      Int iSlot = m_iNumInRead % m_iNumIOBuffers;
+      m_cIOMutex.unlock();
+      
+      m_cTVideoIOYuvInputFile.read( m_apcPicYuvIn[iSlot], m_aiPad );
+      Bool bEof = ( m_cTVideoIOYuvInputFile.isEof() == 1 );
+      if ( bEof && m_iNumInRead > 0 )
+      {
+        // the synchronous reader leaves the previous picture in its buffer at the end of the file
+        m_apcPicYuvIn[ ( iSlot + m_iNumIOBuffers - 1 ) % m_iNumIOBuffers ]->copyToPic( m_apcPicYuvIn[iSlot] );
+      }
+
+      m_cIOMutex.lock();
+      m_abInEof[iSlot] = bEof;
+      m_iNumInRead++;
+      m_bInDone = bEof || m_iNumInRead == m_iFrameToBeEncoded;
+      m_cIOChanged.broadcast();
+    }
+    else
+    {
+      m_cIOChanged.wait( m_cIOMutex );
+    }
+  }
+  m_cIOMutex.unlock();
+}
+
+Void TAppEncIOJob::run()
+{
+  m_pcEncTop->xIOLoop();
+}
+#endif
+
 /**
  *
  */
@@ -44,11 +44,27 @@
 #include "TLibEncoder/TEncTop.h"
 #include "TLibVideoIO/TVideoIOYuv.h"
 #include "TLibCommon/AccessUnit.h"
+#if ENC_ASYNC_IO
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #include "TAppEncCfg.h"
 
 //! \ingroup TAppEncoder
 //! \{
 
+#if ENC_ASYNC_IO
+class TAppEncTop;
+
+/// reading of the input pictures and writing of the output of the encoder application, executed by its I/O thread
+class TAppEncIOJob : public TComJob
+{
+public:
+  TAppEncTop*   m_pcEncTop;
+  
+  Void run();
+};
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -68,6 +84,26 @@ private:
   
   unsigned m_essentialBytes;
   unsigned m_totalBytes;
+  
+#if ENC_ASYNC_IO
+  // asynchronous file I/O
+  TComThreadPool             m_cIOThread;                   ///< I/O thread (AsyncIO)
+  TAppEncIOJob               m_cIOJob;
+  TComMutex                  m_cIOMutex;                    ///< protects the ring counters and the access unit queue
+  TComCondition              m_cIOChanged;                  ///< signalled whenever a counter changes
+  Bool                       m_bIOTerminate;
+  std::ostream*              m_pcBitstreamFile;
+  Int                        m_iNumIOBuffers;               ///< size of the input and output rings
+  TComPicYuv**               m_apcPicYuvIn;                 ///< ring of input pictures read ahead of the encoder
+  Bool*                      m_abInEof;                     ///< end of file was reached when the picture was read
+  Int                        m_iNumInRead;                  ///< number of pictures read by the I/O thread
+  Int                        m_iNumInTaken;                 ///< number of pictures taken by the encoder
+  Bool                       m_bInDone;                     ///< no further picture is to be read
+  TComPicYuv**               m_apcPicYuvOut;                ///< ring of reconstructed pictures waiting to be written
+  std::list<AccessUnit>      m_cOutAccessUnits;             ///< access units waiting to be written
+  Int                        m_iNumOutQueued;               ///< number of pictures queued for writing
+  Int                        m_iNumOutWritten;              ///< number of pictures written by the I/O thread
+#endif
 
 protected:
   // initialization
@@ -86,6 +122,16 @@ protected:
   Void xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits); ///< write bitstream to file
   void rateStatsAccum(const AccessUnit& au, const std::vector<unsigned>& stats);
   void printRateSummary();
+#if ENC_ASYNC_IO
+  friend class TAppEncIOJob;
+  
+  Void  xStartIO          ( std::ostream& bitstreamFile );  ///< allocate the rings and start the I/O thread
+  Void  xFinishIO         ();                               ///< write the queued output and stop the I/O thread
+  TComPicYuv* xTakeInput  ( Bool& rbEof );                  ///< wait for the next input picture
+  Void  xReleaseInput     ();                               ///< the encoder has copied the last input picture taken
+  Void  xQueueOutput      ( Int iNumEncoded, std::list<AccessUnit>& accessUnits ); ///< queue the encoded pictures for writing
+  Void  xIOLoop           ();                               ///< I/O thread: read ahead and write the queued output
+#endif
   
 public:
   TAppEncTop();
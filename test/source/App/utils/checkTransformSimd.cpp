@@ -0,0 +1,259 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     checkTransformSimd.cpp
+    \brief    compares the SIMD transform kernels of TComTrQuant with the C code on random input
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComSimd.h"
+
+// transform kernels of TComTrQuant.cpp, they dispatch to the SIMD code when getSimdLevel() >= SIMD_SSE2
+void partialButterfly4 (short src[4][4],  short dst[4][4],  int shift);
+void partialButterfly8 (short src[8][8],  short dst[8][8],  int shift);
+void partialButterfly16(short src[16][16],short dst[16][16],int shift);
+void partialButterfly32(short src[32][32],short dst[32][32],int shift);
+void partialButterflyInverse4 (short src[4][4],  short dst[4][4],  int shift);
+void partialButterflyInverse8 (short src[8][8],  short dst[8][8],  int shift);
+void partialButterflyInverse16(short src[16][16],short dst[16][16],int shift);
+void partialButterflyInverse32(short src[32][32],short dst[32][32],int shift);
+#if NSQT
+void partialButterfly4 (short *src,short *dst,int shift, int line);
+void partialButterfly8 (short *src,short *dst,int shift, int line);
+void partialButterfly16(short *src,short *dst,int shift, int line);
+void partialButterfly32(short *src,short *dst,int shift, int line);
+void partialButterflyInverse4 (short *src,short *dst,int shift, int line);
+void partialButterflyInverse8 (short *src,short *dst,int shift, int line);
+void partialButterflyInverse16(short *src,short *dst,int shift, int line);
+void partialButterflyInverse32(short *src,short *dst,int shift, int line);
+#endif
+#if INTRA_DST_TYPE_7
+void fastForwardDst(short block[4][4],short coeff[4][4],int shift);
+void fastInverseDst(short tmp[4][4],short block[4][4],int shift);
+#endif
+#if SPARSE_INV_TRANSFORM
+void partialButterflyInverseRows( const short *T, int N, short *src, short *dst, int shift, int line, int srcStride, int rows );
+#endif
+
+#if SIMD_TRANSFORM && SIMD_X86
+
+typedef void (*TransformFunc)( short *src, short *dst, int shift, int line );
+
+// the square kernels take the block as a 2D array, the line count is the transform size
+static void xFwd4  ( short *src, short *dst, int shift, int ) { partialButterfly4 ( (short(*)[4] )src, (short(*)[4] )dst, shift ); }
+static void xFwd8  ( short *src, short *dst, int shift, int ) { partialButterfly8 ( (short(*)[8] )src, (short(*)[8] )dst, shift ); }
+static void xFwd16 ( short *src, short *dst, int shift, int ) { partialButterfly16( (short(*)[16])src, (short(*)[16])dst, shift ); }
+static void xFwd32 ( short *src, short *dst, int shift, int ) { partialButterfly32( (short(*)[32])src, (short(*)[32])dst, shift ); }
+static void xInv4  ( short *src, short *dst, int shift, int ) { partialButterflyInverse4 ( (short(*)[4] )src, (short(*)[4] )dst, shift ); }
+static void xInv8  ( short *src, short *dst, int shift, int ) { partialButterflyInverse8 ( (short(*)[8] )src, (short(*)[8] )dst, shift ); }
+static void xInv16 ( short *src, short *dst, int shift, int ) { partialButterflyInverse16( (short(*)[16])src, (short(*)[16])dst, shift ); }
+static void xInv32 ( short *src, short *dst, int shift, int ) { partialButterflyInverse32( (short(*)[32])src, (short(*)[32])dst, shift ); }
+#if NSQT
+static void xFwdN4 ( short *src, short *dst, int shift, int line ) { partialButterfly4 ( src, dst, shift, line ); }
+static void xFwdN8 ( short *src, short *dst, int shift, int line ) { partialButterfly8 ( src, dst, shift, line ); }
+static void xFwdN16( short *src, short *dst, int shift, int line ) { partialButterfly16( src, dst, shift, line ); }
+static void xFwdN32( short *src, short *dst, int shift, int line ) { partialButterfly32( src, dst, shift, line ); }
+static void xInvN4 ( short *src, short *dst, int shift, int line ) { partialButterflyInverse4 ( src, dst, shift, line ); }
+static void xInvN8 ( short *src, short *dst, int shift, int line ) { partialButterflyInverse8 ( src, dst, shift, line ); }
+static void xInvN16( short *src, short *dst, int shift, int line ) { partialButterflyInverse16( src, dst, shift, line ); }
+static void xInvN32( short *src, short *dst, int shift, int line ) { partialButterflyInverse32( src, dst, shift, line ); }
+#endif
+#if INTRA_DST_TYPE_7
+static void xFwdDst( short *src, short *dst, int shift, int ) { fastForwardDst( (short(*)[4])src, (short(*)[4])dst, shift ); }
+static void xInvDst( short *src, short *dst, int shift, int ) { fastInverseDst( (short(*)[4])src, (short(*)[4])dst, shift ); }
+#endif
+
+/// one kernel with the shift of the first or the second pass, the input is N x line samples
+struct TransformCase
+{
+  const char*   pchName;
+  TransformFunc pfFunc;
+  Int           iSize;
+  Int           iLine;
+  Int           iShift;
+};
+
+// forward shifts are log2(N) - 1 and log2(N) + 6 (no bit increment), inverse shifts are SHIFT_INV_1ST and SHIFT_INV_2ND
+static const TransformCase s_asCases[] =
+{
+  { "forward 4",        xFwd4,    4,  4,  1 }, { "forward 4",        xFwd4,    4,  4,  8 },
+  { "forward 8",        xFwd8,    8,  8,  2 }, { "forward 8",        xFwd8,    8,  8,  9 },
+  { "forward 16",       xFwd16,  16, 16,  3 }, { "forward 16",       xFwd16,  16, 16, 10 },
+  { "forward 32",       xFwd32,  32, 32,  4 }, { "forward 32",       xFwd32,  32, 32, 11 },
+  { "inverse 4",        xInv4,    4,  4,  7 }, { "inverse 4",        xInv4,    4,  4, 12 },
+  { "inverse 8",        xInv8,    8,  8,  7 }, { "inverse 8",        xInv8,    8,  8, 12 },
+  { "inverse 16",       xInv16,  16, 16,  7 }, { "inverse 16",       xInv16,  16, 16, 12 },
+  { "inverse 32",       xInv32,  32, 32,  7 }, { "inverse 32",       xInv32,  32, 32, 12 },
+#if NSQT
+  // 16x4 and 4x16 blocks
+  { "forward 16 x 4",   xFwdN16, 16,  4,  3 }, { "forward 4 x 16",   xFwdN4,   4, 16,  8 },
+  { "forward 4 x 16",   xFwdN4,   4, 16,  1 }, { "forward 16 x 4",   xFwdN16, 16,  4, 10 },
+  { "inverse 4 x 16",   xInvN4,   4, 16,  7 }, { "inverse 16 x 4",   xInvN16, 16,  4, 12 },
+  { "inverse 16 x 4",   xInvN16, 16,  4,  7 }, { "inverse 4 x 16",   xInvN4,   4, 16, 12 },
+  // 32x8 and 8x32 blocks
+  { "forward 32 x 8",   xFwdN32, 32,  8,  4 }, { "forward 8 x 32",   xFwdN8,   8, 32,  9 },
+  { "forward 8 x 32",   xFwdN8,   8, 32,  2 }, { "forward 32 x 8",   xFwdN32, 32,  8, 11 },
+  { "inverse 8 x 32",   xInvN8,   8, 32,  7 }, { "inverse 32 x 8",   xInvN32, 32,  8, 12 },
+  { "inverse 32 x 8",   xInvN32, 32,  8,  7 }, { "inverse 8 x 32",   xInvN8,   8, 32, 12 },
+#endif
+#if INTRA_DST_TYPE_7
+  { "forward DST",      xFwdDst,  4,  4,  1 }, { "forward DST",      xFwdDst,  4,  4,  8 },
+  { "inverse DST",      xInvDst,  4,  4,  7 }, { "inverse DST",      xInvDst,  4,  4, 12 },
+#endif
+};
+
+static UInt s_uiRandom = 1;
+
+/// linear congruential generator, so that a seed reproduces the same input on every platform
+static Int xRandom( Int iMin, Int iMax )
+{
+  s_uiRandom = s_uiRandom * 1103515245 + 12345;
+  return iMin + (Int)( ( s_uiRandom >> 8 ) % (UInt)( iMax - iMin + 1 ) );
+}
+
+/// fills the input with residuals (forward) or coefficients, alternating between the 9-bit and the full 16-bit range
+static Void xFillInput( short *psSrc, Int iNum, Int iIter )
+{
+  Int iMin = ( iIter & 1 ) ? -32768 : -255;
+  Int iMax = ( iIter & 1 ) ?  32767 :  255;
+  for ( Int i = 0; i < iNum; i++ )
+  {
+    psSrc[i] = (short)xRandom( iMin, iMax );
+  }
+}
+
+/// runs the kernel with the C code and with the SIMD code on the same input and compares the output
+static Bool xCompare( const char* pchName, Int iNum, short *psDstC, short *psDstSimd, UInt uiSimdLevel, Int iIter, Int iShift )
+{
+  if ( memcmp( psDstC, psDstSimd, iNum * sizeof(short) ) == 0 )
+  {
+    return true;
+  }
+  for ( Int i = 0; i < iNum; i++ )
+  {
+    if ( psDstC[i] != psDstSimd[i] )
+    {
+      printf( "mismatch: %s, shift %d, iteration %d, SIMD level %d, sample %d: C %d, SIMD %d\n",
+              pchName, iShift, iIter, uiSimdLevel, i, psDstC[i], psDstSimd[i] );
+      break;
+    }
+  }
+  return false;
+}
+
+int main( int argc, char* argv[] )
+{
+  Int iIterations = argc > 1 ? atoi( argv[1] ) : 1000;
+  s_uiRandom      = argc > 2 ? (UInt)atoi( argv[2] ) : 1;
+  if ( argc > 3 || iIterations <= 0 )
+  {
+    printf( "usage: %s [iterations [seed]]\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+  
+  UInt uiSimdLevel = getCpuSimdLevel();
+  if ( uiSimdLevel < SIMD_SSE2 )
+  {
+    printf( "the CPU does not support SSE2, nothing to compare\n" );
+    return EXIT_SUCCESS;
+  }
+  
+  short asSrc    [32*32];
+  short asDstC   [32*32];
+  short asDstSimd[32*32];
+  Int   iNumCases    = 0;
+  Int   iNumMismatch = 0;
+  
+  for ( UInt uiCase = 0; uiCase < sizeof( s_asCases ) / sizeof( s_asCases[0] ); uiCase++ )
+  {
+    const TransformCase& rcCase = s_asCases[uiCase];
+    Int iNum = rcCase.iSize * rcCase.iLine;
+    Int iFail = 0;
+    for ( Int iIter = 0; iIter < iIterations; iIter++ )
+    {
+      xFillInput( asSrc, iNum, iIter );
+      setSimdLevel( SIMD_NONE );
+      rcCase.pfFunc( asSrc, asDstC, rcCase.iShift, rcCase.iLine );
+      setSimdLevel( uiSimdLevel );
+      rcCase.pfFunc( asSrc, asDstSimd, rcCase.iShift, rcCase.iLine );
+      iFail += xCompare( rcCase.pchName, iNum, asDstC, asDstSimd, uiSimdLevel, iIter, rcCase.iShift ) ? 0 : 1;
+    }
+    printf( "%-18s shift %2d: %s\n", rcCase.pchName, rcCase.iShift, iFail ? "FAILED" : "ok" );
+    iNumCases++;
+    iNumMismatch += iFail;
+  }
+  
+#if SPARSE_INV_TRANSFORM
+  // inverse transform with the zero rows left out, the line count and the number of rows are multiples of 4
+  static const short* const apsMatrix[5] = { g_aiT4[0], g_aiT8[0], g_aiT16[0], g_aiT32[0], g_as_DST_MAT_4[0] };
+  static const Int          aiSize   [5] = { 4, 8, 16, 32, 4 };
+  for ( Int iMat = 0; iMat < 5; iMat++ )
+  {
+    Int N = aiSize[iMat];
+    Int iFail = 0;
+    for ( Int iIter = 0; iIter < iIterations; iIter++ )
+    {
+      Int iLine  = 4 * xRandom( 1, 8 );
+      Int iRows  = N == 4 ? 4 : 4 * xRandom( 1, N / 4 );
+      Int iShift = ( iIter & 2 ) ? 12 : 7;
+      xFillInput( asSrc, 32 * N, iIter );
+      setSimdLevel( SIMD_NONE );
+      partialButterflyInverseRows( apsMatrix[iMat], N, asSrc, asDstC, iShift, iLine, 32, iRows );
+      setSimdLevel( uiSimdLevel );
+      partialButterflyInverseRows( apsMatrix[iMat], N, asSrc, asDstSimd, iShift, iLine, 32, iRows );
+      iFail += xCompare( "inverse rows", iLine * N, asDstC, asDstSimd, uiSimdLevel, iIter, iShift ) ? 0 : 1;
+    }
+    printf( "inverse rows %-5s         : %s\n", iMat == 4 ? "DST" : ( N == 4 ? "4" : N == 8 ? "8" : N == 16 ? "16" : "32" ), iFail ? "FAILED" : "ok" );
+    iNumCases++;
+    iNumMismatch += iFail;
+  }
+#endif
+  
+  printf( "%d kernels, %d iterations each, SIMD level %d: %d mismatching iterations\n", iNumCases, iIterations, uiSimdLevel, iNumMismatch );
+  return iNumMismatch ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#else
+
+int main( int, char*[] )
+{
+  printf( "the SIMD transform is not compiled in, nothing to compare\n" );
+  return EXIT_SUCCESS;
+}
+
+#endif
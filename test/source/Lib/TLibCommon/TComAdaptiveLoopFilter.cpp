@@ -1595,6 +1595,12 @@ Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgYRecPost, imgpel *imgYRec, i
   Int numBitsMinus1= NUM_BITS-1;
   Int offset = (1<<(NUM_BITS-2));
 
+#if SIMD_ALF && SIMD_X86 && STAR_CROSS_SHAPES_LUMA
+  if ( xFilterLumaSimd( imgYRecPost, imgYRec, filtNo, 0, m_img_height, 0, m_img_width, stride, m_imgY_var ) )
+  {
+    return;
+  }
+#endif
 #if STAR_CROSS_SHAPES_LUMA
   switch(filtNo)
   {
@@ -1828,6 +1834,12 @@ Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec
   Int numBitsMinus1= NUM_BITS-1;
   Int offset = (1<<(NUM_BITS-2));
 
+#if SIMD_ALF && SIMD_X86 && STAR_CROSS_SHAPES_LUMA
+  if ( xFilterLumaSimd( imgYRecPost, imgYRec, filtNo, startHeight, endHeight, startWidth, endWidth, stride, m_imgY_var ) )
+  {
+    return;
+  }
+#endif
 #if STAR_CROSS_SHAPES_LUMA
   switch(filtNo)
   {
@@ -2528,6 +2540,12 @@ Void TComAdaptiveLoopFilter::xFrameChroma( TComPicYuv* pcPicDec, TComPicYuv* pcP
   Pel* pTmpPixSum;
 #endif
   
+#if SIMD_ALF && SIMD_X86 && ALF_CHROMA_NEW_SHAPES
+  if ( xFilterChromaSimd( pRest, iRestStride, pDec, iDecStride, iWidth, iHeight, iTap, qh ) )
+  {
+    return;
+  }
+#endif
   switch(iTap)
   {
 #if ALF_CHROMA_NEW_SHAPES
@@ -4514,4 +4532,218 @@ Void TComAdaptiveLoopFilter::xPCMSampleRestoration (TComDataCU* pcCU, UInt uiAbs
   }
 }
 #endif
+
+#if SIMD_ALF && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+#define ALF_SIMD_COEF_PAIRS   5   ///< number of packed coefficient pairs of one filter
+
+/// positions (row, column) of the symmetric tap pairs in the order of the coefficients, the center tap follows the pairs
+const Int TComAdaptiveLoopFilter::m_aiSimdTapPos[2][8][2] =
+{
+  { {2, 2}, {2, 0}, {2,-2}, {1, 1}, {1, 0}, {1,-1}, {0, 2}, {0, 1} },
+  { {2, 0}, {1, 0}, {0, 5}, {0, 4}, {0, 3}, {0, 2}, {0, 1}, {0, 0} }
+};
+const Int TComAdaptiveLoopFilter::m_aiSimdNumTapPairs[2] = { 8, 7 };
+
+/// luma coefficients of the star and the cross shape in the order of m_aiSimdTapPos, followed by the center tap
+static const Int s_aiAlfSimdLumaCoefIdx[2][9] =
+{
+  { 3, 5, 7, 15, 16, 17, 25, 26, 27 },
+  { 5, 16, 22, 23, 24, 25, 26, 27, 0 }
+};
+
+/** pack the coefficients of one filter into pairs of 16-bit values for _mm_madd_epi16
+ * \param piCoef      coefficients in the order of m_aiSimdTapPos followed by the center tap
+ * \param iNumCoef    number of coefficients
+ * \param piCoefPair  packed coefficient pairs
+ * \returns false if a coefficient does not fit into 16 bits
+ */
+static Bool xPackAlfCoefSimd(const Int* piCoef, Int iNumCoef, Int* piCoefPair)
+{
+  for (Int k = 0; k < ALF_SIMD_COEF_PAIRS; k++)
+  {
+    Int iCoef0 = ( 2*k     < iNumCoef ) ? piCoef[2*k]     : 0;
+    Int iCoef1 = ( 2*k + 1 < iNumCoef ) ? piCoef[2*k + 1] : 0;
+    if (iCoef0 < -32768 || iCoef0 > 32767 || iCoef1 < -32768 || iCoef1 > 32767)
+    {
+      return false;
+    }
+    piCoefPair[k] = ( iCoef0 & 0xffff ) | ( (UInt)iCoef1 << 16 );
+  }
+  return true;
+}
+
+/** luma ALF of the samples iStartX..iEndX-1 of the lines iStartY..iEndY-1 with the SIMD kernel
+ * \param pRest, pDec   filtered and unfiltered picture
+ * \param iShape        filter shape (0: star, 1: cross)
+ * \param iStride       stride of both pictures
+ * \param ppVar         class of each 4x4 block of the picture
+ * \returns false if the SIMD kernel cannot be used, the caller then filters with the C code
+ */
+Bool TComAdaptiveLoopFilter::xFilterLumaSimd(imgpel* pRest, imgpel* pDec, Int iShape, Int iStartY, Int iEndY, Int iStartX, Int iEndX, Int iStride, imgpel** ppVar)
+{
+  if ( getSimdLevel() < SIMD_SSE2 || g_uiBitDepth + g_uiBitIncrement > 14 || iStartX % VAR_SIZE_W != 0 || iShape > 1 )
+  {
+    return false;
+  }
+
+  Int aiCoefPair[NO_VAR_BINS*ALF_SIMD_COEF_PAIRS];
+  Int aiAdd     [NO_VAR_BINS];
+  Int aiCoef    [9];
+  Int iNumCoef = m_aiSimdNumTapPairs[iShape] + 1;
+
+  for (Int iClass = 0; iClass < NO_VAR_BINS; iClass++)
+  {
+    Int* piCoef = m_filterCoeffPrevSelected[iClass];
+    for (Int k = 0; k < iNumCoef; k++)
+    {
+      aiCoef[k] = piCoef[s_aiAlfSimdLumaCoefIdx[iShape][k]];
+    }
+    if (!xPackAlfCoefSimd( aiCoef, iNumCoef, aiCoefPair + iClass*ALF_SIMD_COEF_PAIRS ))
+    {
+      return false;
+    }
+    aiAdd[iClass] = piCoef[MAX_SQR_FILT_LENGTH-1] + ( 1 << ( NUM_BITS - 2 ) );
+  }
+
+  Int iOffset = iStartY*iStride + iStartX;
+  xFilterBlockSimd( (Pel*)pRest + iOffset, iStride, (const Pel*)pDec + iOffset, iStride, iEndX - iStartX, iEndY - iStartY, iShape,
+                    aiCoefPair, aiAdd, NUM_BITS - 1, ppVar, iStartY, iStartX );
+  return true;
+}
+
+/** chroma ALF of a block with the SIMD kernel
+ * \param pRest, iRestStride  filtered block
+ * \param pDec, iDecStride    unfiltered block
+ * \param iWidth, iHeight     size of the block
+ * \param iShape              filter shape (0: star, 1: cross)
+ * \param qh                  filter coefficients followed by the DC offset
+ * \returns false if the SIMD kernel cannot be used, the caller then filters with the C code
+ */
+Bool TComAdaptiveLoopFilter::xFilterChromaSimd(Pel* pRest, Int iRestStride, Pel* pDec, Int iDecStride, Int iWidth, Int iHeight, Int iShape, Int* qh)
+{
+  if ( getSimdLevel() < SIMD_SSE2 || g_uiBitDepth + g_uiBitIncrement > 14 || iShape > 1 )
+  {
+    return false;
+  }
+
+  Int aiCoefPair[ALF_SIMD_COEF_PAIRS];
+  Int iNumCoef = m_aiSimdNumTapPairs[iShape] + 1;
+  if (!xPackAlfCoefSimd( qh, iNumCoef, aiCoefPair ))
+  {
+    return false;
+  }
+  Int iAdd = ( qh[iNumCoef] << ( g_uiBitDepth + g_uiBitIncrement - 8 ) ) + ALF_ROUND_OFFSET;
+
+  xFilterBlockSimd( pRest, iRestStride, pDec, iDecStride, iWidth, iHeight, iShape, aiCoefPair, &iAdd, ALF_NUM_BIT_SHIFT, NULL, 0, 0 );
+  return true;
+}
+
+/** filter a block with a symmetric star or cross shape, 8 samples per step
+ * \param pDst, iDstStride  filtered block
+ * \param pSrc, iSrcStride  unfiltered block
+ * \param iWidth, iHeight   size of the block
+ * \param iShape            filter shape (0: star, 1: cross)
+ * \param piCoefPair        coefficient pairs of each class, packed by xPackAlfCoefSimd()
+ * \param piAdd             DC offset and rounding of each class
+ * \param iShift            output shift
+ * \param ppVar             class of each 4x4 block, NULL if the block uses the filter of class 0 only
+ * \param iVarY, iVarX      position of the block in ppVar
+ *
+ * The two samples of each tap pair are added in 16 bits and interleaved with the next pair, so that _mm_madd_epi16
+ * applies two coefficients at once. The four left and the four right samples of a step take the coefficients of
+ * their own 4x4 block.
+ */
+Void TComAdaptiveLoopFilter::xFilterBlockSimd(Pel* pDst, Int iDstStride, const Pel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iShape, const Int* piCoefPair, const Int* piAdd, Int iShift, imgpel** ppVar, Int iVarY, Int iVarX)
+{
+  Int iNumPairs  = m_aiSimdNumTapPairs[iShape];
+  Int iNumPacked = ( iNumPairs + 2 ) >> 1;
+  Int aiTapOffset[8];
+  for (Int k = 0; k < iNumPairs; k++)
+  {
+    aiTapOffset[k] = m_aiSimdTapPos[iShape][k][0]*iSrcStride + m_aiSimdTapPos[iShape][k][1];
+  }
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+  const __m128i vMax   = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  const __m128i vZero  = _mm_setzero_si128();
+  __m128i vTerm[10];
+
+  for (Int y = 0; y < iHeight; y++)
+  {
+    const imgpel* pVar = ppVar ? ppVar[( iVarY + y ) / VAR_SIZE_H] + iVarX / VAR_SIZE_W : NULL;
+    Int x = 0;
+
+    for (; x + 8 <= iWidth; x += 8)
+    {
+      Int iClass0 = pVar ? pVar[x / VAR_SIZE_W]     : 0;
+      Int iClass1 = pVar ? pVar[x / VAR_SIZE_W + 1] : 0;
+      const Int* piPair0 = piCoefPair + iClass0*ALF_SIMD_COEF_PAIRS;
+      const Int* piPair1 = piCoefPair + iClass1*ALF_SIMD_COEF_PAIRS;
+      const Pel* p = pSrc + x;
+
+      for (Int k = 0; k < iNumPairs; k++)
+      {
+        vTerm[k] = _mm_add_epi16( _mm_loadu_si128( (const __m128i*)( p + aiTapOffset[k] ) ), _mm_loadu_si128( (const __m128i*)( p - aiTapOffset[k] ) ) );
+      }
+      vTerm[iNumPairs]     = _mm_loadu_si128( (const __m128i*)p );
+      vTerm[iNumPairs + 1] = vZero;
+
+      __m128i vSumLo = _mm_set1_epi32( piAdd[iClass0] );
+      __m128i vSumHi = _mm_set1_epi32( piAdd[iClass1] );
+      for (Int k = 0; k < iNumPacked; k++)
+      {
+        vSumLo = _mm_add_epi32( vSumLo, _mm_madd_epi16( _mm_unpacklo_epi16( vTerm[2*k], vTerm[2*k + 1] ), _mm_set1_epi32( piPair0[k] ) ) );
+        vSumHi = _mm_add_epi32( vSumHi, _mm_madd_epi16( _mm_unpackhi_epi16( vTerm[2*k], vTerm[2*k + 1] ), _mm_set1_epi32( piPair1[k] ) ) );
+      }
+      __m128i vVal = _mm_packs_epi32( _mm_sra_epi32( vSumLo, vShift ), _mm_sra_epi32( vSumHi, vShift ) );
+      vVal = _mm_min_epi16( _mm_max_epi16( vVal, vZero ), vMax );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), vVal );
+    }
+
+    if (x + 4 <= iWidth)
+    {
+      Int iClass0 = pVar ? pVar[x / VAR_SIZE_W] : 0;
+      const Int* piPair0 = piCoefPair + iClass0*ALF_SIMD_COEF_PAIRS;
+      const Pel* p = pSrc + x;
+
+      for (Int k = 0; k < iNumPairs; k++)
+      {
+        vTerm[k] = _mm_add_epi16( _mm_loadl_epi64( (const __m128i*)( p + aiTapOffset[k] ) ), _mm_loadl_epi64( (const __m128i*)( p - aiTapOffset[k] ) ) );
+      }
+      vTerm[iNumPairs]     = _mm_loadl_epi64( (const __m128i*)p );
+      vTerm[iNumPairs + 1] = vZero;
+
+      __m128i vSum = _mm_set1_epi32( piAdd[iClass0] );
+      for (Int k = 0; k < iNumPacked; k++)
+      {
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_unpacklo_epi16( vTerm[2*k], vTerm[2*k + 1] ), _mm_set1_epi32( piPair0[k] ) ) );
+      }
+      __m128i vVal = _mm_packs_epi32( _mm_sra_epi32( vSum, vShift ), vZero );
+      vVal = _mm_min_epi16( _mm_max_epi16( vVal, vZero ), vMax );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), vVal );
+      x += 4;
+    }
+
+    for (; x < iWidth; x++)
+    {
+      Int iClass = pVar ? pVar[x / VAR_SIZE_W] : 0;
+      const Int* piPair = piCoefPair + iClass*ALF_SIMD_COEF_PAIRS;
+      Int iSum = piAdd[iClass];
+      for (Int k = 0; k <= iNumPairs; k++)
+      {
+        Int iTerm = ( k < iNumPairs ) ? pSrc[x + aiTapOffset[k]] + pSrc[x - aiTapOffset[k]] : pSrc[x];
+        iSum += iTerm * (Short)( piPair[k >> 1] >> ( ( k & 1 ) * 16 ) );
+      }
+      pDst[x] = (Pel)Clip3( 0, (Int)g_uiIBDI_MAX, iSum >> iShift );
+    }
+
+    pSrc += iSrcStride;
+    pDst += iDstStride;
+  }
+}
+#endif
+
 //! \}
@@ -40,6 +40,9 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#if SIMD_ALF
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -395,6 +398,10 @@ protected:
   static Int *patternMapTabShapes[NO_TEST_FILT];
   static Int *weightsTabShapes[NO_TEST_FILT];
 #endif
+#if SIMD_ALF && SIMD_X86
+  static const Int m_aiSimdTapPos[2][8][2];       ///< positions of the symmetric tap pairs of the star and the cross shape for the SIMD kernels
+  static const Int m_aiSimdNumTapPairs[2];        ///< number of symmetric tap pairs of the star and the cross shape
+#endif
 #if TI_ALF_MAX_VSIZE_7
   static Int m_pattern9x9Sym[39];
   static Int m_weights9x9Sym[21];
@@ -505,6 +512,11 @@ protected:
   Void xCUAdaptive_qc(TComPic* pcPic, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, Int Stride);
   Void subfilterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int start_height, int end_height, int start_width, int end_width, int Stride);
   Void filterFrame(imgpel *imgY_rec_post, imgpel *imgY_rec, int filtNo, int Stride);
+#if SIMD_ALF && SIMD_X86
+  Bool xFilterLumaSimd  (imgpel* pRest, imgpel* pDec, Int iShape, Int iStartY, Int iEndY, Int iStartX, Int iEndX, Int iStride, imgpel** ppVar);
+  Bool xFilterChromaSimd(Pel* pRest, Int iRestStride, Pel* pDec, Int iDecStride, Int iWidth, Int iHeight, Int iShape, Int* qh);
+  SIMD_TARGET_SSE2 static Void xFilterBlockSimd(Pel* pDst, Int iDstStride, const Pel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iShape, const Int* piCoefPair, const Int* piAdd, Int iShift, imgpel** ppVar, Int iVarY, Int iVarX);
+#endif
   UInt  m_uiNumCUsInFrame;
 #if F747_APS
   Void  setAlfCtrlFlags(AlfCUCtrlInfo* pAlfParam, TComDataCU *pcCU, UInt uiAbsPartIdx, UInt uiDepth, UInt &idx);
@@ -92,6 +92,13 @@ const Short TComInterpolationFilter::m_chromaFilter[8][NTAPS_CHROMA] =
  */
 Void TComInterpolationFilter::filterCopy(const Pel *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast)
 {
+#if SIMD_INTERPOLATION && SIMD_X86
+  if ( ( width & 3 ) == 0 && getSimdLevel() >= SIMD_SSE2 )
+  {
+    filterCopySimd( src, srcStride, dst, dstStride, width, height, isFirst, isLast );
+    return;
+  }
+#endif
   Int row, col;
   
   if ( isFirst == isLast )
@@ -164,6 +171,24 @@ Void TComInterpolationFilter::filterCopy(const Pel *src, Int srcStride, Short *d
 template<int N, bool isVertical, bool isFirst, bool isLast>
 Void TComInterpolationFilter::filter(Short const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff)
 {
+#if SIMD_INTERPOLATION && SIMD_X86
+  if ( ( width & 3 ) == 0 )
+  {
+    SimdLevel eLevel = getSimdLevel();
+#if SIMD_AVX2_SUPPORTED
+    if ( eLevel >= SIMD_AVX2 && width >= 16 )
+    {
+      filterAvx2<N, isVertical, isFirst, isLast>( src, srcStride, dst, dstStride, width, height, coeff );
+      return;
+    }
+#endif
+    if ( eLevel >= SIMD_SSE2 )
+    {
+      filterSimd<N, isVertical, isFirst, isLast>( src, srcStride, dst, dstStride, width, height, coeff );
+      return;
+    }
+  }
+#endif
   Int row, col;
   
   Short c[8];
@@ -305,6 +330,230 @@ Void TComInterpolationFilter::filterVer(Pel *src, Int srcStride, Short *dst, Int
   }      
 }
 
+#if SIMD_INTERPOLATION && SIMD_X86
+// ====================================================================================================================
+// SIMD filter functions
+// ====================================================================================================================
+
+/**
+ * \brief Apply unit FIR filter to a block of samples, 8 samples per step (width multiple of 4)
+ *
+ * Same result as filterCopy().
+ */
+Void TComInterpolationFilter::filterCopySimd(const Pel *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast)
+{
+  Int row, col;
+  Int shift = IF_INTERNAL_PREC - ( g_uiBitDepth + g_uiBitIncrement );
+  __m128i vShift = _mm_cvtsi32_si128( shift );
+  __m128i vOffset16 = _mm_set1_epi16( (Short)IF_INTERNAL_OFFS );
+  __m128i vOffset32 = _mm_set1_epi32( IF_INTERNAL_OFFS + (1 << (shift - 1)) );
+  __m128i vMax = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  __m128i vZero = _mm_setzero_si128();
+  
+  for (row = 0; row < height; row++)
+  {
+    for (col = 0; col < width; col += 8)
+    {
+      __m128i v = ( col + 8 <= width ) ? _mm_loadu_si128( (const __m128i*)&src[col] ) : _mm_loadl_epi64( (const __m128i*)&src[col] );
+      if ( isFirst && !isLast )
+      {
+        v = _mm_sub_epi16( _mm_sll_epi16( v, vShift ), vOffset16 );
+      }
+      else if ( isLast && !isFirst )
+      {
+        // the rounding offset may leave the 16-bit range
+        __m128i vLo = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+        __m128i vHi = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+        vLo = _mm_sra_epi32( _mm_add_epi32( vLo, vOffset32 ), vShift );
+        vHi = _mm_sra_epi32( _mm_add_epi32( vHi, vOffset32 ), vShift );
+        v = _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), vZero ), vMax );
+      }
+      if ( col + 8 <= width )
+      {
+        _mm_storeu_si128( (__m128i*)&dst[col], v );
+      }
+      else
+      {
+        _mm_storel_epi64( (__m128i*)&dst[col], v );
+      }
+    }
+    
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/**
+ * \brief Round, shift and clip the 32-bit filter sums of filterSimd() to 16-bit samples
+ *
+ * The sums are truncated to 16 bits before the clipping as in filter().
+ */
+template<bool isLast>
+SIMD_TARGET_SSE2 static inline __m128i xRoundFilterSums( __m128i vSumLo, __m128i vSumHi, __m128i vOffset, __m128i vShift, __m128i vMax )
+{
+  vSumLo = _mm_sra_epi32( _mm_add_epi32( vSumLo, vOffset ), vShift );
+  vSumHi = _mm_sra_epi32( _mm_add_epi32( vSumHi, vOffset ), vShift );
+  vSumLo = _mm_srai_epi32( _mm_slli_epi32( vSumLo, 16 ), 16 );
+  vSumHi = _mm_srai_epi32( _mm_slli_epi32( vSumHi, 16 ), 16 );
+  __m128i vVal = _mm_packs_epi32( vSumLo, vSumHi );
+  if ( isLast )
+  {
+    vVal = _mm_min_epi16( _mm_max_epi16( vVal, _mm_setzero_si128() ), vMax );
+  }
+  return vVal;
+}
+
+/**
+ * \brief Apply FIR filter to a block of samples, 8 samples per step (width multiple of 4)
+ *
+ * Same result as filter(). Each pair of taps is applied with one multiply-add on the interleaved samples.
+ */
+template<int N, bool isVertical, bool isFirst, bool isLast>
+Void TComInterpolationFilter::filterSimd(Pel const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff)
+{
+  Int row, col, k;
+  
+  Int cStride = ( isVertical ) ? srcStride : 1;
+  src -= ( N/2 - 1 ) * cStride;
+  
+  Int offset;
+  Short maxVal;
+  Int headRoom = IF_INTERNAL_PREC - (g_uiBitDepth + g_uiBitIncrement);
+  Int shift = IF_FILTER_PREC;
+  if ( isLast )
+  {
+    shift += (isFirst) ? 0 : headRoom;
+    offset = 1 << (shift - 1);
+    offset += (isFirst) ? 0 : IF_INTERNAL_OFFS << IF_FILTER_PREC;
+    maxVal = g_uiIBDI_MAX;
+  }
+  else
+  {
+    shift -= (isFirst) ? headRoom : 0;
+    offset = (isFirst) ? -IF_INTERNAL_OFFS << shift : 0;
+    maxVal = 0;
+  }
+  
+  __m128i vCoeff[N/2];
+  for (k = 0; k < N/2; k++)
+  {
+    vCoeff[k] = _mm_set1_epi32( (UShort)coeff[2*k] | ( (Int)coeff[2*k+1] << 16 ) );
+  }
+  __m128i vOffset = _mm_set1_epi32( offset );
+  __m128i vShift  = _mm_cvtsi32_si128( shift );
+  __m128i vMax    = _mm_set1_epi16( maxVal );
+  
+  for (row = 0; row < height; row++)
+  {
+    for (col = 0; col + 8 <= width; col += 8)
+    {
+      __m128i vSumLo = _mm_setzero_si128();
+      __m128i vSumHi = _mm_setzero_si128();
+      for (k = 0; k < N/2; k++)
+      {
+        __m128i vA = _mm_loadu_si128( (const __m128i*)&src[col + (2*k  ) * cStride] );
+        __m128i vB = _mm_loadu_si128( (const __m128i*)&src[col + (2*k+1) * cStride] );
+        vSumLo = _mm_add_epi32( vSumLo, _mm_madd_epi16( _mm_unpacklo_epi16( vA, vB ), vCoeff[k] ) );
+        vSumHi = _mm_add_epi32( vSumHi, _mm_madd_epi16( _mm_unpackhi_epi16( vA, vB ), vCoeff[k] ) );
+      }
+      _mm_storeu_si128( (__m128i*)&dst[col], xRoundFilterSums<isLast>( vSumLo, vSumHi, vOffset, vShift, vMax ) );
+    }
+    if ( col < width )
+    {
+      __m128i vSum = _mm_setzero_si128();
+      for (k = 0; k < N/2; k++)
+      {
+        __m128i vA = _mm_loadl_epi64( (const __m128i*)&src[col + (2*k  ) * cStride] );
+        __m128i vB = _mm_loadl_epi64( (const __m128i*)&src[col + (2*k+1) * cStride] );
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_unpacklo_epi16( vA, vB ), vCoeff[k] ) );
+      }
+      _mm_storel_epi64( (__m128i*)&dst[col], xRoundFilterSums<isLast>( vSum, vSum, vOffset, vShift, vMax ) );
+    }
+    
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+#if SIMD_AVX2_SUPPORTED
+/**
+ * \brief Apply FIR filter to a block of samples, 16 samples per step (width multiple of 4)
+ *
+ * Same result as filter(). The columns beyond the last multiple of 16 are filtered by filterSimd().
+ */
+template<int N, bool isVertical, bool isFirst, bool isLast>
+Void TComInterpolationFilter::filterAvx2(Pel const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff)
+{
+  Int row, col, k;
+  Int width16 = width & ~15;
+  if ( width16 < width )
+  {
+    filterSimd<N, isVertical, isFirst, isLast>( src + width16, srcStride, dst + width16, dstStride, width - width16, height, coeff );
+  }
+  
+  Int cStride = ( isVertical ) ? srcStride : 1;
+  src -= ( N/2 - 1 ) * cStride;
+  
+  Int offset;
+  Short maxVal;
+  Int headRoom = IF_INTERNAL_PREC - (g_uiBitDepth + g_uiBitIncrement);
+  Int shift = IF_FILTER_PREC;
+  if ( isLast )
+  {
+    shift += (isFirst) ? 0 : headRoom;
+    offset = 1 << (shift - 1);
+    offset += (isFirst) ? 0 : IF_INTERNAL_OFFS << IF_FILTER_PREC;
+    maxVal = g_uiIBDI_MAX;
+  }
+  else
+  {
+    shift -= (isFirst) ? headRoom : 0;
+    offset = (isFirst) ? -IF_INTERNAL_OFFS << shift : 0;
+    maxVal = 0;
+  }
+  
+  __m256i vCoeff[N/2];
+  for (k = 0; k < N/2; k++)
+  {
+    vCoeff[k] = _mm256_set1_epi32( (UShort)coeff[2*k] | ( (Int)coeff[2*k+1] << 16 ) );
+  }
+  __m256i vOffset = _mm256_set1_epi32( offset );
+  __m128i vShift  = _mm_cvtsi32_si128( shift );
+  __m256i vMax    = _mm256_set1_epi16( maxVal );
+  
+  for (row = 0; row < height; row++)
+  {
+    for (col = 0; col < width16; col += 16)
+    {
+      __m256i vSumLo = _mm256_setzero_si256();
+      __m256i vSumHi = _mm256_setzero_si256();
+      for (k = 0; k < N/2; k++)
+      {
+        __m256i vA = _mm256_loadu_si256( (const __m256i*)&src[col + (2*k  ) * cStride] );
+        __m256i vB = _mm256_loadu_si256( (const __m256i*)&src[col + (2*k+1) * cStride] );
+        vSumLo = _mm256_add_epi32( vSumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vA, vB ), vCoeff[k] ) );
+        vSumHi = _mm256_add_epi32( vSumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vA, vB ), vCoeff[k] ) );
+      }
+      // the unpack and pack operations both work within the 128-bit lanes, so the samples stay in order
+      vSumLo = _mm256_sra_epi32( _mm256_add_epi32( vSumLo, vOffset ), vShift );
+      vSumHi = _mm256_sra_epi32( _mm256_add_epi32( vSumHi, vOffset ), vShift );
+      vSumLo = _mm256_srai_epi32( _mm256_slli_epi32( vSumLo, 16 ), 16 );
+      vSumHi = _mm256_srai_epi32( _mm256_slli_epi32( vSumHi, 16 ), 16 );
+      __m256i vVal = _mm256_packs_epi32( vSumLo, vSumHi );
+      if ( isLast )
+      {
+        vVal = _mm256_min_epi16( _mm256_max_epi16( vVal, _mm256_setzero_si256() ), vMax );
+      }
+      _mm256_storeu_si256( (__m256i*)&dst[col], vVal );
+    }
+    
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+#endif
+#endif
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -40,6 +40,9 @@
 #define __HM_TCOMINTERPOLATIONFILTER_H__
 
 #include "TypeDef.h"
+#if SIMD_INTERPOLATION
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -65,6 +68,17 @@ class TComInterpolationFilter
   template<int N, bool isVertical, bool isFirst, bool isLast>
   static Void filter(Pel const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff);
 
+#if SIMD_INTERPOLATION && SIMD_X86
+  SIMD_TARGET_SSE2 static Void filterCopySimd(const Pel *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+  
+  template<int N, bool isVertical, bool isFirst, bool isLast>
+  SIMD_TARGET_SSE2 static Void filterSimd(Pel const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff);
+#if SIMD_AVX2_SUPPORTED
+  template<int N, bool isVertical, bool isFirst, bool isLast>
+  SIMD_TARGET_AVX2 static Void filterAvx2(Pel const *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height, Short const *coeff);
+#endif
+#endif
+
   template<int N>
   static Void filterHor(Pel *src, Int srcStride, Short *dst, Int dstStride, Int width, Int height,               Bool isLast, Short const *coeff);
   template<int N>
@@ -200,6 +200,89 @@ Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 #endif
 }
 
+#if LOOP_FILTER_THREADS
+/**
+ - call deblocking function for every CU of one LCU row
+ .
+ \param  pcPic   picture class (TComPic) pointer
+ \param  uiRow   LCU row index in the picture
+ 
+ The edges of a row only modify the row itself and the three bottom lines of the row above, so filtering the rows
+ top-down gives the same picture as loopFilterPic once the row below has been reconstructed.
+ */
+Void TComLoopFilter::loopFilterCURow( TComPic* pcPic, UInt uiRow )
+{
+  if (m_uiDisableDeblockingFilterIdc == 1)
+    return;
+  
+  UInt uiWidthInCU    = pcPic->getFrameWidthInCU();
+  UInt uiStartCUAddr  = uiRow * uiWidthInCU;
+  UInt uiBoundingAddr = uiStartCUAddr + uiWidthInCU;
+  
+#if PARALLEL_MERGED_DEBLK
+  // keep the unfiltered samples of the row for the filter decisions
+  TComPicYuv* pcPicYuvRec = pcPic->getPicYuvRec();
+  Int         iStride     = pcPicYuvRec->getStride();
+  Int         iNumLines   = min( (Int)g_uiMaxCUHeight, pcPicYuvRec->getHeight() - (Int)pcPic->getCU( uiStartCUAddr )->getCUPelY() );
+  Pel*        piSrc       = pcPicYuvRec->getLumaAddr( uiStartCUAddr );
+  Pel*        piDst       = m_preDeblockPic.getLumaAddr( uiStartCUAddr );
+  for ( Int y = 0; y < iNumLines; y++ )
+  {
+    ::memcpy( piDst, piSrc, sizeof( Pel ) * pcPicYuvRec->getWidth() );
+    piSrc += iStride;
+    piDst += iStride;
+  }
+  
+  // Horizontal filtering
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    
+    for( Int iPlane = 0; iPlane < 3; iPlane++ )
+    {
+      ::memset( m_aapucBS       [EDGE_VER][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
+      ::memset( m_aapbEdgeFilter[EDGE_VER][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
+    }
+    
+    // CU-based deblocking
+    xDeblockCU( pcCU, 0, 0, EDGE_VER );
+  }
+  
+  // Vertical filtering
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    
+    for( Int iPlane = 0; iPlane < 3; iPlane++ )
+    {
+      ::memset( m_aapucBS       [EDGE_HOR][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
+      ::memset( m_aapbEdgeFilter[EDGE_HOR][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
+    }
+    
+    // CU-based deblocking
+    xDeblockCU( pcCU, 0, 0, EDGE_HOR );
+  }
+#else
+  // for every CU of the row
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    
+    for( Int iDir = EDGE_VER; iDir <= EDGE_HOR; iDir++ )
+    {
+      for( Int iPlane = 0; iPlane < 3; iPlane++ )
+      {
+        ::memset( m_aapucBS       [iDir][iPlane], 0, sizeof( UChar ) * m_uiNumPartitions );
+        ::memset( m_aapbEdgeFilter[iDir][iPlane], 0, sizeof( bool  ) * m_uiNumPartitions );
+      }
+    }
+    // CU-based deblocking
+    xDeblockCU( pcCU, 0, 0 );
+  }
+#endif
+}
+#endif
+
 
 // ====================================================================================================================
 // Protected member functions
@@ -779,6 +862,10 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
   TComDataCU* pcCUP; 
   TComDataCU* pcCUQ = pcCU;
 #endif
+#if SIMD_DEBLOCK && SIMD_X86 && PARALLEL_MERGED_DEBLK && F118_LUMA_DEBLOCK
+  // the segment kernels keep the filter sums in 16 bits
+  Bool  bSimd = getSimdLevel() >= SIMD_SSE2 && g_uiBitDepth + g_uiBitIncrement <= 12;
+#endif
 
   if (iDir == EDGE_VER)
   {
@@ -1012,8 +1099,18 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
       {
 #if PARALLEL_MERGED_DEBLK
 #if F118_LUMA_DEBLOCK
-        Int iDP = xCalcDP( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+2), iOffset) + xCalcDP( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+5), iOffset);
-        Int iDQ = xCalcDQ( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+2), iOffset) + xCalcDQ( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+5), iOffset);
+        Int iDP, iDQ;
+#if SIMD_DEBLOCK && SIMD_X86
+        if ( bSimd )
+        {
+          xCalcDPDQSimd( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK), iOffset, iSrcStep, iDP, iDQ );
+        }
+        else
+#endif
+        {
+          iDP = xCalcDP( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+2), iOffset) + xCalcDP( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+5), iOffset);
+          iDQ = xCalcDQ( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+2), iOffset) + xCalcDQ( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+5), iOffset);
+        }
         Int iD = iDP + iDQ;
 #else
         Int iD = xCalcD( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+2), iOffset) + xCalcD( piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK+5), iOffset);
@@ -1053,6 +1150,17 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
             bPartPNoFilter = (pcCUP->getIPCMFlag(uiPartPIdx));
             bPartQNoFilter = (pcCUQ->getIPCMFlag(uiPartQIdx));
           }
+#endif
+#if SIMD_DEBLOCK && SIMD_X86 && PARALLEL_MERGED_DEBLK && F118_LUMA_DEBLOCK
+          if ( bSimd )
+          {
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX 
+            xPelFilterLumaSimd( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK), iOffset, iSrcStep, iD, iBeta, iTc, piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK), bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterP, bFilterQ );
+#else
+            xPelFilterLumaSimd( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK), iOffset, iSrcStep, iD, iBeta, iTc, piTmpSrcJudge+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*DEBLOCK_SMALLEST_BLOCK), false, false, iThrCut, bFilterP, bFilterQ );
+#endif
+          }
+          else
 #endif
           for ( UInt i = 0; i < DEBLOCK_SMALLEST_BLOCK; i++)
           {
@@ -1141,6 +1249,10 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
   
   Pel* piTmpSrcCb = piSrcCb;
   Pel* piTmpSrcCr = piSrcCr;
+#if SIMD_DEBLOCK && SIMD_X86
+  // the kernel keeps the filter sums in 16 bits and filters two lines of each component at a time
+  Bool bSimd = getSimdLevel() >= SIMD_SSE2 && g_uiBitDepth + g_uiBitIncrement <= 12 && ( uiPelsInPartChroma & 1 ) == 0;
+#endif
   
   
   if (iDir == EDGE_VER)
@@ -1197,6 +1309,17 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
       }
 #endif
 
+#if SIMD_DEBLOCK && SIMD_X86
+      if ( bSimd )
+      {
+#if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX 
+        xPelFilterChromaSimd( piTmpSrcCb + iSrcStep*iIdx*uiPelsInPartChroma, piTmpSrcCr + iSrcStep*iIdx*uiPelsInPartChroma, iOffset, iSrcStep, uiPelsInPartChroma, iTc, bPartPNoFilter, bPartQNoFilter );
+#else
+        xPelFilterChromaSimd( piTmpSrcCb + iSrcStep*iIdx*uiPelsInPartChroma, piTmpSrcCr + iSrcStep*iIdx*uiPelsInPartChroma, iOffset, iSrcStep, uiPelsInPartChroma, iTc, false, false );
+#endif
+      }
+      else
+#endif
       for ( UInt uiStep = 0; uiStep < uiPelsInPartChroma; uiStep++ )
       {
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX 
@@ -1586,4 +1709,327 @@ __inline Int TComLoopFilter::xCalcD( Pel* piSrc, Int iOffset)
   return abs( piSrc[-iOffset*3] - 2*piSrc[-iOffset*2] + piSrc[-iOffset] ) + abs( piSrc[0] - 2*piSrc[iOffset] + piSrc[iOffset*2] );
 }
 #endif
+#if SIMD_DEBLOCK && SIMD_X86
+// ====================================================================================================================
+// SIMD deblocking functions
+// ====================================================================================================================
+
+/**
+ * \brief Transpose eight rows of eight 16-bit samples in place
+ */
+SIMD_TARGET_SSE2 static inline Void xTranspose8x8( __m128i* pv )
+{
+  __m128i a0 = _mm_unpacklo_epi16( pv[0], pv[1] );
+  __m128i a1 = _mm_unpackhi_epi16( pv[0], pv[1] );
+  __m128i a2 = _mm_unpacklo_epi16( pv[2], pv[3] );
+  __m128i a3 = _mm_unpackhi_epi16( pv[2], pv[3] );
+  __m128i a4 = _mm_unpacklo_epi16( pv[4], pv[5] );
+  __m128i a5 = _mm_unpackhi_epi16( pv[4], pv[5] );
+  __m128i a6 = _mm_unpacklo_epi16( pv[6], pv[7] );
+  __m128i a7 = _mm_unpackhi_epi16( pv[6], pv[7] );
+  __m128i b0 = _mm_unpacklo_epi32( a0, a2 );
+  __m128i b1 = _mm_unpackhi_epi32( a0, a2 );
+  __m128i b2 = _mm_unpacklo_epi32( a1, a3 );
+  __m128i b3 = _mm_unpackhi_epi32( a1, a3 );
+  __m128i b4 = _mm_unpacklo_epi32( a4, a6 );
+  __m128i b5 = _mm_unpackhi_epi32( a4, a6 );
+  __m128i b6 = _mm_unpacklo_epi32( a5, a7 );
+  __m128i b7 = _mm_unpackhi_epi32( a5, a7 );
+  pv[0] = _mm_unpacklo_epi64( b0, b4 );
+  pv[1] = _mm_unpackhi_epi64( b0, b4 );
+  pv[2] = _mm_unpacklo_epi64( b1, b5 );
+  pv[3] = _mm_unpackhi_epi64( b1, b5 );
+  pv[4] = _mm_unpacklo_epi64( b2, b6 );
+  pv[5] = _mm_unpackhi_epi64( b2, b6 );
+  pv[6] = _mm_unpacklo_epi64( b3, b7 );
+  pv[7] = _mm_unpackhi_epi64( b3, b7 );
+}
+
+/**
+ * \brief Load the samples p3..q3 of the eight lines of an edge segment, one vector per distance from the edge
+ */
+SIMD_TARGET_SSE2 static inline Void xLoadLumaSegment( const Pel* piSrc, Int iOffset, Int iSrcStep, __m128i* pv )
+{
+  if ( iOffset == 1 )
+  {
+    for ( Int i = 0; i < 8; i++ )
+    {
+      pv[i] = _mm_loadu_si128( (const __m128i*)( piSrc + i*iSrcStep - 4 ) );
+    }
+    xTranspose8x8( pv );
+  }
+  else
+  {
+    for ( Int i = 0; i < 8; i++ )
+    {
+      pv[i] = _mm_loadu_si128( (const __m128i*)( piSrc + ( i - 4 )*iOffset ) );
+    }
+  }
+}
+
+/// load two adjacent samples into the low element of a vector
+SIMD_TARGET_SSE2 static inline __m128i xLoadPair( const Pel* piSrc )
+{
+  Int iPair;
+  ::memcpy( &iPair, piSrc, sizeof(Int) );
+  return _mm_cvtsi32_si128( iPair );
+}
+
+/// store two adjacent samples
+static inline Void xStorePair( Pel* piDst, Int iPair )
+{
+  ::memcpy( piDst, &iPair, sizeof(Int) );
+}
+
+SIMD_TARGET_SSE2 static inline __m128i xAbs16( __m128i v )
+{
+  return _mm_max_epi16( v, _mm_sub_epi16( _mm_setzero_si128(), v ) );
+}
+
+SIMD_TARGET_SSE2 static inline __m128i xSelect16( __m128i vMask, __m128i vTrue, __m128i vFalse )
+{
+  return _mm_or_si128( _mm_and_si128( vMask, vTrue ), _mm_andnot_si128( vMask, vFalse ) );
+}
+
+#if PARALLEL_MERGED_DEBLK && F118_LUMA_DEBLOCK
+/**
+ - Side activities of the edge segment starting at piSrc, same result as the sums of xCalcDP() and xCalcDQ() over the lines 2 and 5
+ .
+ \param piSrc         pointer to the first line of the segment
+ \param iOffset       offset value for picture data
+ \param iSrcStep      step between the lines of the segment
+ \param riDP          activity of the P side
+ \param riDQ          activity of the Q side
+ */
+Void TComLoopFilter::xCalcDPDQSimd( Pel* piSrc, Int iOffset, Int iSrcStep, Int& riDP, Int& riDQ )
+{
+  if ( iOffset == 1 )
+  {
+    // one line per vector, the second differences of p2..p0 and q0..q2 land in the elements 1 and 4
+    __m128i vSum = _mm_setzero_si128();
+    for ( Int i = 2; i <= 5; i += 3 )
+    {
+      __m128i v = _mm_loadu_si128( (const __m128i*)( piSrc + i*iSrcStep - 4 ) );
+      __m128i vD = _mm_add_epi16( _mm_sub_epi16( v, _mm_slli_epi16( _mm_srli_si128( v, 2 ), 1 ) ), _mm_srli_si128( v, 4 ) );
+      vSum = _mm_add_epi16( vSum, xAbs16( vD ) );
+    }
+    riDP = _mm_extract_epi16( vSum, 1 );
+    riDQ = _mm_extract_epi16( vSum, 4 );
+  }
+  else
+  {
+    __m128i vP2 = _mm_loadu_si128( (const __m128i*)( piSrc - 3*iOffset ) );
+    __m128i vP1 = _mm_loadu_si128( (const __m128i*)( piSrc - 2*iOffset ) );
+    __m128i vP0 = _mm_loadu_si128( (const __m128i*)( piSrc -   iOffset ) );
+    __m128i vQ0 = _mm_loadu_si128( (const __m128i*)( piSrc             ) );
+    __m128i vQ1 = _mm_loadu_si128( (const __m128i*)( piSrc +   iOffset ) );
+    __m128i vQ2 = _mm_loadu_si128( (const __m128i*)( piSrc + 2*iOffset ) );
+    __m128i vDP = xAbs16( _mm_add_epi16( _mm_sub_epi16( vP2, _mm_slli_epi16( vP1, 1 ) ), vP0 ) );
+    __m128i vDQ = xAbs16( _mm_add_epi16( _mm_sub_epi16( vQ0, _mm_slli_epi16( vQ1, 1 ) ), vQ2 ) );
+    riDP = _mm_extract_epi16( vDP, 2 ) + _mm_extract_epi16( vDP, 5 );
+    riDQ = _mm_extract_epi16( vDQ, 2 ) + _mm_extract_epi16( vDQ, 5 );
+  }
+}
+
+/**
+ - Deblocking of the eight lines of an edge segment for the luminance component, same result as xPelFilterLuma() on each line
+ .
+ \param piSrc           pointer to the first line of the segment
+ \param iOffset         offset value for picture data
+ \param iSrcStep        step between the lines of the segment
+ \param d               d value
+ \param beta            beta value
+ \param tc              tc value
+ \param piSrcJudge      pointer to the first line of the segment in the picture data for decision
+ \param bPartPNoFilter  indicator to disable filtering on partP
+ \param bPartQNoFilter  indicator to disable filtering on partQ
+ */
+Void TComLoopFilter::xPelFilterLumaSimd( Pel* piSrc, Int iOffset, Int iSrcStep, Int d, Int beta, Int tc, Pel* piSrcJudge, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ )
+{
+  __m128i m[8], mj[8];
+  xLoadLumaSegment( piSrc,      iOffset, iSrcStep, m  );
+  xLoadLumaSegment( piSrcJudge, iOffset, iSrcStep, mj );
+
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vMax  = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  const __m128i vTc   = _mm_set1_epi16( (Short)tc );
+  const __m128i vTc2  = _mm_set1_epi16( (Short)( tc >> 1 ) );
+
+  // strong filtering decision
+  __m128i vStrong = vZero;
+  if ( d < ( beta >> 2 ) )
+  {
+    __m128i vDStrong = _mm_add_epi16( xAbs16( _mm_sub_epi16( mj[0], mj[3] ) ), xAbs16( _mm_sub_epi16( mj[7], mj[4] ) ) );
+    vStrong = _mm_and_si128( _mm_cmplt_epi16( vDStrong, _mm_set1_epi16( (Short)( beta >> 3 ) ) ),
+                             _mm_cmplt_epi16( xAbs16( _mm_sub_epi16( mj[3], mj[4] ) ), _mm_set1_epi16( (Short)( ( tc*5 + 1 ) >> 1 ) ) ) );
+  }
+
+  // strong filter
+  __m128i vSum = _mm_add_epi16( _mm_add_epi16( m[2], m[3] ), m[4] );
+  __m128i vP2s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( m[0], 1 ), _mm_add_epi16( _mm_slli_epi16( m[1], 1 ), m[1] ) ), _mm_add_epi16( vSum, _mm_set1_epi16( 4 ) ) ), 3 );
+  __m128i vP1s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( m[1], vSum ), _mm_set1_epi16( 2 ) ), 2 );
+  __m128i vP0s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( m[1], _mm_slli_epi16( vSum, 1 ) ), m[5] ), _mm_set1_epi16( 4 ) ), 3 );
+  vSum = _mm_add_epi16( _mm_add_epi16( m[3], m[4] ), m[5] );
+  __m128i vQ0s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( m[2], _mm_slli_epi16( vSum, 1 ) ), m[6] ), _mm_set1_epi16( 4 ) ), 3 );
+  __m128i vQ1s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( vSum, m[6] ), _mm_set1_epi16( 2 ) ), 2 );
+  __m128i vQ2s = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( vSum, _mm_add_epi16( _mm_slli_epi16( m[6], 1 ), m[6] ) ), _mm_add_epi16( _mm_slli_epi16( m[7], 1 ), _mm_set1_epi16( 4 ) ) ), 3 );
+
+  // weak filter, 9*(m4-m3) - 3*(m5-m2) may leave the 16-bit range
+  const __m128i vCoef = _mm_setr_epi16( 9, -3, 9, -3, 9, -3, 9, -3 );
+  const __m128i vRound = _mm_set1_epi32( 8 );
+  __m128i vD43 = _mm_sub_epi16( m[4], m[3] );
+  __m128i vD52 = _mm_sub_epi16( m[5], m[2] );
+  __m128i vDeltaLo = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vD43, vD52 ), vCoef ), vRound ), 4 );
+  __m128i vDeltaHi = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vD43, vD52 ), vCoef ), vRound ), 4 );
+  __m128i vDelta = _mm_packs_epi32( vDeltaLo, vDeltaHi );
+  __m128i vWeak = _mm_andnot_si128( vStrong, _mm_cmplt_epi16( xAbs16( vDelta ), _mm_set1_epi16( (Short)iThrCut ) ) );
+  vDelta = _mm_min_epi16( _mm_max_epi16( vDelta, _mm_sub_epi16( vZero, vTc ) ), vTc );
+
+  __m128i vP0w = _mm_add_epi16( m[3], vDelta );
+  __m128i vQ0w = _mm_sub_epi16( m[4], vDelta );
+  __m128i vOne = _mm_set1_epi16( 1 );
+  __m128i vDelta1 = _mm_srai_epi16( _mm_add_epi16( _mm_sub_epi16( _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( m[1], m[3] ), vOne ), 1 ), m[2] ), vDelta ), 1 );
+  __m128i vDelta2 = _mm_srai_epi16( _mm_sub_epi16( _mm_sub_epi16( _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( m[6], m[4] ), vOne ), 1 ), m[5] ), vDelta ), 1 );
+  __m128i vP1w = _mm_add_epi16( m[2], _mm_min_epi16( _mm_max_epi16( vDelta1, _mm_sub_epi16( vZero, vTc2 ) ), vTc2 ) );
+  __m128i vQ1w = _mm_add_epi16( m[5], _mm_min_epi16( _mm_max_epi16( vDelta2, _mm_sub_epi16( vZero, vTc2 ) ), vTc2 ) );
+
+  // combine the filters line by line and clip the modified samples
+  __m128i vWeakP1 = bFilterSecondP ? vWeak : vZero;
+  __m128i vWeakQ1 = bFilterSecondQ ? vWeak : vZero;
+  __m128i vP2 = xSelect16( vStrong, vP2s, m[1] );
+  __m128i vP1 = xSelect16( vStrong, vP1s, xSelect16( vWeakP1, vP1w, m[2] ) );
+  __m128i vP0 = xSelect16( vStrong, vP0s, xSelect16( vWeak,   vP0w, m[3] ) );
+  __m128i vQ0 = xSelect16( vStrong, vQ0s, xSelect16( vWeak,   vQ0w, m[4] ) );
+  __m128i vQ1 = xSelect16( vStrong, vQ1s, xSelect16( vWeakQ1, vQ1w, m[5] ) );
+  __m128i vQ2 = xSelect16( vStrong, vQ2s, m[6] );
+  if ( !bPartPNoFilter )
+  {
+    m[1] = _mm_min_epi16( _mm_max_epi16( vP2, vZero ), vMax );
+    m[2] = _mm_min_epi16( _mm_max_epi16( vP1, vZero ), vMax );
+    m[3] = _mm_min_epi16( _mm_max_epi16( vP0, vZero ), vMax );
+  }
+  if ( !bPartQNoFilter )
+  {
+    m[4] = _mm_min_epi16( _mm_max_epi16( vQ0, vZero ), vMax );
+    m[5] = _mm_min_epi16( _mm_max_epi16( vQ1, vZero ), vMax );
+    m[6] = _mm_min_epi16( _mm_max_epi16( vQ2, vZero ), vMax );
+  }
+
+  if ( iOffset == 1 )
+  {
+    xTranspose8x8( m );
+    for ( Int i = 0; i < 8; i++ )
+    {
+      _mm_storeu_si128( (__m128i*)( piSrc + i*iSrcStep - 4 ), m[i] );
+    }
+  }
+  else
+  {
+    for ( Int i = 1; i < 7; i++ )
+    {
+      _mm_storeu_si128( (__m128i*)( piSrc + ( i - 4 )*iOffset ), m[i] );
+    }
+  }
+}
+#endif
+
+/**
+ - Deblocking of an edge segment for both chrominance components, same result as xPelFilterChroma() on each line of each component
+ .
+ \param piSrcCb         pointer to the first line of the segment in the Cb picture data
+ \param piSrcCr         pointer to the first line of the segment in the Cr picture data
+ \param iOffset         offset value for picture data
+ \param iSrcStep        step between the lines of the segment
+ \param iLines          number of lines in the segment (multiple of 2)
+ \param tc              tc value
+ \param bPartPNoFilter  indicator to disable filtering on partP
+ \param bPartQNoFilter  indicator to disable filtering on partQ
+ */
+Void TComLoopFilter::xPelFilterChromaSimd( Pel* piSrcCb, Pel* piSrcCr, Int iOffset, Int iSrcStep, Int iLines, Int tc, Bool bPartPNoFilter, Bool bPartQNoFilter )
+{
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vMax  = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  const __m128i vTc   = _mm_set1_epi16( (Short)tc );
+
+  // up to four lines of Cb in the low half and the same lines of Cr in the high half of each vector
+  for ( Int iLine = 0; iLine < iLines; iLine += 4 )
+  {
+    Int iNum = min( iLines - iLine, 4 );
+    Pel* piCb = piSrcCb + iLine*iSrcStep;
+    Pel* piCr = piSrcCr + iLine*iSrcStep;
+    __m128i vP1, vP0, vQ0, vQ1;
+
+    if ( iOffset == 1 )
+    {
+      __m128i vRow[8];
+      for ( Int i = 0; i < 4; i++ )
+      {
+        vRow[i]   = i < iNum ? _mm_loadl_epi64( (const __m128i*)( piCb + i*iSrcStep - 2 ) ) : vZero;
+        vRow[i+4] = i < iNum ? _mm_loadl_epi64( (const __m128i*)( piCr + i*iSrcStep - 2 ) ) : vZero;
+      }
+      __m128i vCbLo = _mm_unpacklo_epi32( _mm_unpacklo_epi16( vRow[0], vRow[1] ), _mm_unpacklo_epi16( vRow[2], vRow[3] ) );
+      __m128i vCbHi = _mm_unpackhi_epi32( _mm_unpacklo_epi16( vRow[0], vRow[1] ), _mm_unpacklo_epi16( vRow[2], vRow[3] ) );
+      __m128i vCrLo = _mm_unpacklo_epi32( _mm_unpacklo_epi16( vRow[4], vRow[5] ), _mm_unpacklo_epi16( vRow[6], vRow[7] ) );
+      __m128i vCrHi = _mm_unpackhi_epi32( _mm_unpacklo_epi16( vRow[4], vRow[5] ), _mm_unpacklo_epi16( vRow[6], vRow[7] ) );
+      vP1 = _mm_unpacklo_epi64( vCbLo, vCrLo );
+      vP0 = _mm_unpackhi_epi64( vCbLo, vCrLo );
+      vQ0 = _mm_unpacklo_epi64( vCbHi, vCrHi );
+      vQ1 = _mm_unpackhi_epi64( vCbHi, vCrHi );
+    }
+    else if ( iNum == 4 )
+    {
+      vP1 = _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)( piCb - 2*iOffset ) ), _mm_loadl_epi64( (const __m128i*)( piCr - 2*iOffset ) ) );
+      vP0 = _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)( piCb -   iOffset ) ), _mm_loadl_epi64( (const __m128i*)( piCr -   iOffset ) ) );
+      vQ0 = _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)( piCb             ) ), _mm_loadl_epi64( (const __m128i*)( piCr             ) ) );
+      vQ1 = _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)( piCb +   iOffset ) ), _mm_loadl_epi64( (const __m128i*)( piCr +   iOffset ) ) );
+    }
+    else
+    {
+      vP1 = _mm_unpacklo_epi64( xLoadPair( piCb - 2*iOffset ), xLoadPair( piCr - 2*iOffset ) );
+      vP0 = _mm_unpacklo_epi64( xLoadPair( piCb -   iOffset ), xLoadPair( piCr -   iOffset ) );
+      vQ0 = _mm_unpacklo_epi64( xLoadPair( piCb             ), xLoadPair( piCr             ) );
+      vQ1 = _mm_unpacklo_epi64( xLoadPair( piCb +   iOffset ), xLoadPair( piCr +   iOffset ) );
+    }
+
+    __m128i vDelta = _mm_srai_epi16( _mm_add_epi16( _mm_sub_epi16( _mm_add_epi16( _mm_slli_epi16( _mm_sub_epi16( vQ0, vP0 ), 2 ), vP1 ), vQ1 ), _mm_set1_epi16( 4 ) ), 3 );
+    vDelta = _mm_min_epi16( _mm_max_epi16( vDelta, _mm_sub_epi16( vZero, vTc ) ), vTc );
+    if ( !bPartPNoFilter )
+    {
+      vP0 = _mm_min_epi16( _mm_max_epi16( _mm_add_epi16( vP0, vDelta ), vZero ), vMax );
+    }
+    if ( !bPartQNoFilter )
+    {
+      vQ0 = _mm_min_epi16( _mm_max_epi16( _mm_sub_epi16( vQ0, vDelta ), vZero ), vMax );
+    }
+
+    if ( iOffset == 1 )
+    {
+      // p0 and q0 of each line are adjacent
+      Int aiPair[8];
+      _mm_storeu_si128( (__m128i*)&aiPair[0], _mm_unpacklo_epi16( vP0, vQ0 ) );
+      _mm_storeu_si128( (__m128i*)&aiPair[4], _mm_unpackhi_epi16( vP0, vQ0 ) );
+      for ( Int i = 0; i < iNum; i++ )
+      {
+        xStorePair( piCb + i*iSrcStep - 1, aiPair[i]   );
+        xStorePair( piCr + i*iSrcStep - 1, aiPair[i+4] );
+      }
+    }
+    else if ( iNum == 4 )
+    {
+      _mm_storel_epi64( (__m128i*)( piCb - iOffset ), vP0 );
+      _mm_storel_epi64( (__m128i*)( piCr - iOffset ), _mm_unpackhi_epi64( vP0, vP0 ) );
+      _mm_storel_epi64( (__m128i*)( piCb           ), vQ0 );
+      _mm_storel_epi64( (__m128i*)( piCr           ), _mm_unpackhi_epi64( vQ0, vQ0 ) );
+    }
+    else
+    {
+      xStorePair( piCb - iOffset, _mm_cvtsi128_si32( vP0 ) );
+      xStorePair( piCr - iOffset, _mm_cvtsi128_si32( _mm_unpackhi_epi64( vP0, vP0 ) ) );
+      xStorePair( piCb          , _mm_cvtsi128_si32( vQ0 ) );
+      xStorePair( piCr          , _mm_cvtsi128_si32( _mm_unpackhi_epi64( vQ0, vQ0 ) ) );
+    }
+  }
+}
+#endif
+
 //! \}
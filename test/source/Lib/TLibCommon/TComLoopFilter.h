@@ -40,6 +40,9 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#if SIMD_DEBLOCK
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -191,6 +194,13 @@ protected:
 #else
   __inline Int xCalcD( Pel* piSrc, Int iOffset);
 #endif
+#if SIMD_DEBLOCK && SIMD_X86
+#if PARALLEL_MERGED_DEBLK && F118_LUMA_DEBLOCK
+  SIMD_TARGET_SSE2 static Void xCalcDPDQSimd       ( Pel* piSrc, Int iOffset, Int iSrcStep, Int& riDP, Int& riDQ );
+  SIMD_TARGET_SSE2 static Void xPelFilterLumaSimd  ( Pel* piSrc, Int iOffset, Int iSrcStep, Int d, Int beta, Int tc, Pel* piSrcJudge, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ );
+#endif
+  SIMD_TARGET_SSE2 static Void xPelFilterChromaSimd( Pel* piSrcCb, Pel* piSrcCr, Int iOffset, Int iSrcStep, Int iLines, Int tc, Bool bPartPNoFilter, Bool bPartQNoFilter );
+#endif
   
 public:
   TComLoopFilter();
@@ -208,6 +218,11 @@ public:
   
   /// picture-level deblocking filter
   Void loopFilterPic( TComPic* pcPic );
+#if LOOP_FILTER_THREADS
+  
+  /// deblocking filter of one LCU row, the rows of a picture have to be filtered top-down
+  Void loopFilterCURow( TComPic* pcPic, UInt uiRow );
+#endif
 };
 
 //! \}
@@ -54,6 +54,18 @@ TComPic::TComPic()
   m_apcPicYuv[1]      = NULL;
   m_pcPicYuvPred      = NULL;
   m_pcPicYuvResi      = NULL;
+#if ME_PYRAMID
+  for ( Int i = 0; i < ME_PYRAMID_LEVELS; i++ )
+  {
+    m_apcPicYuvPyramid[i] = NULL;
+  }
+#endif
+#if ME_SUBPEL_PLANES
+  for ( Int i = 0; i < 16; i++ )
+  {
+    m_apcPicYuvSubPel[i>>2][i&3] = NULL;
+  }
+#endif
 
   m_bReconstructed    = false;
 }
@@ -100,9 +112,76 @@ Void TComPic::destroy()
     m_apcPicYuv[1]  = NULL;
   }
   
+#if ME_PYRAMID
+  for ( Int i = 0; i < ME_PYRAMID_LEVELS; i++ )
+  {
+    if (m_apcPicYuvPyramid[i])
+    {
+      m_apcPicYuvPyramid[i]->destroyLuma();
+      delete m_apcPicYuvPyramid[i];
+      m_apcPicYuvPyramid[i] = NULL;
+    }
+  }
+#endif
+#if ME_SUBPEL_PLANES
+  destroySubPelPlanes();
+#endif
+  
   delete m_SEIs;
 }
 
+#if ME_PYRAMID
+/** Downscale the reconstruction into the pyramid levels, the levels are allocated on the first call.
+ * Must be called again whenever the reconstruction changes.
+ */
+Void TComPic::buildPyramid()
+{
+  for ( Int iLevel = 1; iLevel <= ME_PYRAMID_LEVELS; iLevel++ )
+  {
+    TComPicYuv* pcPicYuvSrc = getPicYuvPyramid( iLevel-1 );
+    if ( m_apcPicYuvPyramid[iLevel-1] == NULL )
+    {
+      m_apcPicYuvPyramid[iLevel-1] = new TComPicYuv;
+      m_apcPicYuvPyramid[iLevel-1]->createLuma( pcPicYuvSrc->getWidth() >> 1, pcPicYuvSrc->getHeight() >> 1, g_uiMaxCUWidth >> iLevel, g_uiMaxCUHeight >> iLevel, g_uiMaxCUDepth );
+    }
+    pcPicYuvSrc->downscaleLuma( m_apcPicYuvPyramid[iLevel-1] );
+  }
+}
+#endif
+
+#if ME_SUBPEL_PLANES
+/** Interpolate the reconstruction at the 15 fractional phases, the planes are allocated on the first call.
+ * Must be called again whenever the reconstruction changes.
+ */
+Void TComPic::buildSubPelPlanes()
+{
+  TComPicYuv* pcPicYuvRec = getPicYuvRec();
+  for ( Int i = 1; i < 16; i++ )
+  {
+    if ( m_apcPicYuvSubPel[i>>2][i&3] == NULL )
+    {
+      m_apcPicYuvSubPel[i>>2][i&3] = new TComPicYuv;
+      m_apcPicYuvSubPel[i>>2][i&3]->createLuma( pcPicYuvRec->getWidth(), pcPicYuvRec->getHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+    }
+  }
+  pcPicYuvRec->extendPicBorder();
+  pcPicYuvRec->interpolateLuma( m_apcPicYuvSubPel );
+}
+
+Void TComPic::destroySubPelPlanes()
+{
+  for ( Int i = 1; i < 16; i++ )
+  {
+    if (m_apcPicYuvSubPel[i>>2][i&3])
+    {
+      m_apcPicYuvSubPel[i>>2][i&3]->destroyLuma();
+      delete m_apcPicYuvSubPel[i>>2][i&3];
+      m_apcPicYuvSubPel[i>>2][i&3] = NULL;
+    }
+  }
+}
+#endif
+
 #if AMVP_BUFFERCOMPRESS
 Void TComPic::compressMotion()
 {
@@ -49,6 +49,14 @@
 
 class SEImessages;
 
+#if ME_PYRAMID
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define ME_PYRAMID_LEVELS           2                           ///< number of downscaled levels of the reconstruction, each one half the width and height of the level below
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -65,6 +73,12 @@ private:
   
   TComPicYuv*           m_pcPicYuvPred;           //  Prediction
   TComPicYuv*           m_pcPicYuvResi;           //  Residual
+#if ME_PYRAMID
+  TComPicYuv*           m_apcPicYuvPyramid[ME_PYRAMID_LEVELS]; ///< luma of the reconstruction at 1/2 and 1/4 width and height, for the hierarchical motion search
+#endif
+#if ME_SUBPEL_PLANES
+  TComPicYuv*           m_apcPicYuvSubPel[4][4];  ///< luma of the reconstruction at each vertical and horizontal quarter-sample phase, for the fractional motion search
+#endif
   Bool                  m_bReconstructed;
   UInt                  m_uiCurrSliceIdx;         // Index of current slice
   
@@ -96,6 +110,15 @@ public:
   
   TComPicYuv*   getPicYuvPred()       { return  m_pcPicYuvPred; }
   TComPicYuv*   getPicYuvResi()       { return  m_pcPicYuvResi; }
+#if ME_PYRAMID
+  TComPicYuv*   getPicYuvPyramid( Int iLevel ) { return iLevel == 0 ? m_apcPicYuv[1] : m_apcPicYuvPyramid[iLevel-1]; } ///< level 0 is the reconstruction, NULL until buildPyramid()
+  Void          buildPyramid();
+#endif
+#if ME_SUBPEL_PLANES
+  TComPicYuv*   getPicYuvSubPel( Int iFracY, Int iFracX ) { return ( iFracY | iFracX ) == 0 ? m_apcPicYuv[1] : m_apcPicYuvSubPel[iFracY][iFracX]; } ///< phase 0,0 is the reconstruction, NULL until buildSubPelPlanes()
+  Void          buildSubPelPlanes();
+  Void          destroySubPelPlanes();
+#endif
   Void          setPicYuvPred( TComPicYuv* pcPicYuv )       { m_pcPicYuvPred = pcPicYuv; }
   Void          setPicYuvResi( TComPicYuv* pcPicYuv )       { m_pcPicYuvResi = pcPicYuv; }
   
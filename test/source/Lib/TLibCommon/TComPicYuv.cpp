@@ -46,6 +46,9 @@
 #endif
 
 #include "TComPicYuv.h"
+#if ME_SUBPEL_PLANES
+#include "TComInterpolationFilter.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -266,6 +269,68 @@ Void TComPicYuv::extendPicBorder ()
   m_bIsBorderExtended = true;
 }
 
+#if ME_PYRAMID
+/** Average each 2x2 luma block into one sample of pcPicYuvDst and extend the border of pcPicYuvDst.
+ * \param pcPicYuvDst luma-only picture of half the width and height
+ */
+Void TComPicYuv::downscaleLuma( TComPicYuv* pcPicYuvDst )
+{
+  Pel*  piSrc       = getLumaAddr();
+  Int   iSrcStride  = getStride();
+  Pel*  piDst       = pcPicYuvDst->getLumaAddr();
+  Int   iDstStride  = pcPicYuvDst->getStride();
+  Int   iWidth      = pcPicYuvDst->getWidth();
+  Int   iHeight     = pcPicYuvDst->getHeight();
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      piDst[x] = ( piSrc[2*x] + piSrc[2*x+1] + piSrc[2*x+iSrcStride] + piSrc[2*x+1+iSrcStride] + 2 ) >> 2;
+    }
+    piSrc += 2*iSrcStride;
+    piDst += iDstStride;
+  }
+  
+  pcPicYuvDst->xExtendPicCompBorder( pcPicYuvDst->getLumaAddr(), iDstStride, iWidth, iHeight, pcPicYuvDst->m_iLumaMarginX, pcPicYuvDst->m_iLumaMarginY );
+}
+#endif
+
+#if ME_SUBPEL_PLANES
+/** Interpolate the luma at the 15 fractional quarter-sample phases, including the margin.
+ * Each phase is a horizontal pass followed by a vertical pass, the same passes the motion search applies to a block,
+ * so the planes are bit-exact with the block interpolation. The border has to be extended before, the outermost
+ * NTAPS_LUMA/2 samples of the margin are not written.
+ * \param apcPicYuvDst luma-only pictures of the same size indexed by vertical and horizontal phase, [0][0] is not used
+ */
+Void TComPicYuv::interpolateLuma( TComPicYuv* apcPicYuvDst[4][4] )
+{
+  TComInterpolationFilter cIf;
+  Int     iStride     = getStride();
+  Int     iHalfTaps   = NTAPS_LUMA >> 1;
+  Int     iBufHeight  = m_iPicHeight + ( m_iLumaMarginY << 1 );
+  Int     iWidth      = getStride() - ( iHalfTaps << 1 );
+  Int     iHeight     = iBufHeight  - ( iHalfTaps << 1 );
+  Int     iOffset     = iHalfTaps * iStride + iHalfTaps;
+  Short*  psTmp       = (Short*)xMalloc( Short, iStride * iBufHeight );
+  
+  for ( Int iFracX = 0; iFracX < 4; iFracX++ )
+  {
+    cIf.filterHorLuma( m_apiPicBufY + iHalfTaps, iStride, psTmp + iHalfTaps, iStride, iWidth, iBufHeight, iFracX, false );
+    for ( Int iFracY = 0; iFracY < 4; iFracY++ )
+    {
+      if ( iFracX == 0 && iFracY == 0 )
+      {
+        continue;
+      }
+      cIf.filterVerLuma( psTmp + iOffset, iStride, apcPicYuvDst[iFracY][iFracX]->getBufY() + iOffset, iStride, iWidth, iHeight, iFracY, false, true );
+    }
+  }
+  
+  xFree( psTmp );
+}
+#endif
+
 Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY)
 {
   Int   x, y;
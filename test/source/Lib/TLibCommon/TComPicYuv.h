@@ -153,6 +153,16 @@ public:
   
   //  Extend function of picture buffer
   Void  extendPicBorder      ();
+#if ME_PYRAMID
+  
+  //  Downscale the luma to half width and height into a luma-only picture
+  Void  downscaleLuma        ( TComPicYuv* pcPicYuvDst );
+#endif
+#if ME_SUBPEL_PLANES
+  
+  //  Interpolate the luma at the fractional quarter-sample phases into luma-only pictures of the same size
+  Void  interpolateLuma      ( TComPicYuv* apcPicYuvDst[4][4] );
+#endif
   
   //  Dump picture
   Void  dump (char* pFileName, Bool bAdd = false);
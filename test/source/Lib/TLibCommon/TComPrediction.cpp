@@ -234,6 +234,12 @@ Void TComPrediction::xPredIntraAng( Int* pSrc, Int srcStride, Pel*& rpDst, Int d
   }
 
   // Do angular predictions
+#if SIMD_INTRA && SIMD_X86
+  else if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xPredIntraAngSimd( pSrc, srcStride, pDst, dstStride, blkSize, modeVer, intraPredAngle, invAngle );
+  }
+#endif
   else
   {
     Pel* refMain;
@@ -1128,6 +1134,13 @@ Void TComPrediction::xPredIntraPlanar( Int* pSrc, Int srcStride, Pel* rpDst, Int
   }
 
   // Generate prediction signal
+#if SIMD_INTRA && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xPredIntraPlanarSimd( topRow, bottomRow, leftColumn, rightColumn, rpDst, dstStride, blkSize, offset2D, shift2D );
+    return;
+  }
+#endif
   for (k=0;k<blkSize;k++)
   {
     horPred = leftColumn[k] + offset2D;
@@ -1233,6 +1246,13 @@ Void TComPrediction::getLumaRecPixels( TComPattern* pcPattern, UInt uiCWidth, UI
 #endif
 
   // inner part from reconstructed picture buffer
+#if SIMD_INTRA && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xGetLumaRecPixelsSimd( pRecSrc, iRecSrcStride, pDst0, iDstStride, uiCWidth, uiCHeight );
+    return;
+  }
+#endif
   for( Int j = 0; j < uiCHeight; j++ )
   {
     for (Int i = 0; i < uiCWidth; i++)
@@ -1486,6 +1506,13 @@ Void TComPrediction::xGetLLSPrediction( TComPattern* pcPattern, Int* pSrc0, Int
   pLuma = pLuma0;
   pDst = pDst0;
 
+#if SIMD_INTRA && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xGetLLSPredictionSimd( pLuma, iLumaStride, pDst, iDstStride, uiWidth, uiHeight, a, iShift, b );
+    return;
+  }
+#endif
   for( i = 0; i < uiHeight; i++ )
   {
     for( j = 0; j < uiWidth; j++ )
@@ -1518,6 +1545,13 @@ Void TComPrediction::xDCPredFiltering( Int* pSrc, Int iSrcStride, Pel*& rpDst, I
   Int x, y, iDstStride2, iSrcStride2;
 
 #if MN_DC_PRED_FILTER_UNIFIED
+#if SIMD_INTRA && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xDCPredFilteringSimd( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight );
+    return;
+  }
+#endif
   // boundary pixels processing
   pDst[0] = (Pel)((pSrc[-iSrcStride] + pSrc[-1] + 2 * pDst[0] + 2) >> 2);
 
@@ -1593,4 +1627,362 @@ Void TComPrediction::xDCPredFiltering( Int* pSrc, Int iSrcStride, Pel*& rpDst, I
   return;
 }
 #endif
+#if SIMD_INTRA && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/**
+ * \brief Transpose eight rows of eight 16-bit samples in place
+ */
+SIMD_TARGET_SSE2 static inline Void xTranspose8x8( __m128i* pv )
+{
+  __m128i a0 = _mm_unpacklo_epi16( pv[0], pv[1] );
+  __m128i a1 = _mm_unpackhi_epi16( pv[0], pv[1] );
+  __m128i a2 = _mm_unpacklo_epi16( pv[2], pv[3] );
+  __m128i a3 = _mm_unpackhi_epi16( pv[2], pv[3] );
+  __m128i a4 = _mm_unpacklo_epi16( pv[4], pv[5] );
+  __m128i a5 = _mm_unpackhi_epi16( pv[4], pv[5] );
+  __m128i a6 = _mm_unpacklo_epi16( pv[6], pv[7] );
+  __m128i a7 = _mm_unpackhi_epi16( pv[6], pv[7] );
+  __m128i b0 = _mm_unpacklo_epi32( a0, a2 );
+  __m128i b1 = _mm_unpackhi_epi32( a0, a2 );
+  __m128i b2 = _mm_unpacklo_epi32( a1, a3 );
+  __m128i b3 = _mm_unpackhi_epi32( a1, a3 );
+  __m128i b4 = _mm_unpacklo_epi32( a4, a6 );
+  __m128i b5 = _mm_unpackhi_epi32( a4, a6 );
+  __m128i b6 = _mm_unpacklo_epi32( a5, a7 );
+  __m128i b7 = _mm_unpackhi_epi32( a5, a7 );
+  pv[0] = _mm_unpacklo_epi64( b0, b4 );
+  pv[1] = _mm_unpackhi_epi64( b0, b4 );
+  pv[2] = _mm_unpacklo_epi64( b1, b5 );
+  pv[3] = _mm_unpackhi_epi64( b1, b5 );
+  pv[4] = _mm_unpacklo_epi64( b2, b6 );
+  pv[5] = _mm_unpackhi_epi64( b2, b6 );
+  pv[6] = _mm_unpacklo_epi64( b3, b7 );
+  pv[7] = _mm_unpackhi_epi64( b3, b7 );
+}
+
+/**
+ * \brief Transpose a square block in place, 4x4 or in 8x8 tiles
+ */
+SIMD_TARGET_SSE2 static Void xTransposeBlock( Pel* pDst, Int dstStride, Int blkSize )
+{
+  if ( blkSize == 4 )
+  {
+    __m128i a0 = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)( pDst               ) ), _mm_loadl_epi64( (const __m128i*)( pDst +   dstStride ) ) );
+    __m128i a1 = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)( pDst + 2*dstStride ) ), _mm_loadl_epi64( (const __m128i*)( pDst + 3*dstStride ) ) );
+    __m128i b0 = _mm_unpacklo_epi32( a0, a1 );
+    __m128i b1 = _mm_unpackhi_epi32( a0, a1 );
+    _mm_storel_epi64( (__m128i*)( pDst               ), b0 );
+    _mm_storel_epi64( (__m128i*)( pDst +   dstStride ), _mm_srli_si128( b0, 8 ) );
+    _mm_storel_epi64( (__m128i*)( pDst + 2*dstStride ), b1 );
+    _mm_storel_epi64( (__m128i*)( pDst + 3*dstStride ), _mm_srli_si128( b1, 8 ) );
+    return;
+  }
+
+  __m128i av[8], bv[8];
+  for ( Int i = 0; i < blkSize; i += 8 )
+  {
+    for ( Int j = i; j < blkSize; j += 8 )
+    {
+      Pel* pA = pDst + i*dstStride + j;
+      Pel* pB = pDst + j*dstStride + i;
+      for ( Int k = 0; k < 8; k++ )
+      {
+        av[k] = _mm_loadu_si128( (const __m128i*)( pA + k*dstStride ) );
+        bv[k] = _mm_loadu_si128( (const __m128i*)( pB + k*dstStride ) );
+      }
+      xTranspose8x8( av );
+      xTranspose8x8( bv );
+      for ( Int k = 0; k < 8; k++ )
+      {
+        _mm_storeu_si128( (__m128i*)( pB + k*dstStride ), av[k] );
+        _mm_storeu_si128( (__m128i*)( pA + k*dstStride ), bv[k] );
+      }
+    }
+  }
+}
+
+/** Angular intra prediction, the same projection as xPredIntraAng() for a whole row at a time
+ * \param pSrc pointer to reconstructed sample array
+ * \param srcStride the stride of the reconstructed sample array
+ * \param pDst pointer for the prediction sample array
+ * \param dstStride the stride of the prediction sample array
+ * \param blkSize the width and height of the block
+ * \param modeVer true for the vertical modes, the horizontal ones are predicted as vertical and transposed
+ * \param intraPredAngle the scaled prediction angle
+ * \param invAngle the inverse angle used to extend the main reference
+ *
+ * The above row is converted eight samples at a time, the left column and the extension of the main reference are
+ * gathered one sample at a time as in the C function.
+ */
+SIMD_TARGET_SSE2 Void TComPrediction::xPredIntraAngSimd( Int* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int blkSize, Bool modeVer, Int intraPredAngle, Int invAngle )
+{
+  Pel* refMain;
+  Pel  refAbove[2*MAX_CU_SIZE+1];
+  Pel  refLeft[2*MAX_CU_SIZE+1];
+  Int  k, l;
+
+  // Initialise the Main and Left reference array.
+  Int  iRefStart = intraPredAngle < 0 ? blkSize-1 : 0;
+  Int  iRefSize  = intraPredAngle < 0 ? blkSize+1 : 2*blkSize+1;
+  Int* pSrcAbove = pSrc - srcStride - 1;
+  for ( k = 0; k + 8 <= iRefSize; k += 8 )
+  {
+    __m128i v = _mm_packs_epi32( _mm_loadu_si128( (const __m128i*)( pSrcAbove + k ) ), _mm_loadu_si128( (const __m128i*)( pSrcAbove + k + 4 ) ) );
+    _mm_storeu_si128( (__m128i*)( refAbove + iRefStart + k ), v );
+  }
+  for ( ; k < iRefSize; k++ )
+  {
+    refAbove[iRefStart+k] = pSrcAbove[k];
+  }
+  for ( k = 0; k < iRefSize; k++ )
+  {
+    refLeft[iRefStart+k] = pSrc[(k-1)*srcStride-1];
+  }
+
+  if (intraPredAngle < 0)
+  {
+    Pel* refMainBuf = modeVer ? refAbove : refLeft;
+    Pel* refSideBuf = modeVer ? refLeft : refAbove;
+
+    // Extend the Main reference to the left, into the start of its buffer in front of the corner sample at blkSize-1.
+    Int invAngleSum    = 128;       // rounding for (shift by 8)
+    for (k=blkSize-2; k>blkSize-1+(blkSize*intraPredAngle>>5); k--)
+    {
+      invAngleSum += invAngle;
+      refMainBuf[k] = refSideBuf[blkSize-1+(invAngleSum>>8)];
+    }
+    refMain = refMainBuf + (blkSize-1);
+  }
+  else
+  {
+    refMain = modeVer ? refAbove : refLeft;
+  }
+
+  // ((32-deltaFract)*refMain[i] + deltaFract*refMain[i+1] + 16) >> 5 as a multiply-add of the interleaved neighbours
+  const __m128i vRound = _mm_set1_epi32( 16 );
+  Int deltaPos = 0;
+  for (k=0;k<blkSize;k++)
+  {
+    deltaPos += intraPredAngle;
+    Int  deltaInt   = deltaPos >> 5;
+    Int  deltaFract = deltaPos & (32 - 1);
+    Pel* pRef       = refMain + deltaInt + 1;
+    Pel* pRow       = pDst + k*dstStride;
+
+    if (deltaFract)
+    {
+      const __m128i vWeight = _mm_set1_epi32( ( 32 - deltaFract ) | ( deltaFract << 16 ) );
+      for ( l = 0; l + 8 <= blkSize; l += 8 )
+      {
+        __m128i v0 = _mm_loadu_si128( (const __m128i*)( pRef + l ) );
+        __m128i v1 = _mm_loadu_si128( (const __m128i*)( pRef + l + 1 ) );
+        __m128i vLo = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( v0, v1 ), vWeight ), vRound ), 5 );
+        __m128i vHi = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( v0, v1 ), vWeight ), vRound ), 5 );
+        _mm_storeu_si128( (__m128i*)( pRow + l ), _mm_packs_epi32( vLo, vHi ) );
+      }
+      for ( ; l < blkSize; l += 4 )
+      {
+        __m128i v0 = _mm_loadl_epi64( (const __m128i*)( pRef + l ) );
+        __m128i v1 = _mm_loadl_epi64( (const __m128i*)( pRef + l + 1 ) );
+        __m128i vLo = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( v0, v1 ), vWeight ), vRound ), 5 );
+        _mm_storel_epi64( (__m128i*)( pRow + l ), _mm_packs_epi32( vLo, vLo ) );
+      }
+    }
+    else
+    {
+      // Just copy the integer samples
+      for ( l = 0; l + 8 <= blkSize; l += 8 )
+      {
+        _mm_storeu_si128( (__m128i*)( pRow + l ), _mm_loadu_si128( (const __m128i*)( pRef + l ) ) );
+      }
+      for ( ; l < blkSize; l += 4 )
+      {
+        _mm_storel_epi64( (__m128i*)( pRow + l ), _mm_loadl_epi64( (const __m128i*)( pRef + l ) ) );
+      }
+    }
+  }
+
+  // Flip the block if this is the horizontal mode
+  if (!modeVer)
+  {
+    xTransposeBlock( pDst, dstStride, blkSize );
+  }
+}
+
+#if ADD_PLANAR_MODE
+/** Planar intra prediction from the prepared reference rows and columns of xPredIntraPlanar()
+ * \param piTopRow top row scaled by the 1-D shift, updated by piBottomRow for every row as in the C function
+ * \param piBottomRow bottom-left sample minus the top row
+ * \param piLeftColumn left column scaled by the 1-D shift
+ * \param piRightColumn top-right sample minus the left column
+ * \param pDst pointer for the prediction sample array
+ * \param dstStride the stride of the prediction sample array
+ * \param blkSize the width and height of the block
+ * \param offset2D rounding offset
+ * \param shift2D final shift
+ *
+ * The horizontal term of column l is leftColumn + offset2D + (l+1)*rightColumn, it is stepped by 4*rightColumn
+ * so that the whole prediction stays in 32-bit additions.
+ */
+SIMD_TARGET_SSE2 Void TComPrediction::xPredIntraPlanarSimd( Int* piTopRow, Int* piBottomRow, Int* piLeftColumn, Int* piRightColumn, Pel* pDst, Int dstStride, Int blkSize, Int offset2D, Int shift2D )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift2D );
+
+  for ( Int k = 0; k < blkSize; k++ )
+  {
+    Int iRight = piRightColumn[k];
+    __m128i vHor  = _mm_add_epi32( _mm_set1_epi32( piLeftColumn[k] + offset2D ), _mm_set_epi32( 4*iRight, 3*iRight, 2*iRight, iRight ) );
+    __m128i vStep = _mm_set1_epi32( 4*iRight );
+    Pel*    pRow  = pDst + k*dstStride;
+    Int     l     = 0;
+
+    for ( ; l + 8 <= blkSize; l += 8 )
+    {
+      __m128i vTop0 = _mm_add_epi32( _mm_loadu_si128( (const __m128i*)( piTopRow + l     ) ), _mm_loadu_si128( (const __m128i*)( piBottomRow + l     ) ) );
+      __m128i vTop1 = _mm_add_epi32( _mm_loadu_si128( (const __m128i*)( piTopRow + l + 4 ) ), _mm_loadu_si128( (const __m128i*)( piBottomRow + l + 4 ) ) );
+      _mm_storeu_si128( (__m128i*)( piTopRow + l     ), vTop0 );
+      _mm_storeu_si128( (__m128i*)( piTopRow + l + 4 ), vTop1 );
+      __m128i vHor1 = _mm_add_epi32( vHor, vStep );
+      __m128i vLo   = _mm_sra_epi32( _mm_add_epi32( vHor,  vTop0 ), vShift );
+      __m128i vHi   = _mm_sra_epi32( _mm_add_epi32( vHor1, vTop1 ), vShift );
+      _mm_storeu_si128( (__m128i*)( pRow + l ), _mm_packs_epi32( vLo, vHi ) );
+      vHor = _mm_add_epi32( vHor1, vStep );
+    }
+    for ( ; l < blkSize; l += 4 )
+    {
+      __m128i vTop = _mm_add_epi32( _mm_loadu_si128( (const __m128i*)( piTopRow + l ) ), _mm_loadu_si128( (const __m128i*)( piBottomRow + l ) ) );
+      _mm_storeu_si128( (__m128i*)( piTopRow + l ), vTop );
+      __m128i vPred = _mm_sra_epi32( _mm_add_epi32( vHor, vTop ), vShift );
+      _mm_storel_epi64( (__m128i*)( pRow + l ), _mm_packs_epi32( vPred, vPred ) );
+      vHor = _mm_add_epi32( vHor, vStep );
+    }
+  }
+}
+#endif
+
+#if MN_DC_PRED_FILTER && MN_DC_PRED_FILTER_UNIFIED
+/** DC filtering as in xDCPredFiltering(), the top row eight samples at a time
+ * \param pSrc pointer to reconstructed sample array
+ * \param iSrcStride the stride of the reconstructed sample array
+ * \param pDst pointer for the prediction sample array
+ * \param iDstStride the stride of the prediction sample array
+ * \param iWidth the width of the block
+ * \param iHeight the height of the block
+ */
+SIMD_TARGET_SSE2 Void TComPrediction::xDCPredFilteringSimd( Int* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  const __m128i vRound = _mm_set1_epi16( 2 );
+  Int* pSrcAbove = pSrc - iSrcStride;
+  Pel  iCorner   = (Pel)((pSrcAbove[0] + pSrc[-1] + 2 * pDst[0] + 2) >> 2);
+  Int  x, y;
+
+  // (above + 3 * pred + 2) >> 2 on the whole row, the corner sample is replaced afterwards
+  for ( x = 0; x + 8 <= iWidth; x += 8 )
+  {
+    __m128i vAbove = _mm_packs_epi32( _mm_loadu_si128( (const __m128i*)( pSrcAbove + x ) ), _mm_loadu_si128( (const __m128i*)( pSrcAbove + x + 4 ) ) );
+    __m128i vPred  = _mm_loadu_si128( (const __m128i*)( pDst + x ) );
+    __m128i vSum   = _mm_add_epi16( _mm_add_epi16( vAbove, vRound ), _mm_add_epi16( vPred, _mm_add_epi16( vPred, vPred ) ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_srai_epi16( vSum, 2 ) );
+  }
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = (Pel)((pSrcAbove[x] + 3 * pDst[x] + 2) >> 2);
+  }
+  pDst[0] = iCorner;
+
+  for ( y = 1; y < iHeight; y++ )
+  {
+    pDst[y*iDstStride] = (Pel)((pSrc[y*iSrcStride-1] + 3 * pDst[y*iDstStride] + 2) >> 2);
+  }
+}
+#endif
+
+#if LM_CHROMA
+/** Downsampled luma of the inner part of the block, (pRecSrc[2*i] + pRecSrc[2*i + iRecSrcStride]) >> 1
+ * \param pRecSrc pointer to reconstructed luma samples
+ * \param iRecSrcStride the stride of the reconstructed luma samples
+ * \param pDst pointer to the downsampled luma buffer
+ * \param iDstStride the stride of the downsampled luma buffer
+ * \param iCWidth the width of the chroma block
+ * \param iCHeight the height of the chroma block
+ */
+SIMD_TARGET_SSE2 Void TComPrediction::xGetLumaRecPixelsSimd( Pel* pRecSrc, Int iRecSrcStride, Pel* pDst, Int iDstStride, Int iCWidth, Int iCHeight )
+{
+  for ( Int j = 0; j < iCHeight; j++ )
+  {
+    Int i = 0;
+    for ( ; i + 8 <= iCWidth; i += 8 )
+    {
+      __m128i vSum0 = _mm_add_epi16( _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i     ) ), _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i     + iRecSrcStride ) ) );
+      __m128i vSum1 = _mm_add_epi16( _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i + 8 ) ), _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i + 8 + iRecSrcStride ) ) );
+      // keep the even samples, sign extended to 32 bits
+      vSum0 = _mm_srai_epi32( _mm_slli_epi32( vSum0, 16 ), 16 );
+      vSum1 = _mm_srai_epi32( _mm_slli_epi32( vSum1, 16 ), 16 );
+      _mm_storeu_si128( (__m128i*)( pDst + i ), _mm_srai_epi16( _mm_packs_epi32( vSum0, vSum1 ), 1 ) );
+    }
+    if ( i + 4 <= iCWidth )
+    {
+      __m128i vSum0 = _mm_add_epi16( _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i ) ), _mm_loadu_si128( (const __m128i*)( pRecSrc + 2*i + iRecSrcStride ) ) );
+      vSum0 = _mm_srai_epi32( _mm_slli_epi32( vSum0, 16 ), 16 );
+      _mm_storel_epi64( (__m128i*)( pDst + i ), _mm_srai_epi16( _mm_packs_epi32( vSum0, vSum0 ), 1 ) );
+      i += 4;
+    }
+    for ( ; i < iCWidth; i++ )
+    {
+      pDst[i] = (pRecSrc[2*i] + pRecSrc[2*i + iRecSrcStride]) >> 1;
+    }
+    pDst    += iDstStride;
+    pRecSrc += iRecSrcStride << 1;
+  }
+}
+
+/** LM chroma prediction Clip(((a * luma) >> iShift) + b), the products are formed in 32 bits by a multiply-add with (a, 0)
+ * \param pLuma pointer to the downsampled luma samples
+ * \param iLumaStride the stride of the downsampled luma samples
+ * \param pDst pointer for the prediction sample array
+ * \param iDstStride the stride of the prediction sample array
+ * \param iWidth the width of the block
+ * \param iHeight the height of the block
+ * \param a the slope, within the 16-bit range
+ * \param iShift the shift of the slope
+ * \param b the offset
+ */
+SIMD_TARGET_SSE2 Void TComPrediction::xGetLLSPredictionSimd( Pel* pLuma, Int iLumaStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int a, Int iShift, Int b )
+{
+  const __m128i vA     = _mm_set_epi16( 0, (Short)a, 0, (Short)a, 0, (Short)a, 0, (Short)a );
+  const __m128i vB     = _mm_set1_epi32( b );
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+  const __m128i vZero  = _mm_setzero_si128();
+  const __m128i vMax   = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+
+  for ( Int i = 0; i < iHeight; i++ )
+  {
+    Int j = 0;
+    for ( ; j + 8 <= iWidth; j += 8 )
+    {
+      __m128i vLuma = _mm_loadu_si128( (const __m128i*)( pLuma + j ) );
+      __m128i vLo   = _mm_add_epi32( _mm_sra_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vLuma, vZero ), vA ), vShift ), vB );
+      __m128i vHi   = _mm_add_epi32( _mm_sra_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vLuma, vZero ), vA ), vShift ), vB );
+      _mm_storeu_si128( (__m128i*)( pDst + j ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), vZero ), vMax ) );
+    }
+    if ( j + 4 <= iWidth )
+    {
+      __m128i vLuma = _mm_loadl_epi64( (const __m128i*)( pLuma + j ) );
+      __m128i vLo   = _mm_add_epi32( _mm_sra_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vLuma, vZero ), vA ), vShift ), vB );
+      _mm_storel_epi64( (__m128i*)( pDst + j ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vLo ), vZero ), vMax ) );
+      j += 4;
+    }
+    for ( ; j < iWidth; j++ )
+    {
+      pDst[j] = Clip( ( ( a * pLuma[j] ) >> iShift ) + b );
+    }
+    pDst  += iDstStride;
+    pLuma += iLumaStride;
+  }
+}
+#endif
+#endif
 //! \}
@@ -52,6 +52,9 @@
 #if WEIGHT_PRED
   #include "TComWeightPrediction.h"
 #endif
+#if SIMD_INTRA
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -136,6 +139,20 @@ protected:
   Void xDCPredFiltering( Int* pSrc, Int iSrcStride, Pel*& rpDst, Int iDstStride, Int iWidth, Int iHeight );
 #endif
 
+#if SIMD_INTRA && SIMD_X86
+  SIMD_TARGET_SSE2 static Void xPredIntraAngSimd      ( Int* pSrc, Int srcStride, Pel* pDst, Int dstStride, Int blkSize, Bool modeVer, Int intraPredAngle, Int invAngle );
+#if ADD_PLANAR_MODE
+  SIMD_TARGET_SSE2 static Void xPredIntraPlanarSimd   ( Int* piTopRow, Int* piBottomRow, Int* piLeftColumn, Int* piRightColumn, Pel* pDst, Int dstStride, Int blkSize, Int offset2D, Int shift2D );
+#endif
+#if MN_DC_PRED_FILTER && MN_DC_PRED_FILTER_UNIFIED
+  SIMD_TARGET_SSE2 static Void xDCPredFilteringSimd   ( Int* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight );
+#endif
+#if LM_CHROMA
+  SIMD_TARGET_SSE2 static Void xGetLumaRecPixelsSimd  ( Pel* pRecSrc, Int iRecSrcStride, Pel* pDst, Int iDstStride, Int iCWidth, Int iCHeight );
+  SIMD_TARGET_SSE2 static Void xGetLLSPredictionSimd  ( Pel* pLuma, Int iLumaStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int a, Int iShift, Int b );
+#endif
+#endif
+
 public:
   TComPrediction();
   virtual ~TComPrediction();
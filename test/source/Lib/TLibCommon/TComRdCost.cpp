@@ -157,6 +157,36 @@ Void TComRdCost::setLambda( Double dLambda )
 }
 
 
+#if WPP_THREADS
+/** copy the lambdas and the motion cost state of another instance.
+ * Each instance keeps its own motion cost table, the predictor is carried over as a position in the table.
+ * \param pcRdCost instance set up by the slice encoder or the motion search
+ */
+Void TComRdCost::copyRDParam( TComRdCost* pcRdCost )
+{
+#if WEIGHTED_CHROMA_DISTORTION
+  m_chromaDistortionWeight = pcRdCost->m_chromaDistortionWeight;
+#endif
+  m_dLambda                = pcRdCost->m_dLambda;
+  m_sqrtLambda             = pcRdCost->m_sqrtLambda;
+  m_uiLambdaMotionSAD      = pcRdCost->m_uiLambdaMotionSAD;
+  m_uiLambdaMotionSSE      = pcRdCost->m_uiLambdaMotionSSE;
+  m_dFrameLambda           = pcRdCost->m_dFrameLambda;
+  m_uiCost                 = pcRdCost->m_uiCost;
+  m_iCostScale             = pcRdCost->m_iCostScale;
+#if FIX203
+  m_mvPredictor            = pcRdCost->m_mvPredictor;
+#else
+  assert( m_iSearchLimit == pcRdCost->m_iSearchLimit );
+  if ( pcRdCost->m_puiHorCost )
+  {
+    m_puiHorCost           = m_puiComponentCost + ( pcRdCost->m_puiHorCost - pcRdCost->m_puiComponentCost );
+    m_puiVerCost           = m_puiComponentCost + ( pcRdCost->m_puiVerCost - pcRdCost->m_puiComponentCost );
+  }
+#endif
+}
+#endif
+
 // Initalize Function Pointer by [eDFunc]
 Void TComRdCost::init()
 {
@@ -219,6 +249,26 @@ Void TComRdCost::init()
   m_afpDistortFunc[27] = TComRdCost::xGetHADs;
   m_afpDistortFunc[28] = TComRdCost::xGetHADs;
   
+#if ME_SAD_X4
+  for ( Int i = 0; i < 64; i++ )
+  {
+    m_afpDistortFuncX4[i] = NULL;
+  }
+  for ( Int i = DF_SAD; i <= DF_SAD16N; i++ )
+  {
+    m_afpDistortFuncX4[i] = TComRdCost::xGetSADx4;
+  }
+#if AMP_SAD
+  m_afpDistortFuncX4[43] = TComRdCost::xGetSADx4;
+  m_afpDistortFuncX4[44] = TComRdCost::xGetSADx4;
+  m_afpDistortFuncX4[45] = TComRdCost::xGetSADx4;
+#endif
+#endif
+  
+#if SIMD_DISTORTION && SIMD_X86
+  xInitSimd();
+#endif
+  
 #if !FIX203
   m_puiComponentCostOriginP = NULL;
   m_puiComponentCost        = NULL;
@@ -308,19 +358,31 @@ Void TComRdCost::setDistParam( TComPattern* pcPatternKey, Pel* piRefY, Int iRefS
   rcDistParam.iCols    = pcPatternKey->getROIYWidth();
   rcDistParam.iRows    = pcPatternKey->getROIYHeight();
   rcDistParam.DistFunc = m_afpDistortFunc[DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1 ];
+#if ME_SAD_X4
+  rcDistParam.DistFuncX4 = m_afpDistortFuncX4[DF_SAD + g_aucConvertToBit[ rcDistParam.iCols ] + 1 ];
+#endif
   
 #if AMP_SAD
   if (rcDistParam.iCols == 12)
   {
     rcDistParam.DistFunc = m_afpDistortFunc[43 ];
+#if ME_SAD_X4
+    rcDistParam.DistFuncX4 = m_afpDistortFuncX4[43];
+#endif
   }
   else if (rcDistParam.iCols == 24)
   {
     rcDistParam.DistFunc = m_afpDistortFunc[44 ];
+#if ME_SAD_X4
+    rcDistParam.DistFuncX4 = m_afpDistortFuncX4[44];
+#endif
   }
   else if (rcDistParam.iCols == 48)
   {
     rcDistParam.DistFunc = m_afpDistortFunc[45 ];
+#if ME_SAD_X4
+    rcDistParam.DistFuncX4 = m_afpDistortFuncX4[45];
+#endif
   }
 #endif
 
@@ -994,6 +1056,25 @@ UInt TComRdCost::xGetSAD48( DistParam* pcDtParam )
 }
 #endif
 
+#if ME_SAD_X4
+/** SADs of the four reference blocks ppCur[0..3] against the original of the distortion parameter
+ * \param pcDtParam distortion parameter, pCur is not used
+ * \param ppCur     the reference blocks, all with the stride iStrideCur
+ * \param puiDist   the four SADs, each equal to DistFunc at the block
+ */
+Void TComRdCost::xGetSADx4( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist )
+{
+  Pel* piCur = pcDtParam->pCur;
+  for ( Int k = 0; k < 4; k++ )
+  {
+    pcDtParam->pCur = ppCur[k];
+    puiDist[k] = pcDtParam->DistFunc( pcDtParam );
+  }
+  pcDtParam->pCur = piCur;
+}
+
+#endif
+
 #if !GENERIC_IF
 // --------------------------------------------------------------------------------------------------------------------
 // SAD with step (used in fractional search)
@@ -2724,4 +2805,755 @@ UInt TComRdCost::xGetHADs( DistParam* pcDtParam )
   return ( uiSum >> g_uiBitIncrement );
 }
 
+#if SIMD_DISTORTION && SIMD_X86
+// ====================================================================================================================
+// SIMD distortion functions
+// ====================================================================================================================
+
+/** plug the SIMD kernels of the selected instruction set level into the distortion function table
+ */
+Void TComRdCost::xInitSimd()
+{
+  SimdLevel eLevel = getSimdLevel();
+  
+  if ( eLevel >= SIMD_SSE2 )
+  {
+#if !IBDI_DISTORTION
+    m_afpDistortFunc[DF_SSE4  ] = TComRdCost::xGetSSESimd<4>;
+    m_afpDistortFunc[DF_SSE8  ] = TComRdCost::xGetSSESimd<8>;
+    m_afpDistortFunc[DF_SSE16 ] = TComRdCost::xGetSSESimd<16>;
+    m_afpDistortFunc[DF_SSE32 ] = TComRdCost::xGetSSESimd<32>;
+    m_afpDistortFunc[DF_SSE64 ] = TComRdCost::xGetSSESimd<64>;
+    m_afpDistortFunc[DF_SSE16N] = TComRdCost::xGetSSESimd<0>;
+#endif
+    
+    m_afpDistortFunc[DF_SAD4  ] = TComRdCost::xGetSADSimd<4>;
+    m_afpDistortFunc[DF_SAD8  ] = TComRdCost::xGetSADSimd<8>;
+    m_afpDistortFunc[DF_SAD16 ] = TComRdCost::xGetSADSimd<16>;
+    m_afpDistortFunc[DF_SAD32 ] = TComRdCost::xGetSADSimd<32>;
+    m_afpDistortFunc[DF_SAD64 ] = TComRdCost::xGetSADSimd<64>;
+    m_afpDistortFunc[DF_SAD16N] = TComRdCost::xGetSADSimd<0>;
+#if AMP_SAD
+    m_afpDistortFunc[43] = TComRdCost::xGetSADSimd<12>;
+    m_afpDistortFunc[44] = TComRdCost::xGetSADSimd<24>;
+    m_afpDistortFunc[45] = TComRdCost::xGetSADSimd<48>;
+#endif
+    
+#if ME_SAD_X4
+    m_afpDistortFuncX4[DF_SAD4  ] = TComRdCost::xGetSADx4Simd<4>;
+    m_afpDistortFuncX4[DF_SAD8  ] = TComRdCost::xGetSADx4Simd<8>;
+    m_afpDistortFuncX4[DF_SAD16 ] = TComRdCost::xGetSADx4Simd<16>;
+    m_afpDistortFuncX4[DF_SAD32 ] = TComRdCost::xGetSADx4Simd<32>;
+    m_afpDistortFuncX4[DF_SAD64 ] = TComRdCost::xGetSADx4Simd<64>;
+    m_afpDistortFuncX4[DF_SAD16N] = TComRdCost::xGetSADx4Simd<0>;
+#if AMP_SAD
+    m_afpDistortFuncX4[43] = TComRdCost::xGetSADx4Simd<12>;
+    m_afpDistortFuncX4[44] = TComRdCost::xGetSADx4Simd<24>;
+    m_afpDistortFuncX4[45] = TComRdCost::xGetSADx4Simd<48>;
+#endif
+#endif
+  }
+  
+#if SIMD_AVX2_SUPPORTED
+  if ( eLevel >= SIMD_AVX2 )
+  {
+#if !IBDI_DISTORTION
+    m_afpDistortFunc[DF_SSE16 ] = TComRdCost::xGetSSEAvx2<16>;
+    m_afpDistortFunc[DF_SSE32 ] = TComRdCost::xGetSSEAvx2<32>;
+    m_afpDistortFunc[DF_SSE64 ] = TComRdCost::xGetSSEAvx2<64>;
+    m_afpDistortFunc[DF_SSE16N] = TComRdCost::xGetSSEAvx2<0>;
+#endif
+    
+    m_afpDistortFunc[DF_SAD16 ] = TComRdCost::xGetSADAvx2<16>;
+    m_afpDistortFunc[DF_SAD32 ] = TComRdCost::xGetSADAvx2<32>;
+    m_afpDistortFunc[DF_SAD64 ] = TComRdCost::xGetSADAvx2<64>;
+    m_afpDistortFunc[DF_SAD16N] = TComRdCost::xGetSADAvx2<0>;
+#if AMP_SAD
+    m_afpDistortFunc[44] = TComRdCost::xGetSADAvx2<24>;
+    m_afpDistortFunc[45] = TComRdCost::xGetSADAvx2<48>;
+#endif
+    
+#if ME_SAD_X4
+    m_afpDistortFuncX4[DF_SAD16 ] = TComRdCost::xGetSADx4Avx2<16>;
+    m_afpDistortFuncX4[DF_SAD32 ] = TComRdCost::xGetSADx4Avx2<32>;
+    m_afpDistortFuncX4[DF_SAD64 ] = TComRdCost::xGetSADx4Avx2<64>;
+    m_afpDistortFuncX4[DF_SAD16N] = TComRdCost::xGetSADx4Avx2<0>;
+#if AMP_SAD
+    m_afpDistortFuncX4[44] = TComRdCost::xGetSADx4Avx2<24>;
+    m_afpDistortFuncX4[45] = TComRdCost::xGetSADx4Avx2<48>;
+#endif
+#endif
+  }
+#endif
+  
+#if GENERIC_IF
+  // the sub-pel search uses the SAD functions
+  for ( Int i = DF_SADS4; i <= DF_SADS16N; i++ )
+  {
+    m_afpDistortFunc[i] = m_afpDistortFunc[i - DF_SADS + DF_SAD];
+  }
+#if AMP_SAD
+  m_afpDistortFunc[46] = m_afpDistortFunc[43];
+  m_afpDistortFunc[47] = m_afpDistortFunc[44];
+  m_afpDistortFunc[48] = m_afpDistortFunc[45];
+#endif
+  
+  if ( eLevel >= SIMD_SSE41 )
+  {
+    for ( Int i = DF_HADS; i <= DF_HADS16N; i++ )
+    {
+#if SIMD_AVX2_SUPPORTED
+      m_afpDistortFunc[i] = eLevel >= SIMD_AVX2 ? TComRdCost::xGetHADsAvx2 : TComRdCost::xGetHADsSimd;
+#else
+      m_afpDistortFunc[i] = TComRdCost::xGetHADsSimd;
+#endif
+    }
+  }
+#endif
+}
+
+/** horizontal sum of the four 32-bit lanes
+ */
+SIMD_TARGET_SSE2 static inline UInt xHorSum32( __m128i vSum )
+{
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( vSum );
+}
+
+#if ME_SAD_X4
+/** horizontal sums of four vectors of four 32-bit lanes, scaled like the single block SAD
+ */
+SIMD_TARGET_SSE2 static inline Void xHorSum32x4( __m128i vSum0, __m128i vSum1, __m128i vSum2, __m128i vSum3, Int iSubShift, UInt* puiDist )
+{
+  __m128i v01 = _mm_add_epi32( _mm_unpacklo_epi32( vSum0, vSum1 ), _mm_unpackhi_epi32( vSum0, vSum1 ) );
+  __m128i v23 = _mm_add_epi32( _mm_unpacklo_epi32( vSum2, vSum3 ), _mm_unpackhi_epi32( vSum2, vSum3 ) );
+  __m128i vSum = _mm_add_epi32( _mm_unpacklo_epi64( v01, v23 ), _mm_unpackhi_epi64( v01, v23 ) );
+  vSum = _mm_sll_epi32( vSum, _mm_cvtsi32_si128( iSubShift ) );
+  vSum = _mm_srl_epi32( vSum, _mm_cvtsi32_si128( g_uiBitIncrement ) );
+  _mm_storeu_si128( (__m128i*)puiDist, vSum );
+}
+#endif
+
+/** SAD of iWidth samples per row, 8 samples per step
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+UInt TComRdCost::xGetSADSimd( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( iWidth != 0 && pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+#endif
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iSubShift  = pcDtParam->iSubShift;
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  __m128i       vSum = _mm_setzero_si128();
+  
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    Int n = 0;
+    for ( ; n + 8 <= iCols; n += 8 )
+    {
+      __m128i vOrg = _mm_loadu_si128( (const __m128i*)&piOrg[n] );
+      __m128i vCur = _mm_loadu_si128( (const __m128i*)&piCur[n] );
+      __m128i vAbs = _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) );
+      vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vAbs, vOne ) );
+    }
+    if ( iCols & 4 )
+    {
+      __m128i vOrg = _mm_loadl_epi64( (const __m128i*)&piOrg[n] );
+      __m128i vCur = _mm_loadl_epi64( (const __m128i*)&piCur[n] );
+      __m128i vAbs = _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) );
+      vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vAbs, vOne ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  UInt uiSum = xHorSum32( vSum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+#if ME_SAD_X4
+/** SADs of four reference blocks of iWidth samples per row, 8 samples per step, each original row is loaded once
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+Void TComRdCost::xGetSADx4Simd( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist )
+{
+#if WEIGHT_PRED
+  if ( pcDtParam->bApplyWeight )
+  {
+    xGetSADx4( pcDtParam, ppCur, puiDist );
+    return;
+  }
+#endif
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur0     = ppCur[0];
+  Pel* piCur1     = ppCur[1];
+  Pel* piCur2     = ppCur[2];
+  Pel* piCur3     = ppCur[3];
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iSubShift  = pcDtParam->iSubShift;
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  const __m128i vOne  = _mm_set1_epi16( 1 );
+  __m128i       vSum0 = _mm_setzero_si128();
+  __m128i       vSum1 = _mm_setzero_si128();
+  __m128i       vSum2 = _mm_setzero_si128();
+  __m128i       vSum3 = _mm_setzero_si128();
+  
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    Int n = 0;
+    for ( ; n + 8 <= iCols; n += 8 )
+    {
+      __m128i vOrg = _mm_loadu_si128( (const __m128i*)&piOrg[n] );
+      __m128i vCur = _mm_loadu_si128( (const __m128i*)&piCur0[n] );
+      vSum0 = _mm_add_epi32( vSum0, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadu_si128( (const __m128i*)&piCur1[n] );
+      vSum1 = _mm_add_epi32( vSum1, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadu_si128( (const __m128i*)&piCur2[n] );
+      vSum2 = _mm_add_epi32( vSum2, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadu_si128( (const __m128i*)&piCur3[n] );
+      vSum3 = _mm_add_epi32( vSum3, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+    }
+    if ( iCols & 4 )
+    {
+      __m128i vOrg = _mm_loadl_epi64( (const __m128i*)&piOrg[n] );
+      __m128i vCur = _mm_loadl_epi64( (const __m128i*)&piCur0[n] );
+      vSum0 = _mm_add_epi32( vSum0, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadl_epi64( (const __m128i*)&piCur1[n] );
+      vSum1 = _mm_add_epi32( vSum1, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadl_epi64( (const __m128i*)&piCur2[n] );
+      vSum2 = _mm_add_epi32( vSum2, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm_loadl_epi64( (const __m128i*)&piCur3[n] );
+      vSum3 = _mm_add_epi32( vSum3, _mm_madd_epi16( _mm_sub_epi16( _mm_max_epi16( vOrg, vCur ), _mm_min_epi16( vOrg, vCur ) ), vOne ) );
+    }
+    piOrg  += iStrideOrg;
+    piCur0 += iStrideCur;
+    piCur1 += iStrideCur;
+    piCur2 += iStrideCur;
+    piCur3 += iStrideCur;
+  }
+  
+  xHorSum32x4( vSum0, vSum1, vSum2, vSum3, iSubShift, puiDist );
+}
+#endif
+
+/** SSE of iWidth samples per row, 8 samples per step, the C function handles the bit increment and weighted prediction
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+UInt TComRdCost::xGetSSESimd( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( g_uiBitIncrement != 0 || pcDtParam->bApplyWeight )
+#else
+  if ( g_uiBitIncrement != 0 )
+#endif
+  {
+    return xGetSSE( pcDtParam );
+  }
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  
+  __m128i vSum = _mm_setzero_si128();
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    Int n = 0;
+    for ( ; n + 8 <= iCols; n += 8 )
+    {
+      __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piOrg[n] ), _mm_loadu_si128( (const __m128i*)&piCur[n] ) );
+      vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vDiff, vDiff ) );
+    }
+    if ( iCols & 4 )
+    {
+      __m128i vDiff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)&piOrg[n] ), _mm_loadl_epi64( (const __m128i*)&piCur[n] ) );
+      vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vDiff, vDiff ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  return xHorSum32( vSum );
+}
+
+/// 4-point Walsh-Hadamard transform across the registers r0..r3
+#define HADAMARD4_SSE( r0, r1, r2, r3 )       \
+{                                             \
+  __m128i t0 = _mm_add_epi32( r0, r1 );       \
+  __m128i t1 = _mm_sub_epi32( r0, r1 );       \
+  __m128i t2 = _mm_add_epi32( r2, r3 );       \
+  __m128i t3 = _mm_sub_epi32( r2, r3 );       \
+  r0 = _mm_add_epi32( t0, t2 );               \
+  r1 = _mm_add_epi32( t1, t3 );               \
+  r2 = _mm_sub_epi32( t0, t2 );               \
+  r3 = _mm_sub_epi32( t1, t3 );               \
+}
+
+/// transpose the 4x4 matrix of 32-bit values in the registers r0..r3
+#define TRANSPOSE4_SSE( r0, r1, r2, r3 )      \
+{                                             \
+  __m128i t0 = _mm_unpacklo_epi32( r0, r1 );  \
+  __m128i t1 = _mm_unpacklo_epi32( r2, r3 );  \
+  __m128i t2 = _mm_unpackhi_epi32( r0, r1 );  \
+  __m128i t3 = _mm_unpackhi_epi32( r2, r3 );  \
+  r0 = _mm_unpacklo_epi64( t0, t1 );          \
+  r1 = _mm_unpackhi_epi64( t0, t1 );          \
+  r2 = _mm_unpacklo_epi64( t2, t3 );          \
+  r3 = _mm_unpackhi_epi64( t2, t3 );          \
+}
+
+/** 4x4 Hadamard SATD, same result as xCalcHADs4x4() with iStep = 1
+ */
+UInt TComRdCost::xCalcHADs4x4Simd( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i r[4];
+  for ( Int k = 0; k < 4; k++ )
+  {
+    __m128i vDiff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)piOrg ), _mm_loadl_epi64( (const __m128i*)piCur ) );
+    r[k] = _mm_cvtepi16_epi32( vDiff );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  HADAMARD4_SSE ( r[0], r[1], r[2], r[3] );
+  TRANSPOSE4_SSE( r[0], r[1], r[2], r[3] );
+  HADAMARD4_SSE ( r[0], r[1], r[2], r[3] );
+  
+  __m128i vSum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( r[0] ), _mm_abs_epi32( r[1] ) ),
+                                _mm_add_epi32( _mm_abs_epi32( r[2] ), _mm_abs_epi32( r[3] ) ) );
+  UInt satd = xHorSum32( vSum );
+  return ( ( satd + 1 ) >> 1 );
+}
+
+/** 8x8 Hadamard SATD, same result as xCalcHADs8x8() with iStep = 1
+ * Each row is held in two registers of four 32-bit values; the columns are transformed as four 4x4 blocks after a
+ * transpose.
+ */
+UInt TComRdCost::xCalcHADs8x8Simd( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i lo[8], hi[8];
+  Int k;
+  for ( k = 0; k < 8; k++ )
+  {
+    __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)piOrg ), _mm_loadu_si128( (const __m128i*)piCur ) );
+    lo[k] = _mm_cvtepi16_epi32( vDiff );
+    hi[k] = _mm_cvtepi16_epi32( _mm_unpackhi_epi64( vDiff, vDiff ) );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  // vertical: 8-point transform across the rows
+  for ( k = 0; k < 4; k++ )
+  {
+    __m128i a = lo[k], b = lo[k+4];
+    lo[k] = _mm_add_epi32( a, b ); lo[k+4] = _mm_sub_epi32( a, b );
+    a = hi[k]; b = hi[k+4];
+    hi[k] = _mm_add_epi32( a, b ); hi[k+4] = _mm_sub_epi32( a, b );
+  }
+  HADAMARD4_SSE( lo[0], lo[1], lo[2], lo[3] );
+  HADAMARD4_SSE( lo[4], lo[5], lo[6], lo[7] );
+  HADAMARD4_SSE( hi[0], hi[1], hi[2], hi[3] );
+  HADAMARD4_SSE( hi[4], hi[5], hi[6], hi[7] );
+  
+  // transpose: column c of the block becomes register row c
+  TRANSPOSE4_SSE( lo[0], lo[1], lo[2], lo[3] );
+  TRANSPOSE4_SSE( lo[4], lo[5], lo[6], lo[7] );
+  TRANSPOSE4_SSE( hi[0], hi[1], hi[2], hi[3] );
+  TRANSPOSE4_SSE( hi[4], hi[5], hi[6], hi[7] );
+  __m128i c[8], d[8];
+  for ( k = 0; k < 4; k++ )
+  {
+    c[k] = lo[k]; d[k] = lo[k+4];                 // columns 0..3
+    c[k+4] = hi[k]; d[k+4] = hi[k+4];             // columns 4..7
+  }
+  
+  // horizontal: 8-point transform across the columns
+  for ( k = 0; k < 4; k++ )
+  {
+    __m128i a = c[k], b = c[k+4];
+    c[k] = _mm_add_epi32( a, b ); c[k+4] = _mm_sub_epi32( a, b );
+    a = d[k]; b = d[k+4];
+    d[k] = _mm_add_epi32( a, b ); d[k+4] = _mm_sub_epi32( a, b );
+  }
+  HADAMARD4_SSE( c[0], c[1], c[2], c[3] );
+  HADAMARD4_SSE( c[4], c[5], c[6], c[7] );
+  HADAMARD4_SSE( d[0], d[1], d[2], d[3] );
+  HADAMARD4_SSE( d[4], d[5], d[6], d[7] );
+  
+  __m128i vSum = _mm_setzero_si128();
+  for ( k = 0; k < 8; k++ )
+  {
+    vSum = _mm_add_epi32( vSum, _mm_add_epi32( _mm_abs_epi32( c[k] ), _mm_abs_epi32( d[k] ) ) );
+  }
+  UInt sad = xHorSum32( vSum );
+  return ( ( sad + 2 ) >> 2 );
+}
+
+/** Hadamard distortion of any block size, same partitioning as xGetHADs()
+ */
+UInt TComRdCost::xGetHADsSimd( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetHADsw( pcDtParam );
+  }
+#endif
+  Pel* piOrg   = pcDtParam->pOrg;
+  Pel* piCur   = pcDtParam->pCur;
+  Int  iRows   = pcDtParam->iRows;
+  Int  iCols   = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  
+  Int  x, y;
+  
+  UInt uiSum = 0;
+  
+  assert( pcDtParam->iStep == 1 );
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    Int  iOffsetOrg = iStrideOrg<<3;
+    Int  iOffsetCur = iStrideCur<<3;
+    for ( y=0; y<iRows; y+= 8 )
+    {
+      for ( x=0; x<iCols; x+= 8 )
+      {
+        uiSum += xCalcHADs8x8Simd( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iOffsetOrg;
+      piCur += iOffsetCur;
+    }
+  }
+  else if( ( iRows % 4 == 0) && (iCols % 4 == 0) )
+  {
+    Int  iOffsetOrg = iStrideOrg<<2;
+    Int  iOffsetCur = iStrideCur<<2;
+    
+    for ( y=0; y<iRows; y+= 4 )
+    {
+      for ( x=0; x<iCols; x+= 4 )
+      {
+        uiSum += xCalcHADs4x4Simd( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iOffsetOrg;
+      piCur += iOffsetCur;
+    }
+  }
+  else
+  {
+    return xGetHADs( pcDtParam );
+  }
+  
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+#if SIMD_AVX2_SUPPORTED
+/** horizontal sum of the eight 32-bit lanes
+ */
+SIMD_TARGET_AVX2 static inline UInt xHorSum32Avx2( __m256i vSum )
+{
+  __m128i v = _mm_add_epi32( _mm256_castsi256_si128( vSum ), _mm256_extracti128_si256( vSum, 1 ) );
+  v = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0x4e ) );
+  v = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( v );
+}
+
+/** SAD of iWidth samples per row, 16 samples per step
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+UInt TComRdCost::xGetSADAvx2( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( iWidth != 0 && pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+#endif
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iSubShift  = pcDtParam->iSubShift;
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  const __m256i vOne = _mm256_set1_epi16( 1 );
+  __m256i       vSum = _mm256_setzero_si256();
+  
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    Int n = 0;
+    for ( ; n + 16 <= iCols; n += 16 )
+    {
+      __m256i vOrg = _mm256_loadu_si256( (const __m256i*)&piOrg[n] );
+      __m256i vCur = _mm256_loadu_si256( (const __m256i*)&piCur[n] );
+      __m256i vAbs = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( vAbs, vOne ) );
+    }
+    if ( iCols & 8 )
+    {
+      __m256i vOrg = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piOrg[n] ) );
+      __m256i vCur = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piCur[n] ) );
+      __m256i vAbs = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( _mm256_permute2x128_si256( vAbs, vAbs, 0x80 ), vOne ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  UInt uiSum = xHorSum32Avx2( vSum );
+  uiSum <<= iSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+#if ME_SAD_X4
+/** SADs of four reference blocks of iWidth samples per row, 16 samples per step, each original row is loaded once
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+Void TComRdCost::xGetSADx4Avx2( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist )
+{
+#if WEIGHT_PRED
+  if ( pcDtParam->bApplyWeight )
+  {
+    xGetSADx4( pcDtParam, ppCur, puiDist );
+    return;
+  }
+#endif
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur0     = ppCur[0];
+  Pel* piCur1     = ppCur[1];
+  Pel* piCur2     = ppCur[2];
+  Pel* piCur3     = ppCur[3];
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iSubShift  = pcDtParam->iSubShift;
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+  
+  const __m256i vOne  = _mm256_set1_epi16( 1 );
+  __m256i       vSum0 = _mm256_setzero_si256();
+  __m256i       vSum1 = _mm256_setzero_si256();
+  __m256i       vSum2 = _mm256_setzero_si256();
+  __m256i       vSum3 = _mm256_setzero_si256();
+  
+  for( ; iRows != 0; iRows-=iSubStep )
+  {
+    Int n = 0;
+    for ( ; n + 16 <= iCols; n += 16 )
+    {
+      __m256i vOrg = _mm256_loadu_si256( (const __m256i*)&piOrg[n] );
+      __m256i vCur = _mm256_loadu_si256( (const __m256i*)&piCur0[n] );
+      vSum0 = _mm256_add_epi32( vSum0, _mm256_madd_epi16( _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm256_loadu_si256( (const __m256i*)&piCur1[n] );
+      vSum1 = _mm256_add_epi32( vSum1, _mm256_madd_epi16( _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm256_loadu_si256( (const __m256i*)&piCur2[n] );
+      vSum2 = _mm256_add_epi32( vSum2, _mm256_madd_epi16( _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) ), vOne ) );
+      vCur  = _mm256_loadu_si256( (const __m256i*)&piCur3[n] );
+      vSum3 = _mm256_add_epi32( vSum3, _mm256_madd_epi16( _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) ), vOne ) );
+    }
+    if ( iCols & 8 )
+    {
+      // the upper lane of the absolute differences is cleared before it is summed
+      __m256i vOrg = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piOrg[n] ) );
+      __m256i vCur = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piCur0[n] ) );
+      __m256i vAbs = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum0 = _mm256_add_epi32( vSum0, _mm256_madd_epi16( _mm256_permute2x128_si256( vAbs, vAbs, 0x80 ), vOne ) );
+      vCur  = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piCur1[n] ) );
+      vAbs  = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum1 = _mm256_add_epi32( vSum1, _mm256_madd_epi16( _mm256_permute2x128_si256( vAbs, vAbs, 0x80 ), vOne ) );
+      vCur  = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piCur2[n] ) );
+      vAbs  = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum2 = _mm256_add_epi32( vSum2, _mm256_madd_epi16( _mm256_permute2x128_si256( vAbs, vAbs, 0x80 ), vOne ) );
+      vCur  = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)&piCur3[n] ) );
+      vAbs  = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vCur ), _mm256_min_epi16( vOrg, vCur ) );
+      vSum3 = _mm256_add_epi32( vSum3, _mm256_madd_epi16( _mm256_permute2x128_si256( vAbs, vAbs, 0x80 ), vOne ) );
+    }
+    piOrg  += iStrideOrg;
+    piCur0 += iStrideCur;
+    piCur1 += iStrideCur;
+    piCur2 += iStrideCur;
+    piCur3 += iStrideCur;
+  }
+  
+  xHorSum32x4( _mm_add_epi32( _mm256_castsi256_si128( vSum0 ), _mm256_extracti128_si256( vSum0, 1 ) ),
+               _mm_add_epi32( _mm256_castsi256_si128( vSum1 ), _mm256_extracti128_si256( vSum1, 1 ) ),
+               _mm_add_epi32( _mm256_castsi256_si128( vSum2 ), _mm256_extracti128_si256( vSum2, 1 ) ),
+               _mm_add_epi32( _mm256_castsi256_si128( vSum3 ), _mm256_extracti128_si256( vSum3, 1 ) ), iSubShift, puiDist );
+}
+#endif
+
+/** SSE of iWidth samples per row, 16 samples per step, the C function handles the bit increment and weighted prediction
+ * \param pcDtParam distortion parameter, iWidth = 0 takes the width (a multiple of 16) from pcDtParam
+ */
+template <Int iWidth>
+UInt TComRdCost::xGetSSEAvx2( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( g_uiBitIncrement != 0 || pcDtParam->bApplyWeight )
+#else
+  if ( g_uiBitIncrement != 0 )
+#endif
+  {
+    return xGetSSE( pcDtParam );
+  }
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = iWidth ? iWidth : pcDtParam->iCols;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  
+  __m256i vSum = _mm256_setzero_si256();
+  
+  for( ; iRows != 0; iRows-- )
+  {
+    for ( Int n = 0; n < iCols; n += 16 )
+    {
+      __m256i vDiff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)&piOrg[n] ), _mm256_loadu_si256( (const __m256i*)&piCur[n] ) );
+      vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( vDiff, vDiff ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  return xHorSum32Avx2( vSum );
+}
+
+/** 8x8 Hadamard SATD, same result as xCalcHADs8x8() with iStep = 1, one row of eight 32-bit values per register
+ */
+UInt TComRdCost::xCalcHADs8x8Avx2( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m256i r[8];
+  Int k;
+  for ( k = 0; k < 8; k++ )
+  {
+    __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)piOrg ), _mm_loadu_si128( (const __m128i*)piCur ) );
+    r[k] = _mm256_cvtepi16_epi32( vDiff );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  
+  for ( Int iPass = 0; iPass < 2; iPass++ )
+  {
+    // 8-point transform across the registers
+    for ( k = 0; k < 4; k++ )
+    {
+      __m256i a = r[k], b = r[k+4];
+      r[k] = _mm256_add_epi32( a, b ); r[k+4] = _mm256_sub_epi32( a, b );
+    }
+    for ( k = 0; k < 8; k += 4 )
+    {
+      __m256i t0 = _mm256_add_epi32( r[k  ], r[k+1] );
+      __m256i t1 = _mm256_sub_epi32( r[k  ], r[k+1] );
+      __m256i t2 = _mm256_add_epi32( r[k+2], r[k+3] );
+      __m256i t3 = _mm256_sub_epi32( r[k+2], r[k+3] );
+      r[k  ] = _mm256_add_epi32( t0, t2 );
+      r[k+1] = _mm256_add_epi32( t1, t3 );
+      r[k+2] = _mm256_sub_epi32( t0, t2 );
+      r[k+3] = _mm256_sub_epi32( t1, t3 );
+    }
+    if ( iPass == 1 )
+    {
+      break;
+    }
+    
+    // transpose the 8x8 matrix
+    __m256i t[8], u[8];
+    for ( k = 0; k < 8; k += 2 )
+    {
+      t[k  ] = _mm256_unpacklo_epi32( r[k], r[k+1] );
+      t[k+1] = _mm256_unpackhi_epi32( r[k], r[k+1] );
+    }
+    for ( k = 0; k < 8; k += 4 )
+    {
+      u[k  ] = _mm256_unpacklo_epi64( t[k  ], t[k+2] );
+      u[k+1] = _mm256_unpackhi_epi64( t[k  ], t[k+2] );
+      u[k+2] = _mm256_unpacklo_epi64( t[k+1], t[k+3] );
+      u[k+3] = _mm256_unpackhi_epi64( t[k+1], t[k+3] );
+    }
+    for ( k = 0; k < 4; k++ )
+    {
+      r[k  ] = _mm256_permute2x128_si256( u[k], u[k+4], 0x20 );
+      r[k+4] = _mm256_permute2x128_si256( u[k], u[k+4], 0x31 );
+    }
+  }
+  
+  __m256i vSum = _mm256_setzero_si256();
+  for ( k = 0; k < 8; k++ )
+  {
+    vSum = _mm256_add_epi32( vSum, _mm256_abs_epi32( r[k] ) );
+  }
+  UInt sad = xHorSum32Avx2( vSum );
+  return ( ( sad + 2 ) >> 2 );
+}
+
+/** Hadamard distortion of any block size, same partitioning as xGetHADs()
+ */
+UInt TComRdCost::xGetHADsAvx2( DistParam* pcDtParam )
+{
+#if WEIGHT_PRED
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetHADsw( pcDtParam );
+  }
+#endif
+  Int  iRows   = pcDtParam->iRows;
+  Int  iCols   = pcDtParam->iCols;
+  if( ( iRows % 8 != 0) || (iCols % 8 != 0) )
+  {
+    return xGetHADsSimd( pcDtParam );
+  }
+  
+  Pel* piOrg   = pcDtParam->pOrg;
+  Pel* piCur   = pcDtParam->pCur;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+  Int  iOffsetOrg = iStrideOrg<<3;
+  Int  iOffsetCur = iStrideCur<<3;
+  
+  UInt uiSum = 0;
+  
+  assert( pcDtParam->iStep == 1 );
+  for ( Int y=0; y<iRows; y+= 8 )
+  {
+    for ( Int x=0; x<iCols; x+= 8 )
+    {
+      uiSum += xCalcHADs8x8Avx2( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+    }
+    piOrg += iOffsetOrg;
+    piCur += iOffsetCur;
+  }
+  
+  return ( uiSum >> g_uiBitIncrement );
+}
+#endif
+#endif
+
 //! \}
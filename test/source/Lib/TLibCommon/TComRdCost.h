@@ -42,6 +42,9 @@
 #include "CommonDef.h"
 #include "TComPattern.h"
 #include "TComMv.h"
+#if SIMD_DISTORTION
+#include "TComSimd.h"
+#endif
 
 #if WEIGHT_PRED
   #include "TComSlice.h"
@@ -62,6 +65,9 @@ class TComPattern;
 
 // for function pointer
 typedef UInt (*FpDistFunc) (DistParam*);
+#if ME_SAD_X4
+typedef Void (*FpDistFuncX4) (DistParam*, Pel** ppCur, UInt* puiDist);  ///< distortions of the four blocks ppCur[0..3]
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -79,6 +85,9 @@ public:
   Int   iCols;
   Int   iStep;
   FpDistFunc DistFunc;
+#if ME_SAD_X4
+  FpDistFuncX4 DistFuncX4;          // same distortion as DistFunc at four positions of pCur, set for the integer ME
+#endif
 
 #if WEIGHT_PRED
   Bool            bApplyWeight;     // whether weithed prediction is used or not
@@ -100,6 +109,9 @@ public:
     iCols = 0;
     iStep = 1;
     DistFunc = NULL;
+#if ME_SAD_X4
+    DistFuncX4 = NULL;
+#endif
     iSubShift = 0;
   }
 };
@@ -120,6 +132,9 @@ private:
 #else  
   FpDistFunc              m_afpDistortFunc[33]; // [eDFunc]
 #endif  
+#if ME_SAD_X4
+  FpDistFuncX4            m_afpDistortFuncX4[64]; // [eDFunc], SAD entries only
+#endif
   
 #if WEIGHTED_CHROMA_DISTORTION
   Double                  m_chromaDistortionWeight;   
@@ -159,6 +174,9 @@ public:
   Void    setFrameLambda ( Double dLambda ) { m_dFrameLambda = dLambda; }
   
   Double  getSqrtLambda ()   { return m_sqrtLambda; }
+#if WPP_THREADS
+  Void    copyRDParam    ( TComRdCost* pcRdCost );   ///< take over the lambdas and the motion cost state of another instance
+#endif
   
   // Distortion Functions
   Void    init();
@@ -253,6 +271,33 @@ private:
   static UInt xCalcHADs4x4      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static UInt xCalcHADs8x8      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   
+#if ME_SAD_X4
+  static Void xGetSADx4         ( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist );
+#endif
+  
+#if SIMD_DISTORTION && SIMD_X86
+  Void        xInitSimd         ();                         ///< replace the C functions by the kernels of getSimdLevel()
+  
+  // iWidth = 0: width is a multiple of 16 given by the distortion parameter
+  template <Int iWidth> SIMD_TARGET_SSE2  static UInt xGetSADSimd   ( DistParam* pcDtParam );
+  template <Int iWidth> SIMD_TARGET_SSE2  static UInt xGetSSESimd   ( DistParam* pcDtParam );
+  SIMD_TARGET_SSE41 static UInt xGetHADsSimd      ( DistParam* pcDtParam );
+  SIMD_TARGET_SSE41 static UInt xCalcHADs4x4Simd  ( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur );
+  SIMD_TARGET_SSE41 static UInt xCalcHADs8x8Simd  ( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur );
+#if ME_SAD_X4
+  template <Int iWidth> SIMD_TARGET_SSE2  static Void xGetSADx4Simd ( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist );
+#endif
+#if SIMD_AVX2_SUPPORTED
+  template <Int iWidth> SIMD_TARGET_AVX2  static UInt xGetSADAvx2   ( DistParam* pcDtParam );
+  template <Int iWidth> SIMD_TARGET_AVX2  static UInt xGetSSEAvx2   ( DistParam* pcDtParam );
+  SIMD_TARGET_AVX2  static UInt xGetHADsAvx2      ( DistParam* pcDtParam );
+  SIMD_TARGET_AVX2  static UInt xCalcHADs8x8Avx2  ( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur );
+#if ME_SAD_X4
+  template <Int iWidth> SIMD_TARGET_AVX2  static Void xGetSADx4Avx2 ( DistParam* pcDtParam, Pel** ppCur, UInt* puiDist );
+#endif
+#endif
+#endif
+  
 public:
 #if WEIGHTED_CHROMA_DISTORTION
   UInt   getDistPart( Pel* piCur, Int iCurStride,  Pel* piOrg, Int iOrgStride, UInt uiBlkWidth, UInt uiBlkHeight, Bool bWeighted = false, DFunc eDFunc = DF_SSE );
@@ -36,6 +36,9 @@
 */
 
 #include "TComRom.h"
+#if ROM_CONTEXT
+#include "TComThreadPool.h"
+#endif
 #include <memory.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -46,11 +49,24 @@
 //! \ingroup TLibCommon
 //! \{
 
+#if ROM_CONTEXT
+static TComMutex  s_cROMMutex;
+static Int        s_iROMRefCount = 0;               ///< number of encoder/decoder instances sharing the tables
+#endif
+
 // initialize ROM variables
 Void initROM()
 {
   Int i, c;
   
+#if ROM_CONTEXT
+  s_cROMMutex.lock();
+  if ( s_iROMRefCount++ > 0 )
+  {
+    s_cROMMutex.unlock();
+    return;
+  }
+#endif
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
   ::memset( g_aucConvertToBit,   -1, sizeof( g_aucConvertToBit ) );
   c=0;
@@ -95,12 +111,23 @@ Void initROM()
     initNonSquareSigLastScan( g_auiNonSquareSigLastScan[ i ], uiW, uiH);
   }
 #endif
+#if ROM_CONTEXT
+  s_cROMMutex.unlock();
+#endif
 }
 
 Void destroyROM()
 {
   Int i;
   
+#if ROM_CONTEXT
+  s_cROMMutex.lock();
+  if ( --s_iROMRefCount > 0 )
+  {
+    s_cROMMutex.unlock();
+    return;
+  }
+#endif
   for ( i=0; i<MAX_CU_DEPTH; i++ )
   {
     delete[] g_auiFrameScanXY[i];
@@ -115,12 +142,48 @@ Void destroyROM()
 #endif
 #endif //QC_MDCS
   }
+#if NSQT
+  for ( i = 0; i < 2; i++ )
+  {
+    delete[] g_auiNonSquareSigLastScan[ i ];
+  }
+#endif
+#if ROM_CONTEXT
+  s_cROMMutex.unlock();
+#endif
 }
 
 // ====================================================================================================================
 // Data structure related table & variable
 // ====================================================================================================================
 
+#if ROM_CONTEXT
+TComRomContext::TComRomContext()
+: m_uiMaxCUWidth        ( MAX_CU_SIZE )
+, m_uiMaxCUHeight       ( MAX_CU_SIZE )
+, m_uiMaxCUDepth        ( MAX_CU_DEPTH )
+, m_uiAddCUDepth        ( 0 )
+, m_uiBitDepth          ( 8 )
+, m_uiBitIncrement      ( 0 )
+, m_uiIBDI_MAX          ( 255 )
+, m_uiBASE_MAX          ( 255 )
+#if E057_INTRA_PCM && E192_SPS_PCM_BIT_DEPTH_SYNTAX
+, m_uiPCMBitDepthLuma   ( 8 )
+, m_uiPCMBitDepthChroma ( 8 )
+#endif
+{
+  ::memset( m_auiZscanToRaster, 0, sizeof( m_auiZscanToRaster ) );
+  ::memset( m_auiRasterToZscan, 0, sizeof( m_auiRasterToZscan ) );
+  ::memset( m_auiRasterToPelX,  0, sizeof( m_auiRasterToPelX  ) );
+  ::memset( m_auiRasterToPelY,  0, sizeof( m_auiRasterToPelY  ) );
+#if REDUCE_UPPER_MOTION_DATA
+  ::memset( m_auiMotionRefer,   0, sizeof( m_auiMotionRefer   ) );
+#endif
+}
+
+static TComRomContext             s_cDefaultRomContext;
+ROM_THREAD_LOCAL TComRomContext*  g_pcRomContext = &s_cDefaultRomContext;
+#else
 UInt g_uiMaxCUWidth  = MAX_CU_SIZE;
 UInt g_uiMaxCUHeight = MAX_CU_SIZE;
 UInt g_uiMaxCUDepth  = MAX_CU_DEPTH;
@@ -133,6 +196,7 @@ UInt g_auiRasterToPelY  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
 #if REDUCE_UPPER_MOTION_DATA
 UInt g_motionRefer   [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, }; 
 #endif
+#endif
 
 #if AMP
 UInt g_auiPUOffset[8] = { 0, 8, 4, 4, 2, 10, 1, 5};
@@ -1798,6 +1862,7 @@ const UChar g_aucAngModeMapping[4][34] = // intra mode conversion for most proba
 // Bit-depth
 // ====================================================================================================================
 
+#if !ROM_CONTEXT
 UInt g_uiBitDepth     = 8;    // base bit-depth
 UInt g_uiBitIncrement = 0;    // increments
 UInt g_uiIBDI_MAX     = 255;  // max. value after  IBDI
@@ -1807,6 +1872,7 @@ UInt g_uiBASE_MAX     = 255;  // max. value before IBDI
 UInt g_uiPCMBitDepthLuma     = 8;    // PCM bit-depth
 UInt g_uiPCMBitDepthChroma   = 8;    // PCM bit-depth
 #endif
+#endif
 
 // ====================================================================================================================
 // Misc.
@@ -76,12 +76,97 @@ Void         initNonSquareSigLastScan(UInt* pBuffZ, UInt uiWidth, UInt uiHeight)
 // Data structure related table & variable
 // ====================================================================================================================
 
+#if ROM_CONTEXT
+/// configuration dependent state of one encoder or decoder instance, the constant tables are shared by all instances
+class TComRomContext
+{
+public:
+  TComRomContext();
+  
+  // LCU width/height, max. CU depth
+  UInt  m_uiMaxCUWidth;
+  UInt  m_uiMaxCUHeight;
+  UInt  m_uiMaxCUDepth;
+  UInt  m_uiAddCUDepth;
+  
+  // bit-depth
+  UInt  m_uiBitDepth;
+  UInt  m_uiBitIncrement;
+  UInt  m_uiIBDI_MAX;
+  UInt  m_uiBASE_MAX;
+#if E057_INTRA_PCM && E192_SPS_PCM_BIT_DEPTH_SYNTAX
+  UInt  m_uiPCMBitDepthLuma;
+  UInt  m_uiPCMBitDepthChroma;
+#endif
+  
+  // partition index conversion for the LCU size above
+  UInt  m_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToPelX [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToPelY [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+#if REDUCE_UPPER_MOTION_DATA
+  UInt  m_auiMotionRefer  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+#endif
+};
+
+#if defined(_MSC_VER)
+#define ROM_THREAD_LOCAL __declspec(thread)
+#else
+#define ROM_THREAD_LOCAL __thread
+#endif
+
+/// context of the encoder or decoder running on the calling thread, a process-wide default context if none was bound
+extern ROM_THREAD_LOCAL TComRomContext* g_pcRomContext;
+
+/// bind pcContext to the calling thread, jobs queued to a TComThreadPool run in the context of the thread queueing them
+inline Void            setRomContext( TComRomContext* pcContext ) { g_pcRomContext = pcContext; }
+inline TComRomContext* getRomContext()                            { return g_pcRomContext; }
+
+/// binds a context to the calling thread for the lifetime of the guard, the previous binding is restored afterwards
+class TComRomContextGuard
+{
+public:
+  TComRomContextGuard( TComRomContext* pcContext ) : m_pcSaved( g_pcRomContext ) { g_pcRomContext = pcContext; }
+  ~TComRomContextGuard()                                                          { g_pcRomContext = m_pcSaved;  }
+  
+private:
+  TComRomContext* m_pcSaved;
+  
+  TComRomContextGuard( const TComRomContextGuard& );
+  TComRomContextGuard& operator= ( const TComRomContextGuard& );
+};
+
+// the former global variables resolve to the bound context
+#define g_uiMaxCUWidth          ( g_pcRomContext->m_uiMaxCUWidth        )
+#define g_uiMaxCUHeight         ( g_pcRomContext->m_uiMaxCUHeight       )
+#define g_uiMaxCUDepth          ( g_pcRomContext->m_uiMaxCUDepth        )
+#define g_uiAddCUDepth          ( g_pcRomContext->m_uiAddCUDepth        )
+#define g_uiBitDepth            ( g_pcRomContext->m_uiBitDepth          )
+#define g_uiBitIncrement        ( g_pcRomContext->m_uiBitIncrement      )
+#define g_uiIBDI_MAX            ( g_pcRomContext->m_uiIBDI_MAX          )
+#define g_uiBASE_MAX            ( g_pcRomContext->m_uiBASE_MAX          )
+#if E057_INTRA_PCM && E192_SPS_PCM_BIT_DEPTH_SYNTAX
+#define g_uiPCMBitDepthLuma     ( g_pcRomContext->m_uiPCMBitDepthLuma   )
+#define g_uiPCMBitDepthChroma   ( g_pcRomContext->m_uiPCMBitDepthChroma )
+#endif
+#define g_auiZscanToRaster      ( g_pcRomContext->m_auiZscanToRaster    )
+#define g_auiRasterToZscan      ( g_pcRomContext->m_auiRasterToZscan    )
+#define g_auiRasterToPelX       ( g_pcRomContext->m_auiRasterToPelX     )
+#define g_auiRasterToPelY       ( g_pcRomContext->m_auiRasterToPelY     )
+#if REDUCE_UPPER_MOTION_DATA
+#define g_motionRefer           ( g_pcRomContext->m_auiMotionRefer      )
+#endif
+
+/** clip x, such that 0 <= x <= #g_uiIBDI_MAX */
+template <typename T> inline T Clip(T x) { return std::min<T>(T(g_uiIBDI_MAX), std::max<T>( T(0), x)); }
+#else
 // flexible conversion from relative to absolute index
 extern       UInt   g_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 extern       UInt   g_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 #if REDUCE_UPPER_MOTION_DATA
 extern       UInt   g_motionRefer[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 #endif
+#endif
 
 Void         initZscanToRaster ( Int iMaxDepth, Int iDepth, UInt uiStartVal, UInt*& rpuiCurrIdx );
 Void         initRasterToZscan ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth         );
@@ -90,17 +175,21 @@ Void         initRasterToZscan ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiM
 Void          initMotionReferIdx ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth );
 #endif
 
+#if !ROM_CONTEXT
 // conversion of partition index to picture pel position
 extern       UInt   g_auiRasterToPelX[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 extern       UInt   g_auiRasterToPelY[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+#endif
 
 Void         initRasterToPelXY ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth );
 
+#if !ROM_CONTEXT
 // global variable (LCU width/height, max. CU depth)
 extern       UInt g_uiMaxCUWidth;
 extern       UInt g_uiMaxCUHeight;
 extern       UInt g_uiMaxCUDepth;
 extern       UInt g_uiAddCUDepth;
+#endif
 
 #if AMP
 extern       UInt g_auiPUOffset[8];
@@ -326,6 +415,7 @@ extern const UChar g_aucAngIntraModeOrder[34];
 // Bit-depth
 // ====================================================================================================================
 
+#if !ROM_CONTEXT
 extern       UInt g_uiBitDepth;
 extern       UInt g_uiBitIncrement;
 extern       UInt g_uiIBDI_MAX;
@@ -334,6 +424,7 @@ extern       UInt g_uiBASE_MAX;
 extern       UInt g_uiPCMBitDepthLuma;
 extern       UInt g_uiPCMBitDepthChroma;
 #endif
+#endif
 
 // ====================================================================================================================
 // Texture type to integer mapping
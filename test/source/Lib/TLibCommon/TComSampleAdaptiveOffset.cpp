@@ -67,6 +67,9 @@ TComSampleAdaptiveOffset::TComSampleAdaptiveOffset()
   m_pTmpL1 = NULL;
   m_pTmpL2 = NULL;
   m_iLcuPartIdx = NULL;
+#if SIMD_SAO && SIMD_X86
+  m_pSaoLineBuf = NULL;
+#endif
 }
 
 TComSampleAdaptiveOffset::~TComSampleAdaptiveOffset()
@@ -308,6 +311,11 @@ Void TComSampleAdaptiveOffset::create( UInt uiSourceWidth, UInt uiSourceHeight,
   m_pTmpU1 = new Pel [m_iPicWidth];
   m_pTmpU2 = new Pel [m_iPicWidth];
 #endif
+#if SIMD_SAO && SIMD_X86
+  // three lines with 8 samples of padding at both ends
+  m_pSaoLineBuf = new Pel [3*(m_uiMaxCUWidth+16)];
+  ::memset( m_pSaoLineBuf, 0, sizeof(Pel)*3*(m_uiMaxCUWidth+16) );
+#endif
 }
 
 /** destroy SampleAdaptiveOffset memory.
@@ -381,6 +389,12 @@ Void TComSampleAdaptiveOffset::destroy()
     delete []m_iLcuPartIdx; m_iLcuPartIdx = NULL;
   }
 #endif
+#if SIMD_SAO && SIMD_X86
+  if (m_pSaoLineBuf)
+  {
+    delete [] m_pSaoLineBuf; m_pSaoLineBuf = NULL;
+  }
+#endif
 }
 
 /** allocate memory for SAO parameters
@@ -1202,6 +1216,13 @@ Void TComSampleAdaptiveOffset::processSaoCu(Int iAddr, Int iSaoType, Int iYCbCr)
     pTmpU = &(m_pTmpU1[uiLPelX]); 
   }
 
+#if SIMD_SAO && SIMD_X86
+  if ( getSimdLevel() >= ( iSaoType <= SAO_EO_3 ? SIMD_SSE2 : SIMD_SSE41 ) )
+  {
+    xProcessSaoCuSimd( pRec, iStride, pTmpU, pTmpL, iSaoType, iLcuWidth, iLcuHeight, uiLPelX == 0, uiTPelY == 0, uiRPelX == iPicWidthTmp, uiBPelY == iPicHeightTmp );
+  }
+  else
+#endif
   switch (iSaoType)
   {
   case SAO_EO_0: // dir: -
@@ -1554,6 +1575,14 @@ Void TComSampleAdaptiveOffset::processSaoOnePart(SAOQTPart *psQTPart, UInt uiPar
         ppLumaTable = m_ppLumaTableBo1;
       }
 
+#if SIMD_SAO && SIMD_X86
+      for (i=0;i<LUMA_GROUP_NUM;i++)
+      {
+        m_asOffsetBoBand[i] = (Short)iOffset[ppLumaTable[i << (g_uiBitDepth+g_uiBitIncrement-SAO_BO_BITS)]];
+      }
+      // the SIMD band offset does not use the sample table
+      if ( getSimdLevel() < SIMD_SSE41 )
+#endif
 #if FULL_NBIT
       for (i=0;i<(1<<(g_uiBitDepth));i++)
 #else
@@ -1719,6 +1748,14 @@ Void TComSampleAdaptiveOffset::xSaoAllPart(SAOQTPart *psQTPart, Int iYCbCr)
               ppLumaTable = m_ppLumaTableBo1;
             }
 
+#if SIMD_SAO && SIMD_X86
+            for (i=0;i<LUMA_GROUP_NUM;i++)
+            {
+              m_asOffsetBoBand[i] = (Short)iOffset[ppLumaTable[i << (g_uiBitDepth+g_uiBitIncrement-SAO_BO_BITS)]];
+            }
+            // the SIMD band offset does not use the sample table
+            if ( getSimdLevel() < SIMD_SSE41 )
+#endif
 #if FULL_NBIT
             for (i=0;i<(1<<(g_uiBitDepth));i++)
 #else
@@ -1938,4 +1975,213 @@ Pel* TComSampleAdaptiveOffset::getPicYuvAddr(TComPicYuv* pcPicYuv, Int iYCbCr, I
     break;
   }
 }
+#if SIMD_SAO && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/** sample adaptive offset process for one LCU with the SIMD kernels, same result as processSaoCuOrg()
+ * \param pRec, iStride         samples of the LCU
+ * \param pTmpU, pTmpL          original samples of the line above and of the column left of the LCU
+ * \param iSaoType              SAO type
+ * \param iLcuWidth, iLcuHeight size of the LCU inside the picture
+ * \param bLeftPic, bTopPic, bRightPic, bBottomPic  LCU at the picture boundaries
+ */
+Void TComSampleAdaptiveOffset::xProcessSaoCuSimd(Pel* pRec, Int iStride, Pel* pTmpU, Pel* pTmpL, Int iSaoType, Int iLcuWidth, Int iLcuHeight, Bool bLeftPic, Bool bTopPic, Bool bRightPic, Bool bBottomPic)
+{
+  Int iStartX = bLeftPic   ? 1 : 0;
+  Int iEndX   = bRightPic  ? iLcuWidth-1 : iLcuWidth;
+  Int iStartY = bTopPic    ? 1 : 0;
+  Int iEndY   = bBottomPic ? iLcuHeight-1 : iLcuHeight;
+
+  switch (iSaoType)
+  {
+  case SAO_EO_0:
+    xSaoEdgeOffsetSimd( pRec, iStride, pTmpU, pTmpL, iSaoType, iStartX, iEndX, iLcuHeight );
+    break;
+  case SAO_EO_1:
+    xSaoEdgeOffsetSimd( pRec + iStartY*iStride, iStride, pTmpU, pTmpL + iStartY, iSaoType, 0, iLcuWidth, iEndY - iStartY );
+    break;
+  case SAO_EO_2:
+  case SAO_EO_3:
+    xSaoEdgeOffsetSimd( pRec + iStartY*iStride, iStride, pTmpU, pTmpL + iStartY, iSaoType, iStartX, iEndX, iEndY - iStartY );
+    break;
+  case SAO_BO_0:
+  case SAO_BO_1:
+    xSaoBandOffsetSimd( pRec, iStride, iLcuWidth, iLcuHeight );
+    break;
+  default: break;
+  }
+}
+
+/** edge offset of the samples iStartX..iEndX-1 of iRows lines, 8 samples per step
+ * \param pRec, iStride  samples of the first line
+ * \param pTmpU          original samples of the line above the LCU
+ * \param pTmpL          original samples left of the first line
+ * \param iSaoType       edge offset type
+ *
+ * The lines above, at and below the current line are copied to m_pSaoLineBuf before the current line is modified,
+ * so that the edge classes are derived from the samples before SAO as in processSaoCuOrg().
+ */
+Void TComSampleAdaptiveOffset::xSaoEdgeOffsetSimd(Pel* pRec, Int iStride, Pel* pTmpU, Pel* pTmpL, Int iSaoType, Int iStartX, Int iEndX, Int iRows)
+{
+  Int  iLineSize = m_uiMaxCUWidth + 16;
+  Pel* pUp       = m_pSaoLineBuf + 8;
+  Pel* pCur      = pUp  + iLineSize;
+  Pel* pDown     = pCur + iLineSize;
+  // the vertical direction does not read the samples left and right of the range
+  Int  iCopyStart = ( iSaoType == SAO_EO_1 ) ? iStartX : iStartX - 1;
+  Int  iCopySize  = ( iSaoType == SAO_EO_1 ) ? iEndX - iStartX : iEndX - iStartX + 2;
+  Int  iNeighborA, iNeighborB;
+
+  switch (iSaoType)
+  {
+  case SAO_EO_0: iNeighborA = -1; iNeighborB =  1; break;
+  case SAO_EO_1: iNeighborA =  0; iNeighborB =  0; break;
+  case SAO_EO_2: iNeighborA = -1; iNeighborB =  1; break;
+  default:       iNeighborA =  1; iNeighborB = -1; break;
+  }
+
+  __m128i vOffset[5];
+  for (Int i = 0; i < 5; i++)
+  {
+    vOffset[i] = _mm_set1_epi16( (Short)m_iOffsetEo[i] );
+  }
+  const __m128i vMax  = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  const __m128i vZero = _mm_setzero_si128();
+
+  if (iSaoType != SAO_EO_0)
+  {
+    ::memcpy( pUp + iCopyStart, pTmpU + iCopyStart, sizeof(Pel)*iCopySize );
+  }
+  ::memcpy( pCur + iCopyStart, pRec + iCopyStart, sizeof(Pel)*iCopySize );
+  pCur[iStartX-1] = pTmpL[0];
+
+  for (Int y = 0; y < iRows; y++)
+  {
+    const Pel* pA;
+    const Pel* pB;
+    if (iSaoType == SAO_EO_0)
+    {
+      pA = pCur + iNeighborA;
+      pB = pCur + iNeighborB;
+    }
+    else
+    {
+      ::memcpy( pDown + iCopyStart, pRec + iStride + iCopyStart, sizeof(Pel)*iCopySize );
+      pDown[iStartX-1] = pTmpL[y+1];
+      pA = pUp   + iNeighborA;
+      pB = pDown + iNeighborB;
+    }
+
+    for (Int x = iStartX; x < iEndX; x += 8)
+    {
+      __m128i vCur = _mm_loadu_si128( (const __m128i*)&pCur[x] );
+      __m128i vA   = _mm_loadu_si128( (const __m128i*)&pA[x] );
+      __m128i vB   = _mm_loadu_si128( (const __m128i*)&pB[x] );
+      // sign(cur - a) + sign(cur - b), the edge type minus 2
+      __m128i vEdge = _mm_add_epi16( _mm_sub_epi16( _mm_cmpgt_epi16( vA, vCur ), _mm_cmpgt_epi16( vCur, vA ) ),
+                                     _mm_sub_epi16( _mm_cmpgt_epi16( vB, vCur ), _mm_cmpgt_epi16( vCur, vB ) ) );
+      __m128i vOff = vZero;
+      for (Int i = 0; i < 5; i++)
+      {
+        vOff = _mm_or_si128( vOff, _mm_and_si128( _mm_cmpeq_epi16( vEdge, _mm_set1_epi16( (Short)( i - 2 ) ) ), vOffset[i] ) );
+      }
+      __m128i vVal = _mm_min_epi16( _mm_max_epi16( _mm_add_epi16( vCur, vOff ), vZero ), vMax );
+      if (x + 8 <= iEndX)
+      {
+        _mm_storeu_si128( (__m128i*)&pRec[x], vVal );
+      }
+      else
+      {
+        Pel aVal[8];
+        _mm_storeu_si128( (__m128i*)aVal, vVal );
+        ::memcpy( &pRec[x], aVal, sizeof(Pel)*( iEndX - x ) );
+      }
+    }
+
+    if (iSaoType == SAO_EO_0)
+    {
+      if (y + 1 < iRows)
+      {
+        ::memcpy( pCur + iCopyStart, pRec + iStride + iCopyStart, sizeof(Pel)*iCopySize );
+        pCur[iStartX-1] = pTmpL[y+1];
+      }
+    }
+    else
+    {
+      Pel* pSwap = pUp;
+      pUp   = pCur;
+      pCur  = pDown;
+      pDown = pSwap;
+    }
+    pRec += iStride;
+  }
+}
+
+/** band offset of a block, 8 samples per step
+ * \param pRec, iStride    samples of the block
+ * \param iWidth, iHeight  size of the block
+ *
+ * The offsets of the 32 bands are looked up with byte shuffles on the low and high bytes of m_asOffsetBoBand.
+ */
+Void TComSampleAdaptiveOffset::xSaoBandOffsetSimd(Pel* pRec, Int iStride, Int iWidth, Int iHeight)
+{
+  UChar aucTable[4][16];
+  for (Int i = 0; i < 16; i++)
+  {
+    aucTable[0][i] = (UChar)( m_asOffsetBoBand[i]      & 0xff );
+    aucTable[1][i] = (UChar)( m_asOffsetBoBand[i]      >> 8   );
+    aucTable[2][i] = (UChar)( m_asOffsetBoBand[i + 16] & 0xff );
+    aucTable[3][i] = (UChar)( m_asOffsetBoBand[i + 16] >> 8   );
+  }
+  const __m128i vLowLo  = _mm_loadu_si128( (const __m128i*)aucTable[0] );
+  const __m128i vLowHi  = _mm_loadu_si128( (const __m128i*)aucTable[1] );
+  const __m128i vHighLo = _mm_loadu_si128( (const __m128i*)aucTable[2] );
+  const __m128i vHighHi = _mm_loadu_si128( (const __m128i*)aucTable[3] );
+  const __m128i vShift  = _mm_cvtsi32_si128( g_uiBitDepth + g_uiBitIncrement - SAO_BO_BITS );
+  // a shuffle index with the top bit set selects zero
+  const __m128i vSel    = _mm_set1_epi8( 0x70 );
+  const __m128i vHalf   = _mm_set1_epi8( 0x10 );
+  const __m128i vMax    = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  const __m128i vZero   = _mm_setzero_si128();
+
+  for (Int y = 0; y < iHeight; y++)
+  {
+    for (Int x = 0; x < iWidth; x += 8)
+    {
+      Pel aVal[8];
+      __m128i vCur;
+      if (x + 8 <= iWidth)
+      {
+        vCur = _mm_loadu_si128( (const __m128i*)&pRec[x] );
+      }
+      else
+      {
+        ::memcpy( aVal, &pRec[x], sizeof(Pel)*( iWidth - x ) );
+        vCur = _mm_loadu_si128( (const __m128i*)aVal );
+      }
+      __m128i vBand = _mm_sra_epi16( vCur, vShift );
+      vBand = _mm_packus_epi16( vBand, vBand );
+      __m128i vIdxLow  = _mm_adds_epu8( vBand, vSel );
+      __m128i vIdxHigh = _mm_adds_epu8( _mm_xor_si128( vBand, vHalf ), vSel );
+      __m128i vOffLo = _mm_or_si128( _mm_shuffle_epi8( vLowLo, vIdxLow ), _mm_shuffle_epi8( vHighLo, vIdxHigh ) );
+      __m128i vOffHi = _mm_or_si128( _mm_shuffle_epi8( vLowHi, vIdxLow ), _mm_shuffle_epi8( vHighHi, vIdxHigh ) );
+      __m128i vVal = _mm_add_epi16( vCur, _mm_unpacklo_epi8( vOffLo, vOffHi ) );
+      vVal = _mm_min_epi16( _mm_max_epi16( vVal, vZero ), vMax );
+      if (x + 8 <= iWidth)
+      {
+        _mm_storeu_si128( (__m128i*)&pRec[x], vVal );
+      }
+      else
+      {
+        _mm_storeu_si128( (__m128i*)aVal, vVal );
+        ::memcpy( &pRec[x], aVal, sizeof(Pel)*( iWidth - x ) );
+      }
+    }
+    pRec += iStride;
+  }
+}
+#endif
+
 //! \}
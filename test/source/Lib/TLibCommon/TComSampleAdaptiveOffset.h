@@ -40,6 +40,9 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#if SIMD_SAO
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -120,6 +123,13 @@ protected:
   Void convertSaoQt2Lcu(SAOQTPart *psQTPart,UInt uiPartIdx);
   Void xSaoAllPart(SAOQTPart *psQTPart, Int iYCbCr);
 #endif
+#if SIMD_SAO && SIMD_X86
+  Pel*  m_pSaoLineBuf;                       ///< original samples of the lines above, at and below the current line for the SIMD edge offset
+  Short m_asOffsetBoBand[LUMA_GROUP_NUM];    ///< offset of each band for the SIMD band offset
+  Void xProcessSaoCuSimd(Pel* pRec, Int iStride, Pel* pTmpU, Pel* pTmpL, Int iSaoType, Int iLcuWidth, Int iLcuHeight, Bool bLeftPic, Bool bTopPic, Bool bRightPic, Bool bBottomPic);
+  SIMD_TARGET_SSE2  Void xSaoEdgeOffsetSimd(Pel* pRec, Int iStride, Pel* pTmpU, Pel* pTmpL, Int iSaoType, Int iStartX, Int iEndX, Int iRows);
+  SIMD_TARGET_SSE41 Void xSaoBandOffsetSimd(Pel* pRec, Int iStride, Int iWidth, Int iHeight);
+#endif
 
 public:
   TComSampleAdaptiveOffset         ();
@@ -0,0 +1,133 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComSimd.cpp
+    \brief    x86 SIMD support: instruction set detection and kernel selection
+*/
+
+#include "TComSimd.h"
+
+#if SIMD_X86 && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+static UInt s_uiMaxSimdLevel = SIMD_AVX2;
+
+#if SIMD_X86
+static Void xCpuId( UInt uiLeaf, UInt auiRegs[4] )
+{
+#if defined(_MSC_VER)
+  Int aiRegs[4];
+  __cpuidex( aiRegs, uiLeaf, 0 );
+  for ( Int i = 0; i < 4; i++ )
+  {
+    auiRegs[i] = (UInt)aiRegs[i];
+  }
+#else
+  __cpuid_count( uiLeaf, 0, auiRegs[0], auiRegs[1], auiRegs[2], auiRegs[3] );
+#endif
+}
+
+/// register state enabled by the operating system (XCR0)
+static UInt xGetXCR0()
+{
+#if defined(_MSC_VER)
+#if SIMD_AVX2_SUPPORTED
+  return (UInt)_xgetbv( 0 );
+#else
+  return 0;
+#endif
+#else
+  UInt uiEax, uiEdx;
+  __asm__ __volatile__ ( "xgetbv" : "=a"( uiEax ), "=d"( uiEdx ) : "c"( 0 ) );
+  return uiEax;
+#endif
+}
+
+static SimdLevel xDetectSimdLevel()
+{
+  UInt auiRegs[4];
+  xCpuId( 0, auiRegs );
+  UInt uiMaxLeaf = auiRegs[0];
+  if ( uiMaxLeaf < 1 )
+  {
+    return SIMD_NONE;
+  }
+  
+  xCpuId( 1, auiRegs );
+  if ( !( auiRegs[3] & ( 1 << 26 ) ) )
+  {
+    return SIMD_NONE;
+  }
+  if ( !( auiRegs[2] & ( 1 << 19 ) ) || !( auiRegs[2] & ( 1 << 9 ) ) )    // SSE4.1, SSSE3
+  {
+    return SIMD_SSE2;
+  }
+  
+  // AVX2 needs the processor support and the YMM state saved by the operating system
+  Bool bOSXSave = ( auiRegs[2] & ( 1 << 27 ) ) != 0;
+  Bool bAVX     = ( auiRegs[2] & ( 1 << 28 ) ) != 0;
+  if ( !SIMD_AVX2_SUPPORTED || !bOSXSave || !bAVX || uiMaxLeaf < 7 || ( xGetXCR0() & 6 ) != 6 )
+  {
+    return SIMD_SSE41;
+  }
+  xCpuId( 7, auiRegs );
+  return ( auiRegs[1] & ( 1 << 5 ) ) ? SIMD_AVX2 : SIMD_SSE41;
+}
+#endif
+
+SimdLevel getCpuSimdLevel()
+{
+#if SIMD_X86
+  static const SimdLevel eLevel = xDetectSimdLevel();
+  return eLevel;
+#else
+  return SIMD_NONE;
+#endif
+}
+
+Void setSimdLevel( UInt uiMaxLevel )
+{
+  s_uiMaxSimdLevel = uiMaxLevel;
+}
+
+SimdLevel getSimdLevel()
+{
+  SimdLevel eLevel = getCpuSimdLevel();
+  return (UInt)eLevel < s_uiMaxSimdLevel ? eLevel : (SimdLevel)s_uiMaxSimdLevel;
+}
+
+//! \}
@@ -0,0 +1,96 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComSimd.h
+    \brief    x86 SIMD support: instruction set detection and kernel selection (header)
+*/
+
+#ifndef __TCOMSIMD__
+#define __TCOMSIMD__
+
+#include "CommonDef.h"
+
+#if ENABLE_SIMD && ( defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64) )
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+#if SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if _MSC_VER >= 1700
+#include <immintrin.h>
+#define SIMD_AVX2_SUPPORTED 1
+#else
+#include <smmintrin.h>
+#define SIMD_AVX2_SUPPORTED 0
+#endif
+// the compiler accepts every intrinsic in every function
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_SSE41
+#define SIMD_TARGET_AVX2
+#else
+#include <immintrin.h>
+#define SIMD_AVX2_SUPPORTED 1
+// the kernels are compiled for their instruction set only, the rest of the code keeps the default target
+#define SIMD_TARGET_SSE2    __attribute__((target("sse2")))
+#define SIMD_TARGET_SSE41   __attribute__((target("sse4.1")))
+#define SIMD_TARGET_AVX2    __attribute__((target("avx2")))
+#endif
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+/// instruction set levels, each level includes the ones below it
+enum SimdLevel
+{
+  SIMD_NONE   = 0,                            ///< C reference functions
+  SIMD_SSE2   = 1,
+  SIMD_SSE41  = 2,                            ///< SSE4.1, including SSSE3
+  SIMD_AVX2   = 3
+};
+
+/// highest level supported by the processor and the operating system
+SimdLevel   getCpuSimdLevel ();
+
+/// limit the kernels selected afterwards to uiMaxLevel, set once at start-up before any encoder or decoder is created
+Void        setSimdLevel    ( UInt uiMaxLevel );
+
+/// level the kernels are selected for, the minimum of getCpuSimdLevel() and the setSimdLevel() limit
+SimdLevel   getSimdLevel    ();
+
+//! \}
+
+#endif // __TCOMSIMD__
@@ -0,0 +1,251 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    portable worker thread pool and synchronisation primitives
+*/
+
+#include <assert.h>
+#include <algorithm>
+#include "TComThreadPool.h"
+#if ROM_CONTEXT
+#include "TComRom.h"
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// TComMutex / TComCondition
+// ====================================================================================================================
+
+#ifdef _WIN32
+TComMutex::TComMutex()                            { InitializeCriticalSection( &m_cSection ); }
+TComMutex::~TComMutex()                           { DeleteCriticalSection( &m_cSection ); }
+Void TComMutex::lock()                            { EnterCriticalSection( &m_cSection ); }
+Void TComMutex::unlock()                          { LeaveCriticalSection( &m_cSection ); }
+
+TComCondition::TComCondition()                    { InitializeConditionVariable( &m_cCond ); }
+TComCondition::~TComCondition()                   {}
+Void TComCondition::wait( TComMutex& rcMutex )    { SleepConditionVariableCS( &m_cCond, &rcMutex.m_cSection, INFINITE ); }
+Void TComCondition::broadcast()                   { WakeAllConditionVariable( &m_cCond ); }
+#else
+TComMutex::TComMutex()                            { pthread_mutex_init( &m_cMutex, NULL ); }
+TComMutex::~TComMutex()                           { pthread_mutex_destroy( &m_cMutex ); }
+Void TComMutex::lock()                            { pthread_mutex_lock( &m_cMutex ); }
+Void TComMutex::unlock()                          { pthread_mutex_unlock( &m_cMutex ); }
+
+TComCondition::TComCondition()                    { pthread_cond_init( &m_cCond, NULL ); }
+TComCondition::~TComCondition()                   { pthread_cond_destroy( &m_cCond ); }
+Void TComCondition::wait( TComMutex& rcMutex )    { pthread_cond_wait( &m_cCond, &rcMutex.m_cMutex ); }
+Void TComCondition::broadcast()                   { pthread_cond_broadcast( &m_cCond ); }
+#endif
+
+// ====================================================================================================================
+// TComThreadPool
+// ====================================================================================================================
+
+TComThreadPool::TComThreadPool()
+: m_bTerminate( false )
+{
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+}
+
+/** start the worker threads
+ * \param iNumThreads number of worker threads, 0 runs every job on the thread calling addJob()
+ */
+Void TComThreadPool::create( Int iNumThreads )
+{
+  assert( m_acThreads.empty() );
+  m_bTerminate = false;
+  for ( Int i = 0; i < iNumThreads; i++ )
+  {
+#ifdef _WIN32
+    HANDLE hThread = CreateThread( NULL, 0, xThreadEntry, this, 0, NULL );
+    if ( hThread == NULL )
+    {
+      break;
+    }
+#else
+    pthread_t hThread;
+    if ( pthread_create( &hThread, NULL, xThreadEntry, this ) != 0 )
+    {
+      break;
+    }
+#endif
+    m_acThreads.push_back( hThread );
+  }
+}
+
+/** stop and join the worker threads, jobs still queued are run before the workers exit
+ */
+Void TComThreadPool::destroy()
+{
+  if ( m_acThreads.empty() )
+  {
+    return;
+  }
+  m_cMutex.lock();
+  m_bTerminate = true;
+  m_cJobAdded.broadcast();
+  m_cMutex.unlock();
+
+  for ( UInt i = 0; i < m_acThreads.size(); i++ )
+  {
+#ifdef _WIN32
+    WaitForSingleObject( m_acThreads[i], INFINITE );
+    CloseHandle( m_acThreads[i] );
+#else
+    pthread_join( m_acThreads[i], NULL );
+#endif
+  }
+  m_acThreads.clear();
+}
+
+Void TComThreadPool::addJob( TComJob* pcJob )
+{
+  pcJob->m_bDone = false;
+  if ( m_acThreads.empty() )
+  {
+    pcJob->run();
+    pcJob->m_bDone = true;
+    return;
+  }
+#if ROM_CONTEXT
+  pcJob->m_pcRomContext = getRomContext();
+#endif
+  m_cMutex.lock();
+  m_cJobQueue.push_back( pcJob );
+  m_cJobAdded.broadcast();
+  m_cMutex.unlock();
+}
+
+/** wait for a job to complete
+ * The calling thread takes part in the processing of queued jobs while waiting, so that a job may itself queue and
+ * wait for further jobs without starving the pool.
+ */
+Void TComThreadPool::waitJob( TComJob* pcJob )
+{
+  m_cMutex.lock();
+  while ( !pcJob->m_bDone )
+  {
+    if ( !m_cJobQueue.empty() )
+    {
+      TComJob* pcNext = m_cJobQueue.front();
+      m_cJobQueue.pop_front();
+      xRunJob( pcNext );
+    }
+    else
+    {
+      m_cJobDone.wait( m_cMutex );
+    }
+  }
+  m_cMutex.unlock();
+}
+
+/** finish a job without executing other queued jobs on the calling thread
+ * Unlike waitJob() this is safe for a caller that other queued jobs may depend on, as long as pcJob itself never waits
+ * for other jobs.
+ */
+Void TComThreadPool::runJob( TComJob* pcJob )
+{
+  m_cMutex.lock();
+  std::deque<TComJob*>::iterator it = std::find( m_cJobQueue.begin(), m_cJobQueue.end(), pcJob );
+  if ( it != m_cJobQueue.end() )
+  {
+    m_cJobQueue.erase( it );
+    xRunJob( pcJob );
+  }
+  while ( !pcJob->m_bDone )
+  {
+    m_cJobDone.wait( m_cMutex );
+  }
+  m_cMutex.unlock();
+}
+
+#ifdef _WIN32
+DWORD WINAPI TComThreadPool::xThreadEntry( LPVOID pArg )
+{
+  ((TComThreadPool*)pArg)->xWorkerLoop();
+  return 0;
+}
+#else
+Void* TComThreadPool::xThreadEntry( Void* pArg )
+{
+  ((TComThreadPool*)pArg)->xWorkerLoop();
+  return NULL;
+}
+#endif
+
+Void TComThreadPool::xWorkerLoop()
+{
+  m_cMutex.lock();
+  for (;;)
+  {
+    if ( !m_cJobQueue.empty() )
+    {
+      TComJob* pcJob = m_cJobQueue.front();
+      m_cJobQueue.pop_front();
+      xRunJob( pcJob );
+    }
+    else if ( m_bTerminate )
+    {
+      break;
+    }
+    else
+    {
+      m_cJobAdded.wait( m_cMutex );
+    }
+  }
+  m_cMutex.unlock();
+}
+
+Void TComThreadPool::xRunJob( TComJob* pcJob )
+{
+  m_cMutex.unlock();
+  {
+#if ROM_CONTEXT
+    TComRomContextGuard cRomContextGuard( pcJob->m_pcRomContext );
+#endif
+    pcJob->run();
+  }
+  m_cMutex.lock();
+  pcJob->m_bDone = true;
+  m_cJobDone.broadcast();
+}
+
+//! \}
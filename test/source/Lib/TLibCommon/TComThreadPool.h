@@ -0,0 +1,174 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    portable worker thread pool and synchronisation primitives (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <deque>
+#include <vector>
+#include "CommonDef.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+#if ROM_CONTEXT
+class TComRomContext;
+#endif
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// mutual exclusion lock
+class TComMutex
+{
+public:
+  TComMutex();
+  ~TComMutex();
+
+  Void  lock    ();
+  Void  unlock  ();
+
+private:
+  friend class TComCondition;
+#ifdef _WIN32
+  CRITICAL_SECTION  m_cSection;
+#else
+  pthread_mutex_t   m_cMutex;
+#endif
+
+  TComMutex( const TComMutex& );
+  TComMutex& operator= ( const TComMutex& );
+};
+
+/// condition variable, always used together with a TComMutex held by the caller
+class TComCondition
+{
+public:
+  TComCondition();
+  ~TComCondition();
+
+  Void  wait      ( TComMutex& rcMutex );     ///< atomically release rcMutex and sleep until signalled
+  Void  broadcast ();                         ///< wake up all waiting threads
+
+private:
+#ifdef _WIN32
+  CONDITION_VARIABLE  m_cCond;
+#else
+  pthread_cond_t      m_cCond;
+#endif
+
+  TComCondition( const TComCondition& );
+  TComCondition& operator= ( const TComCondition& );
+};
+
+/// unit of work executed by TComThreadPool
+class TComJob
+{
+public:
+#if ROM_CONTEXT
+  TComJob() : m_bDone( false ), m_pcRomContext( NULL ) {}
+#else
+  TComJob() : m_bDone( false ) {}
+#endif
+  virtual ~TComJob() {}
+
+  virtual Void run() = 0;
+
+private:
+  friend class TComThreadPool;
+  Bool  m_bDone;                              ///< set by the pool once run() has returned
+#if ROM_CONTEXT
+  TComRomContext* m_pcRomContext;             ///< context of the thread that queued the job, bound while it runs
+#endif
+};
+
+/// fixed-size pool of worker threads processing TComJob objects in FIFO order
+class TComThreadPool
+{
+public:
+  TComThreadPool();
+  ~TComThreadPool();
+
+  Void  create        ( Int iNumThreads );
+  Void  destroy       ();
+
+  /// queue a job; with no worker threads the job is run immediately on the calling thread
+  Void  addJob        ( TComJob* pcJob );
+
+  /// block until pcJob has finished, executing queued jobs on the calling thread meanwhile
+  Void  waitJob       ( TComJob* pcJob );
+
+  /// run pcJob on the calling thread unless a worker has already started it, then block until it has finished
+  Void  runJob        ( TComJob* pcJob );
+
+  Int   getNumThreads ()  { return (Int)m_acThreads.size(); }
+
+private:
+#ifdef _WIN32
+  static DWORD WINAPI xThreadEntry( LPVOID pArg );
+  std::vector<HANDLE>     m_acThreads;
+#else
+  static Void* xThreadEntry( Void* pArg );
+  std::vector<pthread_t>  m_acThreads;
+#endif
+  Void  xWorkerLoop   ();
+  Void  xRunJob       ( TComJob* pcJob );     ///< run pcJob with m_cMutex released, return with it held
+
+  std::deque<TComJob*>    m_cJobQueue;
+  TComMutex               m_cMutex;
+  TComCondition           m_cJobAdded;
+  TComCondition           m_cJobDone;
+  Bool                    m_bTerminate;
+};
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
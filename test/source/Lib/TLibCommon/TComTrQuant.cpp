@@ -41,6 +41,9 @@
 #include "TComTrQuant.h"
 #include "TComPic.h"
 #include "ContextTables.h"
+#if SIMD_TRANSFORM || SIMD_QUANT
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -101,6 +104,9 @@ TComTrQuant::TComTrQuant()
   
   // allocate temporary buffers
   m_plTempCoeff  = new Int[ MAX_CU_SIZE*MAX_CU_SIZE ];
+#if SIMD_QUANT
+  m_bNonZeroMask = false;
+#endif
   
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
@@ -332,6 +338,197 @@ void xITr(Int *coeff, Pel *block, UInt uiStride, UInt uiTrSize)
 
 #else //MATRIX_MULT
 
+#if SIMD_TRANSFORM && SIMD_X86
+/** add the rounding offset, shift and truncate the 32-bit sums to 16 bits like the stores of the C transforms
+ */
+SIMD_TARGET_SSE2 static inline __m128i xRoundShift( __m128i vSum, __m128i vAdd, __m128i vShift )
+{
+  vSum = _mm_sra_epi32( _mm_add_epi32( vSum, vAdd ), vShift );
+  return _mm_srai_epi32( _mm_slli_epi32( vSum, 16 ), 16 );
+}
+
+/** NxN forward transform by matrix multiplication (1D), 4 lines per step
+ *  The sums of products are exact in 32 bits, so the result is identical to partialButterflyN() with matrix T and
+ *  to fastForwardDst() with the DST matrix.
+ *  \param T     transform matrix (N x N)
+ *  \param src   input data (residual), line rows of N samples
+ *  \param dst   output data (transform coefficients), N rows of line samples
+ *  \param shift specifies right shift after 1D transform
+ *  \param line  number of lines, a multiple of 4
+ */
+template<int N>
+SIMD_TARGET_SSE2 static void partialButterflySimd( const short *T, short *src, short *dst, int shift, int line )
+{
+  __m128i vPair[32*32/8];                     // pairs of samples of 4 lines, [line/4][N/2]
+  __m128i vCoeff[N/2];
+  __m128i vAdd   = _mm_set1_epi32( 1<<(shift-1) );
+  __m128i vShift = _mm_cvtsi32_si128( shift );
+  int j, k, p;
+  
+  // transpose the lines as 32-bit pairs of samples
+  for (j=0; j<line; j+=4)
+  {
+    __m128i *pvPair = vPair + (j>>2)*(N/2);
+    for (p=0; p<N/2; p+=4)
+    {
+      __m128i r0, r1, r2, r3;
+      if ( N == 4 )
+      {
+        r0 = _mm_loadl_epi64( (const __m128i*)&src[(j  )*N] );
+        r1 = _mm_loadl_epi64( (const __m128i*)&src[(j+1)*N] );
+        r2 = _mm_loadl_epi64( (const __m128i*)&src[(j+2)*N] );
+        r3 = _mm_loadl_epi64( (const __m128i*)&src[(j+3)*N] );
+      }
+      else
+      {
+        r0 = _mm_loadu_si128( (const __m128i*)&src[(j  )*N + 2*p] );
+        r1 = _mm_loadu_si128( (const __m128i*)&src[(j+1)*N + 2*p] );
+        r2 = _mm_loadu_si128( (const __m128i*)&src[(j+2)*N + 2*p] );
+        r3 = _mm_loadu_si128( (const __m128i*)&src[(j+3)*N + 2*p] );
+      }
+      __m128i t0 = _mm_unpacklo_epi32( r0, r1 );
+      __m128i t1 = _mm_unpacklo_epi32( r2, r3 );
+      __m128i t2 = _mm_unpackhi_epi32( r0, r1 );
+      __m128i t3 = _mm_unpackhi_epi32( r2, r3 );
+      pvPair[p  ] = _mm_unpacklo_epi64( t0, t1 );
+      pvPair[p+1] = _mm_unpackhi_epi64( t0, t1 );
+      if ( N > 4 )
+      {
+        pvPair[p+2] = _mm_unpacklo_epi64( t2, t3 );
+        pvPair[p+3] = _mm_unpackhi_epi64( t2, t3 );
+      }
+    }
+  }
+  
+  for (k=0; k<N; k++)
+  {
+    for (p=0; p<N/2; p++)
+    {
+      vCoeff[p] = _mm_set1_epi32( (unsigned short)T[k*N + 2*p] | ( (int)T[k*N + 2*p + 1] << 16 ) );
+    }
+    for (j=0; j<line; j+=4)
+    {
+      const __m128i *pvPair = vPair + (j>>2)*(N/2);
+      __m128i vSum = _mm_madd_epi16( pvPair[0], vCoeff[0] );
+      for (p=1; p<N/2; p++)
+      {
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( pvPair[p], vCoeff[p] ) );
+      }
+      vSum = xRoundShift( vSum, vAdd, vShift );
+      _mm_storel_epi64( (__m128i*)&dst[k*line + j], _mm_packs_epi32( vSum, vSum ) );
+    }
+  }
+}
+
+/** transpose a 4x4 block of 16-bit outputs and store it in 4 lines
+ *  \param v01 outputs 0 (low half) and 1 (high half) of the 4 lines
+ *  \param v23 outputs 2 and 3 of the 4 lines
+ */
+SIMD_TARGET_SSE2 static inline void xStoreTransposed4x4( __m128i v01, __m128i v23, short *dst, int iStride )
+{
+  v01 = _mm_unpacklo_epi16( v01, _mm_srli_si128( v01, 8 ) );
+  v23 = _mm_unpacklo_epi16( v23, _mm_srli_si128( v23, 8 ) );
+  __m128i vLine01 = _mm_unpacklo_epi32( v01, v23 );
+  __m128i vLine23 = _mm_unpackhi_epi32( v01, v23 );
+  _mm_storel_epi64( (__m128i*)&dst[0        ], vLine01 );
+  _mm_storel_epi64( (__m128i*)&dst[iStride  ], _mm_srli_si128( vLine01, 8 ) );
+  _mm_storel_epi64( (__m128i*)&dst[iStride*2], vLine23 );
+  _mm_storel_epi64( (__m128i*)&dst[iStride*3], _mm_srli_si128( vLine23, 8 ) );
+}
+
+/** NxN inverse transform by matrix multiplication (1D), 4 lines per step
+ *  The sums of products are exact in 32 bits, so the result is identical to partialButterflyInverseN() with matrix T
+ *  and to fastInverseDst() with the DST matrix. For N >= 8 the DCT symmetry is used: the even and the odd rows of T
+ *  give E and O for the first half of the outputs, the second half is E - O in reverse order.
+ *  \param T          transform matrix (N x N)
+ *  \param src        input data (transform coefficients), N rows of line samples
+ *  \param dst        output data (residual), line rows of N samples
+ *  \param shift      specifies right shift after 1D transform
+ *  \param line       number of lines, a multiple of 4
+ *  \param srcStride  distance between the rows of src
+ *  \param rows       number of leading rows of src that may be non-zero, N or a multiple of 4, the others are not read
+ */
+template<int N>
+SIMD_TARGET_SSE2 static void partialButterflyInverseSimd( const short *T, short *src, short *dst, int shift, int line, int srcStride, int rows )
+{
+  __m128i vPair[32*32/8];                     // pairs of coefficients of 4 lines, [line/4][N/2]
+  __m128i vCoeff[4][N/2];
+  __m128i vAdd   = _mm_set1_epi32( 1<<(shift-1) );
+  __m128i vShift = _mm_cvtsi32_si128( shift );
+  int j, k, n, i;
+  
+  if ( N == 4 )
+  {
+    // interleave the coefficient rows k and k+1
+    for (j=0; j<line; j+=4)
+    {
+      __m128i *pvPair = vPair + (j>>2)*2;
+      pvPair[0] = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)&src[            j] ), _mm_loadl_epi64( (const __m128i*)&src[  srcStride + j] ) );
+      pvPair[1] = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)&src[2*srcStride + j] ), _mm_loadl_epi64( (const __m128i*)&src[3*srcStride + j] ) );
+    }
+    for (i=0; i<4; i++)
+    {
+      vCoeff[i][0] = _mm_set1_epi32( (unsigned short)T[    i] | ( (int)T[  N + i] << 16 ) );
+      vCoeff[i][1] = _mm_set1_epi32( (unsigned short)T[2*N+i] | ( (int)T[3*N + i] << 16 ) );
+    }
+    for (j=0; j<line; j+=4)
+    {
+      const __m128i *pvPair = vPair + (j>>2)*2;
+      __m128i vSum[4];
+      for (i=0; i<4; i++)
+      {
+        vSum[i] = _mm_add_epi32( _mm_madd_epi16( pvPair[0], vCoeff[i][0] ), _mm_madd_epi16( pvPair[1], vCoeff[i][1] ) );
+        vSum[i] = xRoundShift( vSum[i], vAdd, vShift );
+      }
+      xStoreTransposed4x4( _mm_packs_epi32( vSum[0], vSum[1] ), _mm_packs_epi32( vSum[2], vSum[3] ), &dst[j*N], N );
+    }
+    return;
+  }
+  
+  // pairs of the even rows (0,2), (4,6), ... followed by pairs of the odd rows (1,3), (5,7), ...
+  for (j=0; j<line; j+=4)
+  {
+    __m128i *pvPair = vPair + (j>>2)*(N/2);
+    for (k=0; k<rows; k+=4)
+    {
+      pvPair[      k>>2] = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)&src[(k  )*srcStride + j] ), _mm_loadl_epi64( (const __m128i*)&src[(k+2)*srcStride + j] ) );
+      pvPair[N/4 + (k>>2)] = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)&src[(k+1)*srcStride + j] ), _mm_loadl_epi64( (const __m128i*)&src[(k+3)*srcStride + j] ) );
+    }
+  }
+  
+  for (n=0; n<N/2; n+=4)
+  {
+    for (i=0; i<4; i++)
+    {
+      for (k=0; k<rows; k+=4)
+      {
+        vCoeff[i][      k>>2] = _mm_set1_epi32( (unsigned short)T[(k  )*N + n+i] | ( (int)T[(k+2)*N + n+i] << 16 ) );
+        vCoeff[i][N/4 + (k>>2)] = _mm_set1_epi32( (unsigned short)T[(k+1)*N + n+i] | ( (int)T[(k+3)*N + n+i] << 16 ) );
+      }
+    }
+    for (j=0; j<line; j+=4)
+    {
+      const __m128i *pvPair = vPair + (j>>2)*(N/2);
+      __m128i vLow[4], vHigh[4];
+      for (i=0; i<4; i++)
+      {
+        __m128i vE = _mm_madd_epi16( pvPair[0], vCoeff[i][0] );
+        __m128i vO = _mm_madd_epi16( pvPair[N/4], vCoeff[i][N/4] );
+        for (k=1; k<(rows>>2); k++)
+        {
+          vE = _mm_add_epi32( vE, _mm_madd_epi16( pvPair[k], vCoeff[i][k] ) );
+          vO = _mm_add_epi32( vO, _mm_madd_epi16( pvPair[N/4 + k], vCoeff[i][N/4 + k] ) );
+        }
+        vLow [i] = xRoundShift( _mm_add_epi32( vE, vO ), vAdd, vShift );
+        vHigh[i] = xRoundShift( _mm_sub_epi32( vE, vO ), vAdd, vShift );
+      }
+      xStoreTransposed4x4( _mm_packs_epi32( vLow [0], vLow [1] ), _mm_packs_epi32( vLow [2], vLow [3] ), &dst[j*N + n], N );
+      xStoreTransposed4x4( _mm_packs_epi32( vHigh[3], vHigh[2] ), _mm_packs_epi32( vHigh[1], vHigh[0] ), &dst[j*N + N-4-n], N );
+    }
+  }
+}
+#endif
+
 /** 4x4 forward transform implemented using partial butterfly structure (1D)
  *  \param src   input data (residual)
  *  \param dst   output data (transform coefficients)
@@ -339,6 +536,13 @@ void xITr(Int *coeff, Pel *block, UInt uiStride, UInt uiTrSize)
  */
 void partialButterfly4(short src[4][4],short dst[4][4],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<4>( g_aiT4[0], src[0], dst[0], shift, 4 );
+    return;
+  }
+#endif
   int j;  
   int E[2],O[2];
   int add = 1<<(shift-1);
@@ -361,6 +565,13 @@ void partialButterfly4(short src[4][4],short dst[4][4],int shift)
 #if NSQT
 void partialButterfly4(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<4>( g_aiT4[0], src, dst, shift, line );
+    return;
+  }
+#endif
   int j;  
   int E[2],O[2];
   int add = 1<<(shift-1);
@@ -389,6 +600,13 @@ void partialButterfly4(short *src,short *dst,int shift, int line)
 // give identical results
 void fastForwardDst(short block[4][4],short coeff[4][4],int shift)  // input block, output coeff
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<4>( g_as_DST_MAT_4[0], block[0], coeff[0], shift, 4 );
+    return;
+  }
+#endif
   int i, c[4];
   int rnd_factor = 1<<(shift-1);
   for (i=0; i<4; i++)
@@ -407,6 +625,13 @@ void fastForwardDst(short block[4][4],short coeff[4][4],int shift)  // input blo
 }
 void fastInverseDst(short tmp[4][4],short block[4][4],int shift)  // input tmp, output block
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<4>( g_as_DST_MAT_4[0], tmp[0], block[0], shift, 4, 4, 4 );
+    return;
+  }
+#endif
   int i, c[4];
   int rnd_factor = 1<<(shift-1);
   for (i=0; i<4; i++)
@@ -476,6 +701,13 @@ void xTr4(short block[4][4],short coeff[4][4])
  */
 void partialButterflyInverse4(short src[4][4],short dst[4][4],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<4>( g_aiT4[0], src[0], dst[0], shift, 4, 4, 4 );
+    return;
+  }
+#endif
   int j;    
   int E[2],O[2];
   int add = 1<<(shift-1);
@@ -499,6 +731,13 @@ void partialButterflyInverse4(short src[4][4],short dst[4][4],int shift)
 #if NSQT
 void partialButterflyInverse4(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<4>( g_aiT4[0], src, dst, shift, line, line, 4 );
+    return;
+  }
+#endif
   int j;    
   int E[2],O[2];
   int add = 1<<(shift-1);
@@ -575,6 +814,13 @@ void xITr4(short coeff[4][4],short block[4][4])
  */
 void partialButterfly8(short src[8][8],short dst[8][8],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<8>( g_aiT8[0], src[0], dst[0], shift, 8 );
+    return;
+  }
+#endif
   int j,k;  
   int E[4],O[4];
   int EE[2],EO[2];
@@ -609,6 +855,13 @@ void partialButterfly8(short src[8][8],short dst[8][8],int shift)
 #if NSQT
 void partialButterfly8(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<8>( g_aiT8[0], src, dst, shift, line );
+    return;
+  }
+#endif
   int j,k;  
   int E[4],O[4];
   int EE[2],EO[2];
@@ -669,6 +922,13 @@ void xTr8(short block[8][8],short coeff[8][8])
  */
 void partialButterflyInverse8(short src[8][8],short dst[8][8],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<8>( g_aiT8[0], src[0], dst[0], shift, 8, 8, 8 );
+    return;
+  }
+#endif
   int j,k;    
   int E[4],O[4];
   int EE[2],EO[2];
@@ -703,6 +963,13 @@ void partialButterflyInverse8(short src[8][8],short dst[8][8],int shift)
 #if NSQT
 void partialButterflyInverse8(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<8>( g_aiT8[0], src, dst, shift, line, line, 8 );
+    return;
+  }
+#endif
   int j,k;    
   int E[4],O[4];
   int EE[2],EO[2];
@@ -762,6 +1029,13 @@ void xITr8(short coeff[8][8],short block[8][8])
  */
 void partialButterfly16(short src[16][16],short dst[16][16],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<16>( g_aiT16[0], src[0], dst[0], shift, 16 );
+    return;
+  }
+#endif
   int j,k;
   int E[8],O[8];
   int EE[4],EO[4];
@@ -810,6 +1084,13 @@ void partialButterfly16(short src[16][16],short dst[16][16],int shift)
 #if NSQT
 void partialButterfly16(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<16>( g_aiT16[0], src, dst, shift, line );
+    return;
+  }
+#endif
   int j,k;
   int E[8],O[8];
   int EE[4],EO[4];
@@ -884,6 +1165,13 @@ void xTr16(short block[16][16],short coeff[16][16])
  */
 void partialButterflyInverse16(short src[16][16],short dst[16][16],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<16>( g_aiT16[0], src[0], dst[0], shift, 16, 16, 16 );
+    return;
+  }
+#endif
   int j,k;  
   int E[8],O[8];
   int EE[4],EO[4];
@@ -929,6 +1217,13 @@ void partialButterflyInverse16(short src[16][16],short dst[16][16],int shift)
 #if NSQT
 void partialButterflyInverse16(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<16>( g_aiT16[0], src, dst, shift, line, line, 16 );
+    return;
+  }
+#endif
   int j,k;  
   int E[8],O[8];
   int EE[4],EO[4];
@@ -999,6 +1294,13 @@ void xITr16(short coeff[16][16],short block[16][16])
  */
 void partialButterfly32(short src[32][32],short dst[32][32],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<32>( g_aiT32[0], src[0], dst[0], shift, 32 );
+    return;
+  }
+#endif
   int j,k;
   int E[16],O[16];
   int EE[8],EO[8];
@@ -1058,6 +1360,13 @@ void partialButterfly32(short src[32][32],short dst[32][32],int shift)
 #if NSQT
 void partialButterfly32(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflySimd<32>( g_aiT32[0], src, dst, shift, line );
+    return;
+  }
+#endif
   int j,k;
   int E[16],O[16];
   int EE[8],EO[8];
@@ -1142,6 +1451,13 @@ void xTr32(short block[32][32],short coeff[32][32])
  */
 void partialButterflyInverse32(short src[32][32],short dst[32][32],int shift)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<32>( g_aiT32[0], src[0], dst[0], shift, 32, 32, 32 );
+    return;
+  }
+#endif
   int j,k;  
   int E[16],O[16];
   int EE[8],EO[8];
@@ -1199,6 +1515,13 @@ void partialButterflyInverse32(short src[32][32],short dst[32][32],int shift)
 #if NSQT
 void partialButterflyInverse32(short *src,short *dst,int shift, int line)
 {
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    partialButterflyInverseSimd<32>( g_aiT32[0], src, dst, shift, line, line, 32 );
+    return;
+  }
+#endif
   int j,k;  
   int E[16],O[16];
   int EE[8],EO[8];
@@ -1332,6 +1655,182 @@ void xITrMxN(short *coeff,short *block, int iWidth, int iHeight)
 }
 #endif
 
+#if SPARSE_INV_TRANSFORM
+/// DCT matrices of the transform sizes 4, 8, 16 and 32
+static const short* const s_apsTrMatrix[4] = { g_aiT4[0], g_aiT8[0], g_aiT16[0], g_aiT32[0] };
+
+/** inverse transform (1D) by matrix multiplication with the zero rows of the input left out
+ *  \param T          transform matrix (N x N)
+ *  \param N          transform size
+ *  \param src        input data (transform coefficients), rows of line samples
+ *  \param dst        output data (residual), line rows of N samples
+ *  \param shift      specifies right shift after 1D transform
+ *  \param line       number of lines
+ *  \param srcStride  distance between the rows of src
+ *  \param rows       number of leading rows of src that may be non-zero
+ */
+void partialButterflyInverseRows( const short *T, int N, short *src, short *dst, int shift, int line, int srcStride, int rows )
+{
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    switch ( N )
+    {
+      case  4: partialButterflyInverseSimd< 4>( T, src, dst, shift, line, srcStride, 4 ); return;
+      case  8: partialButterflyInverseSimd< 8>( T, src, dst, shift, line, srcStride, rows ); return;
+      case 16: partialButterflyInverseSimd<16>( T, src, dst, shift, line, srcStride, rows ); return;
+      default: partialButterflyInverseSimd<32>( T, src, dst, shift, line, srcStride, rows ); return;
+    }
+  }
+#endif
+  int j,k,n;
+  int add = 1<<(shift-1);
+  
+  for (j=0; j<line; j++)
+  {
+    for (n=0; n<N; n++)
+    {
+      int sum = add;
+      for (k=0; k<rows; k++)
+      {
+        sum += T[k*N + n]*src[k*srcStride + j];
+      }
+      dst[n] = sum>>shift;
+    }
+    dst += N;
+  }
+}
+
+/** inverse transform (2D) that only processes the rows and columns up to the last significant coefficient
+ *  The coefficients are laid out as in xITrMxN(): min(iWidth,iHeight) rows of max(iWidth,iHeight) coefficients.
+ *  Blocks with the DC coefficient only are filled with the residual value directly.
+ *  \param plCoef    input data (transform coefficients)
+ *  \param pResidual output data (residual)
+ *  \param uiStride  stride of the residual
+ *  \param iWidth    width of the block
+ *  \param iHeight   height of the block
+ *  \param T1        vertical transform matrix, applied first
+ *  \param T2        horizontal transform matrix
+ *  \param puiNonZeroMask non-zero column mask of every coefficient row, NULL to search the coefficients
+ *  \returns false when the coefficients are too dense for the reduced transform to pay off
+ */
+static Bool xITrSparse( Int* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight, const short *T1, const short *T2, const UInt* puiNonZeroMask )
+{
+  Int iSizeC  = max( iWidth, iHeight );       // coefficients per row
+  Int iLinesC = min( iWidth, iHeight );       // rows of coefficients
+  Int iLastRow = -1;
+  Int iLastCol = -1;
+  Int j, k;
+  
+  if ( puiNonZeroMask )
+  {
+    UInt uiCols = 0;
+    for ( j = 0; j < iLinesC; j++ )
+    {
+      if ( puiNonZeroMask[j] )
+      {
+        iLastRow = j;
+        uiCols  |= puiNonZeroMask[j];
+      }
+    }
+    for ( ; uiCols; uiCols >>= 1 )
+    {
+      iLastCol++;
+    }
+  }
+  else
+  {
+    for ( j = 0; j < iLinesC; j++ )
+    {
+      for ( k = 0; k < iSizeC; k++ )
+      {
+        if ( plCoef[j*iSizeC + k] )
+        {
+          iLastRow = j;
+          iLastCol = max( iLastCol, k );
+        }
+      }
+    }
+  }
+  
+  Int shift_1st = SHIFT_INV_1ST;
+#if FULL_NBIT
+  Int shift_2nd = SHIFT_INV_2ND - ((short)g_uiBitDepth - 8);
+#else
+  Int shift_2nd = SHIFT_INV_2ND - g_uiBitIncrement;
+#endif
+  
+  if ( iLastRow < 0 )
+  {
+    for ( j = 0; j < iHeight; j++ )
+    {
+      memset( pResidual, 0, iWidth * sizeof(Pel) );
+      pResidual += uiStride;
+    }
+    return true;
+  }
+  
+  if ( iLastRow == 0 && iLastCol == 0 && T1[0] == T1[1] && T2[0] == T2[1] )
+  {
+    // DC only: both passes spread the DC value with the constant first basis function
+    short sTmp = (short)( ( T1[0]*(short)plCoef[0] + (1<<(shift_1st-1)) ) >> shift_1st );
+    short sRes = (short)( ( T2[0]*sTmp + (1<<(shift_2nd-1)) ) >> shift_2nd );
+    for ( j = 0; j < iHeight; j++ )
+    {
+      for ( k = 0; k < iWidth; k++ )
+      {
+        pResidual[k] = sRes;
+      }
+      pResidual += uiStride;
+    }
+    return true;
+  }
+  
+  Int iRows  = min( ( iLastRow + 4 ) & ~3, iLinesC );
+  Int iLines = ( iLastCol + 4 ) & ~3;
+#if SIMD_TRANSFORM && SIMD_X86
+  if ( getSimdLevel() < SIMD_SSE2 && ( iRows*4 > iLinesC || iLines*4 > iSizeC ) )
+#else
+  if ( iRows*4 > iLinesC || iLines*4 > iSizeC )
+#endif
+  {
+    return false;
+  }
+  
+  short coeff[ 32 * 32 ];
+  short tmp  [ 32 * 32 ];
+  short block[ 32 * 32 ];
+  for ( j = 0; j < iRows * iSizeC; j++ )
+  {
+    coeff[j] = (short)plCoef[j];
+  }
+  
+  // the lines beyond the last column are zero after the first pass, so they are rows the second pass can leave out
+  partialButterflyInverseRows( T1, iLinesC, coeff, tmp, shift_1st, iLines, iSizeC, iRows );
+  partialButterflyInverseRows( T2, iSizeC, tmp, block, shift_2nd, iLinesC, iLinesC, iLines );
+  
+  if ( iWidth >= iHeight )
+  {
+    for ( j = 0; j < iHeight; j++ )
+    {
+      memcpy( pResidual + j * uiStride, block + j * iWidth, iWidth * sizeof(short) );
+    }
+  }
+  else
+  {
+    for ( j = 0; j < iHeight; j++ )
+    {
+      for ( k = 0; k < iWidth; k++ )
+      {
+        pResidual[k] = block[k * iHeight + j];
+      }
+      pResidual += uiStride;
+    }
+  }
+  return true;
+}
+#endif
+
 #endif //MATRIX_MULT
 
 UInt TComTrQuant::xCountVlcBits(UInt uiTableNumber, UInt uiCodeNumber)
@@ -2819,11 +3318,85 @@ Void TComTrQuant::xRateDistOptQuant_LCEC(TComDataCU* pcCU, Int* pSrcCoeff, TCoef
   }
 }
 
+#if SIMD_QUANT && SIMD_X86
+/** quantize iRows rows of iRowLen coefficients without RDOQ, level = sign(coef) * ((|coef| * iQ + iAdd) >> iQBits)
+ * \param piCoef          transform coefficients
+ * \param piQCoef         quantized levels
+ * \param iRowLen         coefficients per row, a multiple of 4 up to 32
+ * \param iRows           number of rows
+ * \param iQ              quantization scale
+ * \param iAdd            rounding offset
+ * \param iQBits          quantization shift
+ * \returns the sum of the absolute levels
+ */
+SIMD_TARGET_SSE41 static UInt xQuantSimd( const Int* piCoef, TCoeff* piQCoef, Int iRowLen, Int iRows, Int iQ, Int iAdd, Int iQBits )
+{
+  const __m128i vQ     = _mm_set1_epi32( iQ );
+  const __m128i vAdd   = _mm_set1_epi32( iAdd );
+  const __m128i vShift = _mm_cvtsi32_si128( iQBits );
+  __m128i vSum = _mm_setzero_si128();
+  
+  for ( Int j = 0; j < iRows; j++ )
+  {
+    for ( Int k = 0; k < iRowLen; k += 4 )
+    {
+      __m128i vCoef  = _mm_loadu_si128( (const __m128i*)( piCoef + k ) );
+      __m128i vLevel = _mm_srl_epi32( _mm_add_epi32( _mm_mullo_epi32( _mm_abs_epi32( vCoef ), vQ ), vAdd ), vShift );
+      vSum = _mm_add_epi32( vSum, vLevel );
+      _mm_storeu_si128( (__m128i*)( piQCoef + k ), _mm_sign_epi32( vLevel, vCoef ) );
+    }
+    piCoef  += iRowLen;
+    piQCoef += iRowLen;
+  }
+  vSum = _mm_add_epi32( vSum, _mm_srli_si128( vSum, 8 ) );
+  vSum = _mm_add_epi32( vSum, _mm_srli_si128( vSum, 4 ) );
+  return (UInt)_mm_cvtsi128_si32( vSum );
+}
+
+/** dequantize iRows rows of iRowLen levels, coef = Clip3(-32768, 32767, (level * iScale + iAdd) >> iShift)
+ * \param piQCoef         quantized levels
+ * \param piCoef          dequantized coefficients
+ * \param iRowLen         coefficients per row, a multiple of 4 up to 32
+ * \param iRows           number of rows
+ * \param iScale          dequantization scale
+ * \param iAdd            rounding offset
+ * \param iShift          dequantization shift
+ * \param puiNonZeroMask  receives one word per row, bit k set when coefficient k of the row is non-zero
+ */
+SIMD_TARGET_SSE41 static Void xDeQuantSimd( const TCoeff* piQCoef, Int* piCoef, Int iRowLen, Int iRows, Int iScale, Int iAdd, Int iShift, UInt* puiNonZeroMask )
+{
+  const __m128i vScale = _mm_set1_epi32( iScale );
+  const __m128i vAdd   = _mm_set1_epi32( iAdd );
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+  const __m128i vMin   = _mm_set1_epi32( -32768 );
+  const __m128i vMax   = _mm_set1_epi32( 32767 );
+  const __m128i vZero  = _mm_setzero_si128();
+  
+  for ( Int j = 0; j < iRows; j++ )
+  {
+    UInt uiMask = 0;
+    for ( Int k = 0; k < iRowLen; k += 4 )
+    {
+      __m128i vCoef = _mm_sra_epi32( _mm_add_epi32( _mm_mullo_epi32( _mm_loadu_si128( (const __m128i*)( piQCoef + k ) ), vScale ), vAdd ), vShift );
+      vCoef = _mm_min_epi32( _mm_max_epi32( vCoef, vMin ), vMax );
+      _mm_storeu_si128( (__m128i*)( piCoef + k ), vCoef );
+      uiMask |= (UInt)( ~_mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( vCoef, vZero ) ) ) & 0xf ) << k;
+    }
+    puiNonZeroMask[j] = uiMask;
+    piQCoef += iRowLen;
+    piCoef  += iRowLen;
+  }
+}
+#endif
+
 Void TComTrQuant::xQuant(TComDataCU* pcCU, Int* pSrc, TCoeff* pDes, Int iWidth, Int iHeight, UInt& uiAcSum, TextType eTType, UInt uiAbsPartIdx )
 {
   Int*   piCoef    = pSrc;
   TCoeff* piQCoef   = pDes;
   Int   iAdd = 0;
+#if SIMD_QUANT
+  m_bNonZeroMask = false;
+#endif
   
   if ( m_bUseRDOQ && (eTType == TEXT_LUMA || RDOQ_CHROMA) )
   {
@@ -2838,6 +3411,9 @@ Void TComTrQuant::xQuant(TComDataCU* pcCU, Int* pSrc, TCoeff* pDes, Int iWidth,
   }
   else
   {
+#if SIMD_QUANT && SIMD_X86
+    Int iSizeC = max( iWidth, iHeight );      // coefficients per row of the non-zero mask
+#endif
 #if NSQT 
     Bool bNonSqureFlag = ( iWidth != iHeight );
     UInt uiNonSqureScanTableIdx = 0;
@@ -2874,6 +3450,14 @@ Void TComTrQuant::xQuant(TComDataCU* pcCU, Int* pSrc, TCoeff* pDes, Int iWidth,
 
     iAdd = (pcCU->getSlice()->getSliceType()==I_SLICE ? 171 : 85) << (iQBits-9);
 
+#if SIMD_QUANT && SIMD_X86
+    // without the LCEC limits every level is kept, so the block can be quantized in raster order
+    if ( getSimdLevel() >= SIMD_SSE41 && m_iSymbolMode != 0 && iSizeC <= 32 )
+    {
+      uiAcSum += xQuantSimd( piCoef, piQCoef, iSizeC, iWidth*iHeight/iSizeC, uiQ, iAdd, iQBits );
+      return;
+    }
+#endif
     for( Int n = 0; n < iWidth*iHeight; n++ )
     {
       Int iLevel;
@@ -2932,6 +3516,13 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
   
   const TCoeff* piQCoef   = pSrc;
   Int*   piCoef    = pDes;
+#if SIMD_QUANT
+  m_bNonZeroMask = false;
+#endif
+#if SIMD_QUANT && SIMD_X86
+  Int    iSizeC    = max( iWidth, iHeight );  // coefficients per row of the non-zero mask
+  Int    iLinesC   = min( iWidth, iHeight );
+#endif
 #if NSQT
   if( iWidth != iHeight )
   {
@@ -2961,6 +3552,14 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
   iAdd = 1 << (iShift-1);
   Int scale = g_invQuantScales[m_cQP.m_iRem] << m_cQP.m_iPer;
 
+#if SIMD_QUANT && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE41 && iSizeC <= 32 && iSizeC * iLinesC == iWidth * iHeight )
+  {
+    xDeQuantSimd( piQCoef, piCoef, iSizeC, iLinesC, scale, iAdd, iShift, m_auiNonZeroMask );
+    m_bNonZeroMask = true;
+    return;
+  }
+#endif
   for( Int n = 0; n < iWidth*iHeight; n++ )
   {
     iCoeffQ = ( piQCoef[n] * scale + iAdd ) >> iShift;
@@ -2968,6 +3567,21 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
   } 
 }
 
+#if WPP_THREADS
+/** copy the RD parameters configured for the current slice
+ * \param pcTrQuant instance set up by the slice encoder
+ */
+Void TComTrQuant::copyRDParam( TComTrQuant* pcTrQuant )
+{
+#if RDOQ_CHROMA_LAMBDA
+  m_dLambdaLuma   = pcTrQuant->m_dLambdaLuma;
+  m_dLambdaChroma = pcTrQuant->m_dLambdaChroma;
+#endif
+  m_dLambda       = pcTrQuant->m_dLambda;
+  m_uiRDOQOffset  = pcTrQuant->m_uiRDOQOffset;
+}
+#endif
+
 Void TComTrQuant::init( UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxTrSize, Int iSymbolMode, UInt *aTableLP4, UInt *aTableLP8, UInt *aTableLastPosVlcIndex,
                        Bool bUseRDOQ,  Bool bEnc )
 {
@@ -3365,6 +3979,29 @@ Void TComTrQuant::xIT( Int* plCoef, Pel* pResidual, UInt uiStride, Int iSize )
 #endif
 #else
   Int j,k;
+#if SPARSE_INV_TRANSFORM
+  {
+    const short *T1 = s_apsTrMatrix[ (Int)g_aucConvertToBit[ min( iWidth, iHeight ) ] ];
+    const short *T2 = s_apsTrMatrix[ (Int)g_aucConvertToBit[ max( iWidth, iHeight ) ] ];
+#if INTRA_DST_TYPE_7
+    if ( iWidth == 4 && iHeight == 4 && uiMode != REG_DCT )
+    {
+      T1 = g_aucDCTDSTMode_Vert[uiMode] ? g_as_DST_MAT_4[0] : T1;
+      T2 = g_aucDCTDSTMode_Hor [uiMode] ? g_as_DST_MAT_4[0] : T2;
+    }
+#endif
+#if SIMD_QUANT
+    // the mask of the dequantized coefficients replaces the search for the last row and column
+    const UInt* puiNonZeroMask = m_bNonZeroMask && plCoef == m_plTempCoeff ? m_auiNonZeroMask : NULL;
+#else
+    const UInt* puiNonZeroMask = NULL;
+#endif
+    if ( xITrSparse( plCoef, pResidual, uiStride, iWidth, iHeight, T1, T2, puiNonZeroMask ) )
+    {
+      return;
+    }
+  }
+#endif
 #if NSQT
   Int iSize = iWidth; 
   if( iWidth != iHeight )
@@ -3573,7 +4210,7 @@ Void TComTrQuant::xRateDistOptQuant                 ( TComDataCU*
 #endif
 #endif //QC_MDCS
 #if NSQT
-  static Int  orgSrcCoeff[ 256 ];
+  Int* orgSrcCoeff = m_aiNsqtSrcCoeff;
   if( bNonSqureFlag )
   {
     memcpy( &orgSrcCoeff[ 0 ], plSrcCoeff, uiMaxNumCoeff * sizeof( Int ) );
@@ -4006,7 +4643,7 @@ Void TComTrQuant::xRateDistOptQuant                 ( TComDataCU*
   }
 #endif
 #if NSQT
-  static TCoeff dstCoeff[ 256 ];
+  TCoeff* dstCoeff = m_acNsqtDstCoeff;
   if( bNonSqureFlag )
   {
     memcpy( plSrcCoeff, &orgSrcCoeff[ 0 ], uiMaxNumCoeff * sizeof( Int ) );
@@ -175,6 +175,9 @@ public:
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
 #endif
   Void setRDOQOffset( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
+#if WPP_THREADS
+  Void copyRDParam  ( TComTrQuant* pcTrQuant );   ///< take over slice-level lambda and RDOQ offset of another instance
+#endif
   
   estBitsSbacStruct* m_pcEstBitsSbac;
   
@@ -185,6 +188,12 @@ public:
                                      const UInt                      uiStride );
 protected:
   Int*    m_plTempCoeff;
+#if SIMD_QUANT
+  // Only the inverse transform reads the mask. The CBF comes from the level sum the quantizer returns, and the entropy
+  // coder codes the levels of a CU after the blocks of later candidates were quantized, so it finds the last position itself.
+  UInt    m_auiNonZeroMask[ 32 ];   ///< one word per coefficient row, bit k set when column k of the last dequantized block is non-zero
+  Bool    m_bNonZeroMask;           ///< m_auiNonZeroMask was produced for the last dequantized block
+#endif
   
   QpParam  m_cQP;
 #if RDOQ_CHROMA_LAMBDA
@@ -201,6 +210,10 @@ protected:
   UInt     *m_uiLPTableE4;
   Int      m_iSymbolMode;
   UInt     *m_uiLastPosVlcIndex;
+#if NSQT
+  Int      m_aiNsqtSrcCoeff[ 256 ];   ///< RDOQ: source coefficients of a non-square block before re-ordering
+  TCoeff   m_acNsqtDstCoeff[ 256 ];   ///< RDOQ: quantized coefficients of a non-square block before re-ordering
+#endif
   
 private:
   // forward Transform
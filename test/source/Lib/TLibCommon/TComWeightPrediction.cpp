@@ -93,6 +93,13 @@ Void TComWeightPrediction::addWeightBi( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1,
   UInt  iSrc0Stride = pcYuvSrc0->getStride();
   UInt  iSrc1Stride = pcYuvSrc1->getStride();
   UInt  iDstStride  = rpcYuvDst->getStride();
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightBiSimd( pSrcY0, iSrc0Stride, pSrcY1, iSrc1Stride, pDstY, iDstStride, iWidth, iHeight, w0, w1, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -123,6 +130,13 @@ Void TComWeightPrediction::addWeightBi( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1,
   iWidth  >>=1;
   iHeight >>=1;
   
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightBiSimd( pSrcU0, iSrc0Stride, pSrcU1, iSrc1Stride, pDstU, iDstStride, iWidth, iHeight, w0, w1, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -143,6 +157,13 @@ Void TComWeightPrediction::addWeightBi( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1,
   round   = (1<<(shift-1));
   w1      = wp1[2].w;
 
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightBiSimd( pSrcV0, iSrc0Stride, pSrcV1, iSrc1Stride, pDstV, iDstStride, iWidth, iHeight, w0, w1, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -192,6 +213,13 @@ Void TComWeightPrediction::addWeightUni( TComYuv* pcYuvSrc0, UInt iPartUnitIdx,
   UInt  iSrc0Stride = pcYuvSrc0->getStride();
   UInt  iDstStride  = rpcYuvDst->getStride();
   
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightUniSimd( pSrcY0, iSrc0Stride, pDstY, iDstStride, iWidth, iHeight, w0, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -223,6 +251,13 @@ Void TComWeightPrediction::addWeightUni( TComYuv* pcYuvSrc0, UInt iPartUnitIdx,
   iWidth  >>=1;
   iHeight >>=1;
   
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightUniSimd( pSrcU0, iSrc0Stride, pDstU, iDstStride, iWidth, iHeight, w0, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -246,6 +281,13 @@ Void TComWeightPrediction::addWeightUni( TComYuv* pcYuvSrc0, UInt iPartUnitIdx,
   round   = wp0[2].round;
 #endif
 
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xWeightUniSimd( pSrcV0, iSrc0Stride, pDstV, iDstStride, iWidth, iHeight, w0, round, shift, offset );
+  }
+  else
+#endif
   for ( y = iHeight-1; y >= 0; y-- )
   {
     for ( x = iWidth-1; x >= 0; )
@@ -459,5 +501,128 @@ Void TComWeightPrediction::xWeightedPredictionUni( TComDataCU* pcCU, TComYuv* pc
   addWeightUni( pcYuvSrc, uiPartAddr, iWidth, iHeight, pwp, rpcYuvPred );
 }
 
+#if SIMD_YUV && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/** weightBidir() over a block, the weighted sums are formed in 32 bits by a multiply-add of the interleaved sources with (w0, w1)
+ * \param pSrc0 first prediction
+ * \param iSrc0Stride stride of pSrc0
+ * \param pSrc1 second prediction
+ * \param iSrc1Stride stride of pSrc1
+ * \param pDst weighted prediction
+ * \param iDstStride stride of pDst
+ * \param iWidth block width, any width
+ * \param iHeight block height
+ * \param w0 weight of pSrc0
+ * \param w1 weight of pSrc1
+ * \param round rounding offset
+ * \param shift right shift
+ * \param offset offset added after the shift
+ * \returns Void
+ */
+SIMD_TARGET_SSE2 Void TComWeightPrediction::xWeightBiSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int w0, Int w1, Int round, Int shift, Int offset )
+{
+#if GENERIC_IF
+  // w0*(P0 + IF_INTERNAL_OFFS) + w1*(P1 + IF_INTERNAL_OFFS) = w0*P0 + w1*P1 + (w0 + w1)*IF_INTERNAL_OFFS
+  const __m128i vRound  = _mm_set1_epi32( round + ( w0 + w1 ) * IF_INTERNAL_OFFS );
+#else
+  const __m128i vRound  = _mm_set1_epi32( round );
+#endif
+  const __m128i vWeight = _mm_set_epi16( (Short)w1, (Short)w0, (Short)w1, (Short)w0, (Short)w1, (Short)w0, (Short)w1, (Short)w0 );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMax    = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+      __m128i vLo   = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vWeight ), vRound );
+      __m128i vHi   = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vSrc1 ), vWeight ), vRound );
+      vLo = _mm_add_epi32( _mm_sra_epi32( vLo, vShift ), vOffset );
+      vHi = _mm_add_epi32( _mm_sra_epi32( vHi, vShift ), vOffset );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), vZero ), vMax ) );
+    }
+    if ( x + 4 <= iWidth )
+    {
+      __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+      __m128i vLo   = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vWeight ), vRound );
+      vLo = _mm_add_epi32( _mm_sra_epi32( vLo, vShift ), vOffset );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vZero ), vZero ), vMax ) );
+      x += 4;
+    }
+    for ( ; x < iWidth; x++ )
+    {
+      pDst[x] = weightBidir( w0, pSrc0[x], w1, pSrc1[x], round, shift, offset );
+    }
+    pSrc0 += iSrc0Stride;
+    pSrc1 += iSrc1Stride;
+    pDst  += iDstStride;
+  }
+}
+
+/** weightUnidir() over a block, the source is interleaved with zeros and multiplied by (w0, 0)
+ * \param pSrc0 prediction
+ * \param iSrc0Stride stride of pSrc0
+ * \param pDst weighted prediction
+ * \param iDstStride stride of pDst
+ * \param iWidth block width, any width
+ * \param iHeight block height
+ * \param w0 weight
+ * \param round rounding offset
+ * \param shift right shift
+ * \param offset offset added after the shift
+ * \returns Void
+ */
+SIMD_TARGET_SSE2 Void TComWeightPrediction::xWeightUniSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int w0, Int round, Int shift, Int offset )
+{
+#if GENERIC_IF
+  const __m128i vRound  = _mm_set1_epi32( round + w0 * IF_INTERNAL_OFFS );
+#else
+  const __m128i vRound  = _mm_set1_epi32( round );
+#endif
+  const __m128i vWeight = _mm_set_epi16( 0, (Short)w0, 0, (Short)w0, 0, (Short)w0, 0, (Short)w0 );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMax    = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+      __m128i vLo   = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vZero ), vWeight ), vRound );
+      __m128i vHi   = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vZero ), vWeight ), vRound );
+      vLo = _mm_add_epi32( _mm_sra_epi32( vLo, vShift ), vOffset );
+      vHi = _mm_add_epi32( _mm_sra_epi32( vHi, vShift ), vOffset );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), vZero ), vMax ) );
+    }
+    if ( x + 4 <= iWidth )
+    {
+      __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+      __m128i vLo   = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vZero ), vWeight ), vRound );
+      vLo = _mm_add_epi32( _mm_sra_epi32( vLo, vShift ), vOffset );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vZero ), vZero ), vMax ) );
+      x += 4;
+    }
+    for ( ; x < iWidth; x++ )
+    {
+      pDst[x] = weightUnidir( w0, pSrc0[x], round, shift, offset );
+    }
+    pSrc0 += iSrc0Stride;
+    pDst  += iDstStride;
+  }
+}
+#endif
+
 #endif  // WEIGHT_PRED
 
@@ -47,6 +47,9 @@
 #if GENERIC_IF
 #include "TComInterpolationFilter.h"
 #endif
+#if SIMD_YUV
+#include "TComSimd.h"
+#endif
 
 #if WEIGHT_PRED
 
@@ -59,6 +62,11 @@ class TComWeightPrediction
   wpScalingParam  m_wp0[3], m_wp1[3];
   Int             m_ibdi;
 
+#if SIMD_YUV && SIMD_X86
+  SIMD_TARGET_SSE2 Void xWeightBiSimd ( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int w0, Int w1, Int round, Int shift, Int offset );
+  SIMD_TARGET_SSE2 Void xWeightUniSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int w0, Int round, Int shift, Int offset );
+#endif
+
 public:
   TComWeightPrediction();
 
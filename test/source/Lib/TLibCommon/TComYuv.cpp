@@ -403,6 +403,13 @@ Void TComYuv::addClipLuma( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, UInt uiTrUnit
   UInt iSrc0Stride = pcYuvSrc0->getStride();
   UInt iSrc1Stride = pcYuvSrc1->getStride();
   UInt iDstStride  = getStride();
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xAddClipSimd( pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, uiPartSize, uiPartSize );
+    return;
+  }
+#endif
   for ( y = uiPartSize-1; y >= 0; y-- )
   {
     for ( x = uiPartSize-1; x >= 0; x-- )
@@ -429,6 +436,14 @@ Void TComYuv::addClipChroma( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, UInt uiTrUn
   UInt  iSrc0Stride = pcYuvSrc0->getCStride();
   UInt  iSrc1Stride = pcYuvSrc1->getCStride();
   UInt  iDstStride  = getCStride();
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xAddClipSimd( pSrcU0, iSrc0Stride, pSrcU1, iSrc1Stride, pDstU, iDstStride, uiPartSize, uiPartSize );
+    xAddClipSimd( pSrcV0, iSrc0Stride, pSrcV1, iSrc1Stride, pDstV, iDstStride, uiPartSize, uiPartSize );
+    return;
+  }
+#endif
   for ( y = uiPartSize-1; y >= 0; y-- )
   {
     for ( x = uiPartSize-1; x >= 0; x-- )
@@ -463,6 +478,13 @@ Void TComYuv::subtractLuma( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, UInt uiTrUni
   Int  iSrc0Stride = pcYuvSrc0->getStride();
   Int  iSrc1Stride = pcYuvSrc1->getStride();
   Int  iDstStride  = getStride();
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xSubtractSimd( pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, uiPartSize, uiPartSize );
+    return;
+  }
+#endif
   for ( y = uiPartSize-1; y >= 0; y-- )
   {
     for ( x = uiPartSize-1; x >= 0; x-- )
@@ -489,6 +511,14 @@ Void TComYuv::subtractChroma( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, UInt uiTrU
   Int  iSrc0Stride = pcYuvSrc0->getCStride();
   Int  iSrc1Stride = pcYuvSrc1->getCStride();
   Int  iDstStride  = getCStride();
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xSubtractSimd( pSrcU0, iSrc0Stride, pSrcU1, iSrc1Stride, pDstU, iDstStride, uiPartSize, uiPartSize );
+    xSubtractSimd( pSrcV0, iSrc0Stride, pSrcV1, iSrc1Stride, pDstV, iDstStride, uiPartSize, uiPartSize );
+    return;
+  }
+#endif
   for ( y = uiPartSize-1; y >= 0; y-- )
   {
     for ( x = uiPartSize-1; x >= 0; x-- )
@@ -528,6 +558,15 @@ Void TComYuv::addAvg( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, UInt iPartUnitIdx,
   Int shiftNum = IF_INTERNAL_PREC + 1 - ( g_uiBitDepth + g_uiBitIncrement );
   Int offset = ( 1 << ( shiftNum - 1 ) ) + 2 * IF_INTERNAL_OFFS;
   
+#if SIMD_YUV && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    xAddAvgSimd( pSrcY0, iSrc0Stride, pSrcY1, iSrc1Stride, pDstY, iDstStride, iWidth, iHeight, offset, shiftNum );
+    xAddAvgSimd( pSrcU0, pcYuvSrc0->getCStride(), pSrcU1, pcYuvSrc1->getCStride(), pDstU, getCStride(), iWidth>>1, iHeight>>1, offset, shiftNum );
+    xAddAvgSimd( pSrcV0, pcYuvSrc0->getCStride(), pSrcV1, pcYuvSrc1->getCStride(), pDstV, getCStride(), iWidth>>1, iHeight>>1, offset, shiftNum );
+    return;
+  }
+#endif
   for ( y = 0; y < iHeight; y++ )
   {
     for ( x = 0; x < iWidth; x += 4 )
@@ -647,4 +686,111 @@ Pel* TComYuv::getCrAddrPix( UInt iBlkX, UInt iBlkY )
   return m_apiBufV + ( iBlkY ) * getCStride() + ( iBlkX );
 }
 #endif
+#if SIMD_YUV && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/** pSrc0 - pSrc1 -> pDst, eight samples per step with a four sample and a scalar tail
+ */
+SIMD_TARGET_SSE2 Void TComYuv::xSubtractSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_sub_epi16( vSrc0, vSrc1 ) );
+    }
+    if ( x + 4 <= iWidth )
+    {
+      __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_sub_epi16( vSrc0, vSrc1 ) );
+      x += 4;
+    }
+    for ( ; x < iWidth; x++ )
+    {
+      pDst[x] = pSrc0[x] - pSrc1[x];
+    }
+    pSrc0 += iSrc0Stride;
+    pSrc1 += iSrc1Stride;
+    pDst  += iDstStride;
+  }
+}
+
+/** Clip(pSrc0 + pSrc1) -> pDst, the saturating sum clips to the same value as the 32-bit one
+ */
+SIMD_TARGET_SSE2 Void TComYuv::xAddClipSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vMax  = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i vSum = _mm_adds_epi16( _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) ), _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) ) );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vSum, vZero ), vMax ) );
+    }
+    if ( x + 4 <= iWidth )
+    {
+      __m128i vSum = _mm_adds_epi16( _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) ), _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) ) );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vSum, vZero ), vMax ) );
+      x += 4;
+    }
+    for ( ; x < iWidth; x++ )
+    {
+      pDst[x] = Clip( pSrc0[x] + pSrc1[x] );
+    }
+    pSrc0 += iSrc0Stride;
+    pSrc1 += iSrc1Stride;
+    pDst  += iDstStride;
+  }
+}
+
+/** Clip((pSrc0 + pSrc1 + iOffset) >> iShift) -> pDst, the sums are formed in 32 bits by a multiply-add of the interleaved sources with ones
+ */
+SIMD_TARGET_SSE2 Void TComYuv::xAddAvgSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int iOffset, Int iShift )
+{
+  const __m128i vOne    = _mm_set1_epi16( 1 );
+  const __m128i vOffset = _mm_set1_epi32( iOffset );
+  const __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMax    = _mm_set1_epi16( (Short)g_uiIBDI_MAX );
+  
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for ( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+      __m128i vLo   = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vOne ), vOffset );
+      __m128i vHi   = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vSrc1 ), vOne ), vOffset );
+      __m128i vRes  = _mm_packs_epi32( _mm_sra_epi32( vLo, vShift ), _mm_sra_epi32( vHi, vShift ) );
+      _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vRes, vZero ), vMax ) );
+    }
+    if ( x + 4 <= iWidth )
+    {
+      __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+      __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+      __m128i vSum  = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vOne ), vOffset );
+      __m128i vRes  = _mm_packs_epi32( _mm_sra_epi32( vSum, vShift ), vZero );
+      _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vRes, vZero ), vMax ) );
+      x += 4;
+    }
+    for ( ; x < iWidth; x++ )
+    {
+      pDst[x] = Clip( ( pSrc0[x] + pSrc1[x] + iOffset ) >> iShift );
+    }
+    pSrc0 += iSrc0Stride;
+    pSrc1 += iSrc1Stride;
+    pDst  += iDstStride;
+  }
+}
+#endif
 //! \}
@@ -42,6 +42,9 @@
 #include <assert.h>
 #include "CommonDef.h"
 #include "TComPicYuv.h"
+#if SIMD_YUV
+#include "TComSimd.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -87,6 +90,12 @@ private:
     
     return blkX + blkY * iBlkSize;
   }
+
+#if SIMD_YUV && SIMD_X86
+  SIMD_TARGET_SSE2 static Void xSubtractSimd( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight );
+  SIMD_TARGET_SSE2 static Void xAddClipSimd ( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight );
+  SIMD_TARGET_SSE2 static Void xAddAvgSimd  ( Pel* pSrc0, Int iSrc0Stride, Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight, Int iOffset, Int iShift );
+#endif
   
 public:
   
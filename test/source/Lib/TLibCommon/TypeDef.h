@@ -212,7 +212,34 @@
                             // of 4 bits per flush.
                             // Setting to 0 will slow cabac by an as yet unknown amount.
                             // This is here just to perform timing tests -- OL_FLUSH_ALIGN should be 0 for WPP.
-#endif
+#define WPP_THREADS 1       ///< Encoder: compress the LCU rows of a wavefront slice on worker threads (NumWorkerThreads), bit-exact with serial
+#define GOP_THREADS 1       ///< Encoder: compress the non-referenced pictures of a hierarchy level concurrently (NumWorkerThreads, needs WPP_THREADS), bit-exact with serial
+#define LOOP_FILTER_THREADS 1 ///< Encoder: deblock LCU row N-2 and gather the SAO statistics of the row above it on a worker thread while row N is compressed (NumWorkerThreads, needs WPP_THREADS), bit-exact with serial
+#define QP_RD_THREADS 1     ///< Encoder: compress the picture with every DeltaQpRD QP candidate concurrently, each on its own copy of the picture (NumWorkerThreads, needs GOP_THREADS), bit-exact with serial
+#define REF_SEARCH_THREADS 1 ///< Encoder: run the uni-directional motion searches of a prediction unit in its reference pictures concurrently (ParallelRefSearch, NumWorkerThreads), bit-exact with serial
+#define LOOKAHEAD_THREAD   1 ///< Encoder: compute the AQ activity of the input pictures on a lookahead thread ahead of the GOP encoder (Lookahead)
+#define ENC_ASYNC_IO       1 ///< Encoder application: read the input pictures and write the reconstruction and bitstream on an I/O thread (AsyncIO)
+#endif
+#define SPARSE_INV_TRANSFORM 1 ///< Inverse transform only processes the coefficient rows and columns up to the last significant coefficient, DC-only blocks are filled directly
+#define ROM_CONTEXT        1 ///< Keep the LCU geometry, bit depths and partition index tables in a TComRomContext per encoder/decoder instance instead of process-global variables
+#define ENABLE_SIMD        1 ///< x86 SIMD kernels (SSE2, SSE4.1, AVX2) selected at run time from CPUID, the C functions remain the reference (SIMD)
+#if ENABLE_SIMD
+#define SIMD_DISTORTION    1 ///< SAD, SSE and Hadamard kernels in TComRdCost
+#define SIMD_INTERPOLATION 1 ///< luma and chroma interpolation filter kernels in TComInterpolationFilter
+#define SIMD_TRANSFORM     1 ///< forward and inverse DCT (square and NSQT) and 4x4 DST kernels in TComTrQuant
+#define SIMD_DEBLOCK       1 ///< luma and chroma deblocking of a whole edge segment in TComLoopFilter
+#define SIMD_SAO           1 ///< SAO edge and band offset in TComSampleAdaptiveOffset and SAO statistics in TEncSampleAdaptiveOffset
+#define SIMD_ALF           1 ///< ALF luma and chroma filtering in TComAdaptiveLoopFilter and correlation accumulation in TEncAdaptiveLoopFilter
+#define SIMD_YUV           1 ///< residual, reconstruction and bi-prediction averaging in TComYuv and weighted prediction in TComWeightPrediction
+#define SIMD_INTRA         1 ///< angular, planar and LM chroma intra prediction and DC filtering in TComPrediction
+#define SIMD_QUANT         1 ///< non-RDOQ quantization and dequantization in TComTrQuant, with the absolute sum and a mask of the non-zero coefficients
+#define SIMD_VIDEO_IO      1 ///< sample conversion and bit-depth scaling of the YUV file rows in TVideoIOYuv
+#endif
+#define ME_PYRAMID         1 ///< Encoder: downscaled reconstruction pyramid of each picture, a coarse-to-fine search over it seeds the TZ search of the reference and replaces its raster stage (MEPyramid)
+#define ME_SAD_CACHE       1 ///< Encoder: per CU cache of the SADs of a 4x4 grid of sub-blocks at each position of the full search (FastSearch = 0), the searches of all partition shapes of a CU of 32x32 or larger assemble their SADs from it, bit-exact
+#define ME_SAD_X4          1 ///< Encoder: multi-candidate SAD kernels in TComRdCost score four reference positions against one original block per call, the TZ search submits its diamond, square and raster candidates in groups of four, bit-exact
+#define ME_TZ_VISITED      1 ///< Encoder: the TZ search marks the positions of its search window it has scored and skips them when its patterns overlap, counts the skipped positions, bit-exact
+#define ME_SUBPEL_PLANES   1 ///< Encoder: the 15 fractional luma phases of each reference picture are interpolated once when the picture is finished, the fractional motion search reads them instead of interpolating around each PU, bit-exact (SubPelPlanes)
 
 #define MTK_NONCROSS_INLOOP_FILTER        1           ///< Allow non-cross-slice-boundary in-loop filtering, including DB & ALF (JCTVC-D128)
 
@@ -273,6 +300,7 @@
 #if TILES
 #define TILES_DECODER                       1 // JCTVC-F594 - signalling of tile location
 #define MAX_MARKER_PER_NALU                 1000
+#define TILE_THREADS                        1 ///< Encoder: compress independent tiles on worker threads (NumWorkerThreads, needs WPP_THREADS), bit-exact with serial
 #else
 #define TILES_DECODER                       0
 #endif
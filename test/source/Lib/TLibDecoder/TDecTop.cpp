@@ -221,6 +221,9 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
 
 Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame, Int& iPOCLastDisplay)
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
   if (!m_pcPic)
     /* nothing to deblock */
     return;
@@ -248,6 +251,9 @@ Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic
 
 Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
   TComPic*&   pcPic         = m_pcPic;
 #if !F747_APS
 #if E045_SLICE_COMMON_INFO_SHARING
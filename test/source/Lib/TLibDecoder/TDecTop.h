@@ -84,6 +84,9 @@ private:
 
   UInt                    m_uiValidPS;
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
+#if ROM_CONTEXT
+  TComRomContext          m_cRomContext;      ///< LCU geometry, bit depths and partition index tables of this decoder
+#endif
   TComSPS                 m_cSPS;
 
 #if F747_APS
@@ -140,6 +143,9 @@ public:
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
   
   TComSPS *getSPS() { return (m_uiValidPS & 1) ? &m_cSPS : NULL; }
+#if ROM_CONTEXT
+  TComRomContext* getRomContext() { return &m_cRomContext; }
+#endif
   
   Void  deletePicBuffer();
 
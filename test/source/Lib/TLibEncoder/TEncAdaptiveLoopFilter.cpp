@@ -1053,6 +1053,13 @@ Void TEncAdaptiveLoopFilter::xCalcCorrelationFunc(Pel* pOrg, Pel* pCmp, Int iTap
   Pel* pTerm = new Pel[N];
   
   Int i, j;
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER && ALF_CHROMA_NEW_SHAPES
+  if ( getSimdLevel() >= SIMD_SSE2 && g_uiBitDepth + g_uiBitIncrement <= 12 && iTap <= 1 && iWidth % 4 == 0 && iHeight % 2 == 0 )
+  {
+    xCalcCorrelationFuncSimd( ypos, xpos, pOrg, pCmp, iTap, iWidth, iHeight, iOrgStride, iCmpStride );
+  }
+  else
+#endif
 #if MTK_NONCROSS_INLOOP_FILTER
   for (Int y = ypos; y < ypos + iHeight; y++)
   {
@@ -3015,6 +3022,14 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDe
 #endif
 
 #if STAR_CROSS_SHAPES_LUMA
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER && MQT_ALF_NPASS && MQT_BA_RA
+  if ( getSimdLevel() >= SIMD_SSE2 && g_uiBitDepth + g_uiBitIncrement <= 12 && tap <= 1 && sqrFiltLength == m_aiSimdNumTapPairs[tap] + 2
+    && ypos % VAR_SIZE_H == 0 && iheight % VAR_SIZE_H == 0 && xpos % VAR_SIZE_W == 0 && iwidth % VAR_SIZE_W == 0 )
+  {
+    xstoreInBlockMatrixSimd( ypos, xpos, iheight, iwidth, ImgOrg, ImgDec, tap, Stride, regionOfInterested, count_valid == 0 );
+  }
+  else
+#endif
   if (tap == 0)
   {
 #if MTK_NONCROSS_INLOOP_FILTER
@@ -3437,6 +3452,12 @@ Void TEncAdaptiveLoopFilter::xfilterFrame_en(imgpel* ImgDec, imgpel* ImgRest,int
 #endif
   sqrFiltLength=MAX_SQR_FILT_LENGTH;  fl=FILTER_LENGTH/2;
   
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER && MQT_BA_RA && STAR_CROSS_SHAPES_LUMA
+  if ( xFilterLumaSimd( ImgRest, ImgDec, filtNo, ypos, ypos + iheight, xpos, xpos + iwidth, Stride, m_varImg ) )
+  {
+    return;
+  }
+#endif
 #if MTK_NONCROSS_INLOOP_FILTER
   for (y= ypos, i = fl+ ypos; i < ypos+ iheight+ fl; i++, y++)
   {
@@ -6795,4 +6816,231 @@ UInt64 TEncAdaptiveLoopFilter::xCalcRateChroma(ALFParam* pAlfParam)
 }
 #endif
 
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+#define ALF_SIMD_MAX_TERMS    10                                                                ///< tap pairs, center tap and DC term of the star shape
+#define ALF_SIMD_CORR_ACC     ( ALF_SIMD_MAX_TERMS*(ALF_SIMD_MAX_TERMS+1)/2 + ALF_SIMD_MAX_TERMS + 1 )  ///< accumulators of one correlation
+
+/// load 4 samples of two lines into one vector
+SIMD_TARGET_SSE2 static inline __m128i xLoadAlfRowsSimd(const Pel* p0, const Pel* p1)
+{
+  return _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)p0 ), _mm_loadl_epi64( (const __m128i*)p1 ) );
+}
+
+/** add the correlation of the terms of 8 samples to 32-bit accumulators
+ * \param pvTerm     terms of the 8 samples, zero for the samples that are not used
+ * \param iNumTerms  number of terms
+ * \param vOrg       original samples, zero for the samples that are not used
+ * \param pvAcc      upper triangle of the autocorrelation, cross correlation with the original samples and energy of the original samples
+ */
+SIMD_TARGET_SSE2 static inline Void xAccumulateAlfCorrSimd(const __m128i* pvTerm, Int iNumTerms, __m128i vOrg, __m128i* pvAcc)
+{
+  for (Int k = 0; k < iNumTerms; k++)
+  {
+    for (Int l = k; l < iNumTerms; l++)
+    {
+      *pvAcc = _mm_add_epi32( *pvAcc, _mm_madd_epi16( pvTerm[k], pvTerm[l] ) );
+      pvAcc++;
+    }
+  }
+  for (Int k = 0; k < iNumTerms; k++)
+  {
+    *pvAcc = _mm_add_epi32( *pvAcc, _mm_madd_epi16( pvTerm[k], vOrg ) );
+    pvAcc++;
+  }
+  *pvAcc = _mm_add_epi32( *pvAcc, _mm_madd_epi16( vOrg, vOrg ) );
+}
+
+/// add the 32-bit accumulators to 64-bit sums and clear them
+SIMD_TARGET_SSE2 static Void xFlushAlfCorrSimd(__m128i* pvAcc, Int iNumAcc, Int64* piSum)
+{
+  for (Int i = 0; i < iNumAcc; i++)
+  {
+    Int aiLane[4];
+    _mm_storeu_si128( (__m128i*)aiLane, pvAcc[i] );
+    piSum[i] += (Int64)aiLane[0] + aiLane[1] + aiLane[2] + aiLane[3];
+    pvAcc[i] = _mm_setzero_si128();
+  }
+}
+
+/** luma correlation of xstoreInBlockMatrix() for the star and the cross shape, 4x2 samples per step
+ * \param ypos, xpos, iheight, iwidth  region of the picture, multiples of the 4x4 classification blocks
+ * \param ImgOrg, ImgDec, Stride       original and reconstructed picture
+ * \param tap                          filter shape (0: star, 1: cross)
+ * \param regionOfInterested           value of m_maskImg of the samples that are used
+ * \param bAllValid                    all samples are used
+ *
+ * The products are summed in 32-bit lanes that are added to 64-bit sums before they can overflow. All sums are
+ * integers below 2^53, so adding them to the double matrices once gives the same matrices as the C code.
+ */
+Void TEncAdaptiveLoopFilter::xstoreInBlockMatrixSimd(Int ypos, Int xpos, Int iheight, Int iwidth, imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride, imgpel regionOfInterested, Bool bAllValid)
+{
+  Int iNumPairs = m_aiSimdNumTapPairs[tap];
+  Int iNumTerms = iNumPairs + 2;
+  Int iNumAcc   = iNumTerms*(iNumTerms+1)/2 + iNumTerms + 1;
+  Int iMax      = g_uiIBDI_MAX;
+  // a 4x4 block adds at most 4 products of two terms to a lane
+  Int iFlushBlocks = (Int)( 0x7fffffff / ( 16 * (Int64)iMax * iMax ) );
+  Int aiTapOffset[8];
+  for (Int k = 0; k < iNumPairs; k++)
+  {
+    aiTapOffset[k] = m_aiSimdTapPos[tap][k][0]*Stride + m_aiSimdTapPos[tap][k][1];
+  }
+
+  __m128i aavAcc  [NO_VAR_BINS][ALF_SIMD_CORR_ACC];
+  Int64   aaiSum  [NO_VAR_BINS][ALF_SIMD_CORR_ACC];
+  Int     aiBlocks[NO_VAR_BINS];
+  Bool    abUsed  [NO_VAR_BINS];
+  ::memset( aavAcc,   0, sizeof(aavAcc) );
+  ::memset( aaiSum,   0, sizeof(aaiSum) );
+  ::memset( aiBlocks, 0, sizeof(aiBlocks) );
+  ::memset( abUsed,   0, sizeof(abUsed) );
+
+  const __m128i vRoi = _mm_set1_epi16( (Short)regionOfInterested );
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  __m128i vTerm[ALF_SIMD_MAX_TERMS];
+  __m128i vMask = _mm_set1_epi16( -1 );
+
+  for (Int i = ypos; i < ypos + iheight; i += VAR_SIZE_H)
+  {
+    for (Int j = xpos; j < xpos + iwidth; j += VAR_SIZE_W)
+    {
+      Int varInd = m_varImg[i/VAR_SIZE_H][j/VAR_SIZE_W];
+      for (Int ii = i; ii < i + VAR_SIZE_H; ii += 2)
+      {
+        const Pel* p0 = (const Pel*)ImgDec + ii*Stride + j;
+        const Pel* p1 = p0 + Stride;
+        if (!bAllValid)
+        {
+          vMask = _mm_cmpeq_epi16( xLoadAlfRowsSimd( (const Pel*)&m_maskImg[ii][j], (const Pel*)&m_maskImg[ii+1][j] ), vRoi );
+        }
+        for (Int k = 0; k < iNumPairs; k++)
+        {
+          vTerm[k] = _mm_and_si128( vMask, _mm_add_epi16( xLoadAlfRowsSimd( p0 + aiTapOffset[k], p1 + aiTapOffset[k] ),
+                                                          xLoadAlfRowsSimd( p0 - aiTapOffset[k], p1 - aiTapOffset[k] ) ) );
+        }
+        vTerm[iNumPairs]     = _mm_and_si128( vMask, xLoadAlfRowsSimd( p0, p1 ) );
+        vTerm[iNumPairs + 1] = _mm_and_si128( vMask, vOne );
+        const Pel* pOrg = (const Pel*)ImgOrg + ii*Stride + j;
+        __m128i vOrg = _mm_and_si128( vMask, xLoadAlfRowsSimd( pOrg, pOrg + Stride ) );
+
+        xAccumulateAlfCorrSimd( vTerm, iNumTerms, vOrg, aavAcc[varInd] );
+      }
+      abUsed[varInd] = true;
+      if (++aiBlocks[varInd] == iFlushBlocks)
+      {
+        xFlushAlfCorrSimd( aavAcc[varInd], iNumAcc, aaiSum[varInd] );
+        aiBlocks[varInd] = 0;
+      }
+    }
+  }
+
+  for (Int varInd = 0; varInd < NO_VAR_BINS; varInd++)
+  {
+    if (!abUsed[varInd])
+    {
+      continue;
+    }
+    xFlushAlfCorrSimd( aavAcc[varInd], iNumAcc, aaiSum[varInd] );
+
+    double** E  = m_EGlobalSym[tap][varInd];
+    double*  yy = m_yGlobalSym[tap][varInd];
+    Int64*   piSum = aaiSum[varInd];
+    for (Int k = 0; k < iNumTerms; k++)
+    {
+      for (Int l = k; l < iNumTerms; l++)
+      {
+        E[k][l] += (double)*piSum++;
+      }
+    }
+    for (Int k = 0; k < iNumTerms; k++)
+    {
+      yy[k] += (double)*piSum++;
+    }
+    m_pixAcc[varInd] += (double)*piSum;
+  }
+}
+
+/** chroma correlation of xCalcCorrelationFunc() for the star and the cross shape, 4x2 samples per step
+ * \param ypos, xpos, iWidth, iHeight  region of the picture, the width a multiple of 4 and the height a multiple of 2
+ * \param pOrg, pCmp                   original and reconstructed picture
+ * \param iTap                         filter shape (0: star, 1: cross)
+ * \param iOrgStride, iCmpStride       strides of the pictures
+ *
+ * The sums are gathered as in xstoreInBlockMatrixSimd() and added to m_ppdAlfCorr in the layout of the C code.
+ */
+Void TEncAdaptiveLoopFilter::xCalcCorrelationFuncSimd(Int ypos, Int xpos, Pel* pOrg, Pel* pCmp, Int iTap, Int iWidth, Int iHeight, Int iOrgStride, Int iCmpStride)
+{
+  Int N         = m_aiSimdNumTapPairs[iTap] + 1;
+  Int iNumPairs = m_aiSimdNumTapPairs[iTap];
+  Int iNumTerms = N + 1;
+  Int iNumAcc   = iNumTerms*(iNumTerms+1)/2 + iNumTerms + 1;
+  Int iMax      = g_uiIBDI_MAX;
+  // 4x2 samples add at most 2 products of two terms to a lane
+  Int iFlushSteps = (Int)( 0x7fffffff / ( 8 * (Int64)iMax * iMax ) );
+  Int iSteps      = 0;
+  Int aiTapOffset[8];
+  for (Int k = 0; k < iNumPairs; k++)
+  {
+    aiTapOffset[k] = m_aiSimdTapPos[iTap][k][0]*iCmpStride + m_aiSimdTapPos[iTap][k][1];
+  }
+
+  __m128i avAcc[ALF_SIMD_CORR_ACC];
+  Int64   aiSum[ALF_SIMD_CORR_ACC];
+  ::memset( avAcc, 0, sizeof(avAcc) );
+  ::memset( aiSum, 0, sizeof(aiSum) );
+
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  __m128i vTerm[ALF_SIMD_MAX_TERMS];
+
+  for (Int y = ypos; y < ypos + iHeight; y += 2)
+  {
+    for (Int x = xpos; x < xpos + iWidth; x += 4)
+    {
+      const Pel* p0 = pCmp + y*iCmpStride + x;
+      const Pel* p1 = p0 + iCmpStride;
+      for (Int k = 0; k < iNumPairs; k++)
+      {
+        vTerm[k] = _mm_add_epi16( xLoadAlfRowsSimd( p0 + aiTapOffset[k], p1 + aiTapOffset[k] ),
+                                  xLoadAlfRowsSimd( p0 - aiTapOffset[k], p1 - aiTapOffset[k] ) );
+      }
+      vTerm[iNumPairs]     = xLoadAlfRowsSimd( p0, p1 );
+      vTerm[iNumPairs + 1] = vOne;
+      const Pel* pOrg0 = pOrg + y*iOrgStride + x;
+      __m128i vOrg = xLoadAlfRowsSimd( pOrg0, pOrg0 + iOrgStride );
+
+      xAccumulateAlfCorrSimd( vTerm, iNumTerms, vOrg, avAcc );
+      if (++iSteps == iFlushSteps)
+      {
+        xFlushAlfCorrSimd( avAcc, iNumAcc, aiSum );
+        iSteps = 0;
+      }
+    }
+  }
+  xFlushAlfCorrSimd( avAcc, iNumAcc, aiSum );
+
+  // the DC term is the last term, its products are the sums of the terms
+  Int64* piSum = aiSum;
+  for (Int j = 0; j < iNumTerms; j++)
+  {
+    for (Int i = j; i < iNumTerms; i++)
+    {
+      m_ppdAlfCorr[j][i] += (double)*piSum;
+      if (i == N && j < N)
+      {
+        m_ppdAlfCorr[N][j] += (double)*piSum;
+      }
+      piSum++;
+    }
+  }
+  for (Int j = 0; j < iNumTerms; j++)
+  {
+    m_ppdAlfCorr[j][N+1] += (double)*piSum++;
+  }
+}
+#endif
+
 //! \}
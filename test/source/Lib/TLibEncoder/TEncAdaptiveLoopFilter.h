@@ -193,6 +193,9 @@ private:
 #else
   Void xCalcCorrelationFunc   ( Pel* pOrg, Pel* pCmp, Int iTap, Int iWidth, Int iHeight, Int iOrgStride, Int iCmpStride);
 #endif
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER
+  SIMD_TARGET_SSE2 Void xCalcCorrelationFuncSimd( Int ypos, Int xpos, Pel* pOrg, Pel* pCmp, Int iTap, Int iWidth, Int iHeight, Int iOrgStride, Int iCmpStride);
+#endif
 
   // functions related to filtering
   Void xFilterCoefQuickSort   ( Double *coef_data, Int *coef_num, Int upper, Int lower );
@@ -362,6 +365,9 @@ public:
   Void xstoreInBlockMatrix(Int ypos, Int xpos, Int iheight, Int iwidth, Bool bResetBlockMatrix, Bool bSymmCopyBlockMatrix, imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride);
 #else
   Void xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride);
+#endif
+#if SIMD_ALF && SIMD_X86 && MTK_NONCROSS_INLOOP_FILTER
+  SIMD_TARGET_SSE2 Void xstoreInBlockMatrixSimd(Int ypos, Int xpos, Int iheight, Int iwidth, imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride, imgpel regionOfInterested, Bool bAllValid);
 #endif
   Void xFilteringFrameLuma_qc(imgpel* ImgOrg, imgpel* imgY_pad, imgpel* ImgFilt, ALFParam* ALFp, Int tap, Int Stride);
 #if MTK_NONCROSS_INLOOP_FILTER
@@ -111,6 +111,12 @@ protected:
   Int       m_iFastSearch;                      //  0:Full search  1:Diamond  2:PMVFAST
   Int       m_iSearchRange;                     //  0:Full frame
   Int       m_bipredSearchRange;
+#if ME_PYRAMID
+  Bool      m_bUseMEPyramid;                    ///< seed the TZ search with a coarse-to-fine search over the reference pyramid
+#endif
+#if ME_SUBPEL_PLANES
+  Bool      m_bUseSubPelPlanes;                 ///< interpolate the sub-sample phases of each reference picture once for the fractional search
+#endif
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -212,6 +218,15 @@ protected:
   UInt      m_uiBiPredIdc;          //< Use of Bi-Directional Weighting Prediction (B_SLICE)
 #endif
 
+  //====== Multi-threading ========
+  Int       m_iNumWorkerThreads;    ///< number of worker threads, 0: single-threaded encoding
+#if REF_SEARCH_THREADS
+  Bool      m_bUseParallelRefSearch; ///< run the motion searches of the reference pictures of a prediction unit on worker threads
+#endif
+#if LOOKAHEAD_THREAD
+  Bool      m_bUseLookahead;         ///< analyze the input pictures on a lookahead thread
+#endif
+
 public:
   TEncCfg()          {}
   virtual ~TEncCfg() {
@@ -289,6 +304,12 @@ public:
   Void      setFastSearch                   ( Int   i )      { m_iFastSearch = i; }
   Void      setSearchRange                  ( Int   i )      { m_iSearchRange = i; }
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
+#if ME_PYRAMID
+  Void      setUseMEPyramid                 ( Bool  b )      { m_bUseMEPyramid = b; }
+#endif
+#if ME_SUBPEL_PLANES
+  Void      setUseSubPelPlanes              ( Bool  b )      { m_bUseSubPelPlanes = b; }
+#endif
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -341,6 +362,13 @@ public:
   //==== Motion search ========
   Int       getFastSearch                   ()      { return  m_iFastSearch; }
   Int       getSearchRange                  ()      { return  m_iSearchRange; }
+  Int       getBipredSearchRange            ()      { return  m_bipredSearchRange; }
+#if ME_PYRAMID
+  Bool      getUseMEPyramid                 ()      { return  m_bUseMEPyramid; }
+#endif
+#if ME_SUBPEL_PLANES
+  Bool      getUseSubPelPlanes              ()      { return  m_bUseSubPelPlanes; }
+#endif
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   ()      { return  m_iMaxDeltaQP; }
@@ -558,6 +586,17 @@ public:
   UInt      getWPBiPredIdc         ()            { return m_uiBiPredIdc;       }
 #endif
 
+  Void      setNumWorkerThreads    ( Int i )     { m_iNumWorkerThreads = i;    }
+  Int       getNumWorkerThreads    ()            { return m_iNumWorkerThreads; }
+#if REF_SEARCH_THREADS
+  Void      setUseParallelRefSearch( Bool b )    { m_bUseParallelRefSearch = b;    }
+  Bool      getUseParallelRefSearch()            { return m_bUseParallelRefSearch; }
+#endif
+#if LOOKAHEAD_THREAD
+  Void      setUseLookahead        ( Bool b )    { m_bUseLookahead = b;    }
+  Bool      getUseLookahead        ()            { return m_bUseLookahead; }
+#endif
+
 };
 
 //! \}
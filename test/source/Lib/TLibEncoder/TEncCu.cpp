@@ -96,6 +96,8 @@ Void TEncCu::create(UChar uhTotalDepth, UInt uiMaxWidth, UInt uiMaxHeight)
   }
   
   m_bEncodeDQP = false;
+  ::memset( m_afSkipCost, 0, sizeof( m_afSkipCost ) );
+  ::memset( m_aiSkipNum,  0, sizeof( m_aiSkipNum  ) );
 
   // initialize partition order.
   UInt* piTmp = &g_auiZscanToRaster[0];
@@ -221,6 +223,33 @@ Void TEncCu::init( TEncTop* pcEncTop )
   m_bUseSBACRD        = pcEncTop->getUseSBACRD();
 }
 
+#if WPP_THREADS
+/** initialize a CU encoder working on its own search, transform and entropy coding tools
+ * \param pcEncTop pointer of encoder class
+ * \param pcPredSearch encoder search class
+ * \param pcTrQuant transform & quantization class
+ * \param pcBitCounter bit counter
+ * \param pcRdCost RD cost computation class
+ * \param pcEntropyCoder entropy encoder
+ * \param pppcRDSbacCoder storage for SBAC-based RD optimization
+ * \param pcRDGoOnSbacCoder go-on SBAC encoder
+ */
+Void TEncCu::init( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder )
+{
+  init( pcEncTop );
+  
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcBitCounter       = pcBitCounter;
+  m_pcRdCost           = pcRdCost;
+  m_pcEntropyCoder     = pcEntropyCoder;
+  
+  m_pppcRDSbacCoder   = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder = pcRDGoOnSbacCoder;
+}
+#endif
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -555,13 +584,13 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
   Bool    bTrySplitDQP  = true;
 #endif
 
-  static  Double  afCost[ MAX_CU_DEPTH ];
-  static  Int      aiNum [ MAX_CU_DEPTH ];
+  Double* afCost = m_afSkipCost;
+  Int*    aiNum  = m_aiSkipNum;
 
   if ( rpcBestCU->getAddr() == 0 )
   {
-    ::memset( afCost, 0, sizeof( afCost ) );
-    ::memset( aiNum,  0, sizeof( aiNum  ) );
+    ::memset( m_afSkipCost, 0, sizeof( m_afSkipCost ) );
+    ::memset( m_aiSkipNum,  0, sizeof( m_aiSkipNum  ) );
   }
 
   Bool bBoundary = false;
@@ -99,9 +99,18 @@ private:
   TEncSbac*               m_pcRDGoOnSbacCoder;
   Bool                    m_bUseSBACRD;
   
+  //  Data : fast encoder early skip statistics
+  Double                  m_afSkipCost[ MAX_CU_DEPTH ];   ///< accumulated RD cost of skipped CUs for each CU size
+  Int                     m_aiSkipNum [ MAX_CU_DEPTH ];   ///< number of skipped CUs for each CU size
+  
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
+#if WPP_THREADS
+  /// copy parameters from encoder class, using a dedicated set of search, transform and entropy coding tools
+  Void  init                ( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                              TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder );
+#endif
   
   /// create internal buffers
   Void  create              ( UChar uhTotalDepth, UInt iMaxWidth, UInt iMaxHeight );
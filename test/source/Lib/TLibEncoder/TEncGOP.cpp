@@ -78,6 +78,21 @@ TEncGOP::TEncGOP()
   
   m_bRefreshPending     = 0;
   m_uiPOCCDR            = 0;
+#if GOP_THREADS
+  
+  m_iNumPicContexts     = 0;
+  m_pcPicContexts       = NULL;
+#endif
+#if QP_RD_THREADS
+  
+  m_iNumQpContexts      = 0;
+  m_pcQpContexts        = NULL;
+#endif
+#if LOOP_FILTER_THREADS
+  
+  m_pcFilterRowJobs     = NULL;
+  m_pcFilterPic         = NULL;
+#endif
 
   return;
 }
@@ -101,12 +116,36 @@ Void  TEncGOP::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHei
   m_uiStoredStartCUAddrForEncodingSlice = new UInt [uiNumCUsInFrame+1];
   m_uiStoredStartCUAddrForEncodingEntropySlice = new UInt [uiNumCUsInFrame+1];
 #endif
+#if LOOP_FILTER_THREADS
+  m_pcFilterRowJobs = new TEncFilterRowJob [uiHeightInCU];
+#endif
 }
 
 Void  TEncGOP::destroy()
 {
   delete [] m_uiStoredStartCUAddrForEncodingSlice; m_uiStoredStartCUAddrForEncodingSlice = NULL;
   delete [] m_uiStoredStartCUAddrForEncodingEntropySlice; m_uiStoredStartCUAddrForEncodingEntropySlice = NULL;
+#if GOP_THREADS
+  
+  for ( Int i = 0; i < m_iNumPicContexts; i++ )
+  {
+    m_pcPicContexts[i].destroy();
+  }
+  delete [] m_pcPicContexts; m_pcPicContexts = NULL;
+  m_iNumPicContexts = 0;
+#endif
+#if QP_RD_THREADS
+  
+  for ( Int i = 0; i < m_iNumQpContexts; i++ )
+  {
+    m_pcQpContexts[i].destroy();
+  }
+  delete [] m_pcQpContexts; m_pcQpContexts = NULL;
+  m_iNumQpContexts = 0;
+#endif
+#if LOOP_FILTER_THREADS
+  delete [] m_pcFilterRowJobs; m_pcFilterRowJobs = NULL;
+#endif
 }
 
 Void TEncGOP::init ( TEncTop* pcTEncTop )
@@ -140,20 +179,25 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   TComPic*        pcPic;
   TComPicYuv*     pcPicYuvRecOut;
   TComSlice*      pcSlice;
-#if TILES_DECODER
-  TComOutputBitstream  *pcBitstreamRedirect;
-  pcBitstreamRedirect = new TComOutputBitstream;
-  OutputNALUnit        *naluBuffered             = NULL;
-  Bool                  bIteratorAtListStart     = false;
-  AccessUnit::iterator  itLocationToPushSliceHeaderNALU; // used to store location where NALU containing slice header is to be inserted
-  UInt                  uiOneBitstreamPerSliceLength = 0;
+  AccessUnit*     pcAccessUnit;
+#if GOP_THREADS
+  TEncPicContext* pcPicContext;
+  Int             iNumPicsInBatch = 0;
 #endif
-#if OL_USE_WPP
-  TEncSbac* pcSbacCoders = NULL;
-  TComOutputBitstream* pcSubstreamsOut = NULL;
-#endif  
 
   xInitGOP( iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut );
+#if GOP_THREADS
+  if ( m_pcPicContexts == NULL )
+  {
+    xCreatePicContexts();
+  }
+#endif
+#if QP_RD_THREADS
+  if ( m_pcQpContexts == NULL )
+  {
+    xCreateQpContexts();
+  }
+#endif
   
   m_iNumPicCoded = 0;
   for ( Int iDepth = 0; iDepth < m_iHrchDepth; iDepth++ )
@@ -187,8 +231,15 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       /* start a new access unit: create an entry in the list of output
        * access units */
       accessUnitsInGOP.push_back(AccessUnit());
-      AccessUnit& accessUnit = accessUnitsInGOP.back();
+      pcAccessUnit = &accessUnitsInGOP.back();
       xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, uiPOCCurr );
+#if LOOKAHEAD_THREAD
+      if ( m_pcCfg->getUseLookahead() )
+      {
+        // the image characteristics must be known before the picture is compressed
+        m_pcEncTop->getLookahead()->waitPicture( pcPic );
+      }
+#endif
       
       //  Slice data initialization
       pcPic->clearSliceBuffer();
@@ -196,10 +247,19 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       m_pcSliceEncoder->setSliceIdx(0);
       pcPic->setCurrSliceIdx(0);
 
-#if F747_APS
-      std::vector<TComAPS>& vAPS = m_pcEncTop->getAPS();
-#endif
       m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr, iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS() );
+      TEncSlice* pcSliceEncoder = m_pcSliceEncoder;
+#if GOP_THREADS
+      // non-referenced pictures are compressed concurrently, each one with the tools of a picture context
+      pcPicContext = NULL;
+      if ( xUsePicContext( pcSlice ) )
+      {
+        pcPicContext   = &m_pcPicContexts[iNumPicsInBatch];
+        pcSliceEncoder = pcPicContext->getSliceEncoder();
+        pcSliceEncoder->setSliceIdx(0);
+        pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, uiPOCCurr, iNumPicRcvd, iTimeOffset, iDepth, pcSlice, m_pcEncTop->getSPS(), m_pcEncTop->getPPS() );
+      }
+#endif
       pcSlice->setSliceIdx(0);
 
 #if DISABLE_4x4_INTER
@@ -329,12 +389,10 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       //  Slice compression
       if (m_pcCfg->getUseASR())
       {
-        m_pcSliceEncoder->setSearchRange(pcSlice);
+        pcSliceEncoder->setSearchRange(pcSlice);
       }
 
-#if MTK_NONCROSS_INLOOP_FILTER
       UInt uiNumSlices = 1;
-#endif
 
 #if FINE_GRANULARITY_SLICES
       UInt uiInternalAddress = pcPic->getNumPartInCU()-4;
@@ -356,6 +414,8 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         uiExternalAddress++;
       }
       UInt uiRealEndAddress = uiExternalAddress*pcPic->getNumPartInCU()+uiInternalAddress;
+#else
+      UInt uiRealEndAddress = pcPic->getPicSym()->getNumberOfCUsInFrame();
 #endif
 
 #if TILES
@@ -519,1146 +579,1526 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     {
       // Allocate some coders, now we know how many tiles there are.
       m_pcEncTop->createWPPCoders(iNumSubstreams);
-      pcSbacCoders = m_pcEncTop->getSbacCoders();
-      pcSubstreamsOut = new TComOutputBitstream[iNumSubstreams];
     }
 #endif
 
-      UInt uiStartCUAddrSliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
-      UInt uiStartCUAddrSlice    = 0; // used to keep track of current slice's starting CU addr.
-      pcSlice->setSliceCurStartCUAddr( uiStartCUAddrSlice ); // Setting "start CU addr" for current slice
-#if FINE_GRANULARITY_SLICES
-      memset(m_uiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()*pcPic->getNumPartInCU()+1));
-#else
-      memset(m_uiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+      Bool bRowsFiltered = false;
+#if GOP_THREADS
+      if ( pcPicContext )
+      {
+        pcPicContext->m_pcPic            = pcPic;
+        pcPicContext->m_pcPicYuvRecOut   = pcPicYuvRecOut;
+        pcPicContext->m_pcAccessUnit     = pcAccessUnit;
+        pcPicContext->m_iBeforeTime      = iBeforeTime;
+        pcPicContext->m_uiRealEndAddress = uiRealEndAddress;
+        m_pcEncTop->getThreadPool()->addJob( pcPicContext );
+        iNumPicsInBatch++;
+        
+        // the in-loop filters and the entropy coding wait until the batch is full or the level is finished
+        Int  iNextTimeOffset = iTimeOffset + iStep;
+        Bool bSkipNext       = (m_pcCfg->getHierarchicalCoding() == false) && (iDepth != 0) && (iNextTimeOffset == m_iGopSize) && (iPOCLast != 0);
+        if ( iNumPicsInBatch < m_iNumPicContexts && iNextTimeOffset <= iNumPicRcvd && !bSkipNext )
+        {
+          continue;
+        }
+      }
+      else
 #endif
-
-      UInt uiStartCUAddrEntropySliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEntropyEncodingSlice" containing locations of slice boundaries
-      UInt uiStartCUAddrEntropySlice    = 0; // used to keep track of current Entropy slice's starting CU addr.
-      pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice ); // Setting "start CU addr" for current Entropy slice
-      
-#if FINE_GRANULARITY_SLICES
-      memset(m_uiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()*pcPic->getNumPartInCU()+1));
-#else
-      memset(m_uiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+      {
+#if GOP_THREADS
+        assert( iNumPicsInBatch == 0 );
 #endif
-      UInt uiNextCUAddr = 0;
-      m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = uiNextCUAddr;
-      m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiNextCUAddr;
-
-#if FINE_GRANULARITY_SLICES
-      while(uiNextCUAddr<uiRealEndAddress) // determine slice boundaries
+#if LOOP_FILTER_THREADS
+        bRowsFiltered = xUseFilterRows( pcPic );
+        if ( bRowsFiltered )
+        {
+          xStartFilterRows( pcPic, pcSlice );
+        }
+#endif
+        uiNumSlices = xCompressSlices( pcPic, m_pcSliceEncoder, m_uiStoredStartCUAddrForEncodingSlice, m_uiStoredStartCUAddrForEncodingEntropySlice, uiRealEndAddress );
+#if LOOP_FILTER_THREADS
+        if ( bRowsFiltered )
+        {
+          xFinishFilterRows();
+        }
+#endif
+      }
+      
+#if GOP_THREADS
+      // finish the pictures of the batch in decoding order
+      for ( Int iPicInBatch = 0; iPicInBatch < max( iNumPicsInBatch, 1 ); iPicInBatch++ )
+      {
+        if ( iNumPicsInBatch > 0 )
+        {
+          pcPicContext     = &m_pcPicContexts[iPicInBatch];
+          m_pcEncTop->getThreadPool()->waitJob( pcPicContext );
+          pcPic            = pcPicContext->m_pcPic;
+          pcPicYuvRecOut   = pcPicContext->m_pcPicYuvRecOut;
+          pcAccessUnit     = pcPicContext->m_pcAccessUnit;
+          iBeforeTime      = pcPicContext->m_iBeforeTime;
+          uiRealEndAddress = pcPicContext->m_uiRealEndAddress;
+          uiNumSlices      = pcPicContext->m_uiNumSlices;
+          swap( m_uiStoredStartCUAddrForEncodingSlice,        pcPicContext->m_puiStoredStartCUAddrForEncodingSlice );
+          swap( m_uiStoredStartCUAddrForEncodingEntropySlice, pcPicContext->m_puiStoredStartCUAddrForEncodingEntropySlice );
+        }
+        xFinishPicture( pcPic, pcPicYuvRecOut, *pcAccessUnit, rcListPic, iBeforeTime, uiRealEndAddress, uiNumSlices, bRowsFiltered );
+      }
+      iNumPicsInBatch = 0;
 #else
-      while(uiNextCUAddr<pcPic->getPicSym()->getNumberOfCUsInFrame()) // determine slice boundaries
+      xFinishPicture( pcPic, pcPicYuvRecOut, *pcAccessUnit, rcListPic, iBeforeTime, uiRealEndAddress, uiNumSlices, bRowsFiltered );
 #endif
+#if ME_SUBPEL_PLANES
+      if ( m_pcCfg->getUseSubPelPlanes() )
       {
-        pcSlice->setNextSlice       ( false );
-        pcSlice->setNextEntropySlice( false );
-        assert(pcPic->getNumAllocatedSlice() == uiStartCUAddrSliceIdx);
-        m_pcSliceEncoder->precompressSlice( pcPic );
-        m_pcSliceEncoder->compressSlice   ( pcPic );
-
-        Bool bNoBinBitConstraintViolated = (!pcSlice->isNextSlice() && !pcSlice->isNextEntropySlice());
-        if (pcSlice->isNextSlice() || (bNoBinBitConstraintViolated && m_pcCfg->getSliceMode()==AD_HOC_SLICES_FIXED_NUMBER_OF_LCU_IN_SLICE))
+        // no picture is being compressed here, the pictures that can no longer be referenced give their planes back
+        for ( TComList<TComPic*>::iterator iterPic = rcListPic.begin(); iterPic != rcListPic.end(); iterPic++ )
         {
-          uiStartCUAddrSlice                                              = pcSlice->getSliceCurEndCUAddr();
-          // Reconstruction slice
-          m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]  = uiStartCUAddrSlice;
-          // Entropy slice
-          if (uiStartCUAddrEntropySliceIdx>0 && m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx-1] != uiStartCUAddrSlice)
+          if ( !(*iterPic)->getReconMark() || !(*iterPic)->getSlice(0)->isReferenced() )
           {
-            m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrSlice;
+            (*iterPic)->destroySubPelPlanes();
           }
-          
+        }
+      }
+#endif
+    }
+    
+    // generalized B info.
+    if ( m_pcCfg->getHierarchicalCoding() == false && iDepth != 0 )
+      break;
+  }
+  
+  assert ( m_iNumPicCoded == iNumPicRcvd );
+}
+
+/** finish a compressed picture: in-loop filters, entropy coding of the slices, statistics and reference marking
+ * \param pcPic            compressed picture
+ * \param pcPicYuvRecOut   receives the reconstruction for output
+ * \param accessUnit       receives the NAL units of the picture
+ * \param rcListPic        list of the pictures for the reference marking
+ * \param iBeforeTime      clock value when the compression of the picture started
+ * \param uiRealEndAddress address following the last coded unit inside the picture
+ * \param uiNumSlices      number of slices of the picture
+ * \param bRowsFiltered    true when the rows have already been deblocked during the compression
+ */
+Void TEncGOP::xFinishPicture( TComPic* pcPic, TComPicYuv* pcPicYuvRecOut, AccessUnit& accessUnit, TComList<TComPic*>& rcListPic,
+                              long iBeforeTime, UInt uiRealEndAddress, UInt uiNumSlices, Bool bRowsFiltered )
+{
+  TComSlice* pcSlice = pcPic->getSlice(0);
+#if F747_APS
+  std::vector<TComAPS>& vAPS = m_pcEncTop->getAPS();
+#endif
 #if FINE_GRANULARITY_SLICES
-          if (uiStartCUAddrSlice < uiRealEndAddress)
-#else
-          if (uiStartCUAddrSlice < pcPic->getPicSym()->getNumberOfCUsInFrame())
+  UInt uiInternalAddress, uiExternalAddress, uiPosX, uiPosY, uiWidth, uiHeight;
 #endif
-          {
-            pcPic->allocateNewSlice();          
-            pcPic->setCurrSliceIdx                  ( uiStartCUAddrSliceIdx-1 );
-            m_pcSliceEncoder->setSliceIdx           ( uiStartCUAddrSliceIdx-1 );
-            pcSlice = pcPic->getSlice               ( uiStartCUAddrSliceIdx-1 );
-            pcSlice->copySliceInfo                  ( pcPic->getSlice(0)      );
-            pcSlice->setSliceIdx                    ( uiStartCUAddrSliceIdx-1 );
-            pcSlice->setSliceCurStartCUAddr         ( uiStartCUAddrSlice      );
-            pcSlice->setEntropySliceCurStartCUAddr  ( uiStartCUAddrSlice      );
-            pcSlice->setSliceBits(0);
-#if MTK_NONCROSS_INLOOP_FILTER
-            uiNumSlices ++;
+#if TILES_DECODER
+  TComOutputBitstream  *pcBitstreamRedirect;
+  pcBitstreamRedirect = new TComOutputBitstream;
+  OutputNALUnit        *naluBuffered             = NULL;
+  Bool                  bIteratorAtListStart     = false;
+  AccessUnit::iterator  itLocationToPushSliceHeaderNALU; // used to store location where NALU containing slice header is to be inserted
+  UInt                  uiOneBitstreamPerSliceLength = 0;
+#endif
+#if OL_USE_WPP
+  Int                   iNumSubstreams  = pcSlice->getPPS()->getNumSubstreams();
+  TEncSbac*             pcSbacCoders    = NULL;
+  TComOutputBitstream*  pcSubstreamsOut = NULL;
+  if (pcSlice->getPPS()->getEntropyCodingMode())
+  {
+    pcSbacCoders    = m_pcEncTop->getSbacCoders();
+    pcSubstreamsOut = new TComOutputBitstream[iNumSubstreams];
+  }
 #endif
-          }
-        }
-        else if (pcSlice->isNextEntropySlice() || (bNoBinBitConstraintViolated && m_pcCfg->getEntropySliceMode()==SHARP_FIXED_NUMBER_OF_LCU_IN_ENTROPY_SLICE))
-        {
-          uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
-          m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrEntropySlice;
-          pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice );
-        }
-        else
-        {
-          uiStartCUAddrSlice                                                            = pcSlice->getSliceCurEndCUAddr();
-          uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
-        }        
 
-        uiNextCUAddr = (uiStartCUAddrSlice > uiStartCUAddrEntropySlice) ? uiStartCUAddrSlice : uiStartCUAddrEntropySlice;
-      }
-      m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = pcSlice->getSliceCurEndCUAddr();
-      m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = pcSlice->getSliceCurEndCUAddr();
-      
-      pcSlice = pcPic->getSlice(0);
 #if !F747_APS
 #if SAO  // PRE_DF
-      SAOParam cSaoParam;
+  SAOParam cSaoParam;
 #endif
 #endif
-      //-- Loop filter
-      m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), m_pcCfg->getLoopFilterAlphaC0Offget(), m_pcCfg->getLoopFilterBetaOffget());
-      m_pcLoopFilter->loopFilterPic( pcPic );
+  //-- Loop filter
+#if LOOP_FILTER_THREADS
+  // the rows have already been deblocked while the picture was compressed
+  if ( !bRowsFiltered )
+#endif
+  {
+    m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), m_pcCfg->getLoopFilterAlphaC0Offget(), m_pcCfg->getLoopFilterBetaOffget());
+    m_pcLoopFilter->loopFilterPic( pcPic );
+  }
 
 #if SAO && MTK_NONCROSS_INLOOP_FILTER && FINE_GRANULARITY_SLICES 
-      pcSlice = pcPic->getSlice(0);
+  pcSlice = pcPic->getSlice(0);
 
-      if(pcSlice->getSPS()->getUseSAO())
+  if(pcSlice->getSPS()->getUseSAO())
+  {
+    m_pcSAO->setNumSlicesInPic( uiNumSlices );
+    m_pcSAO->setSliceGranularityDepth(pcSlice->getPPS()->getSliceGranularity());
+    if(uiNumSlices == 1)
+    {
+      m_pcSAO->setUseNIF(false);
+    }
+    else
+    {
+      m_pcSAO->setPic(pcPic);
+      m_pcSAO->setUseNIF(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag());
+      if (m_pcSAO->getUseNIF())
       {
-        m_pcSAO->setNumSlicesInPic( uiNumSlices );
-        m_pcSAO->setSliceGranularityDepth(pcSlice->getPPS()->getSliceGranularity());
-        if(uiNumSlices == 1)
-        {
-          m_pcSAO->setUseNIF(false);
-        }
-        else
+        m_pcSAO->InitIsFineSliceCu();
+        UInt uiStartAddr, uiEndAddr;
+        for(UInt i=0; i< uiNumSlices ; i++)
         {
-          m_pcSAO->setPic(pcPic);
-          m_pcSAO->setUseNIF(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag());
-          if (m_pcSAO->getUseNIF())
-          {
-            m_pcSAO->InitIsFineSliceCu();
-            UInt uiStartAddr, uiEndAddr;
-            for(UInt i=0; i< uiNumSlices ; i++)
-            {
-              uiStartAddr = m_uiStoredStartCUAddrForEncodingSlice[i];
-              uiEndAddr   = m_uiStoredStartCUAddrForEncodingSlice[i+1]-1;
-              m_pcSAO->createSliceMap(i, uiStartAddr, uiEndAddr);
-            }
-          }
+          uiStartAddr = m_uiStoredStartCUAddrForEncodingSlice[i];
+          uiEndAddr   = m_uiStoredStartCUAddrForEncodingSlice[i+1]-1;
+          m_pcSAO->createSliceMap(i, uiStartAddr, uiEndAddr);
         }
+      }
+    }
 #if !F747_APS
-        m_pcSAO->allocSaoParam(&cSaoParam);      
+    m_pcSAO->allocSaoParam(&cSaoParam);      
 #endif
-      }
+  }
 #endif
 
 #if F747_APS
-      std::vector<AlfCUCtrlInfo> vAlfCUCtrlParam;
+  std::vector<AlfCUCtrlInfo> vAlfCUCtrlParam;
 #else
 #if E045_SLICE_COMMON_INFO_SHARING
-      ALFParam cAlfParam;
+  ALFParam cAlfParam;
 #endif
 #endif
 
 
 #if MTK_NONCROSS_INLOOP_FILTER || E045_SLICE_COMMON_INFO_SHARING
-      pcSlice = pcPic->getSlice(0);
+  pcSlice = pcPic->getSlice(0);
 
-      if(pcSlice->getSPS()->getUseALF())
-      {
+  if(pcSlice->getSPS()->getUseALF())
+  {
 #if F747_APS
-        vAlfCUCtrlParam.resize(uiNumSlices);
+    vAlfCUCtrlParam.resize(uiNumSlices);
 #endif
-        m_pcAdaptiveLoopFilter->setNumSlicesInPic( uiNumSlices );
+    m_pcAdaptiveLoopFilter->setNumSlicesInPic( uiNumSlices );
 #if FINE_GRANULARITY_SLICES
-        m_pcAdaptiveLoopFilter->setSliceGranularityDepth(pcSlice->getPPS()->getSliceGranularity());
+    m_pcAdaptiveLoopFilter->setSliceGranularityDepth(pcSlice->getPPS()->getSliceGranularity());
 #endif
-        if(uiNumSlices == 1)
-        {
-          m_pcAdaptiveLoopFilter->setUseNonCrossAlf(false);
-        }
-        else
-        {
-          m_pcAdaptiveLoopFilter->setUseNonCrossAlf(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag());
-          m_pcAdaptiveLoopFilter->createSlice(pcPic);
+    if(uiNumSlices == 1)
+    {
+      m_pcAdaptiveLoopFilter->setUseNonCrossAlf(false);
+    }
+    else
+    {
+      m_pcAdaptiveLoopFilter->setUseNonCrossAlf(!pcSlice->getSPS()->getLFCrossSliceBoundaryFlag());
+      m_pcAdaptiveLoopFilter->createSlice(pcPic);
 
-          UInt uiStartAddr, uiEndAddr;
+      UInt uiStartAddr, uiEndAddr;
 
-          for(UInt i=0; i< uiNumSlices ; i++)
-          {
+      for(UInt i=0; i< uiNumSlices ; i++)
+      {
 #if FINE_GRANULARITY_SLICES
-            uiStartAddr = m_uiStoredStartCUAddrForEncodingSlice[i];
-            uiEndAddr   = m_uiStoredStartCUAddrForEncodingSlice[i+1]-1;
+        uiStartAddr = m_uiStoredStartCUAddrForEncodingSlice[i];
+        uiEndAddr   = m_uiStoredStartCUAddrForEncodingSlice[i+1]-1;
 #else
-            uiStartAddr = (m_uiStoredStartCUAddrForEncodingSlice[i]* (pcPic->getNumPartInCU()));
-            uiEndAddr   = (m_uiStoredStartCUAddrForEncodingSlice[i+1]*(pcPic->getNumPartInCU()))-1;
+        uiStartAddr = (m_uiStoredStartCUAddrForEncodingSlice[i]* (pcPic->getNumPartInCU()));
+        uiEndAddr   = (m_uiStoredStartCUAddrForEncodingSlice[i+1]*(pcPic->getNumPartInCU()))-1;
 
 #endif
-            (*m_pcAdaptiveLoopFilter)[i].create(i, uiStartAddr, uiEndAddr);
-          }
+        (*m_pcAdaptiveLoopFilter)[i].create(i, uiStartAddr, uiEndAddr);
+      }
 
-        }
+    }
 #if !F747_APS
 #if E045_SLICE_COMMON_INFO_SHARING
-        m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
-        pcSlice->getPPS()->setSharedPPSInfoEnabled(false); //initial value is false.
+    m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
+    pcSlice->getPPS()->setSharedPPSInfoEnabled(false); //initial value is false.
 #endif
 #endif
 
-      }
+  }
 #endif
 
-      /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
-      // Set entropy coder
-      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-
-      /* write various header sets. */
-      if ( m_bSeqFirst )
-      {
-        OutputNALUnit nalu(NAL_UNIT_SPS, NAL_REF_IDC_PRIORITY_HIGHEST);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSPS(pcSlice->getSPS());
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-
-        nalu = NALUnit(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodePPS(pcSlice->getPPS());
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-
-        m_bSeqFirst = false;
-      }
+  /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
+  // Set entropy coder
+  m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
 
-      /* use the main bitstream buffer for storing the marshalled picture */
-      m_pcEntropyCoder->setBitstream(NULL);
+  /* write various header sets. */
+  if ( m_bSeqFirst )
+  {
+    OutputNALUnit nalu(NAL_UNIT_SPS, NAL_REF_IDC_PRIORITY_HIGHEST);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSPS(pcSlice->getSPS());
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+
+    nalu = NALUnit(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodePPS(pcSlice->getPPS());
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+
+    m_bSeqFirst = false;
+  }
 
-      uiStartCUAddrSliceIdx = 0;
-      uiStartCUAddrSlice    = 0; 
+  /* use the main bitstream buffer for storing the marshalled picture */
+  m_pcEntropyCoder->setBitstream(NULL);
 
-      uiStartCUAddrEntropySliceIdx = 0;
-      uiStartCUAddrEntropySlice    = 0; 
-      uiNextCUAddr                 = 0;
-      pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
+  UInt uiStartCUAddrSliceIdx        = 0; // used to index "m_uiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
+  UInt uiStartCUAddrEntropySliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEntropyEncodingSlice" containing locations of slice boundaries
+  UInt uiNextCUAddr                 = 0;
+  pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
 
 #if E045_SLICE_COMMON_INFO_SHARING
 #if !F747_APS
-      UInt uiMaxAlfCtrlDepth = 0;
+  UInt uiMaxAlfCtrlDepth = 0;
 #endif
 #if SAO
-      Int processingState = (pcSlice->getSPS()->getUseALF() || pcSlice->getSPS()->getUseSAO())?(EXECUTE_INLOOPFILTER):(ENCODE_SLICE);
+  Int processingState = (pcSlice->getSPS()->getUseALF() || pcSlice->getSPS()->getUseSAO())?(EXECUTE_INLOOPFILTER):(ENCODE_SLICE);
 #else
-      Int processingState = (pcSlice->getSPS()->getUseALF() )?(EXECUTE_INLOOPFILTER):(ENCODE_SLICE);
+  Int processingState = (pcSlice->getSPS()->getUseALF() )?(EXECUTE_INLOOPFILTER):(ENCODE_SLICE);
 #endif
 #endif
 
 #if F747_APS
-      static Int iCurrAPSIdx = 0;
-      Int iCodedAPSIdx = 0;
-      TComSlice* pcSliceForAPS = NULL;
+  static Int iCurrAPSIdx = 0;
+  Int iCodedAPSIdx = 0;
+  TComSlice* pcSliceForAPS = NULL;
 #endif
 
 #if FINE_GRANULARITY_SLICES
-      bool skippedSlice=false;
-      while (uiNextCUAddr < uiRealEndAddress) // Iterate over all slices
+  bool skippedSlice=false;
+  while (uiNextCUAddr < uiRealEndAddress) // Iterate over all slices
 #else
-      while (uiNextCUAddr < pcPic->getPicSym()->getNumberOfCUsInFrame()) // Iterate over all slices
+  while (uiNextCUAddr < pcPic->getPicSym()->getNumberOfCUsInFrame()) // Iterate over all slices
 #endif
-      {
+  {
 #if E045_SLICE_COMMON_INFO_SHARING
-        switch(processingState)
-        {
-        case ENCODE_SLICE:
-          {
+    switch(processingState)
+    {
+    case ENCODE_SLICE:
+      {
 #endif
-        pcSlice->setNextSlice       ( false );
-        pcSlice->setNextEntropySlice( false );
-        if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx])
-        {
-          pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
-          pcPic->setCurrSliceIdx(uiStartCUAddrSliceIdx);
-          m_pcSliceEncoder->setSliceIdx(uiStartCUAddrSliceIdx);
-          assert(uiStartCUAddrSliceIdx == pcSlice->getSliceIdx());
-          // Reconstruction slice
-          pcSlice->setSliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setSliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx+1 ] );
-          // Entropy slice
-          pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
-
-          pcSlice->setNextSlice       ( true );
-
-          uiStartCUAddrSliceIdx++;
-          uiStartCUAddrEntropySliceIdx++;
-        } 
-        else if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx])
-        {
-          // Entropy slice
-          pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
-          pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
+    pcSlice->setNextSlice       ( false );
+    pcSlice->setNextEntropySlice( false );
+    if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx])
+    {
+      pcSlice = pcPic->getSlice(uiStartCUAddrSliceIdx);
+      pcPic->setCurrSliceIdx(uiStartCUAddrSliceIdx);
+      m_pcSliceEncoder->setSliceIdx(uiStartCUAddrSliceIdx);
+      assert(uiStartCUAddrSliceIdx == pcSlice->getSliceIdx());
+      // Reconstruction slice
+      pcSlice->setSliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setSliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx+1 ] );
+      // Entropy slice
+      pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
+
+      pcSlice->setNextSlice       ( true );
+
+      uiStartCUAddrSliceIdx++;
+      uiStartCUAddrEntropySliceIdx++;
+    } 
+    else if (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx])
+    {
+      // Entropy slice
+      pcSlice->setEntropySliceCurStartCUAddr( uiNextCUAddr );  // to be used in encodeSlice() + context restriction
+      pcSlice->setEntropySliceCurEndCUAddr  ( m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx+1 ] );
 
-          pcSlice->setNextEntropySlice( true );
+      pcSlice->setNextEntropySlice( true );
 
-          uiStartCUAddrEntropySliceIdx++;
-        }
+      uiStartCUAddrEntropySliceIdx++;
+    }
 
 #if FINE_GRANULARITY_SLICES
-        UInt uiDummyStartCUAddr;
-        UInt uiDummyBoundingCUAddr;
-        m_pcSliceEncoder->xDetermineStartAndBoundingCUAddr(uiDummyStartCUAddr,uiDummyBoundingCUAddr,pcPic,true);
+    UInt uiDummyStartCUAddr;
+    UInt uiDummyBoundingCUAddr;
+    m_pcSliceEncoder->xDetermineStartAndBoundingCUAddr(uiDummyStartCUAddr,uiDummyBoundingCUAddr,pcPic,true);
 
 #if TILES
-        uiInternalAddress = pcPic->getPicSym()->getPicSCUAddr(pcSlice->getEntropySliceCurEndCUAddr()-1) % pcPic->getNumPartInCU();
-        uiExternalAddress = pcPic->getPicSym()->getPicSCUAddr(pcSlice->getEntropySliceCurEndCUAddr()-1) / pcPic->getNumPartInCU();
+    uiInternalAddress = pcPic->getPicSym()->getPicSCUAddr(pcSlice->getEntropySliceCurEndCUAddr()-1) % pcPic->getNumPartInCU();
+    uiExternalAddress = pcPic->getPicSym()->getPicSCUAddr(pcSlice->getEntropySliceCurEndCUAddr()-1) / pcPic->getNumPartInCU();
 #else
-        uiInternalAddress = (pcSlice->getEntropySliceCurEndCUAddr()-1) % pcPic->getNumPartInCU();
-        uiExternalAddress = (pcSlice->getEntropySliceCurEndCUAddr()-1) / pcPic->getNumPartInCU();
-#endif
-        uiPosX = ( uiExternalAddress % pcPic->getFrameWidthInCU() ) * g_uiMaxCUWidth+ g_auiRasterToPelX[ g_auiZscanToRaster[uiInternalAddress] ];
-        uiPosY = ( uiExternalAddress / pcPic->getFrameWidthInCU() ) * g_uiMaxCUHeight+ g_auiRasterToPelY[ g_auiZscanToRaster[uiInternalAddress] ];
-        uiWidth = pcSlice->getSPS()->getWidth();
-        uiHeight = pcSlice->getSPS()->getHeight();
-        while(uiPosX>=uiWidth||uiPosY>=uiHeight)
-        {
-          uiInternalAddress--;
-          uiPosX = ( uiExternalAddress % pcPic->getFrameWidthInCU() ) * g_uiMaxCUWidth+ g_auiRasterToPelX[ g_auiZscanToRaster[uiInternalAddress] ];
-          uiPosY = ( uiExternalAddress / pcPic->getFrameWidthInCU() ) * g_uiMaxCUHeight+ g_auiRasterToPelY[ g_auiZscanToRaster[uiInternalAddress] ];
-        }
-        uiInternalAddress++;
-        if(uiInternalAddress==pcPic->getNumPartInCU())
-        {
-          uiInternalAddress = 0;
+    uiInternalAddress = (pcSlice->getEntropySliceCurEndCUAddr()-1) % pcPic->getNumPartInCU();
+    uiExternalAddress = (pcSlice->getEntropySliceCurEndCUAddr()-1) / pcPic->getNumPartInCU();
+#endif
+    uiPosX = ( uiExternalAddress % pcPic->getFrameWidthInCU() ) * g_uiMaxCUWidth+ g_auiRasterToPelX[ g_auiZscanToRaster[uiInternalAddress] ];
+    uiPosY = ( uiExternalAddress / pcPic->getFrameWidthInCU() ) * g_uiMaxCUHeight+ g_auiRasterToPelY[ g_auiZscanToRaster[uiInternalAddress] ];
+    uiWidth = pcSlice->getSPS()->getWidth();
+    uiHeight = pcSlice->getSPS()->getHeight();
+    while(uiPosX>=uiWidth||uiPosY>=uiHeight)
+    {
+      uiInternalAddress--;
+      uiPosX = ( uiExternalAddress % pcPic->getFrameWidthInCU() ) * g_uiMaxCUWidth+ g_auiRasterToPelX[ g_auiZscanToRaster[uiInternalAddress] ];
+      uiPosY = ( uiExternalAddress / pcPic->getFrameWidthInCU() ) * g_uiMaxCUHeight+ g_auiRasterToPelY[ g_auiZscanToRaster[uiInternalAddress] ];
+    }
+    uiInternalAddress++;
+    if(uiInternalAddress==pcPic->getNumPartInCU())
+    {
+      uiInternalAddress = 0;
 #if TILES
-          uiExternalAddress = pcPic->getPicSym()->getCUOrderMap(pcPic->getPicSym()->getInverseCUOrderMap(uiExternalAddress)+1);
+      uiExternalAddress = pcPic->getPicSym()->getCUOrderMap(pcPic->getPicSym()->getInverseCUOrderMap(uiExternalAddress)+1);
 #else
-          uiExternalAddress++;
+      uiExternalAddress++;
 #endif
-        }
+    }
 #if TILES
-        UInt uiEndAddress = pcPic->getPicSym()->getPicSCUEncOrder(uiExternalAddress*pcPic->getNumPartInCU()+uiInternalAddress);
+    UInt uiEndAddress = pcPic->getPicSym()->getPicSCUEncOrder(uiExternalAddress*pcPic->getNumPartInCU()+uiInternalAddress);
 #else
-        UInt uiEndAddress = uiExternalAddress*pcPic->getNumPartInCU()+uiInternalAddress;
-#endif
-        if(uiEndAddress<=pcSlice->getEntropySliceCurStartCUAddr()) {
-          UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
-          uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
-          uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
-          uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
-          if(pcSlice->isNextSlice())
-          {
-            skippedSlice=true;
-          }
-          continue;
-        }
-        if(skippedSlice) 
-        {
-          pcSlice->setNextSlice       ( true );
-          pcSlice->setNextEntropySlice( false );
-        }
-        skippedSlice=false;
+    UInt uiEndAddress = uiExternalAddress*pcPic->getNumPartInCU()+uiInternalAddress;
+#endif
+    if(uiEndAddress<=pcSlice->getEntropySliceCurStartCUAddr()) {
+      UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
+      uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
+      uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
+      uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
+      if(pcSlice->isNextSlice())
+      {
+        skippedSlice=true;
+      }
+      continue;
+    }
+    if(skippedSlice) 
+    {
+      pcSlice->setNextSlice       ( true );
+      pcSlice->setNextEntropySlice( false );
+    }
+    skippedSlice=false;
 #endif
 #if OL_USE_WPP
-        if (pcSlice->getPPS()->getEntropyCodingMode())
-        {
-          pcSlice->allocSubstreamSizes( iNumSubstreams );
-          for ( UInt ui = 0 ; ui < iNumSubstreams; ui++ )
-            pcSubstreamsOut[ui].clear();
-        }
+    if (pcSlice->getPPS()->getEntropyCodingMode())
+    {
+      pcSlice->allocSubstreamSizes( iNumSubstreams );
+      for ( UInt ui = 0 ; ui < iNumSubstreams; ui++ )
+        pcSubstreamsOut[ui].clear();
+    }
 #endif
 
 #if !E045_SLICE_COMMON_INFO_SHARING
-        // Get ready for writing slice header (other than the first one in the picture)
-        if (uiNextCUAddr!=0)
-        {
+    // Get ready for writing slice header (other than the first one in the picture)
+    if (uiNextCUAddr!=0)
+    {
 #endif
-          m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-          m_pcEntropyCoder->resetEntropy      ();
+      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
+      m_pcEntropyCoder->resetEntropy      ();
 #if !E045_SLICE_COMMON_INFO_SHARING
-        }
+    }
 #endif
-        /* start slice NALunit */
-        OutputNALUnit nalu(pcSlice->getNalUnitType(), pcSlice->isReferenced() ? NAL_REF_IDC_PRIORITY_HIGHEST: NAL_REF_IDC_PRIORITY_LOWEST, pcSlice->getTLayer(), true);
+    /* start slice NALunit */
+    OutputNALUnit nalu(pcSlice->getNalUnitType(), pcSlice->isReferenced() ? NAL_REF_IDC_PRIORITY_HIGHEST: NAL_REF_IDC_PRIORITY_LOWEST, pcSlice->getTLayer(), true);
 #if TILES_DECODER
-        Bool bEntropySlice = (!pcSlice->isNextSlice());
-        if (!bEntropySlice)
-        {
-          uiOneBitstreamPerSliceLength = 0; // start of a new slice
-        }
+    Bool bEntropySlice = (!pcSlice->isNextSlice());
+    if (!bEntropySlice)
+    {
+      uiOneBitstreamPerSliceLength = 0; // start of a new slice
+    }
 
-        // used while writing slice header
-        Int iTransmitLWHeader = (m_pcCfg->getTileMarkerFlag()==0) ? 0 : 1;
-        pcSlice->setTileMarkerFlag ( iTransmitLWHeader );
+    // used while writing slice header
+    Int iTransmitLWHeader = (m_pcCfg->getTileMarkerFlag()==0) ? 0 : 1;
+    pcSlice->setTileMarkerFlag ( iTransmitLWHeader );
 #endif
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSliceHeader(pcSlice);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSliceHeader(pcSlice);
 
 
-        // is it needed?
-        if ( pcSlice->getSymbolMode() )
-        {
+    // is it needed?
+    if ( pcSlice->getSymbolMode() )
+    {
 #if TILES_DECODER
-          if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
-          {
-            pcBitstreamRedirect->writeAlignOne();
-          }
-          else
-          {
+      if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
+      {
+        pcBitstreamRedirect->writeAlignOne();
+      }
+      else
+      {
 #if OL_USE_WPP
-          // We've not completed our slice header info yet, do the alignment later.
+      // We've not completed our slice header info yet, do the alignment later.
 #else
-            nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
+        nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
 #endif
-          }
+      }
 #else
 #if OL_USE_WPP
-          // We've not completed our slice header info yet, do the alignment later.
+      // We've not completed our slice header info yet, do the alignment later.
 #else
-          nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
+      nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
 #endif
 #endif
-          m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
-          m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
-          m_pcEntropyCoder->resetEntropy    ();
+      m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
+      m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
+      m_pcEntropyCoder->resetEntropy    ();
 #if OL_USE_WPP
-          for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams() ; ui++ )
-          {
-            m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[ui], pcSlice );
-            m_pcEntropyCoder->resetEntropy    ();
-          }
+      for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams() ; ui++ )
+      {
+        m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[ui], pcSlice );
+        m_pcEntropyCoder->resetEntropy    ();
+      }
 #endif
-        }
+    }
 
 #if E045_SLICE_COMMON_INFO_SHARING
-        if(pcSlice->isNextSlice())
+    if(pcSlice->isNextSlice())
 #else
-        if (uiNextCUAddr==0)  // Compute ALF params and write only for first slice header
+    if (uiNextCUAddr==0)  // Compute ALF params and write only for first slice header
 #endif
-        {
+    {
 #if !E045_SLICE_COMMON_INFO_SHARING
-          // set entropy coder for RD
-          if ( pcSlice->getSymbolMode() )
-          {
-            m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
-          }
-          else
-          {
-            m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
-          }
+      // set entropy coder for RD
+      if ( pcSlice->getSymbolMode() )
+      {
+        m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
+      }
+      else
+      {
+        m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
+      }
 
 #if SAO
-          if ( pcSlice->getSPS()->getUseSAO() )
-          {
-            m_pcEntropyCoder->resetEntropy();
-            m_pcEntropyCoder->setBitstream( m_pcBitCounter );
-            m_pcSAO->startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
+      if ( pcSlice->getSPS()->getUseSAO() )
+      {
+        m_pcEntropyCoder->resetEntropy();
+        m_pcEntropyCoder->setBitstream( m_pcBitCounter );
+        m_pcSAO->startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
 #if SAO_CHROMA_LAMBDA 
-            m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma());
+        m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma());
 #else
 #if ALF_CHROMA_LAMBDA
-            m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambdaLuma());
+        m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambdaLuma());
 #else
-            m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambda());
+        m_pcSAO->SAOProcess(pcPic->getSlice(0)->getLambda());
 #endif
 #endif
-            m_pcSAO->endSaoEnc();
+        m_pcSAO->endSaoEnc();
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-            m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
+        m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
 #endif
-          }
+      }
 
 #endif
-          // adaptive loop filter
-          ALFParam cAlfParam;
-          UInt uiMaxAlfCtrlDepth;
-          UInt64 uiDist, uiBits;
+      // adaptive loop filter
+      ALFParam cAlfParam;
+      UInt uiMaxAlfCtrlDepth;
+      UInt64 uiDist, uiBits;
 
-          if ( pcSlice->getSPS()->getUseALF())
-          {
-            m_pcEntropyCoder->resetEntropy    ();
-            m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
-            m_pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
-            m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
-            m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
+      if ( pcSlice->getSPS()->getUseALF())
+      {
+        m_pcEntropyCoder->resetEntropy    ();
+        m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
+        m_pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
+        m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
+        m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
 #if ALF_CHROMA_LAMBDA 
-            m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+        m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #else
 #if SAO_CHROMA_LAMBDA 
-            m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+        m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #else
-            m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+        m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #endif
 #endif
-            m_pcAdaptiveLoopFilter->endALFEnc();
+        m_pcAdaptiveLoopFilter->endALFEnc();
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-            m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
+        m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
 #endif
-          }
+      }
 #endif
-          // set entropy coder for writing
-          m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
-          if ( pcSlice->getSymbolMode() )
-          {
+      // set entropy coder for writing
+      m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
+      if ( pcSlice->getSymbolMode() )
+      {
 #if OL_USE_WPP
-            for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams() ; ui++ )
-            {
-              m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[ui], pcSlice );
-              m_pcEntropyCoder->resetEntropy    ();
-            }
-            pcSbacCoders[0].load(m_pcSbacCoder);
-            m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[0], pcSlice );  //ALF is written in substream #0 with CABAC coder #0 (see ALF param encoding below)
+        for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams() ; ui++ )
+        {
+          m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[ui], pcSlice );
+          m_pcEntropyCoder->resetEntropy    ();
+        }
+        pcSbacCoders[0].load(m_pcSbacCoder);
+        m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[0], pcSlice );  //ALF is written in substream #0 with CABAC coder #0 (see ALF param encoding below)
 #else
-            m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
+        m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
 #endif
-          }
-          else
-          {
-            m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
-          }
-          m_pcEntropyCoder->resetEntropy    ();
+      }
+      else
+      {
+        m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
+      }
+      m_pcEntropyCoder->resetEntropy    ();
 #if TILES_DECODER
-          // File writing
-          if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
-          {
-            m_pcEntropyCoder->setBitstream(pcBitstreamRedirect);
-          }
-          else
-          {
-            m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-          }
+      // File writing
+      if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
+      {
+        m_pcEntropyCoder->setBitstream(pcBitstreamRedirect);
+      }
+      else
+      {
+        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      }
 #else
 #if OL_USE_WPP
-          if (pcSlice->getSymbolMode())
-            m_pcEntropyCoder->setBitstream    ( &pcSubstreamsOut[0] );
-          else
-            m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      if (pcSlice->getSymbolMode())
+        m_pcEntropyCoder->setBitstream    ( &pcSubstreamsOut[0] );
+      else
+        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
 #else
-          m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
 #endif
 #endif
 #if OL_USE_WPP
-          // for now, override the TILES_DECODER setting in order to write substreams.
-          if (pcSlice->getSymbolMode())
-            m_pcEntropyCoder->setBitstream    ( &pcSubstreamsOut[0] );
+      // for now, override the TILES_DECODER setting in order to write substreams.
+      if (pcSlice->getSymbolMode())
+        m_pcEntropyCoder->setBitstream    ( &pcSubstreamsOut[0] );
 #endif
 
 #if !F747_APS
 #if E045_SLICE_COMMON_INFO_SHARING
-          if(uiNextCUAddr == 0) //SAO parameters are in the first slice header
-          {
+      if(uiNextCUAddr == 0) //SAO parameters are in the first slice header
+      {
 #endif
 #if SAO
-          if (pcSlice->getSPS()->getUseSAO())
-          {
-            m_pcEntropyCoder->encodeSaoParam(&cSaoParam);
-          }
+      if (pcSlice->getSPS()->getUseSAO())
+      {
+        m_pcEntropyCoder->encodeSaoParam(&cSaoParam);
+      }
 #endif
 #if E045_SLICE_COMMON_INFO_SHARING
-          }
+      }
 #endif
 #endif
-          if (pcSlice->getSPS()->getUseALF())
-          {
+      if (pcSlice->getSPS()->getUseALF())
+      {
 #if F747_APS
-            if(pcSlice->getAPS()->getAlfEnabled())
+        if(pcSlice->getAPS()->getAlfEnabled())
+        {
+          AlfCUCtrlInfo& cAlfCUCtrlParam = vAlfCUCtrlParam[pcSlice->getSliceIdx()];
+          if(cAlfCUCtrlParam.cu_control_flag)
+          {
+            m_pcEntropyCoder->setAlfCtrl( true );
+            m_pcEntropyCoder->setMaxAlfCtrlDepth(cAlfCUCtrlParam.alf_max_depth);
+            if (pcSlice->getSymbolMode() == 0)
             {
-              AlfCUCtrlInfo& cAlfCUCtrlParam = vAlfCUCtrlParam[pcSlice->getSliceIdx()];
-              if(cAlfCUCtrlParam.cu_control_flag)
-              {
-                m_pcEntropyCoder->setAlfCtrl( true );
-                m_pcEntropyCoder->setMaxAlfCtrlDepth(cAlfCUCtrlParam.alf_max_depth);
-                if (pcSlice->getSymbolMode() == 0)
-                {
-                  m_pcCavlcCoder->setAlfCtrl(true);
-                  m_pcCavlcCoder->setMaxAlfCtrlDepth(cAlfCUCtrlParam.alf_max_depth); 
-                }
-              }
-              else
-              {
-                m_pcEntropyCoder->setAlfCtrl(false);
-              }
-              m_pcEntropyCoder->encodeAlfCtrlParam(cAlfCUCtrlParam, m_pcAdaptiveLoopFilter->getNumCUsInPic());
+              m_pcCavlcCoder->setAlfCtrl(true);
+              m_pcCavlcCoder->setMaxAlfCtrlDepth(cAlfCUCtrlParam.alf_max_depth); 
+            }
+          }
+          else
+          {
+            m_pcEntropyCoder->setAlfCtrl(false);
+          }
+          m_pcEntropyCoder->encodeAlfCtrlParam(cAlfCUCtrlParam, m_pcAdaptiveLoopFilter->getNumCUsInPic());
 #if F747_CABAC_FLUSH_SLICE_HEADER
-              if (pcSlice->getSymbolMode())
-              {
-                m_pcEntropyCoder->encodeFinish(0);
+          if (pcSlice->getSymbolMode())
+          {
+            m_pcEntropyCoder->encodeFinish(0);
 #if OL_USE_WPP
-                pcSubstreamsOut[0].writeAlignOne();// for now, override the TILES_DECODER setting in order to write substreams (as done above).
+            pcSubstreamsOut[0].writeAlignOne();// for now, override the TILES_DECODER setting in order to write substreams (as done above).
 #else           
-                     
+                 
 #if TILES_DECODER
-                if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
-                {
-                  pcBitstreamRedirect->writeAlignOne();
-                }
-                else
-                {
-                  nalu.m_Bitstream.writeAlignOne();
-                }                
+            if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
+            {
+              pcBitstreamRedirect->writeAlignOne();
+            }
+            else
+            {
+              nalu.m_Bitstream.writeAlignOne();
+            }                
 #else
-                nalu.m_Bitstream.writeAlignOne();
+            nalu.m_Bitstream.writeAlignOne();
 #endif
-                
+            
 #endif
-                m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
+            m_pcSbacCoder->init( (TEncBinIf*)m_pcBinCABAC );
 #if OL_USE_WPP
-                m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[0], pcSlice );
+            m_pcEntropyCoder->setEntropyCoder ( &pcSbacCoders[0], pcSlice );
 #else
-                m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
+            m_pcEntropyCoder->setEntropyCoder ( m_pcSbacCoder, pcSlice );
 #endif                                
-                m_pcEntropyCoder->resetEntropy    ();
-              }
+            m_pcEntropyCoder->resetEntropy    ();
+          }
 #endif              
-            }
+        }
 #else
-            if (cAlfParam.cu_control_flag)
-            {
-              m_pcEntropyCoder->setAlfCtrl( true );
-              m_pcEntropyCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth);
-              if (pcSlice->getSymbolMode() == 0)
-              {
-                m_pcCavlcCoder->setAlfCtrl(true);
-                m_pcCavlcCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth); //D0201
-              }
-            }
-            else
-            {
-              m_pcEntropyCoder->setAlfCtrl(false);
-            }
+        if (cAlfParam.cu_control_flag)
+        {
+          m_pcEntropyCoder->setAlfCtrl( true );
+          m_pcEntropyCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth);
+          if (pcSlice->getSymbolMode() == 0)
+          {
+            m_pcCavlcCoder->setAlfCtrl(true);
+            m_pcCavlcCoder->setMaxAlfCtrlDepth(uiMaxAlfCtrlDepth); //D0201
+          }
+        }
+        else
+        {
+          m_pcEntropyCoder->setAlfCtrl(false);
+        }
 #if E045_SLICE_COMMON_INFO_SHARING
-            if(!pcSlice->getPPS()->getSharedPPSInfoEnabled())
-            {
+        if(!pcSlice->getPPS()->getSharedPPSInfoEnabled())
+        {
 #endif
-            m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
+        m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
 #if E045_SLICE_COMMON_INFO_SHARING
-            }
+        }
 #endif
 
 #if E045_SLICE_COMMON_INFO_SHARING
-            if(uiNumSlices == 1)
-            {
-              m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
-            }
-            else
-            {
-              m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam, m_pcAdaptiveLoopFilter->getNumSlicesInPic(), &((*m_pcAdaptiveLoopFilter)[pcPic->getCurrSliceIdx()]));
-            }
+        if(uiNumSlices == 1)
+        {
+          m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
+        }
+        else
+        {
+          m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam, m_pcAdaptiveLoopFilter->getNumSlicesInPic(), &((*m_pcAdaptiveLoopFilter)[pcPic->getCurrSliceIdx()]));
+        }
 #else
-            if(cAlfParam.cu_control_flag)
-            {
+        if(cAlfParam.cu_control_flag)
+        {
 #if FINE_GRANULARITY_SLICES && MTK_NONCROSS_INLOOP_FILTER
-              m_pcEntropyCoder->setSliceGranularity(pcSlice->getPPS()->getSliceGranularity());
+          m_pcEntropyCoder->setSliceGranularity(pcSlice->getPPS()->getSliceGranularity());
 #endif
-              m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
-            }
-            m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
+          m_pcEntropyCoder->encodeAlfCtrlParam(&cAlfParam);
+        }
+        m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
 #endif
 #endif
-          }
-        }
+      }
+    }
 #if FINE_GRANULARITY_SLICES
-        pcSlice->setFinalized(true);
+    pcSlice->setFinalized(true);
 #endif
 
 #if OL_USE_WPP
-        if (pcSlice->getSymbolMode())
-          m_pcSbacCoder->load( &pcSbacCoders[0] );
+    if (pcSlice->getSymbolMode())
+      m_pcSbacCoder->load( &pcSbacCoders[0] );
 #endif
 
 #if TILES_DECODER
-        pcSlice->setTileOffstForMultES( uiOneBitstreamPerSliceLength );
-        if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
-        {
-          pcSlice->setTileLocationCount ( 0 );
+    pcSlice->setTileOffstForMultES( uiOneBitstreamPerSliceLength );
+    if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr()  && !bEntropySlice)
+    {
+      pcSlice->setTileLocationCount ( 0 );
 #if OL_USE_WPP
-          m_pcSliceEncoder->encodeSlice(pcPic, pcBitstreamRedirect, pcSubstreamsOut); // redirect is only used for CAVLC tile position info.
+      m_pcSliceEncoder->encodeSlice(pcPic, pcBitstreamRedirect, pcSubstreamsOut); // redirect is only used for CAVLC tile position info.
 #else
-          m_pcSliceEncoder->encodeSlice(pcPic, pcBitstreamRedirect);          
+      m_pcSliceEncoder->encodeSlice(pcPic, pcBitstreamRedirect);          
 #endif
-        }
-        else
-        {
+    }
+    else
+    {
 #if OL_USE_WPP
-          m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream, pcSubstreamsOut); // nalu.m_Bitstream is only used for CAVLC tile position info.
+      m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream, pcSubstreamsOut); // nalu.m_Bitstream is only used for CAVLC tile position info.
 #else
-          m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
+      m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
 #endif
-        }
+    }
 #else // !TILES_DECODER
 #if OL_USE_WPP
-        m_pcSliceEncoder->encodeSlice(pcPic, pcSubstreamsOut);
+    m_pcSliceEncoder->encodeSlice(pcPic, pcSubstreamsOut);
 #else
-        m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
+    m_pcSliceEncoder->encodeSlice(pcPic, &nalu.m_Bitstream);
 #endif // OL_USE_WPP
 #endif // TILES_DECODER
 
 #if OL_USE_WPP
-        if ( pcSlice->getSymbolMode() )
-        {
-          // Construct the final bitstream by flushing and concatenating substreams.
-          // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
-          UInt* puiSubstreamSizes = pcSlice->getSubstreamSizes();
+    if ( pcSlice->getSymbolMode() )
+    {
+      // Construct the final bitstream by flushing and concatenating substreams.
+      // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
+      UInt* puiSubstreamSizes = pcSlice->getSubstreamSizes();
 #if TILES_DECODER
-          UInt uiTotalCodedSize = 0; // for padding calcs.
-          UInt uiNumSubstreamsPerTile = iNumSubstreams;
-          if (pcPic->getPicSym()->getTileBoundaryIndependenceIdr() && pcSlice->getPPS()->getEntropyCodingSynchro())
-            uiNumSubstreamsPerTile /= pcPic->getPicSym()->getNumTiles();
+      UInt uiTotalCodedSize = 0; // for padding calcs.
+      UInt uiNumSubstreamsPerTile = iNumSubstreams;
+      if (pcPic->getPicSym()->getTileBoundaryIndependenceIdr() && pcSlice->getPPS()->getEntropyCodingSynchro())
+        uiNumSubstreamsPerTile /= pcPic->getPicSym()->getNumTiles();
 #endif
-          for ( UInt ui = 0 ; ui < iNumSubstreams; ui++ )
-          {
-            // Flush all substreams -- this includes empty ones.
-            // Terminating bit and flush.
-            m_pcEntropyCoder->setEntropyCoder   ( &pcSbacCoders[ui], pcSlice );
-            m_pcEntropyCoder->setBitstream      (  &pcSubstreamsOut[ui] );
-            m_pcEntropyCoder->encodeTerminatingBit( 1 );
-            m_pcEntropyCoder->encodeSliceFinish();
-            pcSubstreamsOut[ui].write( 1, 1 ); // stop bit.
+      for ( UInt ui = 0 ; ui < iNumSubstreams; ui++ )
+      {
+        // Flush all substreams -- this includes empty ones.
+        // Terminating bit and flush.
+        m_pcEntropyCoder->setEntropyCoder   ( &pcSbacCoders[ui], pcSlice );
+        m_pcEntropyCoder->setBitstream      (  &pcSubstreamsOut[ui] );
+        m_pcEntropyCoder->encodeTerminatingBit( 1 );
+        m_pcEntropyCoder->encodeSliceFinish();
+        pcSubstreamsOut[ui].write( 1, 1 ); // stop bit.
 #if TILES
-            // Byte alignment is necessary between tiles when tiles are independent.
-            uiTotalCodedSize += pcSubstreamsOut[ui].getNumberOfWrittenBits();
+        // Byte alignment is necessary between tiles when tiles are independent.
+        uiTotalCodedSize += pcSubstreamsOut[ui].getNumberOfWrittenBits();
 
-            if (pcPic->getPicSym()->getTileBoundaryIndependenceIdr())
+        if (pcPic->getPicSym()->getTileBoundaryIndependenceIdr())
+        {
+          Bool bNextSubstreamInNewTile = ((ui+1) < iNumSubstreams)
+                                         && ((ui+1)%uiNumSubstreamsPerTile == 0);
+          if (bNextSubstreamInNewTile)
+          {
+            // byte align.
+            while (uiTotalCodedSize&0x7)
             {
-              Bool bNextSubstreamInNewTile = ((ui+1) < iNumSubstreams)
-                                             && ((ui+1)%uiNumSubstreamsPerTile == 0);
-              if (bNextSubstreamInNewTile)
-              {
-                // byte align.
-                while (uiTotalCodedSize&0x7)
-                {
-                  pcSubstreamsOut[ui].write(0, 1);
-                  uiTotalCodedSize++;
-                }
-              }
+              pcSubstreamsOut[ui].write(0, 1);
+              uiTotalCodedSize++;
+            }
+          }
 #if TILES_DECODER
-              Bool bRecordOffsetNext = m_pcCfg->getTileLocationInSliceHeaderFlag()
-                                            && bNextSubstreamInNewTile;
-              if (bRecordOffsetNext)
-                pcSlice->setTileLocation(ui/uiNumSubstreamsPerTile, pcSlice->getTileOffstForMultES()+(uiTotalCodedSize>>3));
+          Bool bRecordOffsetNext = m_pcCfg->getTileLocationInSliceHeaderFlag()
+                                        && bNextSubstreamInNewTile;
+          if (bRecordOffsetNext)
+            pcSlice->setTileLocation(ui/uiNumSubstreamsPerTile, pcSlice->getTileOffstForMultES()+(uiTotalCodedSize>>3));
 #endif
-            }
+        }
 #endif
-            if (ui+1 < pcSlice->getPPS()->getNumSubstreams())
-              puiSubstreamSizes[ui] = pcSubstreamsOut[ui].getNumberOfWrittenBits();
-          }
+        if (ui+1 < pcSlice->getPPS()->getNumSubstreams())
+          puiSubstreamSizes[ui] = pcSubstreamsOut[ui].getNumberOfWrittenBits();
+      }
 
-          // Complete the slice header info.
-          m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-          m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-          m_pcEntropyCoder->encodeSliceHeaderSubstreamTable(pcSlice);
+      // Complete the slice header info.
+      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
+      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      m_pcEntropyCoder->encodeSliceHeaderSubstreamTable(pcSlice);
 
-          // Substreams...
+      // Substreams...
 #if TILES_DECODER
-          TComOutputBitstream *pcOut = pcBitstreamRedirect;
-          // xWriteTileLocation will perform byte-alignment...
-          if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr())
-          {
-            if (bEntropySlice)
-            {
-              // In these cases, padding is necessary here.
-              pcOut = &nalu.m_Bitstream;
-              pcOut->writeAlignOne();
-            }
-          }
+      TComOutputBitstream *pcOut = pcBitstreamRedirect;
+      // xWriteTileLocation will perform byte-alignment...
+      if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr())
+      {
+        if (bEntropySlice)
+        {
+          // In these cases, padding is necessary here.
+          pcOut = &nalu.m_Bitstream;
+          pcOut->writeAlignOne();
+        }
+      }
 #else
-          TComOutputBitstream *pcOut = &nalu.m_Bitstream;
-          nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
+      TComOutputBitstream *pcOut = &nalu.m_Bitstream;
+      nalu.m_Bitstream.writeAlignOne(); // Byte-alignment before CABAC data
 #endif
 #if TILES_DECODER
-          UInt uiAccumulatedLength = 0;
+      UInt uiAccumulatedLength = 0;
 #endif
-          for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams(); ui++ )
-          {
-            pcOut->addSubstream(&pcSubstreamsOut[ui]);
+      for ( UInt ui = 0 ; ui < pcSlice->getPPS()->getNumSubstreams(); ui++ )
+      {
+        pcOut->addSubstream(&pcSubstreamsOut[ui]);
 
 #if TILES_DECODER
-            // Update tile marker location information
-            for (Int uiMrkIdx = 0; uiMrkIdx < pcSubstreamsOut[ui].getTileMarkerLocationCount(); uiMrkIdx++)
-            {
-              UInt uiBottom = pcOut->getTileMarkerLocationCount();
-              pcOut->setTileMarkerLocation      ( uiBottom, uiAccumulatedLength + pcSubstreamsOut[ui].getTileMarkerLocation( uiMrkIdx ) );
-              pcOut->setTileMarkerLocationCount ( uiBottom + 1 );
-            }
-            uiAccumulatedLength = (pcOut->getNumberOfWrittenBits() >> 3);
-#endif
-          }
+        // Update tile marker location information
+        for (Int uiMrkIdx = 0; uiMrkIdx < pcSubstreamsOut[ui].getTileMarkerLocationCount(); uiMrkIdx++)
+        {
+          UInt uiBottom = pcOut->getTileMarkerLocationCount();
+          pcOut->setTileMarkerLocation      ( uiBottom, uiAccumulatedLength + pcSubstreamsOut[ui].getTileMarkerLocation( uiMrkIdx ) );
+          pcOut->setTileMarkerLocationCount ( uiBottom + 1 );
         }
+        uiAccumulatedLength = (pcOut->getNumberOfWrittenBits() >> 3);
+#endif
+      }
+    }
 
 #endif // OL_USE_WPP
 
 #if TILES_DECODER
-        UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
-        uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
-        uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
-        uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
-        Bool bNextCUInNewSlice     = (uiNextCUAddr >= uiRealEndAddress) || (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx]);
-
-        // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple entropy slices) then buffer it.
-        // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
-        Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
-        if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr())
+    UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
+    uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
+    uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
+    uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
+    Bool bNextCUInNewSlice     = (uiNextCUAddr >= uiRealEndAddress) || (uiNextCUAddr == m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx]);
+
+    // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple entropy slices) then buffer it.
+    // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
+    Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
+    if (pcSlice->getSPS()->getTileBoundaryIndependenceIdr())
+    {
+      if (bNextCUInNewSlice)
+      {
+        if (!bEntropySlice) // there were no entropy slices
+        {
+          xWriteTileLocationToSliceHeader(nalu, pcBitstreamRedirect, pcSlice);
+        }
+        // (a) writing current NALU
+        writeRBSPTrailingBits(nalu.m_Bitstream);
+        accessUnit.push_back(new NALUnitEBSP(nalu));
+        bNALUAlignedWrittenToList = true;
+
+        // (b) update and write buffered NALU
+        if (bEntropySlice) // if entropy slices existed in the slice then perform concatenation for the buffered nalu-bitstream and buffered payload bitstream
         {
-          if (bNextCUInNewSlice)
+          // Perform bitstream concatenation of slice header and partial slice payload
+          xWriteTileLocationToSliceHeader((*naluBuffered), pcBitstreamRedirect, pcSlice);
+          if (bIteratorAtListStart)
           {
-            if (!bEntropySlice) // there were no entropy slices
-            {
-              xWriteTileLocationToSliceHeader(nalu, pcBitstreamRedirect, pcSlice);
-            }
-            // (a) writing current NALU
-            writeRBSPTrailingBits(nalu.m_Bitstream);
-            accessUnit.push_back(new NALUnitEBSP(nalu));
-            bNALUAlignedWrittenToList = true;
+            itLocationToPushSliceHeaderNALU = accessUnit.begin();
+          }
+          else
+          {
+            itLocationToPushSliceHeaderNALU++;
+          }
+          accessUnit.insert(itLocationToPushSliceHeaderNALU, (new NALUnitEBSP((*naluBuffered))) );
 
-            // (b) update and write buffered NALU
-            if (bEntropySlice) // if entropy slices existed in the slice then perform concatenation for the buffered nalu-bitstream and buffered payload bitstream
-            {
-              // Perform bitstream concatenation of slice header and partial slice payload
-              xWriteTileLocationToSliceHeader((*naluBuffered), pcBitstreamRedirect, pcSlice);
-              if (bIteratorAtListStart)
-              {
-                itLocationToPushSliceHeaderNALU = accessUnit.begin();
-              }
-              else
-              {
-                itLocationToPushSliceHeaderNALU++;
-              }
-              accessUnit.insert(itLocationToPushSliceHeaderNALU, (new NALUnitEBSP((*naluBuffered))) );
-
-              // free buffered nalu
-              delete naluBuffered;
-              naluBuffered     = NULL;
-            }
+          // free buffered nalu
+          delete naluBuffered;
+          naluBuffered     = NULL;
+        }
+      }
+      else // another entropy slice exists
+      {
+        // Is this start-of-slice NALU? i.e. the one containing slice header. If Yes, then buffer it.
+        if (!bEntropySlice)
+        {
+          // store a pointer to where NALU for slice header is to be written in NALU list
+          itLocationToPushSliceHeaderNALU = accessUnit.end();
+          if (accessUnit.begin() == accessUnit.end())
+          {
+            bIteratorAtListStart = true;
           }
-          else // another entropy slice exists
+          else
           {
-            // Is this start-of-slice NALU? i.e. the one containing slice header. If Yes, then buffer it.
-            if (!bEntropySlice)
-            {
-              // store a pointer to where NALU for slice header is to be written in NALU list
-              itLocationToPushSliceHeaderNALU = accessUnit.end();
-              if (accessUnit.begin() == accessUnit.end())
-              {
-                bIteratorAtListStart = true;
-              }
-              else
-              {
-                bIteratorAtListStart = false;
-                itLocationToPushSliceHeaderNALU--;
-              }
-
-              // buffer nalu for later writing
-              naluBuffered = new OutputNALUnit(pcSlice->getNalUnitType(), pcSlice->isReferenced() ? NAL_REF_IDC_PRIORITY_HIGHEST: NAL_REF_IDC_PRIORITY_LOWEST, pcSlice->getTLayer(), true);
-              copyNaluData( (*naluBuffered), nalu );
-
-              // perform byte-alignment to get appropriate bitstream length (used for explicit tile location signaling in slice header)
-              writeRBSPTrailingBits((*pcBitstreamRedirect));
-              bNALUAlignedWrittenToList = true; // This is not really a write to bitsream but buffered for later. The flag is set to prevent writing of current NALU to list.
-              uiOneBitstreamPerSliceLength += pcBitstreamRedirect->getNumberOfWrittenBits(); // length of bitstream after byte-alignment
-            }
-            else // write out entropy slice
-            {
-              writeRBSPTrailingBits(nalu.m_Bitstream);
-              accessUnit.push_back(new NALUnitEBSP(nalu));
-              bNALUAlignedWrittenToList = true; 
-              uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits(); // length of bitstream after byte-alignment
-            }
+            bIteratorAtListStart = false;
+            itLocationToPushSliceHeaderNALU--;
           }
+
+          // buffer nalu for later writing
+          naluBuffered = new OutputNALUnit(pcSlice->getNalUnitType(), pcSlice->isReferenced() ? NAL_REF_IDC_PRIORITY_HIGHEST: NAL_REF_IDC_PRIORITY_LOWEST, pcSlice->getTLayer(), true);
+          copyNaluData( (*naluBuffered), nalu );
+
+          // perform byte-alignment to get appropriate bitstream length (used for explicit tile location signaling in slice header)
+          writeRBSPTrailingBits((*pcBitstreamRedirect));
+          bNALUAlignedWrittenToList = true; // This is not really a write to bitsream but buffered for later. The flag is set to prevent writing of current NALU to list.
+          uiOneBitstreamPerSliceLength += pcBitstreamRedirect->getNumberOfWrittenBits(); // length of bitstream after byte-alignment
         }
-#if OL_USE_WPP
-        else
+        else // write out entropy slice
         {
-          xWriteTileLocationToSliceHeader(nalu, pcBitstreamRedirect, pcSlice);
           writeRBSPTrailingBits(nalu.m_Bitstream);
           accessUnit.push_back(new NALUnitEBSP(nalu));
           bNALUAlignedWrittenToList = true; 
           uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits(); // length of bitstream after byte-alignment
         }
+      }
+    }
+#if OL_USE_WPP
+    else
+    {
+      xWriteTileLocationToSliceHeader(nalu, pcBitstreamRedirect, pcSlice);
+      writeRBSPTrailingBits(nalu.m_Bitstream);
+      accessUnit.push_back(new NALUnitEBSP(nalu));
+      bNALUAlignedWrittenToList = true; 
+      uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits(); // length of bitstream after byte-alignment
+    }
 #endif
 #endif
 
 #if TILES_DECODER
-        if (!bNALUAlignedWrittenToList)
-        {
+    if (!bNALUAlignedWrittenToList)
+    {
 #endif
 #if OL_USE_WPP
-        if (pcSlice->getSymbolMode())
-          nalu.m_Bitstream.writeAlignZero();
-        else
-          writeRBSPTrailingBits(nalu.m_Bitstream);
+    if (pcSlice->getSymbolMode())
+      nalu.m_Bitstream.writeAlignZero();
+    else
+      writeRBSPTrailingBits(nalu.m_Bitstream);
 #else
-        writeRBSPTrailingBits(nalu.m_Bitstream);
+    writeRBSPTrailingBits(nalu.m_Bitstream);
 #endif
-        accessUnit.push_back(new NALUnitEBSP(nalu));
+    accessUnit.push_back(new NALUnitEBSP(nalu));
 #if TILES_DECODER
-        uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits() + 24; // length of bitstream after byte-alignment + 3 byte startcode 0x000001
-        }
+    uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits() + 24; // length of bitstream after byte-alignment + 3 byte startcode 0x000001
+    }
 #endif
 
 
 #if !TILES_DECODER
-        UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
-        uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
-        uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
-        uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
+    UInt uiBoundingAddrSlice, uiBoundingAddrEntropySlice;
+    uiBoundingAddrSlice        = m_uiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx];          
+    uiBoundingAddrEntropySlice = m_uiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx];          
+    uiNextCUAddr               = min(uiBoundingAddrSlice, uiBoundingAddrEntropySlice);
 #endif
 #if E045_SLICE_COMMON_INFO_SHARING
-        processingState = ENCODE_SLICE;
-          }
-          break;
-        case EXECUTE_INLOOPFILTER:
-          {
+    processingState = ENCODE_SLICE;
+      }
+      break;
+    case EXECUTE_INLOOPFILTER:
+      {
 #if !F747_APS
-            pcSlice->getPPS()->setSharedPPSInfoEnabled(  (m_pcCfg->getSliceMode() == 0)?(false):( pcSlice->getSPS()->getUseALF() )  );
+        pcSlice->getPPS()->setSharedPPSInfoEnabled(  (m_pcCfg->getSliceMode() == 0)?(false):( pcSlice->getSPS()->getUseALF() )  );
 #endif
 #if F747_APS
-            TComAPS cAPS;
-            allocAPS(&cAPS, pcSlice->getSPS());
+        TComAPS cAPS;
+        allocAPS(&cAPS, pcSlice->getSPS());
 #endif
-            // set entropy coder for RD
-            if ( pcSlice->getSymbolMode() )
-            {
-              m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
-            }
-            else
-            {
-              m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
-            }
+        // set entropy coder for RD
+        if ( pcSlice->getSymbolMode() )
+        {
+          m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
+        }
+        else
+        {
+          m_pcEntropyCoder->setEntropyCoder ( m_pcCavlcCoder, pcSlice );
+        }
 
 #if SAO
-            if ( pcSlice->getSPS()->getUseSAO() )
-            {
-              m_pcEntropyCoder->resetEntropy();
-              m_pcEntropyCoder->setBitstream( m_pcBitCounter );
-              m_pcSAO->startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
+        if ( pcSlice->getSPS()->getUseSAO() )
+        {
+          m_pcEntropyCoder->resetEntropy();
+          m_pcEntropyCoder->setBitstream( m_pcBitCounter );
+          m_pcSAO->startSaoEnc(pcPic, m_pcEntropyCoder, m_pcEncTop->getRDSbacCoder(), m_pcCfg->getUseSBACRD() ?  m_pcEncTop->getRDGoOnSbacCoder() : NULL);
 #if F747_APS
-              SAOParam& cSaoParam = *(cAPS.getSaoParam());
+          SAOParam& cSaoParam = *(cAPS.getSaoParam());
 #endif
 
 #if SAO_CHROMA_LAMBDA 
-              m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma());
+          m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma());
 #else
 #if ALF_CHROMA_LAMBDA
-              m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambdaLuma());
+          m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambdaLuma());
 #else
-              m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambda());
+          m_pcSAO->SAOProcess(&cSaoParam, pcPic->getSlice(0)->getLambda());
 #endif
 #endif
-              m_pcSAO->endSaoEnc();
+          m_pcSAO->endSaoEnc();
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-              m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
+          m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
 #endif
-            }
+        }
 
 #endif
-            // adaptive loop filter
-            UInt64 uiDist, uiBits;
-            if ( pcSlice->getSPS()->getUseALF())
-            {
+        // adaptive loop filter
+        UInt64 uiDist, uiBits;
+        if ( pcSlice->getSPS()->getUseALF())
+        {
 #if !F747_APS
-              m_pcAdaptiveLoopFilter->setSharedPPSAlfParamEnabled( pcSlice->getPPS()->getSharedPPSInfoEnabled() );
+          m_pcAdaptiveLoopFilter->setSharedPPSAlfParamEnabled( pcSlice->getPPS()->getSharedPPSInfoEnabled() );
 #endif
-              m_pcEntropyCoder->resetEntropy    ();
-              m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
-              m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
+          m_pcEntropyCoder->resetEntropy    ();
+          m_pcEntropyCoder->setBitstream    ( m_pcBitCounter );
+          m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
 
 #if F747_APS
-              ALFParam& cAlfParam = *( cAPS.getAlfParam());
+          ALFParam& cAlfParam = *( cAPS.getAlfParam());
 #endif
 
 #if ALF_CHROMA_LAMBDA 
 
 #if F747_APS
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits);
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits);
 #else
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), pcPic->getSlice(0)->getLambdaChroma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #endif
 
 #else
 #if SAO_CHROMA_LAMBDA 
 
 #if F747_APS
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits);
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits);
 #else
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdaLuma(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #endif
 
 #else
 
 #if F747_APS
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits);
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, &vAlfCUCtrlParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits);
 #else
-              m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth );
+          m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambda(), uiDist, uiBits, uiMaxAlfCtrlDepth );
 #endif
 
 #endif
 #endif
-              m_pcAdaptiveLoopFilter->endALFEnc();
+          m_pcAdaptiveLoopFilter->endALFEnc();
 
 #if E057_INTRA_PCM && E192_SPS_PCM_FILTER_DISABLE_SYNTAX
-              m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
+          m_pcAdaptiveLoopFilter->PCMLFDisableProcess(pcPic);
 #endif
-            }
+        }
 #if F747_APS
-            iCodedAPSIdx = iCurrAPSIdx;  
-            pcSliceForAPS = pcSlice;
+        iCodedAPSIdx = iCurrAPSIdx;  
+        pcSliceForAPS = pcSlice;
 
-            assignNewAPS(cAPS, iCodedAPSIdx, vAPS, pcSliceForAPS);
-            iCurrAPSIdx = (iCurrAPSIdx +1)%MAX_NUM_SUPPORTED_APS;
-            processingState = ENCODE_APS;
+        assignNewAPS(cAPS, iCodedAPSIdx, vAPS, pcSliceForAPS);
+        iCurrAPSIdx = (iCurrAPSIdx +1)%MAX_NUM_SUPPORTED_APS;
+        processingState = ENCODE_APS;
 
-            //set APS link to the slices
-            for(Int s=0; s< uiNumSlices; s++)
-            {
-              pcPic->getSlice(s)->setAPS(&(vAPS[iCodedAPSIdx]));
-              pcPic->getSlice(s)->setAPSId(iCodedAPSIdx);
-            }
+        //set APS link to the slices
+        for(Int s=0; s< uiNumSlices; s++)
+        {
+          pcPic->getSlice(s)->setAPS(&(vAPS[iCodedAPSIdx]));
+          pcPic->getSlice(s)->setAPSId(iCodedAPSIdx);
+        }
 #else
-            //assign the new state
-            processingState = (!pcSlice->getPPS()->getSharedPPSInfoEnabled())?(ENCODE_SLICE):(ENCODE_PPS);
+        //assign the new state
+        processingState = (!pcSlice->getPPS()->getSharedPPSInfoEnabled())?(ENCODE_SLICE):(ENCODE_PPS);
 #endif
-          }
-          break;
+      }
+      break;
 #if F747_APS
-        case ENCODE_APS:
-          {
-            OutputNALUnit nalu(NAL_UNIT_APS, NAL_REF_IDC_PRIORITY_HIGHEST);
-            encodeAPS(&(vAPS[iCodedAPSIdx]), nalu.m_Bitstream, pcSliceForAPS);
-            accessUnit.push_back(new NALUnitEBSP(nalu));
+    case ENCODE_APS:
+      {
+        OutputNALUnit nalu(NAL_UNIT_APS, NAL_REF_IDC_PRIORITY_HIGHEST);
+        encodeAPS(&(vAPS[iCodedAPSIdx]), nalu.m_Bitstream, pcSliceForAPS);
+        accessUnit.push_back(new NALUnitEBSP(nalu));
 
-            processingState = ENCODE_SLICE;
-          }
-          break;
+        processingState = ENCODE_SLICE;
+      }
+      break;
 #else
-        case ENCODE_PPS:
-          {
-            TComPPS* pcPPS = pcSlice->getPPS();
-            m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
-            m_pcEntropyCoder->resetEntropy      ();
-
-            OutputNALUnit nalu(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
-            m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-            m_pcEntropyCoder->encodePPS(pcPPS);
-
-            if(pcPPS->getSharedPPSInfoEnabled())
-            {
-              if(pcSlice->getSPS()->getUseALF())
-              {
-                m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
-              }
-            }
+    case ENCODE_PPS:
+      {
+        TComPPS* pcPPS = pcSlice->getPPS();
+        m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder, pcSlice );
+        m_pcEntropyCoder->resetEntropy      ();
 
-            writeRBSPTrailingBits(nalu.m_Bitstream);
-            accessUnit.push_back(new NALUnitEBSP(nalu));
+        OutputNALUnit nalu(NAL_UNIT_PPS, NAL_REF_IDC_PRIORITY_HIGHEST);
+        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+        m_pcEntropyCoder->encodePPS(pcPPS);
 
-            processingState = ENCODE_SLICE;
-          }
-          break;
-#endif
-        default:
+        if(pcPPS->getSharedPPSInfoEnabled())
+        {
+          if(pcSlice->getSPS()->getUseALF())
           {
-            printf("Not a supported encoding state\n");
-            assert(0);
-            exit(-1);
+            m_pcEntropyCoder->encodeAlfParam(&cAlfParam);
           }
         }
+
+        writeRBSPTrailingBits(nalu.m_Bitstream);
+        accessUnit.push_back(new NALUnitEBSP(nalu));
+
+        processingState = ENCODE_SLICE;
+      }
+      break;
 #endif
-      } // end iteration over slices
+    default:
+      {
+        printf("Not a supported encoding state\n");
+        assert(0);
+        exit(-1);
+      }
+    }
+#endif
+  } // end iteration over slices
 
 #if !F747_APS
-      if(pcSlice->getSPS()->getUseSAO())      {        m_pcSAO->freeSaoParam(&cSaoParam);      }      
+  if(pcSlice->getSPS()->getUseSAO())      {        m_pcSAO->freeSaoParam(&cSaoParam);      }      
 #endif
 
 #if MTK_NONCROSS_INLOOP_FILTER || E045_SLICE_COMMON_INFO_SHARING
-      if(pcSlice->getSPS()->getUseALF())
-      {
-        if(m_pcAdaptiveLoopFilter->getNumSlicesInPic() > 1)
-        {
-          m_pcAdaptiveLoopFilter->destroySlice();
-        }
+  if(pcSlice->getSPS()->getUseALF())
+  {
+    if(m_pcAdaptiveLoopFilter->getNumSlicesInPic() > 1)
+    {
+      m_pcAdaptiveLoopFilter->destroySlice();
+    }
 #if !F747_APS
 #if E045_SLICE_COMMON_INFO_SHARING
-        m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
+    m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
 #endif
 #endif
-      }
+  }
 #endif 
-      
+  
 #if AMVP_BUFFERCOMPRESS
-      pcPic->compressMotion(); 
+  pcPic->compressMotion(); 
 #endif 
-      
-      // Mark higher temporal layer pictures after switching point as unused
-      pcSlice->decodingTLayerSwitchingMarking( rcListPic );
-
-      //-- For time output for each slice
-      Double dEncTime = (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-
-      const char* digestStr = NULL;
-      if (m_pcCfg->getPictureDigestEnabled())
-      {
-        /* calculate MD5sum for entire reconstructed picture */
-        SEIpictureDigest sei_recon_picture_digest;
-        sei_recon_picture_digest.method = SEIpictureDigest::MD5;
-        calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
-        digestStr = digestToString(sei_recon_picture_digest.digest);
-
-        OutputNALUnit nalu(NAL_UNIT_SEI, NAL_REF_IDC_PRIORITY_LOWEST);
+  
+  // Mark higher temporal layer pictures after switching point as unused
+  pcSlice->decodingTLayerSwitchingMarking( rcListPic );
 
-        /* write the SEI messages */
-        m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcSlice);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
-        writeRBSPTrailingBits(nalu.m_Bitstream);
+  //-- For time output for each slice
+  Double dEncTime = (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
 
-        /* insert the SEI message NALUnit before any Slice NALUnits */
-        AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
-        accessUnit.insert(it, new NALUnitEBSP(nalu));
-      }
+  const char* digestStr = NULL;
+  if (m_pcCfg->getPictureDigestEnabled())
+  {
+    /* calculate MD5sum for entire reconstructed picture */
+    SEIpictureDigest sei_recon_picture_digest;
+    sei_recon_picture_digest.method = SEIpictureDigest::MD5;
+    calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
+    digestStr = digestToString(sei_recon_picture_digest.digest);
+
+    OutputNALUnit nalu(NAL_UNIT_SEI, NAL_REF_IDC_PRIORITY_LOWEST);
+
+    /* write the SEI messages */
+    m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcSlice);
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
+    writeRBSPTrailingBits(nalu.m_Bitstream);
+
+    /* insert the SEI message NALUnit before any Slice NALUnits */
+    AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
+    accessUnit.insert(it, new NALUnitEBSP(nalu));
+  }
 
-      xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), accessUnit, dEncTime );
-      if (digestStr)
-        printf(" [MD5:%s]", digestStr);
+  xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), accessUnit, dEncTime );
+  if (digestStr)
+    printf(" [MD5:%s]", digestStr);
 
 #if FIXED_ROUNDING_FRAME_MEMORY
-      /* TODO: this should happen after copyToPic(pcPicYuvRecOut) */
-      pcPic->getPicYuvRec()->xFixedRoundingPic();
+  /* TODO: this should happen after copyToPic(pcPicYuvRecOut) */
+  pcPic->getPicYuvRec()->xFixedRoundingPic();
 #endif
-      pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
-      
-      pcPic->setReconMark   ( true );
-
-#if REF_SETTING_FOR_LD
-      if ( pcPic->getSlice(0)->getSPS()->getUseNewRefSetting() )
-      {
-        if ( pcPic->getSlice(0)->isReferenced() )
-        {
-          pcPic->getSlice(0)->decodingRefMarkingForLD( rcListPic, pcPic->getSlice(0)->getSPS()->getMaxNumRefFrames(), pcPic->getSlice(0)->getPOC() );
-        }
-      }
+  pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+  
+#if ME_PYRAMID
+  if ( m_pcCfg->getUseMEPyramid() )
+  {
+    // the reconstruction is final, downscale it for the motion searches of the pictures referencing it
+    pcPic->buildPyramid();
+  }
 #endif
-      
-      m_bFirst = false;
-      m_iNumPicCoded++;
+#if ME_SUBPEL_PLANES
+  if ( m_pcCfg->getUseSubPelPlanes() && pcPic->getSlice(0)->isReferenced() )
+  {
+    // interpolate the fractional phases once for all motion searches referencing the picture
+    pcPic->buildSubPelPlanes();
+  }
+#endif
+  pcPic->setReconMark   ( true );
 
-      /* logging: insert a newline at end of picture period */
-      printf("\n");
-      fflush(stdout);
+#if REF_SETTING_FOR_LD
+  if ( pcPic->getSlice(0)->getSPS()->getUseNewRefSetting() )
+  {
+    if ( pcPic->getSlice(0)->isReferenced() )
+    {
+      pcPic->getSlice(0)->decodingRefMarkingForLD( rcListPic, pcPic->getSlice(0)->getSPS()->getMaxNumRefFrames(), pcPic->getSlice(0)->getPOC() );
     }
-    
-    // generalized B info.
-    if ( m_pcCfg->getHierarchicalCoding() == false && iDepth != 0 )
-      break;
   }
+#endif
   
+  m_bFirst = false;
+  m_iNumPicCoded++;
+
+  /* logging: insert a newline at end of picture period */
+  printf("\n");
+  fflush(stdout);
 #if OL_USE_WPP
   delete[] pcSubstreamsOut;
 #endif
 #if TILES_DECODER
   delete pcBitstreamRedirect;
 #endif
+}
 
-  assert ( m_iNumPicCoded == iNumPicRcvd );
+/** compress the slices of a picture and determine the slice boundaries
+ * \param pcPic                                       picture to be compressed
+ * \param pcSliceEncoder                              slice encoder whose analysis tools are used
+ * \param puiStoredStartCUAddrForEncodingSlice        receives the slice boundaries
+ * \param puiStoredStartCUAddrForEncodingEntropySlice receives the entropy slice boundaries
+ * \param uiRealEndAddress                            address following the last coded unit inside the picture
+ * \returns number of slices of the picture
+ */
+UInt TEncGOP::xCompressSlices( TComPic* pcPic, TEncSlice* pcSliceEncoder, UInt* puiStoredStartCUAddrForEncodingSlice,
+                               UInt* puiStoredStartCUAddrForEncodingEntropySlice, UInt uiRealEndAddress )
+{
+  TComSlice* pcSlice     = pcPic->getSlice(0);
+  UInt       uiNumSlices = 1;
+  
+  UInt uiStartCUAddrSliceIdx = 0; // used to index "puiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
+  UInt uiStartCUAddrSlice    = 0; // used to keep track of current slice's starting CU addr.
+  pcSlice->setSliceCurStartCUAddr( uiStartCUAddrSlice ); // Setting "start CU addr" for current slice
+#if FINE_GRANULARITY_SLICES
+  memset(puiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()*pcPic->getNumPartInCU()+1));
+#else
+  memset(puiStoredStartCUAddrForEncodingSlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+#endif
+
+  UInt uiStartCUAddrEntropySliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEntropyEncodingSlice" containing locations of slice boundaries
+  UInt uiStartCUAddrEntropySlice    = 0; // used to keep track of current Entropy slice's starting CU addr.
+  pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice ); // Setting "start CU addr" for current Entropy slice
+  
+#if FINE_GRANULARITY_SLICES
+  memset(puiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()*pcPic->getNumPartInCU()+1));
+#else
+  memset(puiStoredStartCUAddrForEncodingEntropySlice, 0, sizeof(UInt) * (pcPic->getPicSym()->getNumberOfCUsInFrame()+1));
+#endif
+  UInt uiNextCUAddr = 0;
+  puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = uiNextCUAddr;
+  puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiNextCUAddr;
+
+#if FINE_GRANULARITY_SLICES
+  while(uiNextCUAddr<uiRealEndAddress) // determine slice boundaries
+#else
+  while(uiNextCUAddr<pcPic->getPicSym()->getNumberOfCUsInFrame()) // determine slice boundaries
+#endif
+  {
+    pcSlice->setNextSlice       ( false );
+    pcSlice->setNextEntropySlice( false );
+    assert(pcPic->getNumAllocatedSlice() == uiStartCUAddrSliceIdx);
+    pcSliceEncoder->precompressSlice( pcPic );
+    pcSliceEncoder->compressSlice   ( pcPic );
+
+    Bool bNoBinBitConstraintViolated = (!pcSlice->isNextSlice() && !pcSlice->isNextEntropySlice());
+    if (pcSlice->isNextSlice() || (bNoBinBitConstraintViolated && m_pcCfg->getSliceMode()==AD_HOC_SLICES_FIXED_NUMBER_OF_LCU_IN_SLICE))
+    {
+      uiStartCUAddrSlice                                              = pcSlice->getSliceCurEndCUAddr();
+      // Reconstruction slice
+      puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]  = uiStartCUAddrSlice;
+      // Entropy slice
+      if (uiStartCUAddrEntropySliceIdx>0 && puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx-1] != uiStartCUAddrSlice)
+      {
+        puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrSlice;
+      }
+      
+#if FINE_GRANULARITY_SLICES
+      if (uiStartCUAddrSlice < uiRealEndAddress)
+#else
+      if (uiStartCUAddrSlice < pcPic->getPicSym()->getNumberOfCUsInFrame())
+#endif
+      {
+        pcPic->allocateNewSlice();          
+        pcPic->setCurrSliceIdx                  ( uiStartCUAddrSliceIdx-1 );
+        pcSliceEncoder->setSliceIdx             ( uiStartCUAddrSliceIdx-1 );
+        pcSlice = pcPic->getSlice               ( uiStartCUAddrSliceIdx-1 );
+        pcSlice->copySliceInfo                  ( pcPic->getSlice(0)      );
+        pcSlice->setSliceIdx                    ( uiStartCUAddrSliceIdx-1 );
+        pcSlice->setSliceCurStartCUAddr         ( uiStartCUAddrSlice      );
+        pcSlice->setEntropySliceCurStartCUAddr  ( uiStartCUAddrSlice      );
+        pcSlice->setSliceBits(0);
+        uiNumSlices ++;
+      }
+    }
+    else if (pcSlice->isNextEntropySlice() || (bNoBinBitConstraintViolated && m_pcCfg->getEntropySliceMode()==SHARP_FIXED_NUMBER_OF_LCU_IN_ENTROPY_SLICE))
+    {
+      uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
+      puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = uiStartCUAddrEntropySlice;
+      pcSlice->setEntropySliceCurStartCUAddr( uiStartCUAddrEntropySlice );
+    }
+    else
+    {
+      uiStartCUAddrSlice                                                            = pcSlice->getSliceCurEndCUAddr();
+      uiStartCUAddrEntropySlice                                                     = pcSlice->getEntropySliceCurEndCUAddr();
+    }        
+
+    uiNextCUAddr = (uiStartCUAddrSlice > uiStartCUAddrEntropySlice) ? uiStartCUAddrSlice : uiStartCUAddrEntropySlice;
+  }
+  puiStoredStartCUAddrForEncodingSlice[uiStartCUAddrSliceIdx++]                = pcSlice->getSliceCurEndCUAddr();
+  puiStoredStartCUAddrForEncodingEntropySlice[uiStartCUAddrEntropySliceIdx++]  = pcSlice->getSliceCurEndCUAddr();
+
+  return uiNumSlices;
+}
+
+#if GOP_THREADS
+/** create the picture contexts, one for every picture of a level that can be compressed at the same time
+ */
+Void TEncGOP::xCreatePicContexts()
+{
+  m_iNumPicContexts = min( m_pcCfg->getNumWorkerThreads() + 1, max( m_pcCfg->getGOPSize() / 2, 1 ) );
+  if ( m_pcCfg->getNumWorkerThreads() == 0 || !m_pcCfg->getUseSBACRD() || !m_pcCfg->getUseNRF() || m_pcCfg->getDeltaQpRD() > 0 || m_iNumPicContexts < 2 )
+  {
+    m_iNumPicContexts = 0;
+    return;
+  }
+  
+  m_pcPicContexts = new TEncPicContext[ m_iNumPicContexts ];
+  for ( Int i = 0; i < m_iNumPicContexts; i++ )
+  {
+    m_pcPicContexts[i].create( m_pcEncTop, m_pcEncTop->getPPS()->getNumSubstreams() );
+  }
+}
+
+/** check if a picture can be compressed in a picture context
+ * \param pcSlice first slice of the picture
+ * \returns true for a non-referenced picture
+ *
+ * Only non-referenced pictures are batched, so no picture of a batch predicts from another one.
+ * Multi-QP optimization filters trial pictures with the shared in-loop filters
+ * and weighted prediction keeps its state in static members, both stay serial.
+ */
+Bool TEncGOP::xUsePicContext( TComSlice* pcSlice )
+{
+  if ( m_pcPicContexts == NULL || pcSlice->isReferenced() )
+  {
+    return false;
+  }
+#if WEIGHT_PRED
+  if ( pcSlice->getPPS()->getUseWP() || pcSlice->getPPS()->getWPBiPredIdc() )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+#endif
+
+#if QP_RD_THREADS
+/** create the QP contexts, one for every QP candidate of the multi-QP optimization
+ */
+Void TEncGOP::xCreateQpContexts()
+{
+  m_iNumQpContexts = 2 * m_pcCfg->getDeltaQpRD() + 1;
+  if ( m_pcCfg->getNumWorkerThreads() == 0 || !m_pcCfg->getUseSBACRD() || m_pcCfg->getDeltaQpRD() == 0 )
+  {
+    m_iNumQpContexts = 0;
+    return;
+  }
+  
+  m_pcQpContexts = new TEncPicContext[ m_iNumQpContexts ];
+  for ( Int i = 0; i < m_iNumQpContexts; i++ )
+  {
+    m_pcQpContexts[i].create( m_pcEncTop, m_pcEncTop->getPPS()->getNumSubstreams() );
+    m_pcQpContexts[i].createTrialPic( m_pcEncTop );
+  }
+}
+
+/** get the contexts compressing the QP candidates of a picture concurrently
+ * \param pcPic picture being compressed
+ * \returns one context per QP candidate, NULL if the candidates are compressed serially
+ *
+ * Each candidate is compressed on a copy of the picture, so only a picture made of a single slice is supported:
+ * the candidates of a following slice would filter the slices already compressed.
+ * Weighted prediction keeps its state in static members and stays serial.
+ */
+TEncPicContext* TEncGOP::getQpContexts( TComPic* pcPic )
+{
+  if ( m_pcQpContexts == NULL || m_pcCfg->getSliceMode() != 0 || m_pcCfg->getEntropySliceMode() != 0 )
+  {
+    return NULL;
+  }
+#if WEIGHT_PRED
+  TComSlice* pcSlice = pcPic->getSlice(0);
+  if ( pcSlice->getPPS()->getUseWP() || pcSlice->getPPS()->getWPBiPredIdc() )
+  {
+    return NULL;
+  }
+#endif
+  return m_pcQpContexts;
+}
+#endif
+
+#if ME_TZ_VISITED
+Void TEncGOP::getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated )
+{
+#if GOP_THREADS
+  for ( Int i = 0; i < m_iNumPicContexts; i++ )
+  {
+    m_pcPicContexts[i].getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+  }
+#endif
+#if QP_RD_THREADS
+  for ( Int i = 0; i < m_iNumQpContexts; i++ )
+  {
+    m_pcQpContexts[i].getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+  }
+#endif
 }
+#endif
+
+#if LOOP_FILTER_THREADS
+Void TEncFilterRowJob::run()
+{
+  m_pcGOPEncoder->xFilterRow( m_uiRow );
+}
+
+/** check if the in-loop filters can follow the compression of a picture row by row
+ * \param pcPic picture to be compressed
+ * \returns true if worker threads are available and the LCU rows are compressed once, top-down
+ *
+ * Multi-QP optimization compresses the picture several times and tiles complete the rows out of order.
+ */
+Bool TEncGOP::xUseFilterRows( TComPic* pcPic )
+{
+  if ( m_pcCfg->getNumWorkerThreads() == 0 || m_pcCfg->getDeltaQpRD() > 0 )
+  {
+    return false;
+  }
+#if TILES
+  if ( pcPic->getPicSym()->getNumTiles() > 1 )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** prepare the deblocking filter and the SAO statistics for a picture filtered while it is compressed
+ * \param pcPic   picture to be compressed
+ * \param pcSlice first slice of the picture
+ */
+Void TEncGOP::xStartFilterRows( TComPic* pcPic, TComSlice* pcSlice )
+{
+  m_pcLoopFilter->setCfg(pcSlice->getLoopFilterDisable(), m_pcCfg->getLoopFilterAlphaC0Offget(), m_pcCfg->getLoopFilterBetaOffget());
+  
+  m_bFilterSaoStats = false;
+#if SAO
+  // the statistics only depend on the slices if SAO does not cross slice boundaries
+  if ( pcSlice->getSPS()->getUseSAO() && pcSlice->getSPS()->getLFCrossSliceBoundaryFlag() )
+  {
+    m_pcSAO->startSaoRowStats( pcPic );
+    m_bFilterSaoStats = true;
+  }
+#endif
+  
+  m_uiNumFilterRowsQueued = 0;
+  m_uiNumFilterRowsDone   = 0;
+  m_pcFilterPic           = pcPic;
+}
+
+/** queue the filter jobs of the rows that may be deblocked
+ * \param pcPic     picture being compressed
+ * \param uiNumRows number of LCU rows compressed from the top of the picture
+ *
+ * A row is deblocked once the row below it is compressed, as the intra prediction of that row reads
+ * the unfiltered bottom line of the row. Pictures that are not filtered row by row are ignored.
+ */
+Void TEncGOP::setRowsCompressed( TComPic* pcPic, UInt uiNumRows )
+{
+  if ( pcPic != m_pcFilterPic )
+  {
+    return;
+  }
+  UInt uiHeightInLCUs  = pcPic->getFrameHeightInCU();
+  UInt uiNumFilterRows = ( uiNumRows < uiHeightInLCUs ) ? uiNumRows - 1 : uiHeightInLCUs;
+  
+  // rows are queued top-down, so a filter job only ever waits for jobs that were started before it
+  m_cFilterMutex.lock();
+  while ( m_uiNumFilterRowsQueued < uiNumFilterRows )
+  {
+    TEncFilterRowJob* pcJob = &m_pcFilterRowJobs[m_uiNumFilterRowsQueued];
+    pcJob->m_pcGOPEncoder = this;
+    pcJob->m_uiRow        = m_uiNumFilterRowsQueued++;
+    m_pcEncTop->getThreadPool()->addJob( pcJob );
+  }
+  m_cFilterMutex.unlock();
+}
+
+/** filter the remaining rows and wait for all filter jobs of the picture
+ */
+Void TEncGOP::xFinishFilterRows()
+{
+  UInt uiHeightInLCUs = m_pcFilterPic->getFrameHeightInCU();
+  
+  setRowsCompressed( m_pcFilterPic, uiHeightInLCUs );
+  for ( UInt uiRow = 0; uiRow < uiHeightInLCUs; uiRow++ )
+  {
+    m_pcEncTop->getThreadPool()->waitJob( &m_pcFilterRowJobs[uiRow] );
+  }
+  m_pcFilterPic = NULL;
+}
+
+/** deblock one LCU row and gather the SAO statistics of the row above it
+ * \param uiRow LCU row index in the picture
+ */
+Void TEncGOP::xFilterRow( UInt uiRow )
+{
+  m_cFilterMutex.lock();
+  while ( m_uiNumFilterRowsDone < uiRow )
+  {
+    m_cFilterRowDone.wait( m_cFilterMutex );
+  }
+  m_cFilterMutex.unlock();
+  
+  m_pcLoopFilter->loopFilterCURow( m_pcFilterPic, uiRow );
+#if SAO
+  // the edge offset classes read one line of the neighbouring rows, so a row is final once the row below is deblocked
+  if ( m_bFilterSaoStats )
+  {
+    if ( uiRow > 0 )
+    {
+      m_pcSAO->calcSaoStatsRow( uiRow - 1 );
+    }
+    if ( uiRow == m_pcFilterPic->getFrameHeightInCU() - 1 )
+    {
+      m_pcSAO->calcSaoStatsRow( uiRow );
+    }
+  }
+#endif
+  
+  m_cFilterMutex.lock();
+  m_uiNumFilterRowsDone++;
+  m_cFilterRowDone.broadcast();
+  m_cFilterMutex.unlock();
+}
+#endif
 
 #if F747_APS
 /** Memory allocation for APS
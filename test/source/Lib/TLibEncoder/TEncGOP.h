@@ -53,6 +53,9 @@
 #include "TEncEntropy.h"
 #include "TEncCavlc.h"
 #include "TEncSbac.h"
+#if GOP_THREADS
+#include "TEncPicContext.h"
+#endif
 
 #include "TEncAnalyze.h"
 
@@ -64,6 +67,19 @@
 //! \{
 
 class TEncTop;
+#if LOOP_FILTER_THREADS
+class TEncGOP;
+
+/// deblocking of one LCU row and SAO statistics of the row above it, executed by the encoder thread pool
+class TEncFilterRowJob : public TComJob
+{
+public:
+  TEncGOP*    m_pcGOPEncoder;                                   ///< GOP encoder owning the in-loop filters
+  UInt        m_uiRow;                                          ///< LCU row index in the picture
+  
+  Void run();
+};
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -108,6 +124,23 @@ private:
   UInt                    m_uiPOCCDR;
   UInt*                   m_uiStoredStartCUAddrForEncodingSlice;
   UInt*                   m_uiStoredStartCUAddrForEncodingEntropySlice;
+#if GOP_THREADS
+  Int                     m_iNumPicContexts;
+  TEncPicContext*         m_pcPicContexts;                      ///< analysis tools of the pictures of a level compressed concurrently
+#endif
+#if QP_RD_THREADS
+  Int                     m_iNumQpContexts;
+  TEncPicContext*         m_pcQpContexts;                       ///< analysis tools and trial picture of each QP candidate compressed concurrently
+#endif
+#if LOOP_FILTER_THREADS
+  TEncFilterRowJob*       m_pcFilterRowJobs;                    ///< one in-loop filter job per LCU row
+  TComPic*                m_pcFilterPic;                        ///< picture filtered while it is compressed, NULL if none
+  Bool                    m_bFilterSaoStats;                    ///< the filter jobs gather the SAO statistics
+  UInt                    m_uiNumFilterRowsQueued;              ///< number of rows whose filter job has been queued
+  UInt                    m_uiNumFilterRowsDone;                ///< number of filtered rows
+  TComMutex               m_cFilterMutex;                       ///< protects the row counters
+  TComCondition           m_cFilterRowDone;                     ///< signalled whenever a row has been filtered
+#endif
 
 // #if MTK_NONCROSS_INLOOP_FILTER
 //   UInt                    m_uiILSliceCount;
@@ -144,6 +177,15 @@ public:
   Void  preLoopFilterPicAll  ( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiBits );
   
   TEncSlice*  getSliceEncoder()   { return m_pcSliceEncoder; }
+#if LOOP_FILTER_THREADS
+  Void  setRowsCompressed    ( TComPic* pcPic, UInt uiNumRows );    ///< the first uiNumRows LCU rows of pcPic are compressed
+#endif
+#if QP_RD_THREADS
+  TEncPicContext* getQpContexts ( TComPic* pcPic );                 ///< contexts of the QP candidates of pcPic, NULL if serial
+#endif
+#if ME_TZ_VISITED
+  Void  getTZSearchCounts    ( UInt64& ruiPoints, UInt64& ruiPointsRepeated ); ///< add the TZ search counters of the searches of the picture and QP contexts
+#endif
 
 #if F747_APS
   Void freeAPS     (TComAPS* pAPS, TComSPS* pSPS);
@@ -167,6 +209,28 @@ protected:
 #if RVM_VCEGAM10
   Double xCalculateRVM();
 #endif
+  
+  UInt  xCompressSlices   ( TComPic* pcPic, TEncSlice* pcSliceEncoder, UInt* puiStoredStartCUAddrForEncodingSlice,
+                            UInt* puiStoredStartCUAddrForEncodingEntropySlice, UInt uiRealEndAddress );
+  Void  xFinishPicture    ( TComPic* pcPic, TComPicYuv* pcPicYuvRecOut, AccessUnit& accessUnit, TComList<TComPic*>& rcListPic,
+                            long iBeforeTime, UInt uiRealEndAddress, UInt uiNumSlices, Bool bRowsFiltered );
+#if GOP_THREADS
+  friend class TEncPicContext;
+  
+  Void  xCreatePicContexts();
+  Bool  xUsePicContext    ( TComSlice* pcSlice );
+#endif
+#if QP_RD_THREADS
+  Void  xCreateQpContexts ();
+#endif
+#if LOOP_FILTER_THREADS
+  friend class TEncFilterRowJob;
+  
+  Bool  xUseFilterRows    ( TComPic* pcPic );
+  Void  xStartFilterRows  ( TComPic* pcPic, TComSlice* pcSlice );
+  Void  xFinishFilterRows ();
+  Void  xFilterRow        ( UInt uiRow );
+#endif
 };// END CLASS DEFINITION TEncGOP
 
 // ====================================================================================================================
@@ -0,0 +1,211 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncLookahead.cpp
+    \brief    input picture analysis ahead of the GOP encoder
+*/
+
+#include "TEncLookahead.h"
+#if QP_ADAPTATION
+#include "TEncPic.h"
+#endif
+
+//! \ingroup TLibEncoder
+//! \{
+
+#if LOOKAHEAD_THREAD
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncLookahead::TEncLookahead()
+{
+  m_pcCfg         = NULL;
+  m_bTerminate    = false;
+  m_iQueueSize    = 0;
+  m_pcQueue       = NULL;
+  m_uiNumQueued   = 0;
+  m_uiNumAnalyzed = 0;
+}
+
+TEncLookahead::~TEncLookahead()
+{
+  destroy();
+}
+
+/** allocate the queue and start the lookahead thread
+ * \param pcCfg encoder configuration
+ * \param iQueueSize number of pictures the lookahead may be ahead of the GOP encoder
+ */
+Void TEncLookahead::create( TEncCfg* pcCfg, Int iQueueSize )
+{
+  m_pcCfg      = pcCfg;
+  m_iQueueSize = iQueueSize;
+  m_pcQueue    = new TEncLookaheadPic[ m_iQueueSize ];
+  for ( Int i = 0; i < m_iQueueSize; i++ )
+  {
+    m_pcQueue[i].m_pcPic = NULL;
+    m_pcQueue[i].m_uiIdx = 0;
+  }
+  
+  m_bTerminate    = false;
+  m_uiNumQueued   = 0;
+  m_uiNumAnalyzed = 0;
+  
+  // without a thread the pictures are analyzed when they are queued
+  m_cThreadPool.create( 1 );
+  if ( m_cThreadPool.getNumThreads() > 0 )
+  {
+    m_cThreadPool.addJob( this );
+  }
+}
+
+/** stop the lookahead thread and free the queue
+ */
+Void TEncLookahead::destroy()
+{
+  if ( m_pcQueue == NULL )
+  {
+    return;
+  }
+  
+  m_cMutex.lock();
+  m_bTerminate = true;
+  m_cQueueChanged.broadcast();
+  m_cMutex.unlock();
+  m_cThreadPool.destroy();
+  
+  delete[] m_pcQueue;
+  m_pcQueue = NULL;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** queue a picture for analysis; the slot of the oldest picture is reused once it has been analyzed
+ * \param pcPic input picture, its original samples must not change until it has been analyzed
+ */
+Void TEncLookahead::addPicture( TComPic* pcPic )
+{
+  m_cMutex.lock();
+  while ( m_uiNumQueued - m_uiNumAnalyzed >= (UInt)m_iQueueSize )
+  {
+    m_cQueueChanged.wait( m_cMutex );
+  }
+  TEncLookaheadPic* pcLaPic = &m_pcQueue[ m_uiNumQueued % m_iQueueSize ];
+  pcLaPic->m_pcPic = pcPic;
+  pcLaPic->m_uiIdx = m_uiNumQueued;
+  m_uiNumQueued++;
+  m_cQueueChanged.broadcast();
+  m_cMutex.unlock();
+  
+  if ( m_cThreadPool.getNumThreads() == 0 )
+  {
+    xAnalyze( pcLaPic );
+    m_uiNumAnalyzed++;
+  }
+}
+
+/** wait for the analysis of a picture
+ * \param pcPic picture queued by addPicture
+ */
+Void TEncLookahead::waitPicture( TComPic* pcPic )
+{
+  TEncLookaheadPic* pcLaPic = NULL;
+  
+  m_cMutex.lock();
+  // picture buffers are reused, take the latest picture queued in pcPic
+  for ( Int i = 0; i < m_iQueueSize; i++ )
+  {
+    if ( m_pcQueue[i].m_pcPic == pcPic && ( pcLaPic == NULL || m_pcQueue[i].m_uiIdx > pcLaPic->m_uiIdx ) )
+    {
+      pcLaPic = &m_pcQueue[i];
+    }
+  }
+  assert( pcLaPic != NULL );
+  while ( pcLaPic->m_uiIdx >= m_uiNumAnalyzed )
+  {
+    m_cQueueChanged.wait( m_cMutex );
+  }
+  m_cMutex.unlock();
+}
+
+/** lookahead thread: analyze the queued pictures in input order until destroy() is called
+ */
+Void TEncLookahead::run()
+{
+  m_cMutex.lock();
+  for (;;)
+  {
+    if ( m_uiNumAnalyzed < m_uiNumQueued )
+    {
+      TEncLookaheadPic* pcLaPic = &m_pcQueue[ m_uiNumAnalyzed % m_iQueueSize ];
+      m_cMutex.unlock();
+      xAnalyze( pcLaPic );
+      m_cMutex.lock();
+      m_uiNumAnalyzed++;
+      m_cQueueChanged.broadcast();
+    }
+    else if ( m_bTerminate )
+    {
+      break;
+    }
+    else
+    {
+      m_cQueueChanged.wait( m_cMutex );
+    }
+  }
+  m_cMutex.unlock();
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** analyze a picture: AQ activity of its CUs
+ * \param pcLaPic picture to analyze, the pictures are analyzed in input order
+ */
+Void TEncLookahead::xAnalyze( TEncLookaheadPic* pcLaPic )
+{
+#if QP_ADAPTATION
+  if ( m_pcCfg->getUseAdaptiveQP() )
+  {
+    m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcLaPic->m_pcPic ) );
+  }
+#endif
+}
+#endif
+
+//! \}
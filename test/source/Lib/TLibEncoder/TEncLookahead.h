@@ -0,0 +1,103 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncLookahead.h
+    \brief    input picture analysis ahead of the GOP encoder (header)
+*/
+
+#ifndef __TENCLOOKAHEAD__
+#define __TENCLOOKAHEAD__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TEncCfg.h"
+#if QP_ADAPTATION
+#include "TEncPreanalyzer.h"
+#endif
+
+//! \ingroup TLibEncoder
+//! \{
+
+#if LOOKAHEAD_THREAD
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// queue entry of one input picture, the analysis results are stored in the picture itself
+class TEncLookaheadPic
+{
+public:
+  TComPic*  m_pcPic;                                            ///< analyzed picture
+  UInt      m_uiIdx;                                            ///< input order of the picture
+};
+
+/// input picture analyzer running on its own thread over a bounded queue of pictures
+class TEncLookahead : public TComJob
+{
+public:
+  TEncLookahead();
+  virtual ~TEncLookahead();
+  
+  Void  create      ( TEncCfg* pcCfg, Int iQueueSize );
+  Void  destroy     ();
+  
+  Void              addPicture  ( TComPic* pcPic );             ///< queue pcPic for analysis, blocks while the queue is full
+  Void              waitPicture ( TComPic* pcPic );             ///< wait for the analysis of pcPic
+  
+  Void  run         ();
+  
+private:
+  Void  xAnalyze    ( TEncLookaheadPic* pcLaPic );
+  
+  TEncCfg*          m_pcCfg;
+  TComThreadPool    m_cThreadPool;                              ///< the lookahead thread
+  TComMutex         m_cMutex;                                   ///< protects the queue counters
+  TComCondition     m_cQueueChanged;                            ///< signalled whenever a picture is queued or analyzed
+  Bool              m_bTerminate;
+  
+  Int               m_iQueueSize;
+  TEncLookaheadPic* m_pcQueue;                                  ///< ring of the results of the last m_iQueueSize pictures
+  UInt              m_uiNumQueued;                              ///< number of pictures queued so far
+  UInt              m_uiNumAnalyzed;                            ///< number of pictures analyzed so far
+  
+#if QP_ADAPTATION
+  TEncPreanalyzer   m_cPreanalyzer;
+#endif
+};
+#endif
+
+//! \}
+
+#endif // __TENCLOOKAHEAD__
@@ -0,0 +1,294 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncPicContext.cpp
+    \brief    analysis tools of a picture compressed concurrently with other pictures
+*/
+
+#include "TEncTop.h"
+#include "TEncPicContext.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+#if GOP_THREADS
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncPicContext::TEncPicContext()
+{
+  m_pcGOPEncoder        = NULL;
+  m_pppcRDSbacCoder     = NULL;
+  m_pppcBinCoderCABAC   = NULL;
+  m_iNumSubstreams      = 0;
+  m_ppppcRDSbacCoders   = NULL;
+  m_ppppcBinCodersCABAC = NULL;
+  m_pcBitCounters       = NULL;
+  
+  m_pcPic               = NULL;
+  m_pcPicYuvRecOut      = NULL;
+  m_pcAccessUnit        = NULL;
+  m_iBeforeTime         = 0;
+  m_uiRealEndAddress    = 0;
+  m_uiNumSlices         = 0;
+  m_puiStoredStartCUAddrForEncodingSlice        = NULL;
+  m_puiStoredStartCUAddrForEncodingEntropySlice = NULL;
+#if QP_RD_THREADS
+  m_pcTrialPic          = NULL;
+#endif
+}
+
+TEncPicContext::~TEncPicContext()
+{
+}
+
+/** create and initialize the analysis tools of the context
+ * \param pcEncTop       pointer of encoder class, providing the configuration and the coding tables
+ * \param iNumSubstreams number of substreams of a picture
+ */
+Void TEncPicContext::create( TEncTop* pcEncTop, Int iNumSubstreams )
+{
+  Int iDepth, iCIIdx;
+  
+  m_pcGOPEncoder = pcEncTop->getGOPEncoder();
+  
+  // create processing unit classes
+  m_cSliceEncoder.create( pcEncTop->getSourceWidth(), pcEncTop->getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+  m_cCuEncoder.   create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+  
+  // SBAC RD
+  m_pppcRDSbacCoder   = new TEncSbac**     [g_uiMaxCUDepth+1];
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+  for ( iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder  [iDepth] = new TEncSbac*     [CI_NUM];
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+    for ( iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      m_pppcRDSbacCoder  [iDepth][iCIIdx] = new TEncSbac;
+      m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABAC;
+      m_pppcRDSbacCoder  [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC[iDepth][iCIIdx] );
+    }
+  }
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+  m_cSbacCoder.      init( &m_cBinCoderCABAC );
+  
+  // SBAC RD of the substreams, used by the serial LCU loop of the slice encoder
+  m_iNumSubstreams      = iNumSubstreams;
+  m_ppppcRDSbacCoders   = new TEncSbac***     [iNumSubstreams];
+  m_ppppcBinCodersCABAC = new TEncBinCABAC*** [iNumSubstreams];
+  m_pcBitCounters       = new TComBitCounter  [iNumSubstreams];
+  for ( Int iSubStrm = 0; iSubStrm < iNumSubstreams; iSubStrm++ )
+  {
+    m_ppppcRDSbacCoders  [iSubStrm] = new TEncSbac**     [g_uiMaxCUDepth+1];
+    m_ppppcBinCodersCABAC[iSubStrm] = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+    for ( iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+    {
+      m_ppppcRDSbacCoders  [iSubStrm][iDepth] = new TEncSbac*     [CI_NUM];
+      m_ppppcBinCodersCABAC[iSubStrm][iDepth] = new TEncBinCABAC* [CI_NUM];
+      for ( iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+      {
+        m_ppppcRDSbacCoders  [iSubStrm][iDepth][iCIIdx] = new TEncSbac;
+        m_ppppcBinCodersCABAC[iSubStrm][iDepth][iCIIdx] = new TEncBinCABAC;
+        m_ppppcRDSbacCoders  [iSubStrm][iDepth][iCIIdx]->init( m_ppppcBinCodersCABAC[iSubStrm][iDepth][iCIIdx] );
+      }
+    }
+  }
+  
+  // initialize transform & quantization and search classes as TEncTop::init() does
+  UInt *aTable4=NULL, *aTable8=NULL;
+  UInt* aTableLastPosVlcIndex=NULL; 
+#if !CAVLC_COEF_LRG_BLK
+  aTable8 = pcEncTop->getCavlcCoder()->GetLP8Table();
+#endif
+  aTable4 = pcEncTop->getCavlcCoder()->GetLP4Table();
+  aTableLastPosVlcIndex=pcEncTop->getCavlcCoder()->GetLastPosVlcIndexTable();
+  
+  m_cTrQuant.init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << pcEncTop->getQuadtreeTULog2MaxSize(), pcEncTop->getSymbolMode(), aTable4, aTable8, 
+    aTableLastPosVlcIndex, pcEncTop->getUseRDOQ(), true );
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), 0, &m_cEntropyCoder, &m_cRdCost, 
+    m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+#if REF_SEARCH_THREADS
+  m_cSearch.createRefJobs( pcEncTop->getThreadPool() );
+#endif
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cBitCounter, &m_cRdCost, &m_cEntropyCoder, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+  m_cSliceEncoder.init( pcEncTop, &m_cCuEncoder, &m_cSearch, &m_cEntropyCoder, &m_cSbacCoder, &m_cBinCoderCABAC, &m_cTrQuant, &m_cBitCounter, &m_cRdCost,
+    m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder, m_ppppcRDSbacCoders, m_pcBitCounters );
+  
+  // slice boundaries, sized as in TEncGOP::create()
+  UInt uiWidthInCU       = ( pcEncTop->getSourceWidth() %g_uiMaxCUWidth  ) ? pcEncTop->getSourceWidth() /g_uiMaxCUWidth  + 1 : pcEncTop->getSourceWidth() /g_uiMaxCUWidth;
+  UInt uiHeightInCU      = ( pcEncTop->getSourceHeight()%g_uiMaxCUHeight ) ? pcEncTop->getSourceHeight()/g_uiMaxCUHeight + 1 : pcEncTop->getSourceHeight()/g_uiMaxCUHeight;
+  UInt uiNumCUsInFrame   = uiWidthInCU * uiHeightInCU;
+#if FINE_GRANULARITY_SLICES
+  m_puiStoredStartCUAddrForEncodingSlice        = new UInt [uiNumCUsInFrame*(1<<(g_uiMaxCUDepth<<1))+1];
+  m_puiStoredStartCUAddrForEncodingEntropySlice = new UInt [uiNumCUsInFrame*(1<<(g_uiMaxCUDepth<<1))+1];
+#else
+  m_puiStoredStartCUAddrForEncodingSlice        = new UInt [uiNumCUsInFrame+1];
+  m_puiStoredStartCUAddrForEncodingEntropySlice = new UInt [uiNumCUsInFrame+1];
+#endif
+}
+
+Void TEncPicContext::destroy()
+{
+  Int iDepth, iCIIdx;
+  
+  m_cSliceEncoder.destroy();
+  m_cCuEncoder.   destroy();
+  
+  for ( iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    for ( iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      delete m_pppcRDSbacCoder  [iDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+    }
+    delete [] m_pppcRDSbacCoder  [iDepth];
+    delete [] m_pppcBinCoderCABAC[iDepth];
+  }
+  delete [] m_pppcRDSbacCoder;    m_pppcRDSbacCoder   = NULL;
+  delete [] m_pppcBinCoderCABAC;  m_pppcBinCoderCABAC = NULL;
+  
+  for ( Int iSubStrm = 0; iSubStrm < m_iNumSubstreams; iSubStrm++ )
+  {
+    for ( iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+    {
+      for ( iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+      {
+        delete m_ppppcRDSbacCoders  [iSubStrm][iDepth][iCIIdx];
+        delete m_ppppcBinCodersCABAC[iSubStrm][iDepth][iCIIdx];
+      }
+      delete [] m_ppppcRDSbacCoders  [iSubStrm][iDepth];
+      delete [] m_ppppcBinCodersCABAC[iSubStrm][iDepth];
+    }
+    delete [] m_ppppcRDSbacCoders  [iSubStrm];
+    delete [] m_ppppcBinCodersCABAC[iSubStrm];
+  }
+  delete [] m_ppppcRDSbacCoders;    m_ppppcRDSbacCoders   = NULL;
+  delete [] m_ppppcBinCodersCABAC;  m_ppppcBinCodersCABAC = NULL;
+  delete [] m_pcBitCounters;        m_pcBitCounters       = NULL;
+  m_iNumSubstreams = 0;
+  
+  delete [] m_puiStoredStartCUAddrForEncodingSlice;        m_puiStoredStartCUAddrForEncodingSlice        = NULL;
+  delete [] m_puiStoredStartCUAddrForEncodingEntropySlice; m_puiStoredStartCUAddrForEncodingEntropySlice = NULL;
+#if QP_RD_THREADS
+  if ( m_pcTrialPic )
+  {
+    m_pcTrialPic->destroy();
+    delete m_pcTrialPic;
+    m_pcTrialPic = NULL;
+  }
+#endif
+}
+
+#if QP_RD_THREADS
+/** allocate the picture compressed with one QP candidate of the multi-QP optimization
+ * \param pcEncTop pointer of encoder class, providing the picture size and the tile structure
+ */
+Void TEncPicContext::createTrialPic( TEncTop* pcEncTop )
+{
+  m_pcTrialPic = new TComPic;
+  m_pcTrialPic->create( pcEncTop->getSourceWidth(), pcEncTop->getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+#if TILES
+  m_pcTrialPic->getPicSym()->setNumColumnsMinus1( pcEncTop->getNumColumnsMinus1() );
+  m_pcTrialPic->getPicSym()->setNumRowsMinus1   ( pcEncTop->getNumRowsMinus1() );
+  m_pcTrialPic->getPicSym()->xCreateTComTileArray();
+#endif
+}
+
+/** copy the original samples, the tile structure and the slice of a picture into the trial picture
+ * \param pcPic   picture being compressed
+ * \param pcSlice slice of pcPic, its QP and lambda are set afterwards by the slice encoder
+ *
+ * The trial picture keeps its own CU data and reconstruction, the reference pictures are shared read-only.
+ * The prediction buffer is shared as well, it is only used as ALF scratch by the serial in-loop filter pass.
+ */
+Void TEncPicContext::initTrialPic( TComPic* pcPic, TComSlice* pcSlice )
+{
+  TComPicSym* pcSrcSym = pcPic->getPicSym();
+  TComPicSym* pcDstSym = m_pcTrialPic->getPicSym();
+  
+  pcPic->getPicYuvOrg()->copyToPic( m_pcTrialPic->getPicYuvOrg() );
+  m_pcTrialPic->setPicYuvPred( pcPic->getPicYuvPred() );
+  m_pcTrialPic->setPicYuvResi( pcPic->getPicYuvResi() );
+  m_pcTrialPic->setTLayer    ( pcPic->getTLayer() );
+  
+#if TILES
+  assert( pcDstSym->getNumColumnsMinus1() == pcSrcSym->getNumColumnsMinus1() && pcDstSym->getNumRowsMinus1() == pcSrcSym->getNumRowsMinus1() );
+  pcDstSym->setTileBoundaryIndependenceIdr( pcSrcSym->getTileBoundaryIndependenceIdr() );
+  for ( UInt uiTileIdx = 0; uiTileIdx < (pcSrcSym->getNumColumnsMinus1()+1)*(pcSrcSym->getNumRowsMinus1()+1); uiTileIdx++ )
+  {
+    pcDstSym->getTComTile( uiTileIdx )->setTileWidth ( pcSrcSym->getTComTile( uiTileIdx )->getTileWidth () );
+    pcDstSym->getTComTile( uiTileIdx )->setTileHeight( pcSrcSym->getTComTile( uiTileIdx )->getTileHeight() );
+  }
+  pcDstSym->xInitTiles();
+  for ( UInt uiCUAddr = 0; uiCUAddr <= pcSrcSym->getNumberOfCUsInFrame(); uiCUAddr++ )
+  {
+    pcDstSym->setCUOrderMap       ( uiCUAddr, pcSrcSym->getCUOrderMap( uiCUAddr ) );
+    pcDstSym->setInverseCUOrderMap( uiCUAddr, pcSrcSym->getInverseCUOrderMap( uiCUAddr ) );
+  }
+#endif
+  
+  m_pcTrialPic->clearSliceBuffer();
+  m_pcTrialPic->setCurrSliceIdx( 0 );
+  TComSlice* pcTrialSlice = m_pcTrialPic->getSlice(0);
+  pcTrialSlice->copySliceInfo( pcSlice );
+  pcTrialSlice->setPic       ( m_pcTrialPic );
+  pcTrialSlice->setSliceBits ( 0 );
+  m_cSliceEncoder.setSliceIdx( 0 );
+}
+#endif
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** compress the slices of m_pcPic and store the slice boundaries in the context,
+ *  or the trial picture with the QP candidate set up by the slice encoder
+ */
+Void TEncPicContext::run()
+{
+#if QP_RD_THREADS
+  if ( m_pcTrialPic )
+  {
+    m_cSliceEncoder.compressSlice( m_pcTrialPic );
+    return;
+  }
+#endif
+  m_uiNumSlices = m_pcGOPEncoder->xCompressSlices( m_pcPic, &m_cSliceEncoder, m_puiStoredStartCUAddrForEncodingSlice,
+                                                  m_puiStoredStartCUAddrForEncodingEntropySlice, m_uiRealEndAddress );
+}
+#endif
+
+//! \}
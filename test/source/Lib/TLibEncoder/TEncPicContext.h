@@ -0,0 +1,131 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2011, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncPicContext.h
+    \brief    analysis tools of a picture compressed concurrently with other pictures (header)
+*/
+
+#ifndef __TENCPICCONTEXT__
+#define __TENCPICCONTEXT__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComBitCounter.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TLibCommon/AccessUnit.h"
+#include "TEncSlice.h"
+#include "TEncCu.h"
+#include "TEncSearch.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+#include "TEncBinCoderCABAC.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+#if GOP_THREADS
+class TEncTop;
+class TEncGOP;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// slice compression of one picture with its own analysis tools, executed by the encoder thread pool
+class TEncPicContext : public TComJob
+{
+private:
+  TEncGOP*                m_pcGOPEncoder;                       ///< GOP encoder owning the context
+  
+  // processing units
+  TEncSlice               m_cSliceEncoder;                      ///< slice encoder
+  TEncCu                  m_cCuEncoder;                         ///< CU encoder
+  TEncSearch              m_cSearch;                            ///< encoder search class
+  TComTrQuant             m_cTrQuant;                           ///< transform & quantization
+  
+  // entropy coding and RD optimization
+  TEncEntropy             m_cEntropyCoder;                      ///< entropy encoder
+  TEncSbac                m_cSbacCoder;                         ///< SBAC encoder
+  TEncBinCABAC            m_cBinCoderCABAC;                     ///< bin encoder CABAC
+  TComBitCounter          m_cBitCounter;                        ///< bit counter
+  TComRdCost              m_cRdCost;                            ///< RD cost computation
+  TEncSbac***             m_pppcRDSbacCoder;                    ///< storage for SBAC-based RD optimization
+  TEncBinCABAC***         m_pppcBinCoderCABAC;                  ///< bin encoders of m_pppcRDSbacCoder
+  TEncSbac                m_cRDGoOnSbacCoder;                   ///< go-on SBAC encoder
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;               ///< bin encoder of m_cRDGoOnSbacCoder
+  
+  // substreams
+  Int                     m_iNumSubstreams;                     ///< number of substreams of the picture
+  TEncSbac****            m_ppppcRDSbacCoders;                  ///< SBAC RD storage of each substream
+  TEncBinCABAC****        m_ppppcBinCodersCABAC;                ///< bin encoders of m_ppppcRDSbacCoders
+  TComBitCounter*         m_pcBitCounters;                      ///< bit counter of each substream
+  
+public:
+  // picture being compressed, filled in by the GOP encoder
+  TComPic*                m_pcPic;                              ///< picture
+  TComPicYuv*             m_pcPicYuvRecOut;                     ///< output buffer of the reconstruction
+  AccessUnit*             m_pcAccessUnit;                       ///< access unit of the picture
+  long                    m_iBeforeTime;                        ///< clock() at the start of the picture
+  UInt                    m_uiRealEndAddress;                   ///< address following the last coded unit inside the picture
+  UInt                    m_uiNumSlices;                        ///< number of slices found by the compression
+  UInt*                   m_puiStoredStartCUAddrForEncodingSlice;        ///< slice boundaries found by the compression
+  UInt*                   m_puiStoredStartCUAddrForEncodingEntropySlice; ///< entropy slice boundaries found by the compression
+#if QP_RD_THREADS
+  TComPic*                m_pcTrialPic;                         ///< copy of the picture compressed with one QP candidate, NULL for a picture context
+#endif
+  
+  TEncPicContext();
+  virtual ~TEncPicContext();
+  
+  Void  create          ( TEncTop* pcEncTop, Int iNumSubstreams );
+  Void  destroy         ();
+#if QP_RD_THREADS
+  Void  createTrialPic  ( TEncTop* pcEncTop );
+  Void  initTrialPic    ( TComPic* pcPic, TComSlice* pcSlice );
+#endif
+  
+  TEncSlice*  getSliceEncoder ()  { return &m_cSliceEncoder; }
+#if ME_TZ_VISITED
+  Void  getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated ) { m_cSearch.getTZSearchCounts( ruiPoints, ruiPointsRepeated ); }
+#endif
+  
+  Void  run             ();
+};
+#endif
+
+//! \}
+
+#endif // __TENCPICCONTEXT__
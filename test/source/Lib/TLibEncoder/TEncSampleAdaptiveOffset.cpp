@@ -58,6 +58,14 @@ TEncSampleAdaptiveOffset::TEncSampleAdaptiveOffset()
   m_dCostPartBest = NULL; 
   m_iDistOrg = NULL;      
   m_iTypePartBest = NULL; 
+#if LOOP_FILTER_THREADS
+  for (Int k=0;k<3;k++)
+  {
+    m_iCountRow[k] = NULL;
+    m_iOffsetOrgRow[k] = NULL;
+  }
+  m_bRowStats = false;
+#endif
 }
 TEncSampleAdaptiveOffset::~TEncSampleAdaptiveOffset()
 {
@@ -402,6 +410,24 @@ Void TEncSampleAdaptiveOffset::destroyEncBuffer()
   {
     delete [] m_iOffsetOrg ; m_iOffsetOrg = NULL;
   }
+#if LOOP_FILTER_THREADS
+  for (Int k=0;k<3;k++)
+  {
+    for (Int i=0;i<m_iNumTotalParts;i++)
+    {
+      for (Int j=0;j<MAX_NUM_SAO_TYPE;j++)
+      {
+        delete [] m_iCountRow[k][i][j];
+        delete [] m_iOffsetOrgRow[k][i][j];
+      }
+      delete [] m_iCountRow[k][i];
+      delete [] m_iOffsetOrgRow[k][i];
+    }
+    delete [] m_iCountRow[k]; m_iCountRow[k] = NULL;
+    delete [] m_iOffsetOrgRow[k]; m_iOffsetOrgRow[k] = NULL;
+  }
+  freeSaoParam(&m_cRowStatsParam);
+#endif
 
   Int iMaxDepth = 4;
   Int iDepth;
@@ -458,6 +484,25 @@ Void TEncSampleAdaptiveOffset::createEncBuffer()
       m_iOffsetOrg[i][j]= new Int64 [MAX_NUM_SAO_CLASS]; 
     }
   }
+#if LOOP_FILTER_THREADS
+
+  for (Int k=0;k<3;k++)
+  {
+    m_iCountRow[k] = new Int64 **[m_iNumTotalParts];
+    m_iOffsetOrgRow[k] = new Int64 **[m_iNumTotalParts];
+    for (Int i=0;i<m_iNumTotalParts;i++)
+    {
+      m_iCountRow[k][i] = new Int64 *[MAX_NUM_SAO_TYPE];
+      m_iOffsetOrgRow[k][i] = new Int64 *[MAX_NUM_SAO_TYPE];
+      for (Int j=0;j<MAX_NUM_SAO_TYPE;j++)
+      {
+        m_iCountRow[k][i][j] = new Int64 [MAX_NUM_SAO_CLASS];
+        m_iOffsetOrgRow[k][i][j] = new Int64 [MAX_NUM_SAO_CLASS];
+      }
+    }
+  }
+  allocSaoParam(&m_cRowStatsParam);
+#endif
 
   Int iMaxDepth = 4;
   m_pppcRDSbacCoder = new TEncSbac** [iMaxDepth+1];
@@ -507,8 +552,65 @@ Void TEncSampleAdaptiveOffset::endSaoEnc()
 {
   m_pcPic = NULL;
   m_pcEntropyCoder = NULL;
+#if LOOP_FILTER_THREADS
+  m_bRowStats = false;
+#endif
+}
+
+#if LOOP_FILTER_THREADS
+/** Start gathering the SAO statistics of a picture row by row
+ * \param pcPic picture whose statistics are gathered by calcSaoStatsRow() before SAOProcess()
+ */
+Void TEncSampleAdaptiveOffset::startSaoRowStats(TComPic* pcPic)
+{
+  m_pcPic = pcPic;
+  for (Int k=0;k<3;k++)
+  {
+    for (Int i=0;i<m_iNumTotalParts;i++)
+    {
+      for (Int j=0;j<MAX_NUM_SAO_TYPE;j++)
+      {
+        ::memset(m_iCountRow[k][i][j], 0, sizeof(Int64)*MAX_NUM_SAO_CLASS);
+        ::memset(m_iOffsetOrgRow[k][i][j], 0, sizeof(Int64)*MAX_NUM_SAO_CLASS);
+      }
+    }
+  }
+  m_bRowStats = true;
 }
 
+/** Gather the SAO statistics of one LCU row of all components
+ * \param iRow LCU row index, the rows above and below have to be deblocked
+ */
+Void TEncSampleAdaptiveOffset::calcSaoStatsRow(Int iRow)
+{
+  SAOQTPart*  psQTPart = m_cRowStatsParam.psSaoPart[0];
+  Int iFrameWidthInCU  = m_pcPic->getFrameWidthInCU();
+  Int iPartStart       = (m_uiMaxSplitLevel == 0) ? 0 : m_aiNumCulPartsLevel[m_uiMaxSplitLevel-1];
+  Int iPartEnd         = m_aiNumCulPartsLevel[m_uiMaxSplitLevel];
+
+  for (Int iYCbCr=0; iYCbCr<3; iYCbCr++)
+  {
+    // calcSaoStatsCu() accumulates into m_iCount and m_iOffsetOrg
+    swap(m_iCount, m_iCountRow[iYCbCr]);
+    swap(m_iOffsetOrg, m_iOffsetOrgRow[iYCbCr]);
+    for (Int iPartIdx=iPartStart; iPartIdx<iPartEnd; iPartIdx++)
+    {
+      SAOQTPart* pOnePart = &(psQTPart[iPartIdx]);
+      if (iRow < pOnePart->StartCUY || iRow > pOnePart->EndCUY)
+      {
+        continue;
+      }
+      for (Int LcuIdxX = pOnePart->StartCUX; LcuIdxX<= pOnePart->EndCUX; LcuIdxX++)
+      {
+        calcSaoStatsCu(iRow*iFrameWidthInCU + LcuIdxX, iPartIdx, iYCbCr);
+      }
+    }
+    swap(m_iCount, m_iCountRow[iYCbCr]);
+    swap(m_iOffsetOrg, m_iOffsetOrgRow[iYCbCr]);
+  }
+}
+#endif
+
 inline int xSign(int x)
 {
   return ((x >> 31) | ((int)( (((unsigned int) -x)) >> 31)));
@@ -1115,6 +1217,34 @@ Void TEncSampleAdaptiveOffset::calcSaoStatsCu(Int iAddr, Int iPartIdx, Int iYCbC
 
   iStride    =  (iYCbCr == 0)? m_pcPic->getStride(): m_pcPic->getCStride();
 
+#if SIMD_SAO && SIMD_X86
+  if ( getSimdLevel() >= SIMD_SSE2 )
+  {
+    pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
+    pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
+
+    iStartX = (uiLPelX == 0) ? 1 : 0;
+    iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth;
+    iStartY = (uiTPelY == 0) ? 1 : 0;
+    iEndY   = (uiBPelY == iPicHeightTmp) ? iLcuHeight-1 : iLcuHeight;
+
+    xCalcSaoStatsBoSimd( pRec, pOrg, iStride, iLcuWidth, iLcuHeight,
+                         m_iOffsetOrg[iPartIdx][SAO_BO_0], m_iCount[iPartIdx][SAO_BO_0], m_iOffsetOrg[iPartIdx][SAO_BO_1], m_iCount[iPartIdx][SAO_BO_1] );
+    xCalcSaoStatsEoSimd( pRec, pOrg, iStride, iStartX, iEndX, iLcuHeight, -1, 1,
+                         m_iOffsetOrg[iPartIdx][SAO_EO_0], m_iCount[iPartIdx][SAO_EO_0] );
+
+    pOrg += iStartY*iStride;
+    pRec += iStartY*iStride;
+    xCalcSaoStatsEoSimd( pRec, pOrg, iStride, 0, iLcuWidth, iEndY-iStartY, -iStride, iStride,
+                         m_iOffsetOrg[iPartIdx][SAO_EO_1], m_iCount[iPartIdx][SAO_EO_1] );
+    xCalcSaoStatsEoSimd( pRec, pOrg, iStride, iStartX, iEndX, iEndY-iStartY, -iStride-1, iStride+1,
+                         m_iOffsetOrg[iPartIdx][SAO_EO_2], m_iCount[iPartIdx][SAO_EO_2] );
+    xCalcSaoStatsEoSimd( pRec, pOrg, iStride, iStartX, iEndX, iEndY-iStartY, -iStride+1, iStride-1,
+                         m_iOffsetOrg[iPartIdx][SAO_EO_3], m_iCount[iPartIdx][SAO_EO_3] );
+    return;
+  }
+#endif
+
 //if(iSaoType == BO_0 || iSaoType == BO_1)
   {
     iStats = m_iOffsetOrg[iPartIdx][SAO_BO_0];
@@ -1556,6 +1686,20 @@ Void TEncSampleAdaptiveOffset::calcSaoStatsCu(Int iAddr, Int iPartIdx, Int iYCbC
 }
 #endif
 
+#if LOOP_FILTER_THREADS
+/** load the statistics of a leaf partition gathered by calcSaoStatsRow()
+ * \param  iPartIdx,  iYCbCr
+ */
+Void TEncSampleAdaptiveOffset::xLoadSaoRowStats(Int iPartIdx, Int iYCbCr)
+{
+  for (Int iTypeIdx=0; iTypeIdx<MAX_NUM_SAO_TYPE; iTypeIdx++)
+  {
+    ::memcpy(m_iOffsetOrg[iPartIdx][iTypeIdx], m_iOffsetOrgRow[iYCbCr][iPartIdx][iTypeIdx], sizeof(Int64)*MAX_NUM_SAO_CLASS);
+    ::memcpy(m_iCount    [iPartIdx][iTypeIdx], m_iCountRow    [iYCbCr][iPartIdx][iTypeIdx], sizeof(Int64)*MAX_NUM_SAO_CLASS);
+  }
+}
+
+#endif
 /** get SAO statistics
  * \param  *psQTPart,  iYCbCr
  */
@@ -1577,6 +1721,13 @@ Void TEncSampleAdaptiveOffset::getSaoStats(SAOQTPart *psQTPart, Int iYCbCr)
   {
     iPartIdx = 0;
     pOnePart = &(psQTPart[iPartIdx]);
+#if LOOP_FILTER_THREADS
+    if (m_bRowStats)
+    {
+      xLoadSaoRowStats(iPartIdx, iYCbCr);
+    }
+    else
+#endif
     for (LcuIdxY = pOnePart->StartCUY; LcuIdxY<= pOnePart->EndCUY; LcuIdxY++)
     {
       for (LcuIdxX = pOnePart->StartCUX; LcuIdxX<= pOnePart->EndCUX; LcuIdxX++)
@@ -1591,6 +1742,13 @@ Void TEncSampleAdaptiveOffset::getSaoStats(SAOQTPart *psQTPart, Int iYCbCr)
     for(iPartIdx=m_aiNumCulPartsLevel[m_uiMaxSplitLevel-1]; iPartIdx<m_aiNumCulPartsLevel[m_uiMaxSplitLevel]; iPartIdx++)
     {
       pOnePart = &(psQTPart[iPartIdx]);
+#if LOOP_FILTER_THREADS
+      if (m_bRowStats)
+      {
+        xLoadSaoRowStats(iPartIdx, iYCbCr);
+        continue;
+      }
+#endif
       for (LcuIdxY = pOnePart->StartCUY; LcuIdxY<= pOnePart->EndCUY; LcuIdxY++)
       {
         for (LcuIdxX = pOnePart->StartCUX; LcuIdxX<= pOnePart->EndCUX; LcuIdxX++)
@@ -1748,4 +1906,143 @@ Void TEncSampleAdaptiveOffset::SAOProcess(SAOParam *pcSaoParam, Double dLambda)
 #endif
   }
 }
+
+#if SIMD_SAO && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/** band offset statistics of a block for both band groups, same result as the loops of calcSaoStatsCuOrg()
+ * \param pRec, pOrg, iStride  reconstructed and original samples of the block
+ * \param iWidth, iHeight      size of the block
+ * \param iStatsBo0, iCountBo0, iStatsBo1, iCountBo1  statistics of SAO_BO_0 and SAO_BO_1
+ *
+ * The band and the difference of 8 samples are derived at once, the sums are gathered per band in a single pass
+ * and distributed to the classes of the two band groups at the end.
+ */
+Void TEncSampleAdaptiveOffset::xCalcSaoStatsBoSimd(Pel* pRec, Pel* pOrg, Int iStride, Int iWidth, Int iHeight, Int64* iStatsBo0, Int64* iCountBo0, Int64* iStatsBo1, Int64* iCountBo1)
+{
+  Int   iShift = g_uiBitDepth + g_uiBitIncrement - SAO_BO_BITS;
+  Int   aiSum  [LUMA_GROUP_NUM];
+  Int   aiCount[LUMA_GROUP_NUM];
+  Short asBand[8];
+  Short asDiff[8];
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+
+  ::memset( aiSum,   0, sizeof(aiSum) );
+  ::memset( aiCount, 0, sizeof(aiCount) );
+
+  for (Int y = 0; y < iHeight; y++)
+  {
+    Int x = 0;
+    for (; x + 8 <= iWidth; x += 8)
+    {
+      __m128i vRec = _mm_loadu_si128( (const __m128i*)&pRec[x] );
+      __m128i vOrg = _mm_loadu_si128( (const __m128i*)&pOrg[x] );
+      _mm_storeu_si128( (__m128i*)asBand, _mm_sra_epi16( vRec, vShift ) );
+      _mm_storeu_si128( (__m128i*)asDiff, _mm_sub_epi16( vOrg, vRec ) );
+      for (Int i = 0; i < 8; i++)
+      {
+        aiSum  [asBand[i]] += asDiff[i];
+        aiCount[asBand[i]] ++;
+      }
+    }
+    for (; x < iWidth; x++)
+    {
+      aiSum  [pRec[x] >> iShift] += pOrg[x] - pRec[x];
+      aiCount[pRec[x] >> iShift] ++;
+    }
+    pRec += iStride;
+    pOrg += iStride;
+  }
+
+  for (Int iBand = 0; iBand < LUMA_GROUP_NUM; iBand++)
+  {
+    Int iClassIdx = m_ppLumaTableBo0[iBand << iShift];
+    if (iClassIdx)
+    {
+      iStatsBo0[iClassIdx] += aiSum  [iBand];
+      iCountBo0[iClassIdx] += aiCount[iBand];
+    }
+    iClassIdx = m_ppLumaTableBo1[iBand << iShift];
+    if (iClassIdx)
+    {
+      iStatsBo1[iClassIdx] += aiSum  [iBand];
+      iCountBo1[iClassIdx] += aiCount[iBand];
+    }
+  }
+}
+
+/** edge offset statistics of the samples iStartX..iEndX-1 of iRows lines, 8 samples per step
+ * \param pRec, pOrg, iStride  reconstructed and original samples of the first line
+ * \param iOffsetA, iOffsetB   positions of the two neighbours relative to the current sample
+ * \param iStats, iCount       statistics of the edge offset type
+ *
+ * The differences are summed per edge type in 32-bit lanes, the samples are counted in 16-bit lanes that are
+ * flushed after each line.
+ */
+Void TEncSampleAdaptiveOffset::xCalcSaoStatsEoSimd(Pel* pRec, Pel* pOrg, Int iStride, Int iStartX, Int iEndX, Int iRows, Int iOffsetA, Int iOffsetB, Int64* iStats, Int64* iCount)
+{
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  __m128i vSum      [5];
+  __m128i vCount    [5];
+  __m128i vLineCount[5];
+  Int     aiSum  [5] = { 0, 0, 0, 0, 0 };
+  Int     aiCount[5] = { 0, 0, 0, 0, 0 };
+
+  for (Int i = 0; i < 5; i++)
+  {
+    vSum  [i] = _mm_setzero_si128();
+    vCount[i] = _mm_setzero_si128();
+  }
+
+  for (Int y = 0; y < iRows; y++)
+  {
+    for (Int i = 0; i < 5; i++)
+    {
+      vLineCount[i] = _mm_setzero_si128();
+    }
+    Int x = iStartX;
+    for (; x + 8 <= iEndX; x += 8)
+    {
+      __m128i vCur  = _mm_loadu_si128( (const __m128i*)&pRec[x] );
+      __m128i vA    = _mm_loadu_si128( (const __m128i*)&pRec[x + iOffsetA] );
+      __m128i vB    = _mm_loadu_si128( (const __m128i*)&pRec[x + iOffsetB] );
+      __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&pOrg[x] ), vCur );
+      // sign(cur - a) + sign(cur - b), the edge type minus 2
+      __m128i vEdge = _mm_add_epi16( _mm_sub_epi16( _mm_cmpgt_epi16( vA, vCur ), _mm_cmpgt_epi16( vCur, vA ) ),
+                                     _mm_sub_epi16( _mm_cmpgt_epi16( vB, vCur ), _mm_cmpgt_epi16( vCur, vB ) ) );
+      for (Int i = 0; i < 5; i++)
+      {
+        __m128i vMask = _mm_cmpeq_epi16( vEdge, _mm_set1_epi16( (Short)( i - 2 ) ) );
+        vSum      [i] = _mm_add_epi32( vSum[i], _mm_madd_epi16( _mm_and_si128( vMask, vDiff ), vOne ) );
+        vLineCount[i] = _mm_sub_epi16( vLineCount[i], vMask );
+      }
+    }
+    for (Int i = 0; i < 5; i++)
+    {
+      vCount[i] = _mm_add_epi32( vCount[i], _mm_madd_epi16( vLineCount[i], vOne ) );
+    }
+    for (; x < iEndX; x++)
+    {
+      UInt uiEdgeType = xSign( pRec[x] - pRec[x + iOffsetA] ) + xSign( pRec[x] - pRec[x + iOffsetB] ) + 2;
+      aiSum  [uiEdgeType] += pOrg[x] - pRec[x];
+      aiCount[uiEdgeType] ++;
+    }
+    pRec += iStride;
+    pOrg += iStride;
+  }
+
+  for (Int i = 0; i < 5; i++)
+  {
+    Int aiSumLane  [4];
+    Int aiCountLane[4];
+    _mm_storeu_si128( (__m128i*)aiSumLane,   vSum  [i] );
+    _mm_storeu_si128( (__m128i*)aiCountLane, vCount[i] );
+    iStats[m_auiEoTable[i]] += aiSum  [i] + aiSumLane  [0] + aiSumLane  [1] + aiSumLane  [2] + aiSumLane  [3];
+    iCount[m_auiEoTable[i]] += aiCount[i] + aiCountLane[0] + aiCountLane[1] + aiCountLane[2] + aiCountLane[3];
+  }
+}
+#endif
+
 //! \}
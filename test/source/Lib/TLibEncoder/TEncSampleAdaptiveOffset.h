@@ -77,6 +77,20 @@ private:
   Int     m_iOffsetTh;
 #endif
   Bool    m_bUseSBACRD;
+#if LOOP_FILTER_THREADS
+  SAOParam  m_cRowStatsParam;     ///< partition layout used for gathering the statistics row by row
+  Int64  ***m_iCountRow[3];       ///< m_iCount of the leaf partitions gathered row by row, per component
+  Int64  ***m_iOffsetOrgRow[3];   ///< m_iOffsetOrg of the leaf partitions gathered row by row, per component
+  Bool      m_bRowStats;          ///< the statistics of the current picture have been gathered row by row
+#endif
+
+#if LOOP_FILTER_THREADS
+  Void xLoadSaoRowStats(Int iPartIdx, Int iYCbCr);
+#endif
+#if SIMD_SAO && SIMD_X86
+  SIMD_TARGET_SSE2 Void xCalcSaoStatsBoSimd(Pel* pRec, Pel* pOrg, Int iStride, Int iWidth, Int iHeight, Int64* iStatsBo0, Int64* iCountBo0, Int64* iStatsBo1, Int64* iCountBo1);
+  SIMD_TARGET_SSE2 Void xCalcSaoStatsEoSimd(Pel* pRec, Pel* pOrg, Int iStride, Int iStartX, Int iEndX, Int iRows, Int iOffsetA, Int iOffsetB, Int64* iStats, Int64* iCount);
+#endif
 
 public:
   TEncSampleAdaptiveOffset         ();
@@ -101,6 +115,10 @@ public:
 #endif
   Void destroyEncBuffer();
   Void createEncBuffer();
+#if LOOP_FILTER_THREADS
+  Void startSaoRowStats(TComPic* pcPic);
+  Void calcSaoStatsRow(Int iRow);
+#endif
 };
 #endif
 
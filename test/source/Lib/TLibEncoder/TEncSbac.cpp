@@ -1695,7 +1695,7 @@ Void TEncSbac::codeCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartIdx
 #endif //QC_MDCS
   
 #if NSQT
-  static TCoeff orgCoeff[ 256 ];
+  TCoeff* orgCoeff = m_acNsqtOrgCoeff;
   if( bNonSqureFlag )
   {        
     memcpy( &orgCoeff[ 0 ], pcCoef, uiMaxNumCoeff * sizeof( TCoeff ) );
@@ -159,6 +159,9 @@ protected:
   
   //SBAC RD
   UInt          m_uiCoeffCost;
+#if NSQT
+  TCoeff        m_acNsqtOrgCoeff[ 256 ];  ///< coefficients of a non-square block before re-ordering
+#endif
   
   // Adaptive loop filter
   UInt          m_uiMaxAlfCtrlDepth;
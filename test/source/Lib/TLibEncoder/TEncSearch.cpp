@@ -91,6 +91,39 @@ TEncSearch::TEncSearch()
   m_pcEncCfg = NULL;
   m_pcEntropyCoder = NULL;
   m_pTempPel = NULL;
+#if ME_PYRAMID
+  m_bMvPyramid         = false;
+  m_pcPyramidLCUPic    = NULL;
+  m_iPyramidLCUPOC     = 0;
+  m_uiPyramidLCUAddr   = 0;
+  m_iNumPyramidLCURefs = 0;
+#endif
+#if ME_SUBPEL_PLANES
+  m_pcSubPelRefPic     = NULL;
+  m_iSubPelRefOffset   = 0;
+#endif
+#if ME_SAD_CACHE
+  m_pcSadCache           = NULL;
+  m_uiSadCacheGeneration = 0;
+  m_pcSadCachePic        = NULL;
+  m_iSadCachePOC         = 0;
+  m_uiSadCacheCUAddr     = 0;
+  m_uiSadCacheAbsPartIdx = 0;
+  m_uiSadCacheCUWidth    = 0;
+  m_bSadCache            = false;
+#endif
+#if ME_TZ_VISITED
+  m_pusTZVisited         = NULL;
+  m_usTZVisitedMark      = 0;
+  m_iTZVisitedSize       = 0;
+  m_uiTZPoints           = 0;
+  m_uiTZPointsRepeated   = 0;
+#endif
+#if REF_SEARCH_THREADS
+  m_pcThreadPool = NULL;
+  m_iNumRefJobs  = 0;
+  m_pcRefJobs    = NULL;
+#endif
 
 #if WEIGHT_PRED
   setWpScalingDistParam( NULL, -1, REF_PIC_LIST_X );
@@ -129,6 +162,15 @@ TEncSearch::~TEncSearch()
   delete[] m_pcQTTempTComYuv;
   
   m_tmpYuvPred.destroy();
+#if REF_SEARCH_THREADS
+  delete[] m_pcRefJobs;
+#endif
+#if ME_SAD_CACHE
+  delete[] m_pcSadCache;
+#endif
+#if ME_TZ_VISITED
+  delete[] m_pusTZVisited;
+#endif
 }
 
 void TEncSearch::init(TEncCfg*      pcEncCfg,
@@ -210,7 +252,67 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
   }
   
   m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE);
+#if ME_SAD_CACHE
+  
+  m_pcSadCache = new SadCacheEntry[ ME_SAD_CACHE_MV_RANGE * ME_SAD_CACHE_MV_RANGE ];
+  for ( Int i = 0; i < ME_SAD_CACHE_MV_RANGE * ME_SAD_CACHE_MV_RANGE; i++ )
+  {
+    m_pcSadCache[i].piRef        = NULL;
+    m_pcSadCache[i].uiGeneration = 0;
+    m_pcSadCache[i].uiValid      = 0;
+  }
+#endif
+#if ME_TZ_VISITED
+  
+  m_iTZVisitedSize = 2 * m_iSearchRange + 1;
+  m_pusTZVisited   = new UShort[ m_iTZVisitedSize * m_iTZVisitedSize ];
+  memset( m_pusTZVisited, 0, sizeof(UShort) * m_iTZVisitedSize * m_iTZVisitedSize );
+#endif
+}
+
+#if REF_SEARCH_THREADS
+/** create the motion estimation jobs of the reference pictures, nothing is done if they are not used
+ * \param pcThreadPool thread pool executing the jobs
+ */
+Void TEncSearch::createRefJobs( TComThreadPool* pcThreadPool )
+{
+  if ( !m_pcEncCfg->getUseParallelRefSearch() || pcThreadPool->getNumThreads() == 0 )
+  {
+    return;
+  }
+  
+  m_pcThreadPool = pcThreadPool;
+  m_iNumRefJobs  = m_pcEncCfg->getNumOfReference();
+  if ( m_pcEncCfg->getNumOfReferenceB_L0() > m_iNumRefJobs ) m_iNumRefJobs = m_pcEncCfg->getNumOfReferenceB_L0();
+  if ( m_pcEncCfg->getNumOfReferenceB_L1() > m_iNumRefJobs ) m_iNumRefJobs = m_pcEncCfg->getNumOfReferenceB_L1();
+  
+  m_pcRefJobs = new TEncSearchRefJob[ m_iNumRefJobs ];
+  for ( Int i = 0; i < m_iNumRefJobs; i++ )
+  {
+    m_pcRefJobs[i].m_cSearch.init( m_pcEncCfg, m_pcTrQuant, m_iSearchRange, m_bipredSearchRange, m_iFastSearch, m_iMaxDeltaQP, m_pcEntropyCoder,
+                                   &m_pcRefJobs[i].m_cRdCost, m_pppcRDSbacCoder, m_pcRDGoOnSbacCoder );
+    m_pcRefJobs[i].m_bQueued = false;
+  }
+}
+#endif
+
+#if ME_TZ_VISITED
+/** add the counts of the TZ searches of this object and of its reference jobs
+ * \param ruiPoints         returns the positions submitted to the TZ searches
+ * \param ruiPointsRepeated returns the positions skipped because their TZ search had scored them before
+ */
+Void TEncSearch::getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated )
+{
+  ruiPoints         += m_uiTZPoints;
+  ruiPointsRepeated += m_uiTZPointsRepeated;
+#if REF_SEARCH_THREADS
+  for ( Int i = 0; i < m_iNumRefJobs && m_pcRefJobs; i++ )
+  {
+    m_pcRefJobs[i].m_cSearch.getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+  }
+#endif
 }
+#endif
 
 #if FASTME_SMOOTHER_MV
 #define FIRSTSEARCHSTOP     1
@@ -243,6 +345,13 @@ __inline Void TEncSearch::xTZSearchHelp( TComPattern* pcPatternKey, IntTZSearchS
   
   Pel*  piRefSrch;
   
+#if ME_TZ_VISITED
+  if ( xTZSearchRepeated( rcStruct, iSearchX, iSearchY ) )
+  {
+    return;
+  }
+  
+#endif
   piRefSrch = rcStruct.piRefY + iSearchY * rcStruct.iYStride + iSearchX;
   
   //-- jclee for using the SAD function pointer
@@ -278,6 +387,135 @@ __inline Void TEncSearch::xTZSearchHelp( TComPattern* pcPatternKey, IntTZSearchS
   }
 }
 
+/** queue a candidate of the TZ search, every four queued candidates are scored by one multi-candidate SAD call
+ * \param pcPatternKey original block
+ * \param rcStruct     search state holding the queue
+ * \param iSearchX     horizontal position of the candidate
+ * \param iSearchY     vertical position of the candidate
+ * \param ucPointNr    pattern point number of the candidate
+ * \param uiDistance   pattern distance of the candidate
+ *
+ * The candidates are compared with the best point in the order they were queued, the search result is the same as
+ * with one xTZSearchHelp call per candidate. The callers end a pattern with xTZSearchFlush.
+ */
+__inline Void TEncSearch::xTZSearchPush( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
+{
+#if ME_SAD_X4
+#if ME_TZ_VISITED
+  if ( xTZSearchRepeated( rcStruct, iSearchX, iSearchY ) )
+  {
+    return;
+  }
+#endif
+  Int iCand = rcStruct.iNumCand++;
+  rcStruct.aiCandX        [iCand] = iSearchX;
+  rcStruct.aiCandY        [iCand] = iSearchY;
+  rcStruct.aucCandPointNr [iCand] = ucPointNr;
+  rcStruct.auiCandDistance[iCand] = uiDistance;
+  if ( rcStruct.iNumCand == 4 )
+  {
+    xTZSearchFlush( pcPatternKey, rcStruct );
+  }
+#else
+  xTZSearchHelp( pcPatternKey, rcStruct, iSearchX, iSearchY, ucPointNr, uiDistance );
+#endif
+}
+
+/** score the queued candidates of the TZ search, a full queue in one multi-candidate SAD call, a partial queue
+ *  with single SAD calls sharing one DistParam setup
+ */
+__inline Void TEncSearch::xTZSearchFlush( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct )
+{
+#if ME_SAD_X4
+  if ( rcStruct.iNumCand == 0 )
+  {
+    return;
+  }
+  
+  Pel* apiRefSrch[4];
+  UInt auiSad[4];
+  for ( Int iCand = 0; iCand < rcStruct.iNumCand; iCand++ )
+  {
+    apiRefSrch[iCand] = rcStruct.piRefY + rcStruct.aiCandY[iCand] * rcStruct.iYStride + rcStruct.aiCandX[iCand];
+  }
+  
+  m_pcRdCost->setDistParam( pcPatternKey, apiRefSrch[0], rcStruct.iYStride,  m_cDistParam );
+  
+  // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
+  if ( m_pcEncCfg->getUseFastEnc() )
+  {
+    if ( m_cDistParam.iRows > 8 )
+    {
+      m_cDistParam.iSubShift = 1;
+    }
+  }
+  
+#if WEIGHT_PRED
+  setDistParamComp(0);  // Y component
+#endif
+  
+  if ( rcStruct.iNumCand == 4 )
+  {
+    m_cDistParam.DistFuncX4( &m_cDistParam, apiRefSrch, auiSad );
+  }
+  else
+  {
+    for ( Int iCand = 0; iCand < rcStruct.iNumCand; iCand++ )
+    {
+      m_cDistParam.pCur = apiRefSrch[iCand];
+      auiSad[iCand] = m_cDistParam.DistFunc( &m_cDistParam );
+    }
+  }
+  
+  for ( Int iCand = 0; iCand < rcStruct.iNumCand; iCand++ )
+  {
+    Int  iSearchX = rcStruct.aiCandX[iCand];
+    Int  iSearchY = rcStruct.aiCandY[iCand];
+    UInt uiSad    = auiSad[iCand] + m_pcRdCost->getCost( iSearchX, iSearchY );
+    if( uiSad < rcStruct.uiBestSad )
+    {
+      rcStruct.uiBestSad      = uiSad;
+      rcStruct.iBestX         = iSearchX;
+      rcStruct.iBestY         = iSearchY;
+      rcStruct.uiBestDistance = rcStruct.auiCandDistance[iCand];
+      rcStruct.uiBestRound    = 0;
+      rcStruct.ucPointNr      = rcStruct.aucCandPointNr[iCand];
+    }
+  }
+  rcStruct.iNumCand = 0;
+#endif
+}
+
+#if ME_TZ_VISITED
+/** check whether the current TZ search has scored a position before and mark it
+ * \param rcStruct search state holding the marks of the search window
+ * \param iSearchX horizontal position
+ * \param iSearchY vertical position
+ * \returns true if the position was scored before, its cost was compared with the best point then and cannot win now
+ */
+__inline Bool TEncSearch::xTZSearchRepeated( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY )
+{
+  m_uiTZPoints++;
+  
+  UInt uiX = (UInt)( iSearchX - rcStruct.iVisitedLeft );
+  UInt uiY = (UInt)( iSearchY - rcStruct.iVisitedTop  );
+  if ( rcStruct.pusVisited == NULL || uiX >= (UInt)rcStruct.iVisitedWidth || uiY >= (UInt)rcStruct.iVisitedHeight )
+  {
+    // start points outside of the search window are not marked
+    return false;
+  }
+  
+  UShort* pusMark = rcStruct.pusVisited + uiY * m_iTZVisitedSize + uiX;
+  if ( *pusMark == m_usTZVisitedMark )
+  {
+    m_uiTZPointsRepeated++;
+    return true;
+  }
+  *pusMark = m_usTZVisitedMark;
+  return false;
+}
+#endif
+
 __inline Void TEncSearch::xTZ2PointSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
@@ -429,38 +667,40 @@ __inline Void TEncSearch::xTZ8PointSquareSearch( TComPattern* pcPatternKey, IntT
   {
     if ( iLeft >= iSrchRngHorLeft ) // check top left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iLeft, iTop, 1, iDist );
     }
     // top middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+    xTZSearchPush( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
     
     if ( iRight <= iSrchRngHorRight ) // check top right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iRight, iTop, 3, iDist );
     }
   } // check top
   if ( iLeft >= iSrchRngHorLeft ) // check middle left
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+    xTZSearchPush( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
   }
   if ( iRight <= iSrchRngHorRight ) // check middle right
   {
-    xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+    xTZSearchPush( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
   }
   if ( iBottom <= iSrchRngVerBottom ) // check bottom
   {
     if ( iLeft >= iSrchRngHorLeft ) // check bottom left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iLeft, iBottom, 6, iDist );
     }
     // check bottom middle
-    xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+    xTZSearchPush( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
     
     if ( iRight <= iSrchRngHorRight ) // check bottom right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iRight, iBottom, 8, iDist );
     }
   } // check bottom
+  
+  xTZSearchFlush( pcPatternKey, rcStruct );
 }
 
 __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist )
@@ -484,19 +724,19 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
   {
     if ( iTop >= iSrchRngVerTop ) // check top
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
     }
     if ( iLeft >= iSrchRngHorLeft ) // check middle left
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
     }
     if ( iRight <= iSrchRngHorRight ) // check middle right
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
     }
     if ( iBottom <= iSrchRngVerBottom ) // check bottom
     {
-      xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+      xTZSearchPush( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
     }
   }
   else // if (iDist != 1)
@@ -511,54 +751,54 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
       if (  iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
+        xTZSearchPush( pcPatternKey, rcStruct, iStartX,  iTop,      2, iDist    );
+        xTZSearchPush( pcPatternKey, rcStruct, iLeft_2,  iTop_2,    1, iDist>>1 );
+        xTZSearchPush( pcPatternKey, rcStruct, iRight_2, iTop_2,    3, iDist>>1 );
+        xTZSearchPush( pcPatternKey, rcStruct, iLeft,    iStartY,   4, iDist    );
+        xTZSearchPush( pcPatternKey, rcStruct, iRight,   iStartY,   5, iDist    );
+        xTZSearchPush( pcPatternKey, rcStruct, iLeft_2,  iBottom_2, 6, iDist>>1 );
+        xTZSearchPush( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, iDist>>1 );
+        xTZSearchPush( pcPatternKey, rcStruct, iStartX,  iBottom,   7, iDist    );
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iStartX, iTop, 2, iDist );
         }
         if ( iTop_2 >= iSrchRngVerTop ) // check half top
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
+            xTZSearchPush( pcPatternKey, rcStruct, iLeft_2, iTop_2, 1, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
+            xTZSearchPush( pcPatternKey, rcStruct, iRight_2, iTop_2, 3, (iDist>>1) );
           }
         } // check half top
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iLeft, iStartY, 4, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iRight, iStartY, 5, iDist );
         }
         if ( iBottom_2 <= iSrchRngVerBottom ) // check half bottom
         {
           if ( iLeft_2 >= iSrchRngHorLeft ) // check half left
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
+            xTZSearchPush( pcPatternKey, rcStruct, iLeft_2, iBottom_2, 6, (iDist>>1) );
           }
           if ( iRight_2 <= iSrchRngHorRight ) // check half right
           {
-            xTZSearchHelp( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
+            xTZSearchPush( pcPatternKey, rcStruct, iRight_2, iBottom_2, 8, (iDist>>1) );
           }
         } // check half bottom
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iStartX, iBottom, 7, iDist );
         }
       } // check border
     }
@@ -567,39 +807,39 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
       if ( iTop >= iSrchRngVerTop && iLeft >= iSrchRngHorLeft &&
           iRight <= iSrchRngHorRight && iBottom <= iSrchRngVerBottom ) // check border
       {
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
-        xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+        xTZSearchPush( pcPatternKey, rcStruct, iStartX, iTop,    0, iDist );
+        xTZSearchPush( pcPatternKey, rcStruct, iLeft,   iStartY, 0, iDist );
+        xTZSearchPush( pcPatternKey, rcStruct, iRight,  iStartY, 0, iDist );
+        xTZSearchPush( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         for ( Int index = 1; index < 4; index++ )
         {
           Int iPosYT = iTop    + ((iDist>>2) * index);
           Int iPosYB = iBottom - ((iDist>>2) * index);
           Int iPosXL = iStartX - ((iDist>>2) * index);
           Int iPosXR = iStartX + ((iDist>>2) * index);
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
-          xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
         }
       }
       else // check border
       {
         if ( iTop >= iSrchRngVerTop ) // check top
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iStartX, iTop, 0, iDist );
         }
         if ( iLeft >= iSrchRngHorLeft ) // check left
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iLeft, iStartY, 0, iDist );
         }
         if ( iRight <= iSrchRngHorRight ) // check right
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iRight, iStartY, 0, iDist );
         }
         if ( iBottom <= iSrchRngVerBottom ) // check bottom
         {
-          xTZSearchHelp( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
+          xTZSearchPush( pcPatternKey, rcStruct, iStartX, iBottom, 0, iDist );
         }
         for ( Int index = 1; index < 4; index++ )
         {
@@ -612,28 +852,30 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
+              xTZSearchPush( pcPatternKey, rcStruct, iPosXL, iPosYT, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
+              xTZSearchPush( pcPatternKey, rcStruct, iPosXR, iPosYT, 0, iDist );
             }
           } // check top
           if ( iPosYB <= iSrchRngVerBottom ) // check bottom
           {
             if ( iPosXL >= iSrchRngHorLeft ) // check left
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
+              xTZSearchPush( pcPatternKey, rcStruct, iPosXL, iPosYB, 0, iDist );
             }
             if ( iPosXR <= iSrchRngHorRight ) // check right
             {
-              xTZSearchHelp( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
+              xTZSearchPush( pcPatternKey, rcStruct, iPosXR, iPosYB, 0, iDist );
             }
           } // check bottom
         } // for ...
       } // check border
     } // iDist <= 8
   } // iDist == 1
+  
+  xTZSearchFlush( pcPatternKey, rcStruct );
 }
 
 //<--
@@ -653,6 +895,12 @@ UInt TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
   Pel*  piRefPos;
 #if GENERIC_IF
   Int iRefStride = m_filteredBlock[0][0].getStride();
+#if ME_SUBPEL_PLANES
+  if ( m_pcSubPelRefPic )
+  {
+    iRefStride = m_pcSubPelRefPic->getPicYuvRec()->getStride();
+  }
+#endif
   m_pcRdCost->setDistParam( pcPatternKey, m_filteredBlock[0][0].getLumaAddr(), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() );
 #else
   m_pcRdCost->setDistParam( pcPatternKey, piRef, iRefStride, iIntStep, m_cDistParam, m_pcEncCfg->getUseHADME() );
@@ -668,11 +916,23 @@ UInt TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
     
     Int horVal = cMvTest.getHor() * iFrac;
     Int verVal = cMvTest.getVer() * iFrac;
+#if ME_SUBPEL_PLANES
+    if ( m_pcSubPelRefPic )
+    {
+      // read the position from the interpolated planes of the reference instead of the interpolated blocks
+      piRefPos = m_pcSubPelRefPic->getPicYuvSubPel( verVal & 3, horVal & 3 )->getLumaAddr() + m_iSubPelRefOffset + ( verVal >> 2 ) * iRefStride + ( horVal >> 2 );
+    }
+    else
+    {
+#endif
     piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getLumaAddr();
     if ( horVal == 2 && ( verVal & 1 ) == 0 )
       piRefPos += 1;
     if ( ( horVal & 1 ) == 0 && verVal == 2 )
       piRefPos += iRefStride;
+#if ME_SUBPEL_PLANES
+    }
+#endif
     cMvTest = pcMvRefine[i];
     cMvTest += rcMvFrac;
 #else
@@ -2648,6 +2908,9 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
     for ( Int iRefList = 0; iRefList < iNumPredDir; iRefList++ )
     {
       RefPicList  eRefPicList = ( iRefList ? REF_PIC_LIST_1 : REF_PIC_LIST_0 );
+#if REF_SEARCH_THREADS
+      Bool        bRefJobs    = xStartRefJobs( pcCU, pcOrgYuv, iPartIdx, iRefList, uiMbBits[iRefList], iRefIdx[0] );
+#endif
       
       for ( Int iRefIdxTemp = 0; iRefIdxTemp < pcCU->getSlice()->getNumRefIdx(eRefPicList); iRefIdxTemp++ )
       {
@@ -2657,6 +2920,13 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
           uiBitsTemp += iRefIdxTemp+1;
           if ( iRefIdxTemp == pcCU->getSlice()->getNumRefIdx(eRefPicList)-1 ) uiBitsTemp--;
         }
+#if REF_SEARCH_THREADS
+        if ( bRefJobs )
+        {
+          xLoadRefJobAMVP( pcCU, iPartIdx, eRefPicList, iRefIdxTemp, cMvPred[iRefList][iRefIdxTemp] );
+        }
+        else
+#endif
 #if ZERO_MVD_EST
         xEstimateMvPredAMVP( pcCU, pcOrgYuv, iPartIdx, eRefPicList, iRefIdxTemp, cMvPred[iRefList][iRefIdxTemp], false, &uiZeroMvdDistTemp);
 #else
@@ -2718,7 +2988,10 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
             }
             else
             {
-              xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
+#if REF_SEARCH_THREADS
+              if ( !bRefJobs || !xGetRefJobResult( iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp ) )
+#endif
+                xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
             }
         }
         else
@@ -2730,11 +3003,17 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
           }
           else
           { 
-            xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
+#if REF_SEARCH_THREADS
+            if ( !bRefJobs || !xGetRefJobResult( iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp ) )
+#endif
+              xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
           }        
         }
 #else
-        xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
+#if REF_SEARCH_THREADS
+        if ( !bRefJobs || !xGetRefJobResult( iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp ) )
+#endif
+          xMotionEstimation ( pcCU, pcOrgYuv, iPartIdx, eRefPicList, &cMvPred[iRefList][iRefIdxTemp], iRefIdxTemp, cMvTemp[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp );
 #endif
         xCopyAMVPInfo(pcCU->getCUMvField(eRefPicList)->getAMVPInfo(), &aacAMVPInfo[iRefList][iRefIdxTemp]); // must always be done ( also when AMVP_MODE = AM_NONE )
         if ( pcCU->getAMVPMode(uiPartAddr) == AM_EXPL )
@@ -2794,6 +3073,12 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
             }
           }
       }
+#if REF_SEARCH_THREADS
+      if ( bRefJobs )
+      {
+        xFinishRefJobs();
+      }
+#endif
     }
     //  Bi-directional prediction
     if ( pcCU->getSlice()->isInterB() )
@@ -3613,7 +3898,7 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_iSearchRange = m_aaiAdaptSR[eRefPicList][iRefIdxPred];
   
   Int           iSrchRng      = ( bBi ? m_bipredSearchRange : m_iSearchRange );
-  TComPattern*  pcPatternKey  = pcCU->getPattern        ();
+  TComPattern*  pcPatternKey  = &m_cPatternKey;
   
   Double        fWeight       = 1.0;
   
@@ -3655,6 +3940,20 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
 
 #if WEIGHT_PRED
   setWpScalingDistParam( pcCU, iRefIdxPred, eRefPicList );
+#endif
+#if ME_SAD_CACHE
+  // the full search visits the positions of the 2Nx2N search again for the other partition shapes of the CU, the start
+  // points of the TZ search move with the partition and too few of its positions repeat to pay for the lookups. the
+  // bi-predictive search key is not the original and weighted prediction scales the reference.
+  m_bSadCache = false;
+#if WEIGHT_PRED
+  if ( !m_iFastSearch && !bBi && !m_cDistParam.bApplyWeight )
+#else
+  if ( !m_iFastSearch && !bBi )
+#endif
+  {
+    xSadCacheInit( pcCU, pcYuvOrg, uiPartAddr, iRoiWidth, iRoiHeight, iRefIdxPred, iRefStride );
+  }
 #endif
   //  Do integer search
   if ( !m_iFastSearch || bBi )
@@ -3664,12 +3963,45 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   else
   {
     rcMv = *pcMvPred;
+#if ME_PYRAMID
+    m_bMvPyramid = false;
+    if ( m_pcEncCfg->getUseMEPyramid() )
+    {
+      TComPic* pcRefPic = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred );
+      m_bMvPyramid = xPyramidSearch( pcCU, pcPatternKey, pcRefPic, uiPartAddr, m_cMvPyramid );
+      if ( m_bMvPyramid )
+      {
+        // extend the search window by the search range around the start point of the hierarchical search
+        TComMv cMvPyramid = m_cMvPyramid;
+        TComMv cMvPyramidRngLT;
+        TComMv cMvPyramidRngRB;
+        cMvPyramid <<= 2;
+        xSetSearchRange( pcCU, cMvPyramid, iSrchRng, cMvPyramidRngLT, cMvPyramidRngRB );
+        cMvSrchRngLT.set( min( cMvSrchRngLT.getHor(), cMvPyramidRngLT.getHor() ), min( cMvSrchRngLT.getVer(), cMvPyramidRngLT.getVer() ) );
+        cMvSrchRngRB.set( max( cMvSrchRngRB.getHor(), cMvPyramidRngRB.getHor() ), max( cMvSrchRngRB.getVer(), cMvPyramidRngRB.getVer() ) );
+      }
+    }
+#endif
     xPatternSearchFast  ( pcCU, pcPatternKey, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost );
   }
+#if ME_SAD_CACHE
+  m_bSadCache = false;
+#endif
   
   m_pcRdCost->getMotionCost( 1, 0 );
   m_pcRdCost->setCostScale ( 1 );
   
+#if ME_SUBPEL_PLANES
+  m_pcSubPelRefPic = NULL;
+  if ( m_pcEncCfg->getUseSubPelPlanes() )
+  {
+    TComPic* pcRefPic = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred );
+    if ( pcRefPic->getPicYuvSubPel( 0, 1 ) )
+    {
+      m_pcSubPelRefPic = pcRefPic;
+    }
+  }
+#endif
   {
     xPatternSearchFracDIF( pcCU, pcPatternKey, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost
 #if GENERIC_IF
@@ -3692,6 +4024,162 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
 }
 
 
+#if REF_SEARCH_THREADS
+/** estimate the motion vector predictors of a prediction unit in all reference pictures of a list and queue the motion
+ *  estimations the reference loop of predInterSearch does, each one on its own job
+ * \param pcCU CU of the prediction unit
+ * \param pcOrgYuv original samples of the CU
+ * \param iPartIdx prediction unit index
+ * \param iRefList reference picture list index
+ * \param uiMbBits bits of the prediction direction
+ * \param iRefIdxL0 best reference picture index of list 0
+ * \returns true if the motion estimations have been queued
+ */
+Bool TEncSearch::xStartRefJobs( TComDataCU* pcCU, TComYuv* pcOrgYuv, Int iPartIdx, Int iRefList, UInt uiMbBits, Int iRefIdxL0 )
+{
+  TComSlice*  pcSlice     = pcCU->getSlice();
+  RefPicList  eRefPicList = ( iRefList ? REF_PIC_LIST_1 : REF_PIC_LIST_0 );
+  Int         iNumRefIdx  = pcSlice->getNumRefIdx( eRefPicList );
+  
+#if ZERO_MVD_EST
+  return false;
+#endif
+  if ( m_pcRefJobs == NULL || iNumRefIdx < 2 || iNumRefIdx > m_iNumRefJobs || pcSlice->getPPS()->getUseWP() || pcSlice->getPPS()->getWPBiPredIdc() )
+  {
+    return false;
+  }
+  
+  UInt uiPartAddr;
+  Int  iRoiWidth, iRoiHeight;
+  pcCU->getPartIndexAndSize( iPartIdx, uiPartAddr, iRoiWidth, iRoiHeight );
+  
+  for ( Int iRefIdxTemp = 0; iRefIdxTemp < iNumRefIdx; iRefIdxTemp++ )
+  {
+    TEncSearchRefJob* pcJob = &m_pcRefJobs[iRefIdxTemp];
+    
+    pcJob->m_uiBits = uiMbBits + iRefIdxTemp + 1;
+    if ( iRefIdxTemp == iNumRefIdx-1 ) pcJob->m_uiBits--;
+    
+    xEstimateMvPredAMVP( pcCU, pcOrgYuv, iPartIdx, eRefPicList, iRefIdxTemp, pcJob->m_cMvPred );
+    pcJob->m_iMvpIdx = pcCU->getMVPIdx( eRefPicList, uiPartAddr );
+    pcJob->m_iMvpNum = pcCU->getMVPNum( eRefPicList, uiPartAddr );
+    xCopyAMVPInfo( pcCU->getCUMvField( eRefPicList )->getAMVPInfo(), &pcJob->m_cAMVPInfo );
+    
+#if MRG_AMVP_FIXED_IDX_F470
+    pcJob->m_uiBits += m_auiMVPIdxCost[pcJob->m_iMvpIdx][AMVP_MAX_NUM_CANDS];
+#else
+    pcJob->m_uiBits += m_auiMVPIdxCost[pcJob->m_iMvpIdx][pcJob->m_iMvpNum];
+#endif
+  }
+  
+  for ( Int iRefIdxTemp = 0; iRefIdxTemp < iNumRefIdx; iRefIdxTemp++ )
+  {
+    // skip the reference pictures whose motion is taken from list 0
+    Bool bSearch = true;
+#if GPB_SIMPLE_UNI
+    if ( iRefList )
+    {
+      if ( pcSlice->getSPS()->getUseLDC() || pcSlice->getNumRefIdx(REF_PIC_LIST_C) > 0 )
+      {
+        bSearch = !( ( pcSlice->getSPS()->getUseLDC() && iRefIdxTemp != iRefIdxL0 ) || pcSlice->getNoBackPredFlag() ||
+                     ( pcSlice->getNumRefIdx(REF_PIC_LIST_C) > 0 && pcSlice->getRefIdxOfL0FromRefIdxOfL1(iRefIdxTemp) >= 0 ) );
+      }
+      else
+      {
+        bSearch = !pcSlice->getNoBackPredFlag();
+      }
+    }
+#endif
+    if ( !bSearch )
+    {
+      continue;
+    }
+    
+    TEncSearchRefJob* pcJob = &m_pcRefJobs[iRefIdxTemp];
+    pcJob->m_cRdCost.copyRDParam( m_pcRdCost );
+    pcJob->m_pcCU        = pcCU;
+    pcJob->m_pcYuvOrg    = pcOrgYuv;
+    pcJob->m_iPartIdx    = iPartIdx;
+    pcJob->m_eRefPicList = eRefPicList;
+    pcJob->m_iRefIdx     = iRefIdxTemp;
+    pcJob->m_bQueued     = true;
+    pcJob->m_cSearch.m_aaiAdaptSR[iRefList][iRefIdxTemp] = m_aaiAdaptSR[iRefList][iRefIdxTemp];
+    
+    m_pcThreadPool->addJob( pcJob );
+  }
+  
+  return true;
+}
+
+/** restore the motion vector predictor of a reference picture estimated by xStartRefJobs
+ * \param pcCU CU of the prediction unit
+ * \param iPartIdx prediction unit index
+ * \param eRefPicList reference picture list
+ * \param iRefIdx reference picture index
+ * \param rcMvPred returns the motion vector predictor
+ */
+Void TEncSearch::xLoadRefJobAMVP( TComDataCU* pcCU, Int iPartIdx, RefPicList eRefPicList, Int iRefIdx, TComMv& rcMvPred )
+{
+  TEncSearchRefJob* pcJob = &m_pcRefJobs[iRefIdx];
+  UInt              uiPartAddr;
+  Int               iRoiWidth, iRoiHeight;
+  
+  pcCU->getPartIndexAndSize( iPartIdx, uiPartAddr, iRoiWidth, iRoiHeight );
+  
+  xCopyAMVPInfo( &pcJob->m_cAMVPInfo, pcCU->getCUMvField( eRefPicList )->getAMVPInfo() );
+  pcCU->setMVPIdxSubParts( pcJob->m_iMvpIdx, eRefPicList, uiPartAddr, iPartIdx, pcCU->getDepth(uiPartAddr) );
+  pcCU->setMVPNumSubParts( pcJob->m_iMvpNum, eRefPicList, uiPartAddr, iPartIdx, pcCU->getDepth(uiPartAddr) );
+  rcMvPred = pcJob->m_cMvPred;
+}
+
+/** wait for the motion estimation of a reference picture and take its result
+ * \param iRefIdx reference picture index
+ * \param rcMv returns the motion vector
+ * \param ruiBits returns the bits including the motion vector bits
+ * \param ruiCost returns the cost
+ * \returns false if the motion estimation of iRefIdx has not been queued
+ */
+Bool TEncSearch::xGetRefJobResult( Int iRefIdx, TComMv& rcMv, UInt& ruiBits, UInt& ruiCost )
+{
+  TEncSearchRefJob* pcJob = &m_pcRefJobs[iRefIdx];
+  
+  if ( !pcJob->m_bQueued )
+  {
+    return false;
+  }
+  
+  m_pcThreadPool->runJob( pcJob );
+  pcJob->m_bQueued = false;
+  
+  rcMv    = pcJob->m_cMv;
+  ruiBits = pcJob->m_uiBits;
+  ruiCost = pcJob->m_uiCost;
+  
+  // leave the RD cost as the motion estimation of the serial loop does
+  m_pcRdCost->copyRDParam( &pcJob->m_cRdCost );
+  return true;
+}
+
+/** wait for the motion estimations whose result has not been taken
+ */
+Void TEncSearch::xFinishRefJobs()
+{
+  for ( Int i = 0; i < m_iNumRefJobs; i++ )
+  {
+    if ( m_pcRefJobs[i].m_bQueued )
+    {
+      m_pcThreadPool->runJob( &m_pcRefJobs[i] );
+      m_pcRefJobs[i].m_bQueued = false;
+    }
+  }
+}
+
+Void TEncSearchRefJob::run()
+{
+  m_cSearch.xMotionEstimation( m_pcCU, m_pcYuvOrg, m_iPartIdx, m_eRefPicList, &m_cMvPred, m_iRefIdx, m_cMv, m_uiBits, m_uiCost );
+}
+#endif
+
 Void TEncSearch::xSetSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng, TComMv& rcMvSrchRngLT, TComMv& rcMvSrchRngRB )
 {
   Int  iMvShift = 2;
@@ -3710,6 +4198,402 @@ Void TEncSearch::xSetSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int iSrchR
   rcMvSrchRngRB >>= iMvShift;
 }
 
+#if ME_PYRAMID
+/** hierarchical motion search of a prediction unit in the pyramid of a reference picture
+ * \param pcCU CU of the prediction unit
+ * \param pcPatternKey search key
+ * \param pcRefPic reference picture, its pyramid is built when the picture is finished
+ * \param uiPartAddr address of the prediction unit in the CU
+ * \param rcMv returns the integer start point for the TZ search
+ * \returns false when the prediction unit is too small for the pyramid or the pyramid is not built
+ *
+ * The motion of the whole LCU found by xPyramidSearchLCU() is refined by +-2 at the coarsest level the prediction
+ * unit allows (at least 4 samples wide and high) and by +-1 at each finer level down to half resolution.
+ */
+Bool TEncSearch::xPyramidSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, TComPic* pcRefPic, UInt uiPartAddr, TComMv& rcMv )
+{
+  Int iWidth    = pcPatternKey->getROIYWidth();
+  Int iHeight   = pcPatternKey->getROIYHeight();
+  Int iTopLevel = 0;
+  while ( iTopLevel < ME_PYRAMID_LEVELS && ( min( iWidth, iHeight ) >> ( iTopLevel + 1 ) ) >= 4 )
+  {
+    iTopLevel++;
+  }
+  if ( iTopLevel == 0 || pcRefPic->getPicYuvPyramid( ME_PYRAMID_LEVELS ) == NULL )
+  {
+    return false;
+  }
+  
+  TComMv cMvLCU = xPyramidSearchLCU( pcCU, pcRefPic );
+  
+  xPyramidDownscaleKey( pcPatternKey->getROIY(), pcPatternKey->getPatternLStride(), iWidth, iHeight, iTopLevel );
+  
+  Int iPelX  = pcCU->getCUPelX() + g_auiRasterToPelX[ g_auiZscanToRaster[uiPartAddr] ];
+  Int iPelY  = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[uiPartAddr] ];
+  Int iBestX = cMvLCU.getHor() << ( ME_PYRAMID_LEVELS - iTopLevel );
+  Int iBestY = cMvLCU.getVer() << ( ME_PYRAMID_LEVELS - iTopLevel );
+  Int iRange = 2;
+  for ( Int iLevel = iTopLevel; iLevel >= 1; iLevel-- )
+  {
+    xPyramidSearchLevel( pcRefPic->getPicYuvPyramid( iLevel ), iLevel, iPelX, iPelY, iWidth >> iLevel, iHeight >> iLevel,
+                         iBestX - iRange, iBestY - iRange, iBestX + iRange, iBestY + iRange, true, iBestX, iBestY );
+    if ( iLevel > 1 )
+    {
+      iBestX <<= 1;
+      iBestY <<= 1;
+    }
+    iRange = 1;
+  }
+  
+  rcMv.set( iBestX << 3, iBestY << 3 );
+  pcCU->clipMv( rcMv );
+  rcMv >>= 2;
+  return true;
+}
+
+/** motion of the whole LCU of a CU in the top level of the pyramid of a reference picture
+ * \param pcCU CU in the LCU
+ * \param pcRefPic reference picture
+ * \returns motion vector at the top pyramid level
+ *
+ * The LCU is searched once per reference picture over twice the configured search range around the zero vector, by
+ * SAD only so that the result does not depend on the prediction unit that asked first.
+ */
+TComMv TEncSearch::xPyramidSearchLCU( TComDataCU* pcCU, TComPic* pcRefPic )
+{
+  TComPic* pcPic = pcCU->getPic();
+  if ( m_pcPyramidLCUPic != pcPic || m_iPyramidLCUPOC != pcPic->getPOC() || m_uiPyramidLCUAddr != pcCU->getAddr() )
+  {
+    m_pcPyramidLCUPic    = pcPic;
+    m_iPyramidLCUPOC     = pcPic->getPOC();
+    m_uiPyramidLCUAddr   = pcCU->getAddr();
+    m_iNumPyramidLCURefs = 0;
+  }
+  for ( Int i = 0; i < m_iNumPyramidLCURefs; i++ )
+  {
+    if ( m_apcPyramidLCURef[i] == pcRefPic )
+    {
+      return m_acMvPyramidLCU[i];
+    }
+  }
+  
+  TComMv      cMv;
+  TComPicYuv* pcPicYuvOrg = pcPic->getPicYuvOrg();
+  Int         iPelX       = pcPic->getCU( pcCU->getAddr() )->getCUPelX();
+  Int         iPelY       = pcPic->getCU( pcCU->getAddr() )->getCUPelY();
+  Int         iWidth      = min( (Int)g_uiMaxCUWidth,  pcPicYuvOrg->getWidth()  - iPelX ) & ~( ( 1 << ME_PYRAMID_LEVELS ) - 1 );
+  Int         iHeight     = min( (Int)g_uiMaxCUHeight, pcPicYuvOrg->getHeight() - iPelY ) & ~( ( 1 << ME_PYRAMID_LEVELS ) - 1 );
+  if ( iWidth > 0 && iHeight > 0 )
+  {
+    // search window as TComDataCU::clipMv() for the LCU
+    Int iSrchRng = 2 * m_pcEncCfg->getSearchRange();
+    Int iLeft    = max( -iSrchRng, -(Int)g_uiMaxCUWidth  - iPelX + 1 );
+    Int iTop     = max( -iSrchRng, -(Int)g_uiMaxCUHeight - iPelY + 1 );
+    Int iRight   = min(  iSrchRng, pcPicYuvOrg->getWidth()  - iPelX - 1 );
+    Int iBottom  = min(  iSrchRng, pcPicYuvOrg->getHeight() - iPelY - 1 );
+    Int iBestX   = 0;
+    Int iBestY   = 0;
+    
+    xPyramidDownscaleKey( pcPicYuvOrg->getLumaAddr( pcCU->getAddr() ), pcPicYuvOrg->getStride(), iWidth, iHeight, ME_PYRAMID_LEVELS );
+    xPyramidSearchLevel( pcRefPic->getPicYuvPyramid( ME_PYRAMID_LEVELS ), ME_PYRAMID_LEVELS, iPelX, iPelY, iWidth >> ME_PYRAMID_LEVELS, iHeight >> ME_PYRAMID_LEVELS,
+                         iLeft >> ME_PYRAMID_LEVELS, iTop >> ME_PYRAMID_LEVELS, iRight >> ME_PYRAMID_LEVELS, iBottom >> ME_PYRAMID_LEVELS, false, iBestX, iBestY );
+    cMv.set( iBestX, iBestY );
+  }
+  
+  if ( m_iNumPyramidLCURefs < 2*MAX_NUM_REF )
+  {
+    m_apcPyramidLCURef[m_iNumPyramidLCURefs] = pcRefPic;
+    m_acMvPyramidLCU  [m_iNumPyramidLCURefs] = cMv;
+    m_iNumPyramidLCURefs++;
+  }
+  return cMv;
+}
+
+/** downscale a search key into m_aaiPyramidOrg the same way as the reference pictures
+ * \param piOrg search key
+ * \param iOrgStride stride of piOrg
+ * \param iWidth width of the search key
+ * \param iHeight height of the search key
+ * \param iTopLevel number of levels to downscale
+ */
+Void TEncSearch::xPyramidDownscaleKey( Pel* piOrg, Int iOrgStride, Int iWidth, Int iHeight, Int iTopLevel )
+{
+  for ( Int iLevel = 1; iLevel <= iTopLevel; iLevel++ )
+  {
+    Pel* piDst      = m_aaiPyramidOrg[iLevel-1];
+    Int  iDstWidth  = iWidth  >> iLevel;
+    Int  iDstHeight = iHeight >> iLevel;
+    for ( Int y = 0; y < iDstHeight; y++ )
+    {
+      for ( Int x = 0; x < iDstWidth; x++ )
+      {
+        piDst[x] = ( piOrg[2*x] + piOrg[2*x+1] + piOrg[2*x+iOrgStride] + piOrg[2*x+1+iOrgStride] + 2 ) >> 2;
+      }
+      piOrg += 2*iOrgStride;
+      piDst += iDstWidth;
+    }
+    piOrg      = m_aaiPyramidOrg[iLevel-1];
+    iOrgStride = iDstWidth;
+  }
+}
+
+/** search a rectangle of integer positions at one level of the reference pyramid
+ * \param pcPicYuvLevel pyramid level of the reference picture
+ * \param iLevel level, the search key is m_aaiPyramidOrg[iLevel-1]
+ * \param iPelX horizontal position of the search key in full resolution samples
+ * \param iPelY vertical position of the search key in full resolution samples
+ * \param iWidth width of the search key at this level
+ * \param iHeight height of the search key at this level
+ * \param iLeft left of the rectangle, at this level
+ * \param iTop top of the rectangle, at this level
+ * \param iRight right of the rectangle, at this level
+ * \param iBottom bottom of the rectangle, at this level
+ * \param bMvCost add the cost of the full resolution motion vector to the SAD
+ * \param riBestX returns the horizontal motion of the lowest cost, at this level
+ * \param riBestY returns the vertical motion of the lowest cost, at this level
+ *
+ * The SAD is scaled up to full resolution.
+ */
+Void TEncSearch::xPyramidSearchLevel( TComPicYuv* pcPicYuvLevel, Int iLevel, Int iPelX, Int iPelY, Int iWidth, Int iHeight, Int iLeft, Int iTop, Int iRight, Int iBottom, Bool bMvCost, Int& riBestX, Int& riBestY )
+{
+  Int   iRefStride = pcPicYuvLevel->getStride();
+  Pel*  piRef      = pcPicYuvLevel->getLumaAddr() + ( iPelY >> iLevel ) * iRefStride + ( iPelX >> iLevel );
+  UInt  uiCostBest = MAX_UINT;
+  
+  DistParam cDistParam;
+  m_pcRdCost->setDistParam( cDistParam, m_aaiPyramidOrg[iLevel-1], iWidth, piRef, iRefStride, iWidth, iHeight );
+#if WEIGHT_PRED
+  cDistParam.bApplyWeight = false;
+#endif
+  
+  for ( Int y = iTop; y <= iBottom; y++ )
+  {
+    for ( Int x = iLeft; x <= iRight; x++ )
+    {
+      cDistParam.pCur = piRef + y * iRefStride + x;
+      UInt uiCost = cDistParam.DistFunc( &cDistParam ) << ( 2 * iLevel );
+      if ( bMvCost )
+      {
+        uiCost += m_pcRdCost->getCost( x << iLevel, y << iLevel );
+      }
+      if ( uiCost < uiCostBest )
+      {
+        uiCostBest = uiCost;
+        riBestX    = x;
+        riBestY    = y;
+      }
+    }
+  }
+}
+#endif
+
+#if ME_SAD_CACHE
+/** prepare the SAD cache for the integer search of a prediction unit
+ * \param pcCU CU of the prediction unit
+ * \param pcYuvOrg original samples of the CU
+ * \param uiPartAddr z-order index of the prediction unit in the CU
+ * \param iRoiWidth width of the prediction unit
+ * \param iRoiHeight height of the prediction unit
+ * \param iRefIdx reference picture index
+ * \param iRefStride stride of the reference picture
+ *
+ * The entries of another CU are invalidated by a new generation. m_bSadCache stays false for CUs smaller than
+ * 32x32, the lookup of their sub-blocks costs more than the SAD it saves.
+ */
+Void TEncSearch::xSadCacheInit( TComDataCU* pcCU, TComYuv* pcYuvOrg, UInt uiPartAddr, Int iRoiWidth, Int iRoiHeight, Int iRefIdx, Int iRefStride )
+{
+  UInt uiCUWidth = pcCU->getWidth( 0 );
+  Int  iBlkSize  = uiCUWidth / ME_SAD_CACHE_GRID;
+  if ( iBlkSize < 8 )
+  {
+    return;
+  }
+  
+  Int iOffsetX = g_auiRasterToPelX[ g_auiZscanToRaster[uiPartAddr] ];
+  Int iOffsetY = g_auiRasterToPelY[ g_auiZscanToRaster[uiPartAddr] ];
+  if ( iOffsetX % iBlkSize || iOffsetY % iBlkSize || iRoiWidth % iBlkSize || iRoiHeight % iBlkSize )
+  {
+    return;
+  }
+  
+  if ( pcCU->getPic() != m_pcSadCachePic || pcCU->getSlice()->getPOC() != m_iSadCachePOC || pcCU->getAddr() != m_uiSadCacheCUAddr
+    || pcCU->getZorderIdxInCU() != m_uiSadCacheAbsPartIdx || uiCUWidth != m_uiSadCacheCUWidth )
+  {
+    m_pcSadCachePic        = pcCU->getPic();
+    m_iSadCachePOC         = pcCU->getSlice()->getPOC();
+    m_uiSadCacheCUAddr     = pcCU->getAddr();
+    m_uiSadCacheAbsPartIdx = pcCU->getZorderIdxInCU();
+    m_uiSadCacheCUWidth    = uiCUWidth;
+    m_uiSadCacheGeneration++;
+  }
+  
+  m_piSadCacheOrg      = pcYuvOrg->getLumaAddr();
+  m_iSadCacheOrgStride = pcYuvOrg->getStride();
+  m_iSadCacheBlkSize   = iBlkSize;
+  m_iSadCacheRefStride = iRefStride;
+  m_iSadCacheRefOffset = iOffsetY * iRefStride + iOffsetX;
+  
+  // the first four reference pictures get a quadrant of the motion vector wrap-around of the cache each
+  m_iSadCacheSlotX     = ( iRefIdx & 1 ) * ( ME_SAD_CACHE_MV_RANGE >> 1 );
+  m_iSadCacheSlotY     = ( ( iRefIdx >> 1 ) & 1 ) * ( ME_SAD_CACHE_MV_RANGE >> 1 );
+  
+  // same subsampling as xPatternSearch, the odd rows are not needed for it
+  m_iSadCacheSubShift  = ( m_pcEncCfg->getUseFastEnc() && iRoiHeight > 8 ) ? 1 : 0;
+  
+  m_uiSadCacheMask     = 0;
+  m_iSadCacheNumIdx    = 0;
+  for ( Int iParity = 0; iParity < 2 - m_iSadCacheSubShift; iParity++ )
+  {
+    for ( Int y = iOffsetY / iBlkSize; y < ( iOffsetY + iRoiHeight ) / iBlkSize; y++ )
+    {
+      for ( Int x = iOffsetX / iBlkSize; x < ( iOffsetX + iRoiWidth ) / iBlkSize; x++ )
+      {
+        Int iIdx = iParity * ME_SAD_CACHE_BLOCKS + y * ME_SAD_CACHE_GRID + x;
+        m_uiSadCacheMask |= 1 << iIdx;
+        m_aiSadCacheIdx[ m_iSadCacheNumIdx++ ] = iIdx;
+      }
+    }
+  }
+  m_bSadCache = true;
+}
+
+/** SAD of the prediction unit at a reference position, assembled from the sub-blocks of the cache
+ * \param piRefSrch reference samples of the prediction unit at the searched position
+ * \param iSearchX horizontal motion vector of the position
+ * \param iSearchY vertical motion vector of the position
+ * \returns the distortion DistFunc of m_cDistParam returns
+ */
+UInt TEncSearch::xSadCacheGet( Pel* piRefSrch, Int iSearchX, Int iSearchY )
+{
+  Pel* piRef = piRefSrch - m_iSadCacheRefOffset;
+  Int  iX    = ( iSearchX + m_iSadCacheSlotX ) & ( ME_SAD_CACHE_MV_RANGE - 1 );
+  Int  iY    = ( iSearchY + m_iSadCacheSlotY ) & ( ME_SAD_CACHE_MV_RANGE - 1 );
+  
+  SadCacheEntry* pcEntry = &m_pcSadCache[ iY * ME_SAD_CACHE_MV_RANGE + iX ];
+  if ( pcEntry->piRef != piRef || pcEntry->uiGeneration != m_uiSadCacheGeneration )
+  {
+    pcEntry->piRef        = piRef;
+    pcEntry->uiGeneration = m_uiSadCacheGeneration;
+    pcEntry->uiValid      = 0;
+  }
+  
+  UInt uiMissing = m_uiSadCacheMask & ~pcEntry->uiValid;
+  if ( uiMissing )
+  {
+    xSadCacheFill( pcEntry, uiMissing );
+  }
+  
+  UInt uiSum = 0;
+  for ( Int i = 0; i < m_iSadCacheNumIdx; i++ )
+  {
+    uiSum += pcEntry->auiSad[ m_aiSadCacheIdx[i] ];
+  }
+  
+  uiSum <<= m_iSadCacheSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+/** compute the missing sub-blocks of a cache entry, the bounding rectangle of them for each row parity
+ * \param pcEntry cache entry
+ * \param uiMissing mask of the sub-blocks to compute
+ */
+Void TEncSearch::xSadCacheFill( SadCacheEntry* pcEntry, UInt uiMissing )
+{
+  const UInt uiRowMask = ( 1 << ME_SAD_CACHE_GRID ) - 1;
+  Int        iBlkSize  = m_iSadCacheBlkSize;
+  
+  for ( Int iParity = 0; iParity < 2; iParity++ )
+  {
+    UInt uiCols   = 0;
+    Int  iFirstY  = ME_SAD_CACHE_GRID;
+    Int  iLastY   = -1;
+    for ( Int y = 0; y < ME_SAD_CACHE_GRID; y++ )
+    {
+      UInt uiRow = ( uiMissing >> ( iParity * ME_SAD_CACHE_BLOCKS + y * ME_SAD_CACHE_GRID ) ) & uiRowMask;
+      if ( uiRow )
+      {
+        uiCols  |= uiRow;
+        iFirstY  = min( iFirstY, y );
+        iLastY   = y;
+      }
+    }
+    if ( uiCols == 0 )
+    {
+      continue;
+    }
+    Int iFirstX = 0;
+    Int iLastX  = ME_SAD_CACHE_GRID - 1;
+    while ( !( uiCols & ( 1 << iFirstX ) ) ) iFirstX++;
+    while ( !( uiCols & ( 1 << iLastX  ) ) ) iLastX--;
+    
+    Pel*  piOrg    = m_piSadCacheOrg + ( iFirstY * iBlkSize + iParity ) * m_iSadCacheOrgStride + iFirstX * iBlkSize;
+    Pel*  piRef    = pcEntry->piRef  + ( iFirstY * iBlkSize + iParity ) * m_iSadCacheRefStride + iFirstX * iBlkSize;
+    Int   iIdx     = iParity * ME_SAD_CACHE_BLOCKS + iFirstY * ME_SAD_CACHE_GRID + iFirstX;
+    Int   iNumBlksX = iLastX - iFirstX + 1;
+    Int   iNumBlksY = iLastY - iFirstY + 1;
+#if SIMD_X86
+#if SIMD_AVX2_SUPPORTED
+    if ( getSimdLevel() >= SIMD_AVX2 )
+    {
+      xSadCacheBlocksAvx2( piOrg, 2 * m_iSadCacheOrgStride, piRef, 2 * m_iSadCacheRefStride, iBlkSize, iNumBlksX, iNumBlksY, &pcEntry->auiSad[iIdx] );
+    }
+    else
+#endif
+    if ( getSimdLevel() >= SIMD_SSE2 )
+    {
+      xSadCacheBlocksSimd( piOrg, 2 * m_iSadCacheOrgStride, piRef, 2 * m_iSadCacheRefStride, iBlkSize, iNumBlksX, iNumBlksY, &pcEntry->auiSad[iIdx] );
+    }
+    else
+#endif
+    {
+      xSadCacheBlocks( piOrg, 2 * m_iSadCacheOrgStride, piRef, 2 * m_iSadCacheRefStride, iBlkSize, iNumBlksX, iNumBlksY, &pcEntry->auiSad[iIdx] );
+    }
+    
+    UInt uiRect = ( ( 2 << iLastX ) - ( 1 << iFirstX ) );
+    for ( Int y = iFirstY; y <= iLastY; y++ )
+    {
+      pcEntry->uiValid |= uiRect << ( iParity * ME_SAD_CACHE_BLOCKS + y * ME_SAD_CACHE_GRID );
+    }
+  }
+}
+
+/** SADs of the rows of one parity of a rectangle of sub-blocks
+ * \param piOrg original samples of the first sub-block
+ * \param iStrideOrg stride of the original samples, twice the one of the picture
+ * \param piRef reference samples of the first sub-block
+ * \param iStrideRef stride of the reference samples, twice the one of the picture
+ * \param iBlkSize width and height of a sub-block
+ * \param iNumBlksX number of sub-blocks in a row
+ * \param iNumBlksY number of rows of sub-blocks
+ * \param puiSad SAD of each sub-block, ME_SAD_CACHE_GRID entries per row
+ */
+Void TEncSearch::xSadCacheBlocks( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad )
+{
+  for ( Int by = 0; by < iNumBlksY; by++ )
+  {
+    for ( Int bx = 0; bx < iNumBlksX; bx++ )
+    {
+      Pel* piO   = piOrg + bx * iBlkSize;
+      Pel* piR   = piRef + bx * iBlkSize;
+      UInt uiSum = 0;
+      for ( Int y = 0; y < iBlkSize; y += 2 )
+      {
+        for ( Int x = 0; x < iBlkSize; x++ )
+        {
+          uiSum += abs( piO[x] - piR[x] );
+        }
+        piO += iStrideOrg;
+        piR += iStrideRef;
+      }
+      puiSad[bx] = uiSum;
+    }
+    piOrg  += ( iBlkSize >> 1 ) * iStrideOrg;
+    piRef  += ( iBlkSize >> 1 ) * iStrideRef;
+    puiSad += ME_SAD_CACHE_GRID;
+  }
+}
+
+#endif
 Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, UInt& ruiSAD )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
@@ -3749,6 +4633,13 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
       setDistParamComp(0);
 #endif
 
+#if ME_SAD_CACHE
+      if ( m_bSadCache )
+      {
+        uiSad = xSadCacheGet( piRefSrch, x, y );
+      }
+      else
+#endif
       uiSad = m_cDistParam.DistFunc( &m_cDistParam );
       
       // motion cost
@@ -3804,6 +4695,26 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
   cStruct.iYStride    = iRefStride;
   cStruct.piRefY      = piRefY;
   cStruct.uiBestSad   = MAX_UINT;
+#if ME_SAD_X4
+  cStruct.iNumCand    = 0;
+#endif
+#if ME_TZ_VISITED
+  // a new mark invalidates the marks of the previous searches, all marks are cleared when it wraps around
+  cStruct.pusVisited     = NULL;
+  cStruct.iVisitedLeft   = iSrchRngHorLeft;
+  cStruct.iVisitedTop    = iSrchRngVerTop;
+  cStruct.iVisitedWidth  = iSrchRngHorRight  - iSrchRngHorLeft + 1;
+  cStruct.iVisitedHeight = iSrchRngVerBottom - iSrchRngVerTop  + 1;
+  if ( cStruct.iVisitedWidth <= m_iTZVisitedSize && cStruct.iVisitedHeight <= m_iTZVisitedSize )
+  {
+    if ( ++m_usTZVisitedMark == 0 )
+    {
+      memset( m_pusTZVisited, 0, sizeof(UShort) * m_iTZVisitedSize * m_iTZVisitedSize );
+      m_usTZVisitedMark = 1;
+    }
+    cStruct.pusVisited = m_pusTZVisited;
+  }
+#endif
   
   // set rcMv (Median predictor) as start point and as best point
   xTZSearchHelp( pcPatternKey, cStruct, rcMv.getHor(), rcMv.getVer(), 0, 0 );
@@ -3826,6 +4737,14 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
   
+#if ME_PYRAMID
+  // test whether the result of the hierarchical search is a better start point
+  if ( m_bMvPyramid )
+  {
+    xTZSearchHelp( pcPatternKey, cStruct, m_cMvPyramid.getHor(), m_cMvPyramid.getVer(), 0, 0 );
+  }
+#endif
+  
   // start search
   Int  iDist = 0;
   Int  iStartX = cStruct.iBestX;
@@ -3874,17 +4793,22 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     xTZ2PointSearch( pcPatternKey, cStruct, pcMvSrchRngLT, pcMvSrchRngRB );
   }
   
-  // raster search if distance is too big
+  // raster search if distance is too big, the hierarchical search already covered the window
+#if ME_PYRAMID
+  if ( bEnableRasterSearch && !m_bMvPyramid && ( ((Int)(cStruct.uiBestDistance) > iRaster) || bAlwaysRasterSearch ) )
+#else
   if ( bEnableRasterSearch && ( ((Int)(cStruct.uiBestDistance) > iRaster) || bAlwaysRasterSearch ) )
+#endif
   {
     cStruct.uiBestDistance = iRaster;
     for ( iStartY = iSrchRngVerTop; iStartY <= iSrchRngVerBottom; iStartY += iRaster )
     {
       for ( iStartX = iSrchRngHorLeft; iStartX <= iSrchRngHorRight; iStartX += iRaster )
       {
-        xTZSearchHelp( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
+        xTZSearchPush( pcPatternKey, cStruct, iStartX, iStartY, 0, iRaster );
       }
     }
+    xTZSearchFlush( pcPatternKey, cStruct );
   }
   
   // raster refinement
@@ -3989,8 +4913,18 @@ Void TEncSearch::xPatternSearchFracDIF(TComDataCU* pcCU,
   iRefStride  = m_cYuvExt.getStride();
 #endif
   
+#if ME_SUBPEL_PLANES
+  if ( m_pcSubPelRefPic )
+  {
+    m_iSubPelRefOffset = (Int)( cPatternRoi.getROIY() - m_pcSubPelRefPic->getPicYuvRec()->getLumaAddr() );
+  }
+#endif
+  
   //  Half-pel refinement
 #if GENERIC_IF
+#if ME_SUBPEL_PLANES
+  if ( m_pcSubPelRefPic == NULL )
+#endif
   xExtDIFUpSamplingH ( &cPatternRoi, biPred );
 #else
   xExtDIFUpSamplingH ( &cPatternRoi, &m_cYuvExt );
@@ -4008,6 +4942,9 @@ Void TEncSearch::xPatternSearchFracDIF(TComDataCU* pcCU,
   m_pcRdCost->setCostScale( 0 );
   
 #if GENERIC_IF
+#if ME_SUBPEL_PLANES
+  if ( m_pcSubPelRefPic == NULL )
+#endif
   xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf, biPred );
   baseRefMv = rcMvHalf;
   baseRefMv <<= 1;
@@ -5957,4 +6894,101 @@ Void  TEncSearch::setWpScalingDistParam( TComDataCU* pcCU, Int iRefIdx, RefPicLi
 }
 #endif
 
+#if ME_SAD_CACHE && SIMD_X86
+// ====================================================================================================================
+// SIMD functions
+// ====================================================================================================================
+
+/** SSE2 version of xSadCacheBlocks, 8 samples per step
+ */
+Void TEncSearch::xSadCacheBlocksSimd( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad )
+{
+  const __m128i vOne   = _mm_set1_epi16( 1 );
+  Int           iRows  = iBlkSize >> 1;
+  
+  for ( Int by = 0; by < iNumBlksY; by++ )
+  {
+    for ( Int bx = 0; bx < iNumBlksX; bx++ )
+    {
+      __m128i vSum = _mm_setzero_si128();
+      for ( Int n = bx * iBlkSize; n < ( bx + 1 ) * iBlkSize; n += 8 )
+      {
+        Pel* piO = piOrg + n;
+        Pel* piR = piRef + n;
+        for ( Int y = 0; y < iRows; y++ )
+        {
+          __m128i vOrg = _mm_loadu_si128( (const __m128i*)piO );
+          __m128i vRef = _mm_loadu_si128( (const __m128i*)piR );
+          __m128i vAbs = _mm_sub_epi16( _mm_max_epi16( vOrg, vRef ), _mm_min_epi16( vOrg, vRef ) );
+          vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vAbs, vOne ) );
+          piO += iStrideOrg;
+          piR += iStrideRef;
+        }
+      }
+      vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+      vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+      puiSad[bx] = _mm_cvtsi128_si32( vSum );
+    }
+    piOrg  += iRows * iStrideOrg;
+    piRef  += iRows * iStrideRef;
+    puiSad += ME_SAD_CACHE_GRID;
+  }
+}
+
+#if SIMD_AVX2_SUPPORTED
+/** AVX2 version of xSadCacheBlocks, 16 samples per step, two sub-blocks of 8 samples share a step
+ */
+Void TEncSearch::xSadCacheBlocksAvx2( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad )
+{
+  const __m256i vOne   = _mm256_set1_epi16( 1 );
+  Int           iWidth = iBlkSize * iNumBlksX;
+  Int           iRows  = iBlkSize >> 1;
+  
+  if ( iWidth & 15 )
+  {
+    // an odd number of sub-blocks of 8 samples
+    xSadCacheBlocksSimd( piOrg, iStrideOrg, piRef, iStrideRef, iBlkSize, iNumBlksX, iNumBlksY, puiSad );
+    return;
+  }
+  
+  for ( Int by = 0; by < iNumBlksY; by++ )
+  {
+    for ( Int n = 0; n < iWidth; n += 16 )
+    {
+      Pel*    piO  = piOrg + n;
+      Pel*    piR  = piRef + n;
+      __m256i vSum = _mm256_setzero_si256();
+      for ( Int y = 0; y < iRows; y++ )
+      {
+        __m256i vOrg = _mm256_loadu_si256( (const __m256i*)piO );
+        __m256i vRef = _mm256_loadu_si256( (const __m256i*)piR );
+        __m256i vAbs = _mm256_sub_epi16( _mm256_max_epi16( vOrg, vRef ), _mm256_min_epi16( vOrg, vRef ) );
+        vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( vAbs, vOne ) );
+        piO += iStrideOrg;
+        piR += iStrideRef;
+      }
+      
+      // the 128 bit lanes hold the sums of the left and of the right 8 samples
+      vSum = _mm256_hadd_epi32( vSum, vSum );
+      vSum = _mm256_hadd_epi32( vSum, vSum );
+      UInt uiLeft  = _mm_cvtsi128_si32( _mm256_castsi256_si128( vSum ) );
+      UInt uiRight = _mm_cvtsi128_si32( _mm256_extracti128_si256( vSum, 1 ) );
+      if ( iBlkSize == 8 )
+      {
+        puiSad[( n >> 3 )    ] = uiLeft;
+        puiSad[( n >> 3 ) + 1] = uiRight;
+      }
+      else
+      {
+        puiSad[n / iBlkSize] = uiLeft + uiRight;
+      }
+    }
+    piOrg  += iRows * iStrideOrg;
+    piRef  += iRows * iStrideRef;
+    puiSad += ME_SAD_CACHE_GRID;
+  }
+}
+#endif
+#endif
+
 //! \}
@@ -51,11 +51,30 @@
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TEncCfg.h"
+#if REF_SEARCH_THREADS
+#include "TLibCommon/TComThreadPool.h"
+#endif
+#if ME_SAD_CACHE
+#include "TLibCommon/TComSimd.h"
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
 
+#if ME_SAD_CACHE
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define ME_SAD_CACHE_GRID           4                           ///< sub-blocks per CU side, all partition shapes of the CU are unions of them
+#define ME_SAD_CACHE_BLOCKS         ( ME_SAD_CACHE_GRID * ME_SAD_CACHE_GRID ) ///< sub-blocks per CU
+#define ME_SAD_CACHE_MV_RANGE       64                          ///< the cache holds the motion vectors of a window of 64x64, the ones outside of it wrap around
+#endif
+
 class TEncCu;
+#if REF_SEARCH_THREADS
+class TEncSearchRefJob;
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -93,6 +112,63 @@ protected:
   TComMv          m_cSrchRngLT;
   TComMv          m_cSrchRngRB;
   TComMv          m_acMvPredictors[3];
+  TComPattern     m_cPatternKey;                                ///< search key of the motion estimation
+#if ME_PYRAMID
+  Pel             m_aaiPyramidOrg[ME_PYRAMID_LEVELS][(MAX_CU_SIZE/2)*(MAX_CU_SIZE/2)]; ///< search key downscaled to each pyramid level
+  TComMv          m_cMvPyramid;                                 ///< start point of the TZ search found in the reference pyramid
+  Bool            m_bMvPyramid;                                 ///< m_cMvPyramid is valid, the raster search is skipped
+  TComPic*        m_pcPyramidLCUPic;                            ///< picture of the LCU of m_acMvPyramidLCU
+  Int             m_iPyramidLCUPOC;                             ///< POC of m_pcPyramidLCUPic
+  UInt            m_uiPyramidLCUAddr;                           ///< address of the LCU of m_acMvPyramidLCU
+  Int             m_iNumPyramidLCURefs;                         ///< number of references searched for the LCU so far
+  TComPic*        m_apcPyramidLCURef[2*MAX_NUM_REF];            ///< references searched for the LCU
+  TComMv          m_acMvPyramidLCU[2*MAX_NUM_REF];              ///< motion of the whole LCU in each reference, at the top pyramid level
+#endif
+#if ME_SUBPEL_PLANES
+  TComPic*        m_pcSubPelRefPic;                             ///< reference of the current motion search if its sub-pel planes are built, else NULL
+  Int             m_iSubPelRefOffset;                           ///< offset of the block at the integer motion vector in the sub-pel planes
+#endif
+#if ME_SAD_CACHE
+  typedef struct
+  {
+    Pel*  piRef;                                                ///< reference samples at the CU origin displaced by the motion vector
+    UInt  uiGeneration;                                         ///< CU the entry belongs to
+    UInt  uiValid;                                              ///< mask of the valid SADs of auiSad
+    UInt  auiSad[2*ME_SAD_CACHE_BLOCKS];                        ///< SADs of the even rows of each sub-block, then of the odd rows, before the bit increment shift
+  } SadCacheEntry;
+  
+  SadCacheEntry*  m_pcSadCache;                                 ///< SADs of the current CU, indexed by the motion vector
+  UInt            m_uiSadCacheGeneration;                       ///< generation of the current CU, older entries are invalid
+  TComPic*        m_pcSadCachePic;                              ///< picture of the current CU
+  Int             m_iSadCachePOC;                               ///< POC of m_pcSadCachePic
+  UInt            m_uiSadCacheCUAddr;                           ///< LCU address of the current CU
+  UInt            m_uiSadCacheAbsPartIdx;                       ///< z-order index of the current CU in its LCU
+  UInt            m_uiSadCacheCUWidth;                          ///< width of the current CU
+  Bool            m_bSadCache;                                  ///< the integer search of the current prediction unit uses the cache
+  Pel*            m_piSadCacheOrg;                              ///< original samples of the CU
+  Int             m_iSadCacheOrgStride;
+  Int             m_iSadCacheBlkSize;                           ///< width and height of a sub-block
+  Int             m_iSadCacheRefStride;
+  Int             m_iSadCacheRefOffset;                         ///< offset from the CU origin to the prediction unit in the reference
+  Int             m_iSadCacheSlotX;                             ///< offset of the motion vectors of the reference picture in the cache
+  Int             m_iSadCacheSlotY;
+  Int             m_iSadCacheSubShift;                          ///< only the even rows are summed, like the iSubShift of the fast encoder
+  UInt            m_uiSadCacheMask;                             ///< SADs of the sub-blocks covered by the prediction unit
+  Int             m_iSadCacheNumIdx;
+  Int             m_aiSadCacheIdx[2*ME_SAD_CACHE_BLOCKS];       ///< indices of the SADs of m_uiSadCacheMask
+#endif
+#if ME_TZ_VISITED
+  UShort*         m_pusTZVisited;                               ///< per position of the search window, the mark of the last TZ search that scored it
+  UShort          m_usTZVisitedMark;                            ///< mark of the current TZ search
+  Int             m_iTZVisitedSize;                             ///< width and height of m_pusTZVisited, twice the search range plus one
+  UInt64          m_uiTZPoints;                                 ///< positions submitted to the TZ searches
+  UInt64          m_uiTZPointsRepeated;                         ///< positions skipped because their TZ search had scored them before
+#endif
+#if REF_SEARCH_THREADS
+  TComThreadPool* m_pcThreadPool;
+  Int             m_iNumRefJobs;
+  TEncSearchRefJob* m_pcRefJobs;                                ///< one motion estimation job per reference picture of a list
+#endif
   
   // RD computation
   TEncSbac***     m_pppcRDSbacCoder;
@@ -123,6 +199,12 @@ public:
             TComRdCost*   pcRdCost,
             TEncSbac***   pppcRDSbacCoder,
             TEncSbac*     pcRDGoOnSbacCoder );
+#if REF_SEARCH_THREADS
+  Void createRefJobs( TComThreadPool* pcThreadPool );
+#endif
+#if ME_TZ_VISITED
+  Void getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated );
+#endif
   
 protected:
   
@@ -149,10 +231,29 @@ protected:
     UInt  uiBestDistance;
     UInt  uiBestSad;
     UChar ucPointNr;
+#if ME_SAD_X4
+    Int   iNumCand;           ///< candidates waiting in aiCandX .. auiCandDistance for xTZSearchFlush
+    Int   aiCandX[4];
+    Int   aiCandY[4];
+    UChar aucCandPointNr[4];
+    UInt  auiCandDistance[4];
+#endif
+#if ME_TZ_VISITED
+    UShort* pusVisited;       ///< marks of the search window, NULL if the window does not fit
+    Int   iVisitedLeft;       ///< motion vector of the first mark
+    Int   iVisitedTop;
+    Int   iVisitedWidth;
+    Int   iVisitedHeight;
+#endif
   } IntTZSearchStruct;
   
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  __inline Void xTZSearchPush         ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+  __inline Void xTZSearchFlush        ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct );
+#if ME_TZ_VISITED
+  __inline Bool xTZSearchRepeated     ( IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY );
+#endif
   __inline Void xTZ2PointSearch       ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
@@ -208,6 +309,7 @@ public:
   
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
+  Int  getAdaptiveSearchRange   ( Int iDir, Int iRefIdx )                   { return m_aaiAdaptSR[iDir][iRefIdx]; }
   
 #if E057_INTRA_PCM
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, TextType eText);
@@ -371,6 +473,62 @@ protected:
                                     TComMv&       rcMv,
                                     UInt&         ruiSAD );
   
+#if ME_PYRAMID
+  Bool xPyramidSearch             ( TComDataCU*   pcCU,
+                                    TComPattern*  pcPatternKey,
+                                    TComPic*      pcRefPic,
+                                    UInt          uiPartAddr,
+                                    TComMv&       rcMv );
+  
+  TComMv xPyramidSearchLCU        ( TComDataCU*   pcCU,
+                                    TComPic*      pcRefPic );
+  
+  Void xPyramidDownscaleKey       ( Pel*          piOrg,
+                                    Int           iOrgStride,
+                                    Int           iWidth,
+                                    Int           iHeight,
+                                    Int           iTopLevel );
+  
+  Void xPyramidSearchLevel        ( TComPicYuv*   pcPicYuvLevel,
+                                    Int           iLevel,
+                                    Int           iPelX,
+                                    Int           iPelY,
+                                    Int           iWidth,
+                                    Int           iHeight,
+                                    Int           iLeft,
+                                    Int           iTop,
+                                    Int           iRight,
+                                    Int           iBottom,
+                                    Bool          bMvCost,
+                                    Int&          riBestX,
+                                    Int&          riBestY );
+  
+#endif
+#if ME_SAD_CACHE
+  Void xSadCacheInit              ( TComDataCU*   pcCU,
+                                    TComYuv*      pcYuvOrg,
+                                    UInt          uiPartAddr,
+                                    Int           iRoiWidth,
+                                    Int           iRoiHeight,
+                                    Int           iRefIdx,
+                                    Int           iRefStride );
+  
+  UInt xSadCacheGet               ( Pel*          piRefSrch,
+                                    Int           iSearchX,
+                                    Int           iSearchY );
+  
+  Void xSadCacheFill              ( SadCacheEntry* pcEntry,
+                                    UInt          uiMissing );
+  
+  static Void xSadCacheBlocks     ( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad );
+#if SIMD_X86
+  SIMD_TARGET_SSE2 static Void xSadCacheBlocksSimd( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad );
+#if SIMD_AVX2_SUPPORTED
+  SIMD_TARGET_AVX2 static Void xSadCacheBlocksAvx2( Pel* piOrg, Int iStrideOrg, Pel* piRef, Int iStrideRef, Int iBlkSize, Int iNumBlksX, Int iNumBlksY, UInt* puiSad );
+#endif
+#endif
+  
+#endif
   Void xSetSearchRange            ( TComDataCU*   pcCU,
                                     TComMv&       cMvPred,
                                     Int           iSrchRng,
@@ -459,8 +617,59 @@ protected:
   inline  Void  setDistParamComp( UInt uiComp )  { m_cDistParam.uiComp = uiComp; }
 #endif
   
+#if REF_SEARCH_THREADS
+  // -------------------------------------------------------------------------------------------------------------------
+  // concurrent motion estimation in the reference pictures of a list
+  // -------------------------------------------------------------------------------------------------------------------
+  
+  friend class TEncSearchRefJob;
+  
+  Bool  xStartRefJobs             ( TComDataCU*   pcCU,
+                                    TComYuv*      pcOrgYuv,
+                                    Int           iPartIdx,
+                                    Int           iRefList,
+                                    UInt          uiMbBits,
+                                    Int           iRefIdxL0 );
+  Void  xLoadRefJobAMVP           ( TComDataCU*   pcCU,
+                                    Int           iPartIdx,
+                                    RefPicList    eRefPicList,
+                                    Int           iRefIdx,
+                                    TComMv&       rcMvPred );
+  Bool  xGetRefJobResult          ( Int           iRefIdx,
+                                    TComMv&       rcMv,
+                                    UInt&         ruiBits,
+                                    UInt&         ruiCost );
+  Void  xFinishRefJobs            ();
+#endif
+  
 };// END CLASS DEFINITION TEncSearch
 
+#if REF_SEARCH_THREADS
+/// motion estimation of one prediction unit in one reference picture, executed by the encoder thread pool
+class TEncSearchRefJob : public TComJob
+{
+public:
+  TEncSearch    m_cSearch;                                      ///< search tools of the job
+  TComRdCost    m_cRdCost;                                      ///< RD cost of the job, copied from the owning search
+  
+  TComDataCU*   m_pcCU;                                         ///< CU of the prediction unit, only read by the job
+  TComYuv*      m_pcYuvOrg;                                     ///< original samples of the CU
+  Int           m_iPartIdx;                                     ///< prediction unit index
+  RefPicList    m_eRefPicList;                                  ///< reference picture list
+  Int           m_iRefIdx;                                      ///< reference picture index
+  TComMv        m_cMvPred;                                      ///< motion vector predictor
+  AMVPInfo      m_cAMVPInfo;                                    ///< motion vector predictor candidates found before the search
+  Int           m_iMvpIdx;                                      ///< index of the motion vector predictor
+  Int           m_iMvpNum;                                      ///< number of motion vector predictor candidates
+  TComMv        m_cMv;                                          ///< motion vector found by the search
+  UInt          m_uiBits;                                       ///< bits of the prediction unit, the motion vector bits are added by the search
+  UInt          m_uiCost;                                       ///< cost of the motion vector found by the search
+  Bool          m_bQueued;                                      ///< the job has been queued and its result not taken yet
+  
+  Void run();
+};
+#endif
+
 //! \}
 
 #endif // __TENCSEARCH__
@@ -58,6 +58,17 @@ TEncSlice::TEncSlice()
   m_pcBufferSbacCoders    = NULL;
   m_pcBufferBinCoderCABACs  = NULL;
 #endif
+#if WPP_THREADS
+  m_pcRowJobs       = NULL;
+  m_puiRowProgress  = NULL;
+#if TILE_THREADS
+  m_pcTileJobs      = NULL;
+#endif
+#endif
+#if GOP_THREADS
+  m_ppppcRDSbacCoders = NULL;
+  m_pcBitCounters     = NULL;
+#endif
 }
 
 TEncSlice::~TEncSlice()
@@ -79,6 +90,16 @@ Void TEncSlice::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHe
     m_apcPicYuvResi  = new TComPicYuv;
     m_apcPicYuvResi->create( iWidth, iHeight, iMaxCUWidth, iMaxCUHeight, uhTotalDepth );
   }
+#if WPP_THREADS
+  
+  // create row jobs
+  UInt uiHeightInLCUs = ( iHeight + iMaxCUHeight - 1 ) / iMaxCUHeight;
+  if ( m_pcRowJobs == NULL )
+  {
+    m_pcRowJobs       = new TEncSliceRowJob[ uiHeightInLCUs ];
+    m_puiRowProgress  = new UInt           [ uiHeightInLCUs ];
+  }
+#endif
 }
 
 Void TEncSlice::destroy()
@@ -110,6 +131,15 @@ Void TEncSlice::destroy()
   if ( m_pcBufferBinCoderCABACs )
     delete[] m_pcBufferBinCoderCABACs;
 #endif
+#if WPP_THREADS
+  
+  // destroy row jobs
+  delete[] m_pcRowJobs;       m_pcRowJobs      = NULL;
+  delete[] m_puiRowProgress;  m_puiRowProgress = NULL;
+#if TILE_THREADS
+  delete[] m_pcTileJobs;      m_pcTileJobs     = NULL;
+#endif
+#endif
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -136,7 +166,52 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_pdRdPicLambda     = (Double*)xMalloc( Double, m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_pdRdPicQp         = (Double*)xMalloc( Double, m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_piRdPicQp         = (Int*   )xMalloc( Int,    m_pcCfg->getDeltaQpRD() * 2 + 1 );
+#if TILE_THREADS
+  
+  // create tile jobs
+  m_pcTileJobs        = new TEncSliceTileJob[ ( m_pcCfg->getNumColumnsMinus1() + 1 ) * ( m_pcCfg->getNumRowsMinus1() + 1 ) ];
+#endif
+}
+
+#if GOP_THREADS
+/** initialize a slice encoder working on the analysis tools of a picture context
+ * \param pcEncTop pointer of encoder class
+ * \param pcCuEncoder CU encoder
+ * \param pcPredSearch encoder search class
+ * \param pcEntropyCoder entropy encoder
+ * \param pcSbacCoder SBAC encoder
+ * \param pcBinCABAC bin encoder CABAC
+ * \param pcTrQuant transform & quantization class
+ * \param pcBitCounter bit counter
+ * \param pcRdCost RD cost computation class
+ * \param pppcRDSbacCoder storage for SBAC-based RD optimization
+ * \param pcRDGoOnSbacCoder go-on SBAC encoder
+ * \param ppppcRDSbacCoders storage for SBAC-based RD optimization of each substream
+ * \param pcBitCounters bit counter of each substream
+ */
+Void TEncSlice::init( TEncTop* pcEncTop, TEncCu* pcCuEncoder, TEncSearch* pcPredSearch, TEncEntropy* pcEntropyCoder, TEncSbac* pcSbacCoder,
+                      TEncBinCABAC* pcBinCABAC, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                      TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncSbac**** ppppcRDSbacCoders, TComBitCounter* pcBitCounters )
+{
+  init( pcEncTop );
+  
+  m_pcCuEncoder       = pcCuEncoder;
+  m_pcPredSearch      = pcPredSearch;
+  
+  m_pcEntropyCoder    = pcEntropyCoder;
+  m_pcSbacCoder       = pcSbacCoder;
+  m_pcBinCABAC        = pcBinCABAC;
+  m_pcTrQuant         = pcTrQuant;
+  
+  m_pcBitCounter      = pcBitCounter;
+  m_pcRdCost          = pcRdCost;
+  m_pppcRDSbacCoder   = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder = pcRDGoOnSbacCoder;
+  
+  m_ppppcRDSbacCoders = ppppcRDSbacCoders;
+  m_pcBitCounters     = pcBitCounters;
 }
+#endif
 
 /**
  - non-referenced frame marking
@@ -498,31 +573,18 @@ Void TEncSlice::precompressSlice( TComPic*& rpcPic )
   }
   m_pcRdCost      ->setFrameLambda(dFrameLambda);
   
+#if QP_RD_THREADS
+  TEncPicContext* pcQpContexts = m_pcGOPEncoder->getQpContexts( rpcPic );
+  if ( pcQpContexts )
+  {
+    uiQpIdxBest = xPrecompressSliceQps( rpcPic, pcQpContexts );
+  }
+  else
+#endif
   // for each QP candidate
   for ( UInt uiQpIdx = 0; uiQpIdx < 2 * m_pcCfg->getDeltaQpRD() + 1; uiQpIdx++ )
   {
-    pcSlice       ->setSliceQp             ( m_piRdPicQp    [uiQpIdx] );
-    m_pcRdCost    ->setLambda              ( m_pdRdPicLambda[uiQpIdx] );
-#if WEIGHTED_CHROMA_DISTORTION
-    // for RDO
-    // in RdCost there is only one lambda because the luma and chroma bits are not separated, instead we weight the distortion of chroma.
-    int iQP = m_piRdPicQp    [uiQpIdx];
-    double weight = pow( 2.0, (iQP-g_aucChromaScale[iQP])/3.0 );  // takes into account of the chroma qp mapping without chroma qp Offset
-    m_pcRdCost    ->setChromaDistortionWeight( weight );     
-#endif
-
-#if RDOQ_CHROMA_LAMBDA 
-    // for RDOQ
-    m_pcTrQuant   ->setLambda( m_pdRdPicLambda[uiQpIdx], m_pdRdPicLambda[uiQpIdx] / weight );
-#else
-    m_pcTrQuant   ->setLambda              ( m_pdRdPicLambda[uiQpIdx] );
-#endif
-#if ALF_CHROMA_LAMBDA || SAO_CHROMA_LAMBDA
-    // For ALF or SAO
-    pcSlice       ->setLambda              ( m_pdRdPicLambda[uiQpIdx], m_pdRdPicLambda[uiQpIdx] / weight ); 
-#else
-    pcSlice       ->setLambda              ( m_pdRdPicLambda[uiQpIdx] );
-#endif
+    xSetPicQp( pcSlice, m_piRdPicQp[uiQpIdx], m_pdRdPicLambda[uiQpIdx] );
     
     // try compress
     compressSlice   ( rpcPic );
@@ -544,29 +606,101 @@ Void TEncSlice::precompressSlice( TComPic*& rpcPic )
   }
   
   // set best values
-  pcSlice       ->setSliceQp             ( m_piRdPicQp    [uiQpIdxBest] );
-  m_pcRdCost    ->setLambda              ( m_pdRdPicLambda[uiQpIdxBest] );
+  xSetPicQp( pcSlice, m_piRdPicQp[uiQpIdxBest], m_pdRdPicLambda[uiQpIdxBest] );
+}
+
+/** set the slice QP and the lambdas of the RD tools for one QP candidate
+ * \param pcSlice slice being compressed
+ * \param iQP     slice QP
+ * \param dLambda lambda of the QP
+ */
+Void TEncSlice::xSetPicQp( TComSlice* pcSlice, Int iQP, Double dLambda )
+{
+  pcSlice       ->setSliceQp             ( iQP );
+  m_pcRdCost    ->setLambda              ( dLambda );
 #if WEIGHTED_CHROMA_DISTORTION
   // in RdCost there is only one lambda because the luma and chroma bits are not separated, instead we weight the distortion of chroma.
-  int iQP = m_piRdPicQp    [uiQpIdxBest];
   double weight = pow( 2.0, (iQP-g_aucChromaScale[iQP])/3.0 );  // takes into account of the chroma qp mapping without chroma qp Offset
-  m_pcRdCost ->setChromaDistortionWeight( weight );     
+  m_pcRdCost    ->setChromaDistortionWeight( weight );     
 #endif
 
 #if RDOQ_CHROMA_LAMBDA 
-  // for RDOQ 
-  m_pcTrQuant   ->setLambda( m_pdRdPicLambda[uiQpIdxBest], m_pdRdPicLambda[uiQpIdxBest] / weight ); 
+  // for RDOQ
+  m_pcTrQuant   ->setLambda( dLambda, dLambda / weight );
 #else
-  m_pcTrQuant   ->setLambda              ( m_pdRdPicLambda[uiQpIdxBest] );
+  m_pcTrQuant   ->setLambda              ( dLambda );
 #endif
 #if ALF_CHROMA_LAMBDA || SAO_CHROMA_LAMBDA
   // For ALF or SAO
-  pcSlice       ->setLambda              ( m_pdRdPicLambda[uiQpIdxBest], m_pdRdPicLambda[uiQpIdxBest] / weight ); 
+  pcSlice       ->setLambda              ( dLambda, dLambda / weight ); 
 #else
-  pcSlice       ->setLambda              ( m_pdRdPicLambda[uiQpIdxBest] );
+  pcSlice       ->setLambda              ( dLambda );
 #endif
 }
 
+#if QP_RD_THREADS
+/** compress the picture with every QP candidate concurrently and choose the best one
+ * \param pcPic        picture class
+ * \param pcQpContexts one context per QP candidate
+ * \returns index of the QP candidate with the lowest RD cost
+ *
+ * Every candidate is compressed on the trial picture of its context with a copy of the RD setup of this encoder.
+ * The trial pictures are then filtered with the shared in-loop filters in candidate order, as the serial loop does,
+ * so the costs and the choice are the same.
+ */
+UInt TEncSlice::xPrecompressSliceQps( TComPic* pcPic, TEncPicContext* pcQpContexts )
+{
+  TComThreadPool* pcThreadPool   = ((TEncTop*) m_pcCfg)->getThreadPool();
+  TComSlice*      pcSlice        = pcPic->getSlice(getSliceIdx());
+  UInt            uiNumQps       = 2 * m_pcCfg->getDeltaQpRD() + 1;
+  Double          dPicRdCostBest = MAX_DOUBLE;
+  UInt            uiQpIdxBest    = 0;
+  UInt            uiQpIdx;
+  
+  for ( uiQpIdx = 0; uiQpIdx < uiNumQps; uiQpIdx++ )
+  {
+    TEncPicContext* pcQpContext     = &pcQpContexts[uiQpIdx];
+    TEncSlice*      pcTrialEncoder  = pcQpContext->getSliceEncoder();
+    
+    pcQpContext->initTrialPic( pcPic, pcSlice );
+    pcTrialEncoder->m_pcRdCost->copyRDParam( m_pcRdCost );
+    pcTrialEncoder->m_pcTrQuant->copyRDParam( m_pcTrQuant );
+    for ( Int iDir = 0; iDir < 2; iDir++ )
+    {
+      for ( Int iRefIdx = 0; iRefIdx < 33; iRefIdx++ )
+      {
+        pcTrialEncoder->m_pcPredSearch->setAdaptiveSearchRange( iDir, iRefIdx, m_pcPredSearch->getAdaptiveSearchRange( iDir, iRefIdx ) );
+      }
+    }
+    pcTrialEncoder->xSetPicQp( pcQpContext->m_pcTrialPic->getSlice(0), m_piRdPicQp[uiQpIdx], m_pdRdPicLambda[uiQpIdx] );
+    pcThreadPool->addJob( pcQpContext );
+  }
+  
+  for ( uiQpIdx = 0; uiQpIdx < uiNumQps; uiQpIdx++ )
+  {
+    TEncPicContext* pcQpContext     = &pcQpContexts[uiQpIdx];
+    TEncSlice*      pcTrialEncoder  = pcQpContext->getSliceEncoder();
+    pcThreadPool->waitJob( pcQpContext );
+    
+    Double dPicRdCost;
+    UInt64 uiPicDist        = pcTrialEncoder->m_uiPicDist;
+    UInt64 uiALFBits        = 0;
+    
+    m_pcGOPEncoder->preLoopFilterPicAll( pcQpContext->m_pcTrialPic, uiPicDist, uiALFBits );
+    
+    // compute RD cost and choose the best
+    dPicRdCost = pcTrialEncoder->m_pcRdCost->calcRdCost64( pcTrialEncoder->m_uiPicTotalBits + uiALFBits, uiPicDist, true, DF_SSE_FRAME);
+    
+    if ( dPicRdCost < dPicRdCostBest )
+    {
+      uiQpIdxBest    = uiQpIdx;
+      dPicRdCostBest = dPicRdCost;
+    }
+  }
+  return uiQpIdxBest;
+}
+#endif
+
 /** \param rpcPic   picture class
  */
 Void TEncSlice::compressSlice( TComPic*& rpcPic )
@@ -649,6 +783,13 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   TEncTop* pcEncTop = (TEncTop*) m_pcCfg;
   TEncSbac**** ppppcRDSbacCoders    = pcEncTop->getRDSbacCoders();
   TComBitCounter* pcBitCounters     = pcEncTop->getBitCounters();
+#if GOP_THREADS
+  if ( m_ppppcRDSbacCoders )
+  {
+    ppppcRDSbacCoders = m_ppppcRDSbacCoders;
+    pcBitCounters     = m_pcBitCounters;
+  }
+#endif
   Int  iNumSubstreams = 1;
   UInt uiTilesAcross  = 0;
 
@@ -674,6 +815,28 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
     for ( UInt ui = 0 ; ui < iNumSubstreams ; ui++ ) //init all sbac coders for RD optimization
       ppppcRDSbacCoders[ui][0][CI_CURR_BEST]->load(m_pppcRDSbacCoder[0][CI_CURR_BEST]);
   }
+#if WPP_THREADS
+  Bool bThreaded = false;
+  if ( xUseRowThreads( rpcPic, pcSlice ) )
+  {
+    xCompressSliceRows( rpcPic, uiStartCUAddr/rpcPic->getNumPartInCU(), (uiBoundingCUAddr+(rpcPic->getNumPartInCU()-1))/rpcPic->getNumPartInCU() );
+    bThreaded = true;
+  }
+#if TILE_THREADS
+  else if ( xUseTileThreads( rpcPic, pcSlice ) )
+  {
+    xCompressSliceTiles( rpcPic, uiStartCUAddr/rpcPic->getNumPartInCU(), (uiBoundingCUAddr+(rpcPic->getNumPartInCU()-1))/rpcPic->getNumPartInCU() );
+    bThreaded = true;
+  }
+#endif
+  if ( bThreaded )
+  {
+#if WEIGHT_PRED
+    xRestoreWPparam( pcSlice );
+#endif
+    return;
+  }
+#endif
   UInt uiWidthInLCUs  = rpcPic->getPicSym()->getFrameWidthInCU();
   //UInt uiHeightInLCUs = rpcPic->getPicSym()->getFrameHeightInCU();
   UInt uiCol=0, uiLin, uiSubStrm=0;
@@ -1014,6 +1177,14 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
     m_uiPicTotalBits += pcCU->getTotalBits();
     m_dPicRdCost     += pcCU->getTotalCost();
     m_uiPicDist      += pcCU->getTotalDistortion();
+#if LOOP_FILTER_THREADS
+    
+    // let the in-loop filters follow the compressed rows
+    if ( ( uiCUAddr + 1 ) % rpcPic->getFrameWidthInCU() == 0 )
+    {
+      m_pcGOPEncoder->setRowsCompressed( rpcPic, ( uiCUAddr + 1 ) / rpcPic->getFrameWidthInCU() );
+    }
+#endif
   }
 #if !FINE_GRANULARITY_SLICES
 #if TILES
@@ -1030,6 +1201,374 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
 #endif
 }
 
+#if WPP_THREADS
+Void TEncSliceRowJob::run()
+{
+  m_pcSliceEncoder->xCompressRow( m_pcPic, m_uiRow );
+}
+
+#if TILE_THREADS
+Void TEncSliceTileJob::run()
+{
+  m_pcSliceEncoder->xCompressTile( m_pcPic, m_uiStartCUOrder, m_uiBoundingCUOrder, m_uiSubStrm );
+}
+#endif
+
+/** check if the slice can be compressed by worker threads
+ * \param pcSlice slice to be compressed
+ * \returns true if the substream tools are available and the slice does not depend on the serial coding order
+ *
+ * Bit/bin limited slices and weighted prediction are left to the serial loop:
+ * the former need the coded size after every LCU, the latter keeps its state in static members.
+ */
+Bool TEncSlice::xUseThreads( TComSlice* pcSlice )
+{
+  TEncTop* pcEncTop = (TEncTop*) m_pcCfg;
+  
+  if ( pcEncTop->getCuEncoders() == NULL || !m_pcCfg->getUseSBACRD() )
+  {
+    return false;
+  }
+#if GOP_THREADS
+  // the picture is already compressed on a worker thread
+  if ( m_ppppcRDSbacCoders )
+  {
+    return false;
+  }
+#endif
+  if ( m_pcCfg->getSliceMode() == AD_HOC_SLICES_FIXED_NUMBER_OF_BYTES_IN_SLICE || m_pcCfg->getEntropySliceMode() == SHARP_MULTIPLE_CONSTRAINT_BASED_ENTROPY_SLICE )
+  {
+    return false;
+  }
+#if WEIGHT_PRED
+  if ( pcSlice->getPPS()->getUseWP() || pcSlice->getPPS()->getWPBiPredIdc() )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** check if the slice can be compressed by one job per LCU row
+ * \param pcPic   picture class
+ * \param pcSlice slice to be compressed
+ * \returns true for a wavefront slice with more than one substream in a picture without tiles
+ */
+Bool TEncSlice::xUseRowThreads( TComPic* pcPic, TComSlice* pcSlice )
+{
+  if ( !xUseThreads( pcSlice ) || !pcSlice->getPPS()->getEntropyCodingSynchro() )
+  {
+    return false;
+  }
+#if TILES
+  if ( pcPic->getPicSym()->getNumTiles() > 1 )
+  {
+    return false;
+  }
+#endif
+  return pcSlice->getPPS()->getNumSubstreams() > 1;
+}
+
+#if TILE_THREADS
+/** check if the slice can be compressed by one job per tile
+ * \param pcPic   picture class
+ * \param pcSlice slice to be compressed
+ * \returns true for independent tiles without wavefront synchronisation
+ */
+Bool TEncSlice::xUseTileThreads( TComPic* pcPic, TComSlice* pcSlice )
+{
+  if ( !xUseThreads( pcSlice ) || pcSlice->getPPS()->getEntropyCodingSynchro() )
+  {
+    return false;
+  }
+  return pcPic->getPicSym()->getNumTiles() > 1 && pcPic->getPicSym()->getTileBoundaryIndependenceIdr();
+}
+#endif
+
+/** hand the slice-level RD setup over to the tools of the substreams
+ * \param iNumSubstreams number of substream tool sets used by the jobs
+ */
+Void TEncSlice::xInitSubstreamTools( Int iNumSubstreams )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TEncSbac****    ppppcRDSbacCoders = pcEncTop->getRDSbacCoders();
+  
+  for ( Int iSubStrm = 0; iSubStrm < iNumSubstreams; iSubStrm++ )
+  {
+    pcEncTop->getRdCosts()[iSubStrm].copyRDParam( m_pcRdCost );
+    pcEncTop->getTrQuants()[iSubStrm].copyRDParam( m_pcTrQuant );
+    for ( Int iDir = 0; iDir < 2; iDir++ )
+    {
+      for ( Int iRefIdx = 0; iRefIdx < 33; iRefIdx++ )
+      {
+        pcEncTop->getPredSearches()[iSubStrm].setAdaptiveSearchRange( iDir, iRefIdx, m_pcPredSearch->getAdaptiveSearchRange( iDir, iRefIdx ) );
+      }
+    }
+    TEncBinCABAC* pcRDSbacBin = (TEncBinCABAC*) ppppcRDSbacCoders[iSubStrm][0][CI_CURR_BEST]->getEncBinIf();
+    pcRDSbacBin->setBinCountingEnableFlag( false );
+    pcRDSbacBin->setBinsCoded( 0 );
+  }
+}
+
+/** compress a wavefront slice with one job per LCU row
+ * \param pcPic            picture class
+ * \param uiStartCUAddr    first LCU of the slice
+ * \param uiBoundingCUAddr LCU following the last LCU of the slice
+ *
+ * Every substream owns its CU encoder, search, transform and RD coders, so the rows run concurrently
+ * while keeping the two-LCU lag of the wavefront. The picture cost is summed afterwards in coding order.
+ */
+Void TEncSlice::xCompressSliceRows( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TComSlice*      pcSlice           = pcPic->getSlice(getSliceIdx());
+  TEncSbac****    ppppcRDSbacCoders = pcEncTop->getRDSbacCoders();
+  TComThreadPool* pcThreadPool      = pcEncTop->getThreadPool();
+  Int             iNumSubstreams    = pcSlice->getPPS()->getNumSubstreams();
+  UInt            uiWidthInLCUs     = pcPic->getPicSym()->getFrameWidthInCU();
+  UInt            uiStartRow        = uiStartCUAddr / uiWidthInLCUs;
+  UInt            uiLastRow         = ( uiBoundingCUAddr - 1 ) / uiWidthInLCUs;
+  UInt            uiRow;
+  
+  xInitSubstreamTools( iNumSubstreams );
+  
+  m_uiRowStartCU    = uiStartCUAddr;
+  m_uiRowBoundingCU = uiBoundingCUAddr;
+  for ( uiRow = uiStartRow; uiRow <= uiLastRow; uiRow++ )
+  {
+    m_puiRowProgress[uiRow] = ( uiRow == uiStartRow ) ? uiStartCUAddr % uiWidthInLCUs : 0;
+  }
+  
+  // rows are queued top-down, so a row only ever waits for rows that were started before it
+  for ( uiRow = uiStartRow; uiRow <= uiLastRow; uiRow++ )
+  {
+    m_pcRowJobs[uiRow].m_pcSliceEncoder = this;
+    m_pcRowJobs[uiRow].m_pcPic          = pcPic;
+    m_pcRowJobs[uiRow].m_uiRow          = uiRow;
+    pcThreadPool->addJob( &m_pcRowJobs[uiRow] );
+  }
+  for ( uiRow = uiStartRow; uiRow <= uiLastRow; uiRow++ )
+  {
+    pcThreadPool->waitJob( &m_pcRowJobs[uiRow] );
+  }
+  
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingCUAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    m_uiPicTotalBits += pcCU->getTotalBits();
+    m_dPicRdCost     += pcCU->getTotalCost();
+    m_uiPicDist      += pcCU->getTotalDistortion();
+  }
+  
+  // leave the RD coder with the contexts after the last LCU, as the serial loop does
+  m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( ppppcRDSbacCoders[uiLastRow % iNumSubstreams][0][CI_CURR_BEST] );
+}
+
+/** compress the LCUs of the slice in one row
+ * \param pcPic picture class
+ * \param uiRow LCU row index in the picture
+ */
+Void TEncSlice::xCompressRow( TComPic* pcPic, UInt uiRow )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TComSlice*      pcSlice           = pcPic->getSlice(getSliceIdx());
+  Int             iNumSubstreams    = pcSlice->getPPS()->getNumSubstreams();
+  UInt            uiSyncLCU         = pcSlice->getPPS()->getEntropyCodingSynchro();
+  UInt            uiWidthInLCUs     = pcPic->getPicSym()->getFrameWidthInCU();
+  UInt            uiStartRow        = m_uiRowStartCU / uiWidthInLCUs;
+  UInt            uiSubStrm         = uiRow % iNumSubstreams;
+  UInt            uiMaxParts        = 1<<(pcSlice->getSPS()->getMaxCUDepth()<<1);
+  TEncSbac*       pcRDSbacCoder     = pcEncTop->getRDSbacCoders()[uiSubStrm][0][CI_CURR_BEST];
+  
+  // the previous row of the same substream shares the coding tools
+  if ( uiRow >= uiStartRow + iNumSubstreams )
+  {
+    xWaitRowProgress( uiRow - iNumSubstreams, uiWidthInLCUs );
+  }
+  
+  UInt uiStartCUAddr    = max( m_uiRowStartCU, uiRow * uiWidthInLCUs );
+  UInt uiBoundingCUAddr = min( m_uiRowBoundingCU, ( uiRow + 1 ) * uiWidthInLCUs );
+  for ( UInt uiCUAddr = uiStartCUAddr; uiCUAddr < uiBoundingCUAddr; uiCUAddr++ )
+  {
+    UInt uiCol = uiCUAddr % uiWidthInLCUs;
+    
+    // wait for the above-right LCU, and for the LCU providing the contexts at the start of the row
+    if ( uiRow > uiStartRow )
+    {
+      UInt uiNumAbove = ( uiCol == 0 ) ? max<UInt>( 2, uiSyncLCU + 1 ) : uiCol + 2;
+      xWaitRowProgress( uiRow - 1, min( uiNumAbove, uiWidthInLCUs ) );
+    }
+    
+    // initialize CU encoder
+    TComDataCU*& pcCU = pcPic->getCU( uiCUAddr );
+    pcCU->initCU( pcPic, uiCUAddr );
+    
+    // inherit from TR if available
+    if ( uiCol == 0 && uiCUAddr )
+    {
+      TComDataCU* pcCUUp = pcCU->getCUAbove();
+      TComDataCU* pcCUTR = NULL;
+      if ( pcCUUp && uiSyncLCU < uiWidthInLCUs )
+      {
+        pcCUTR = pcPic->getCU( uiCUAddr - uiWidthInLCUs + uiSyncLCU );
+      }
+      if ( pcCUTR && pcCUTR->getSlice() &&
+           pcCUTR->getSCUAddr()+uiMaxParts-1 >= pcSlice->getSliceCurStartCUAddr() &&
+           pcCUTR->getSCUAddr()+uiMaxParts-1 >= pcSlice->getEntropySliceCurStartCUAddr() )
+      {
+        pcRDSbacCoder->loadContexts( &m_pcBufferSbacCoders[0] );
+      }
+    }
+    
+    xCompressLCU( pcCU, pcSlice, uiSubStrm );
+    
+    // store probabilities of the synchronisation LCU for the next row
+    if ( uiCol == uiSyncLCU )
+    {
+      m_pcBufferSbacCoders[0].loadContexts( pcRDSbacCoder );
+    }
+    
+    m_cRowMutex.lock();
+    m_puiRowProgress[uiRow] = uiCol + 1;
+    m_cRowProgressed.broadcast();
+    m_cRowMutex.unlock();
+#if LOOP_FILTER_THREADS
+    
+    // a row only completes after the row above it
+    if ( uiCol == uiWidthInLCUs - 1 )
+    {
+      m_pcGOPEncoder->setRowsCompressed( pcPic, uiRow + 1 );
+    }
+#endif
+  }
+}
+
+/** wait until a row has compressed the given number of LCUs
+ * \param uiRow     LCU row index in the picture
+ * \param uiNumLCUs number of LCUs counted from the left picture border
+ */
+Void TEncSlice::xWaitRowProgress( UInt uiRow, UInt uiNumLCUs )
+{
+  m_cRowMutex.lock();
+  while ( m_puiRowProgress[uiRow] < uiNumLCUs )
+  {
+    m_cRowProgressed.wait( m_cRowMutex );
+  }
+  m_cRowMutex.unlock();
+}
+
+#if TILE_THREADS
+/** compress a slice of independent tiles with one job per tile
+ * \param pcPic              picture class
+ * \param uiStartCUOrder     first LCU of the slice in coding order
+ * \param uiBoundingCUOrder  LCU following the last LCU of the slice in coding order
+ *
+ * The part of every tile covered by the slice is compressed with the tools of its own substream.
+ * Independent tiles start from the initial contexts of the slice, so the result equals the serial loop.
+ */
+Void TEncSlice::xCompressSliceTiles( TComPic* pcPic, UInt uiStartCUOrder, UInt uiBoundingCUOrder )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TComPicSym*     pcPicSym          = pcPic->getPicSym();
+  TEncSbac****    ppppcRDSbacCoders = pcEncTop->getRDSbacCoders();
+  TComThreadPool* pcThreadPool      = pcEncTop->getThreadPool();
+  UInt            uiNumJobs         = 0;
+  UInt            uiEncCUOrder;
+  UInt            uiJob;
+  
+  // split the slice into runs of LCUs of the same tile
+  for ( uiEncCUOrder = uiStartCUOrder; uiEncCUOrder < uiBoundingCUOrder; uiEncCUOrder++ )
+  {
+    if ( uiNumJobs == 0 || pcPicSym->getTileIdxMap( pcPicSym->getCUOrderMap( uiEncCUOrder ) ) != pcPicSym->getTileIdxMap( pcPicSym->getCUOrderMap( uiEncCUOrder-1 ) ) )
+    {
+      m_pcTileJobs[uiNumJobs].m_pcSliceEncoder = this;
+      m_pcTileJobs[uiNumJobs].m_pcPic          = pcPic;
+      m_pcTileJobs[uiNumJobs].m_uiStartCUOrder = uiEncCUOrder;
+      m_pcTileJobs[uiNumJobs].m_uiSubStrm      = uiNumJobs;
+      uiNumJobs++;
+    }
+    m_pcTileJobs[uiNumJobs-1].m_uiBoundingCUOrder = uiEncCUOrder + 1;
+  }
+  
+  xInitSubstreamTools( uiNumJobs );
+  for ( uiJob = 0; uiJob < uiNumJobs; uiJob++ )
+  {
+    ppppcRDSbacCoders[uiJob][0][CI_CURR_BEST]->load( m_pppcRDSbacCoder[0][CI_CURR_BEST] );
+    pcThreadPool->addJob( &m_pcTileJobs[uiJob] );
+  }
+  for ( uiJob = 0; uiJob < uiNumJobs; uiJob++ )
+  {
+    pcThreadPool->waitJob( &m_pcTileJobs[uiJob] );
+  }
+  
+  for ( uiEncCUOrder = uiStartCUOrder; uiEncCUOrder < uiBoundingCUOrder; uiEncCUOrder++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( pcPicSym->getCUOrderMap( uiEncCUOrder ) );
+    m_uiPicTotalBits += pcCU->getTotalBits();
+    m_dPicRdCost     += pcCU->getTotalCost();
+    m_uiPicDist      += pcCU->getTotalDistortion();
+  }
+  
+  // leave the RD coder with the contexts after the last LCU, as the serial loop does
+  m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( ppppcRDSbacCoders[uiNumJobs-1][0][CI_CURR_BEST] );
+}
+
+/** compress the LCUs of the slice in one tile
+ * \param pcPic              picture class
+ * \param uiStartCUOrder     first LCU in coding order
+ * \param uiBoundingCUOrder  LCU following the last LCU in coding order
+ * \param uiSubStrm          substream whose tools are used
+ */
+Void TEncSlice::xCompressTile( TComPic* pcPic, UInt uiStartCUOrder, UInt uiBoundingCUOrder, UInt uiSubStrm )
+{
+  TComSlice* pcSlice = pcPic->getSlice(getSliceIdx());
+  
+  for ( UInt uiEncCUOrder = uiStartCUOrder; uiEncCUOrder < uiBoundingCUOrder; uiEncCUOrder++ )
+  {
+    UInt uiCUAddr = pcPic->getPicSym()->getCUOrderMap( uiEncCUOrder );
+    
+    // initialize CU encoder
+    TComDataCU*& pcCU = pcPic->getCU( uiCUAddr );
+    pcCU->initCU( pcPic, uiCUAddr );
+    
+    xCompressLCU( pcCU, pcSlice, uiSubStrm );
+  }
+}
+#endif
+
+/** compress and size one LCU with the tools of a substream
+ * \param pcCU      LCU to be compressed
+ * \param pcSlice   slice containing the LCU
+ * \param uiSubStrm substream whose tools are used
+ */
+Void TEncSlice::xCompressLCU( TComDataCU* pcCU, TComSlice* pcSlice, UInt uiSubStrm )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TEncCu*         pcCuEncoder       = &pcEncTop->getCuEncoders()[uiSubStrm];
+  TEncEntropy*    pcEntropyCoder    = &pcEncTop->getEntropyCoders()[uiSubStrm];
+  TComBitCounter* pcBitCounter      = &pcEncTop->getBitCounters()[uiSubStrm];
+  TComBitCounter* pcCuBitCounter    = &pcEncTop->getCuBitCounters()[uiSubStrm];
+  TEncSbac*       pcRDSbacCoder     = pcEncTop->getRDSbacCoders()[uiSubStrm][0][CI_CURR_BEST];
+  TEncSbac*       pcRDGoOnSbacCoder = &pcEncTop->getRDGoOnSbacCoders()[uiSubStrm];
+  TEncBinCABAC*   pcRDSbacBin       = (TEncBinCABAC*) pcRDSbacCoder->getEncBinIf();
+  
+  // run CU encoder
+  pcEntropyCoder->setEntropyCoder ( pcRDGoOnSbacCoder, pcSlice );
+  pcEntropyCoder->setBitstream    ( pcBitCounter );
+  ((TEncBinCABAC*)pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+  pcCuEncoder->compressCU( pcCU );
+  
+  // restore entropy coder to an initial stage
+  pcEntropyCoder->setEntropyCoder ( pcRDSbacCoder, pcSlice );
+  pcEntropyCoder->setBitstream    ( pcBitCounter );
+  pcRDSbacBin->setBinCountingEnableFlag( true );
+  pcCuBitCounter->resetBits();
+  pcRDSbacBin->setBinsCoded( 0 );
+  pcCuEncoder->encodeCU( pcCU );
+  pcRDSbacBin->setBinCountingEnableFlag( false );
+}
+#endif
+
 /**
  \param  rpcPic        picture class
  \retval rpcBitstream  bitstream class
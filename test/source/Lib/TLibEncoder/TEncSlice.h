@@ -44,6 +44,9 @@
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComPicYuv.h"
 #include "TEncCu.h"
+#if WPP_THREADS
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #if WEIGHT_PRED
 #include "WeightPredAnalysis.h"
 #endif
@@ -53,6 +56,38 @@
 
 class TEncTop;
 class TEncGOP;
+#if QP_RD_THREADS
+class TEncPicContext;
+#endif
+#if WPP_THREADS
+class TEncSlice;
+
+/// compression of one LCU row of a wavefront slice, executed by the encoder thread pool
+class TEncSliceRowJob : public TComJob
+{
+public:
+  TEncSlice*  m_pcSliceEncoder;                                 ///< slice encoder owning the row
+  TComPic*    m_pcPic;                                          ///< picture being compressed
+  UInt        m_uiRow;                                          ///< LCU row index in the picture
+  
+  Void run();
+};
+
+#if TILE_THREADS
+/// compression of the LCUs of a slice in one tile, executed by the encoder thread pool
+class TEncSliceTileJob : public TComJob
+{
+public:
+  TEncSlice*  m_pcSliceEncoder;                                 ///< slice encoder owning the tile
+  TComPic*    m_pcPic;                                          ///< picture being compressed
+  UInt        m_uiStartCUOrder;                                 ///< first LCU of the tile in coding order
+  UInt        m_uiBoundingCUOrder;                              ///< LCU following the last LCU of the tile in coding order
+  UInt        m_uiSubStrm;                                      ///< substream whose tools are used
+  
+  Void run();
+};
+#endif
+#endif
 
 // ====================================================================================================================
 // Class definition
@@ -102,6 +137,21 @@ private:
   TEncBinCABAC*           m_pcBufferBinCoderCABACs;       ///< line of bin coder CABAC
   TEncSbac*               m_pcBufferSbacCoders;                 ///< line to store temporary contexts
 #endif
+#if WPP_THREADS
+  TEncSliceRowJob*        m_pcRowJobs;                          ///< one compression job per LCU row
+  UInt*                   m_puiRowProgress;                     ///< number of compressed LCUs per row, counted from the left picture border
+  UInt                    m_uiRowStartCU;                       ///< first LCU of the slice compressed by the row jobs
+  UInt                    m_uiRowBoundingCU;                    ///< LCU following the last LCU of the slice compressed by the row jobs
+  TComMutex               m_cRowMutex;                          ///< protects m_puiRowProgress
+  TComCondition           m_cRowProgressed;                     ///< signalled whenever a row has compressed an LCU
+#if TILE_THREADS
+  TEncSliceTileJob*       m_pcTileJobs;                         ///< one compression job per tile
+#endif
+#endif
+#if GOP_THREADS
+  TEncSbac****            m_ppppcRDSbacCoders;                  ///< substream SBAC RD storage of a picture context, NULL for the TEncTop one
+  TComBitCounter*         m_pcBitCounters;                      ///< substream bit counters of a picture context, NULL for the TEncTop ones
+#endif
   
   UInt                    m_uiSliceIdx;
 public:
@@ -111,6 +161,11 @@ public:
   Void    create              ( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHeight, UChar uhTotalDepth );
   Void    destroy             ();
   Void    init                ( TEncTop* pcEncTop );
+#if GOP_THREADS
+  Void    init                ( TEncTop* pcEncTop, TEncCu* pcCuEncoder, TEncSearch* pcPredSearch, TEncEntropy* pcEntropyCoder, TEncSbac* pcSbacCoder,
+                                TEncBinCABAC* pcBinCABAC, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                                TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncSbac**** ppppcRDSbacCoders, TComBitCounter* pcBitCounters );
+#endif
   
   /// preparation of slice encoding (reference marking, QP and lambda)
   Void    initEncSlice        ( TComPic*  pcPic, Int iPOCLast, UInt uiPOCCurr, Int iNumPicRcvd,
@@ -137,6 +192,32 @@ public:
   Void    xDetermineStartAndBoundingCUAddr  ( UInt& uiStartCUAddr, UInt& uiBoundingCUAddr, TComPic*& rpcPic, Bool bEncodeSlice );
   UInt    getSliceIdx()         { return m_uiSliceIdx;                    }
   Void    setSliceIdx(UInt i)   { m_uiSliceIdx = i;                       }
+
+private:
+  Void    xSetPicQp           ( TComSlice* pcSlice, Int iQP, Double dLambda );        ///< set the slice QP and the RD lambdas of a QP candidate
+#if QP_RD_THREADS
+  UInt    xPrecompressSliceQps( TComPic* pcPic, TEncPicContext* pcQpContexts );       ///< compress the QP candidates concurrently
+#endif
+
+#if WPP_THREADS
+private:
+  friend class TEncSliceRowJob;
+  
+  Bool    xUseThreads         ( TComSlice* pcSlice );                                   ///< check if the slice can be compressed by worker threads
+  Bool    xUseRowThreads      ( TComPic* pcPic, TComSlice* pcSlice );                   ///< check if the slice can be compressed by row jobs
+  Void    xInitSubstreamTools ( Int iNumSubstreams );                                   ///< copy the slice-level RD setup to the substream tools
+  Void    xCompressSliceRows  ( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr ); ///< compress the slice with one job per LCU row
+  Void    xCompressRow        ( TComPic* pcPic, UInt uiRow );                           ///< compress the LCUs of the slice in one row
+  Void    xWaitRowProgress    ( UInt uiRow, UInt uiNumLCUs );                           ///< wait until a row has compressed the given number of LCUs
+  Void    xCompressLCU        ( TComDataCU* pcCU, TComSlice* pcSlice, UInt uiSubStrm ); ///< compress one LCU with the tools of a substream
+#if TILE_THREADS
+  friend class TEncSliceTileJob;
+  
+  Bool    xUseTileThreads     ( TComPic* pcPic, TComSlice* pcSlice );                   ///< check if the slice can be compressed by tile jobs
+  Void    xCompressSliceTiles ( TComPic* pcPic, UInt uiStartCUOrder, UInt uiBoundingCUOrder ); ///< compress the slice with one job per tile
+  Void    xCompressTile       ( TComPic* pcPic, UInt uiStartCUOrder, UInt uiBoundingCUOrder, UInt uiSubStrm ); ///< compress the LCUs of the slice in one tile
+#endif
+#endif
 };
 
 //! \}
@@ -73,6 +73,13 @@ TEncTop::TEncTop()
   m_pcRDGoOnBinCodersCABAC = NULL;
   m_pcBitCounters          = NULL;
   m_pcRdCosts              = NULL;
+#if WPP_THREADS
+  m_pcCuEncoders           = NULL;
+  m_pcSearches             = NULL;
+  m_pcTrQuants             = NULL;
+  m_pcEntropyCoders        = NULL;
+  m_pcCuBitCounters        = NULL;
+#endif
 #endif
 }
 
@@ -85,9 +92,17 @@ TEncTop::~TEncTop()
 
 Void TEncTop::create ()
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
   // initialize global variables
   initROM();
   
+#if SIMD_DISTORTION
+  // select the distortion kernels again now that the SIMD level is configured
+  m_cRdCost.init();
+#endif
+  
   // create processing unit classes
   m_cGOPEncoder.        create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight );
   m_cSliceEncoder.      create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
@@ -140,6 +155,14 @@ Void TEncTop::create ()
       }
     }
   }
+  
+  m_cThreadPool.create( m_iNumWorkerThreads );
+#if LOOKAHEAD_THREAD
+  if ( m_bUseLookahead )
+  {
+    m_cLookahead.create( this, getGOPSize() + 1 );
+  }
+#endif
 }
 
 #if OL_USE_WPP
@@ -153,6 +176,13 @@ Void TEncTop::createWPPCoders(Int iNumSubstreams)
   if (m_pcSbacCoders != NULL)
     return; // already generated.
 
+#if TILE_THREADS
+  // independent tiles are compressed concurrently, each one with the coders of a substream
+  if ( m_iNumWorkerThreads > 0 && m_bUseSBACRD && m_iTileBoundaryIndependenceIdr )
+  {
+    iNumSubstreams = max( iNumSubstreams, (m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1) );
+  }
+#endif
   m_iNumSubstreams         = iNumSubstreams;
   m_pcSbacCoders           = new TEncSbac       [iNumSubstreams];
   m_pcBinCoderCABACs       = new TEncBinCABAC   [iNumSubstreams];
@@ -188,12 +218,47 @@ Void TEncTop::createWPPCoders(Int iNumSubstreams)
         }
       }
     }
+#if WPP_THREADS
+    // separate analysis tools for each substream, so that LCU rows or tiles can be compressed concurrently
+    if ( m_iNumWorkerThreads > 0 && iNumSubstreams > 1 )
+    {
+      UInt *aTable4=NULL, *aTable8=NULL;
+      UInt* aTableLastPosVlcIndex=NULL; 
+#if !CAVLC_COEF_LRG_BLK
+      aTable8 = m_pcCavlcCoder->GetLP8Table();
+#endif
+      aTable4 = m_pcCavlcCoder->GetLP4Table();
+      aTableLastPosVlcIndex=m_pcCavlcCoder->GetLastPosVlcIndexTable();
+      
+      m_pcCuEncoders    = new TEncCu      [iNumSubstreams];
+      m_pcSearches      = new TEncSearch  [iNumSubstreams];
+      m_pcTrQuants      = new TComTrQuant [iNumSubstreams];
+      m_pcEntropyCoders = new TEncEntropy [iNumSubstreams];
+      m_pcCuBitCounters = new TComBitCounter [iNumSubstreams];
+      for ( UInt ui = 0 ; ui < iNumSubstreams ; ui++ )
+      {
+        m_pcTrQuants[ui].init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << m_uiQuadtreeTULog2MaxSize, m_iSymbolMode, aTable4, aTable8, 
+          aTableLastPosVlcIndex, m_bUseRDOQ, true );
+        m_pcSearches[ui].init( this, &m_pcTrQuants[ui], m_iSearchRange, m_bipredSearchRange, m_iFastSearch, 0, &m_pcEntropyCoders[ui], &m_pcRdCosts[ui],
+          m_ppppcRDSbacCoders[ui], &m_pcRDGoOnSbacCoders[ui] );
+#if REF_SEARCH_THREADS
+        m_pcSearches[ui].createRefJobs( &m_cThreadPool );
+#endif
+        m_pcCuEncoders[ui].create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+        m_pcCuEncoders[ui].init( this, &m_pcSearches[ui], &m_pcTrQuants[ui], &m_pcCuBitCounters[ui], &m_pcRdCosts[ui],
+          &m_pcEntropyCoders[ui], m_ppppcRDSbacCoders[ui], &m_pcRDGoOnSbacCoders[ui] );
+      }
+    }
+#endif
   }
 }
 #endif
 
 Void TEncTop::destroy ()
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
 #if MQT_BA_RA && MQT_ALF_NPASS
   if(m_bUseALF)
   {
@@ -276,6 +341,25 @@ Void TEncTop::destroy ()
   delete[] m_pcRDGoOnBinCodersCABAC;
   delete[] m_pcBitCounters;
   delete[] m_pcRdCosts;
+#if WPP_THREADS
+  if ( m_pcCuEncoders )
+  {
+    for ( UInt ui = 0; ui < m_iNumSubstreams; ui++ )
+    {
+      m_pcCuEncoders[ui].destroy();
+    }
+  }
+  delete[] m_pcCuEncoders;
+  delete[] m_pcSearches;
+  delete[] m_pcTrQuants;
+  delete[] m_pcEntropyCoders;
+  delete[] m_pcCuBitCounters;
+#endif
+#endif
+  
+  m_cThreadPool.destroy();
+#if LOOKAHEAD_THREAD
+  m_cLookahead.destroy();
 #endif
   
   // destroy ROM
@@ -286,6 +370,9 @@ Void TEncTop::destroy ()
 
 Void TEncTop::init()
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
   UInt *aTable4=NULL, *aTable8=NULL;
   UInt* aTableLastPosVlcIndex=NULL; 
   // initialize SPS
@@ -319,6 +406,9 @@ Void TEncTop::init()
   
   // initialize encoder search class
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_iFastSearch, 0, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
+#if REF_SEARCH_THREADS
+  m_cSearch.createRefJobs( &m_cThreadPool );
+#endif
 
 #if MQT_ALF_NPASS
   if(m_bUseALF)
@@ -349,6 +439,22 @@ Void TEncTop::deletePicBuffer()
   }
 }
 
+#if ME_TZ_VISITED
+Void TEncTop::getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated )
+{
+  ruiPoints         = 0;
+  ruiPointsRepeated = 0;
+  m_cSearch.getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+#if OL_USE_WPP && WPP_THREADS
+  for ( UInt ui = 0; ui < m_iNumSubstreams && m_pcSearches; ui++ )
+  {
+    m_pcSearches[ui].getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+  }
+#endif
+  m_cGOPEncoder.getTZSearchCounts( ruiPoints, ruiPointsRepeated );
+}
+#endif
+
 /**
  - Application has picture buffer list with size of GOP + 1
  - Picture buffer list acts like as ring buffer
@@ -362,15 +468,29 @@ Void TEncTop::deletePicBuffer()
  */
 Void TEncTop::encode( bool bEos, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded )
 {
+#if ROM_CONTEXT
+  TComRomContextGuard cRomContextGuard( &m_cRomContext );
+#endif
   TComPic* pcPicCurr = NULL;
   
   // get original YUV
   xGetNewPicBuffer( pcPicCurr );
   pcPicYuvOrg->copyToPic( pcPicCurr->getPicYuvOrg() );
   
+#if LOOKAHEAD_THREAD
+  // the lookahead thread analyzes the picture while the next ones are read, the GOP encoder waits for it
+  if ( m_bUseLookahead )
+  {
+    m_cLookahead.addPicture( pcPicCurr );
+  }
+#endif
 #if QP_ADAPTATION
   // compute image characteristics
+#if LOOKAHEAD_THREAD
+  if ( getUseAdaptiveQP() && !m_bUseLookahead )
+#else
   if ( getUseAdaptiveQP() )
+#endif
   {
     m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
   }
@@ -43,6 +43,7 @@
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/TComThreadPool.h"
 
 #include "TLibVideoIO/TVideoIOYuv.h"
 
@@ -58,6 +59,9 @@
 #if QP_ADAPTATION
 #include "TEncPreanalyzer.h"
 #endif
+#if LOOKAHEAD_THREAD
+#include "TEncLookahead.h"
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -122,7 +126,23 @@ private:
   TEncSbac*               m_pcRDGoOnSbacCoders;            ///< going on SBAC model for RD stage per substream
   TEncBinCABAC****        m_ppppcBinCodersCABAC;           ///< temporal CABAC state storage for RD computation per substream
   TEncBinCABAC*           m_pcRDGoOnBinCodersCABAC;        ///< going on bin coder CABAC for RD stage per substream
+#if WPP_THREADS
+  TEncCu*                 m_pcCuEncoders;                  ///< CU encoder per substream (threaded wavefront and tiles)
+  TEncSearch*             m_pcSearches;                    ///< encoder search class per substream (threaded wavefront and tiles)
+  TComTrQuant*            m_pcTrQuants;                    ///< transform & quantization class per substream (threaded wavefront and tiles)
+  TEncEntropy*            m_pcEntropyCoders;               ///< entropy encoder per substream (threaded wavefront and tiles)
+  TComBitCounter*         m_pcCuBitCounters;               ///< bit counter of the CU encoder per substream (threaded wavefront and tiles)
+#endif
 #endif 
+  
+  // multi-threading
+  TComThreadPool          m_cThreadPool;                  ///< worker threads (NumWorkerThreads)
+#if ROM_CONTEXT
+  TComRomContext          m_cRomContext;                  ///< LCU geometry, bit depths and partition index tables of this encoder
+#endif
+#if LOOKAHEAD_THREAD
+  TEncLookahead           m_cLookahead;                   ///< input picture analysis ahead of the GOP encoder (Lookahead)
+#endif
 
 #if QP_ADAPTATION
   // quality control
@@ -185,6 +205,20 @@ public:
   TComRdCost*             getRdCosts            () { return  m_pcRdCosts;             }
   TEncSbac****            getRDSbacCoders       () { return  m_ppppcRDSbacCoders;     }
   TEncSbac*               getRDGoOnSbacCoders   () { return  m_pcRDGoOnSbacCoders;   }
+#if WPP_THREADS
+  TEncCu*                 getCuEncoders         () { return  m_pcCuEncoders;          }
+  TEncSearch*             getPredSearches       () { return  m_pcSearches;            }
+  TComTrQuant*            getTrQuants           () { return  m_pcTrQuants;            }
+  TEncEntropy*            getEntropyCoders      () { return  m_pcEntropyCoders;       }
+  TComBitCounter*         getCuBitCounters      () { return  m_pcCuBitCounters;       }
+#endif
+#endif
+  TComThreadPool*         getThreadPool         () { return  &m_cThreadPool;          }
+#if ROM_CONTEXT
+  TComRomContext*         getRomContext         () { return  &m_cRomContext;          }
+#endif
+#if LOOKAHEAD_THREAD
+  TEncLookahead*          getLookahead          () { return  &m_cLookahead;           }
 #endif
   
   TComSPS*                getSPS                () { return  &m_cSPS;                 }
@@ -200,6 +234,11 @@ public:
   /// encode several number of pictures until end-of-sequence
   Void encode( bool bEos, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut,
               std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded );
+#if ME_TZ_VISITED
+  
+  /// positions submitted to the TZ searches of all search objects and the ones skipped as repeated
+  Void getTZSearchCounts( UInt64& ruiPoints, UInt64& ruiPointsRepeated );
+#endif
 };
 
 //! \}
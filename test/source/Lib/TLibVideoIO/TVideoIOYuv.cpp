@@ -42,90 +42,176 @@
 #include <fstream>
 #include <iostream>
 
+#include <memory.h>
+
 #include "TLibCommon/TComRom.h"
+#if SIMD_VIDEO_IO
+#include "TLibCommon/TComSimd.h"
+#endif
 #include "TVideoIOYuv.h"
 
 using namespace std;
 
 /**
- * Perform division with rounding of all pixels in img by
- * 2<sup>shiftbits</sup>. All pixels are clipped to [minval, maxval]
+ * Scale one sample by 2<sup>shiftbits</sup>.
  *
- * @param img        pointer to image to be transformed
- * @param stride     distance between vertically adjacent pixels of img.
- * @param width      width of active area in img.
- * @param height     height of active area in img.
- * @param shiftbits  number of rounding bits
- * @param minval     minimum clipping value
- * @param maxval     maximum clipping value
+ * @param val        sample to be scaled
+ * @param shiftbits  if zero, no operation performed
+ *                   if > 0, multiply by 2<sup>shiftbits</sup>
+ *                   if < 0, divide and round by 2<sup>-shiftbits</sup> and clip
+ * @param minval     minimum clipping value when dividing.
+ * @param maxval     maximum clipping value when dividing.
  */
-static void invScalePlane(Pel* img, unsigned int stride, unsigned int width, unsigned int height,
-                       unsigned int shiftbits, Pel minval, Pel maxval)
+static inline Pel scaleSample(Pel val, int shiftbits, Pel minval, Pel maxval)
 {
-  Pel offset = 1 << (shiftbits-1);
-  for (unsigned int y = 0; y < height; y++)
+  if (shiftbits > 0)
   {
-    for (unsigned int x = 0; x < width; x++)
-    {
-      Pel val = (img[x] + offset) >> shiftbits;
-      img[x] = Clip3(minval, maxval, val);
-    }
-    img += stride;
+    return (Pel)(val << shiftbits);
+  }
+  if (shiftbits < 0)
+  {
+    Pel offset = 1 << (-shiftbits-1);
+    Pel res = (val + offset) >> -shiftbits;
+    return Clip3(minval, maxval, res);
   }
+  return val;
 }
 
+#if SIMD_VIDEO_IO && SIMD_X86
 /**
- * Multiply all pixels in img by 2<sup>shiftbits</sup>.
+ * Scale eight samples as scaleSample(). The rounded division is done as
+ * (val >> s) + bit s-1 of val, which cannot overflow 16 bits.
+ */
+SIMD_TARGET_SSE2 static inline __m128i scaleSamplesSimd(__m128i val, int shiftbits, __m128i minval, __m128i maxval)
+{
+  if (shiftbits > 0)
+  {
+    return _mm_sll_epi16(val, _mm_cvtsi32_si128(shiftbits));
+  }
+  if (shiftbits < 0)
+  {
+    __m128i res = _mm_add_epi16(_mm_sra_epi16(val, _mm_cvtsi32_si128(-shiftbits)),
+                                _mm_and_si128(_mm_srl_epi16(val, _mm_cvtsi32_si128(-shiftbits-1)), _mm_set1_epi16(1)));
+    return _mm_min_epi16(_mm_max_epi16(res, minval), maxval);
+  }
+  return val;
+}
+#endif
+
+/**
+ * Convert one row of file samples to Pel and scale them by
+ * 2<sup>shiftbits</sup> (see scaleSample()). For 16bit input src may alias
+ * dst, every sample is read before it is written.
  *
- * @param img        pointer to image to be transformed
- * @param stride     distance between vertically adjacent pixels of img.
- * @param width      width of active area in img.
- * @param height     height of active area in img.
- * @param shiftbits  number of bits to shift
+ * @param dst        destination samples
+ * @param src        file samples, 8bit or 16bit little-endian lsb-aligned words
+ * @param is16bit    true if the file carries > 8bit data, false otherwise.
+ * @param width      number of samples
+ * @param shiftbits  number of bits to scale by
+ * @param minval     minimum clipping value when dividing.
+ * @param maxval     maximum clipping value when dividing.
  */
-static void scalePlane(Pel* img, unsigned int stride, unsigned int width, unsigned int height,
-                       unsigned int shiftbits)
+static void readRow(Pel* dst, const unsigned char* src, bool is16bit, unsigned int width,
+                    int shiftbits, Pel minval, Pel maxval)
 {
-  for (unsigned int y = 0; y < height; y++)
+  unsigned int x = 0;
+#if SIMD_VIDEO_IO && SIMD_X86
+  if (getSimdLevel() >= SIMD_SSE2)
+  {
+    const __m128i vMin = _mm_set1_epi16(minval);
+    const __m128i vMax = _mm_set1_epi16(maxval);
+    if (!is16bit)
+    {
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+        _mm_storeu_si128((__m128i*)(dst + x),     scaleSamplesSimd(_mm_unpacklo_epi8(v, _mm_setzero_si128()), shiftbits, vMin, vMax));
+        _mm_storeu_si128((__m128i*)(dst + x + 8), scaleSamplesSimd(_mm_unpackhi_epi8(v, _mm_setzero_si128()), shiftbits, vMin, vMax));
+      }
+    }
+    else
+    {
+      // x86 is little-endian, the file words are the samples
+      for (; x + 8 <= width; x += 8)
+      {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + 2*x));
+        _mm_storeu_si128((__m128i*)(dst + x), scaleSamplesSimd(v, shiftbits, vMin, vMax));
+      }
+    }
+  }
+#endif
+  if (!is16bit)
   {
-    for (unsigned int x = 0; x < width; x++)
+    for (; x < width; x++)
     {
-      img[x] <<= shiftbits;
+      dst[x] = scaleSample(src[x], shiftbits, minval, maxval);
+    }
+  }
+  else
+  {
+    for (; x < width; x++)
+    {
+      dst[x] = scaleSample((Pel)((src[2*x+1] << 8) | src[2*x]), shiftbits, minval, maxval);
     }
-    img += stride;
   }
 }
 
 /**
- * Scale all pixels in img depending upon sign of shiftbits by a factor of
- * 2<sup>shiftbits</sup>.
+ * Scale one row of samples by 2<sup>shiftbits</sup> (see scaleSample()) and
+ * convert them to file samples.
  *
- * @param img        pointer to image to be transformed
- * @param stride  distance between vertically adjacent pixels of img.
- * @param width   width of active area in img.
- * @param height  height of active area in img.
- * @param shiftbits if zero, no operation performed
- *                  if > 0, multiply by 2<sup>shiftbits</sup>, see scalePlane()
- *                  if < 0, divide and round by 2<sup>shiftbits</sup> and clip,
- *                          see invScalePlane().
- * @param minval  minimum clipping value when dividing.
- * @param maxval  maximum clipping value when dividing.
+ * @param dst        file samples, 8bit or 16bit little-endian lsb-aligned words
+ * @param src        source samples
+ * @param is16bit    true if the file carries > 8bit data, false otherwise.
+ * @param width      number of samples
+ * @param shiftbits  number of bits to scale by
+ * @param minval     minimum clipping value when dividing.
+ * @param maxval     maximum clipping value when dividing.
  */
-static void scalePlane(Pel* img, unsigned int stride, unsigned int width, unsigned int height,
-                       int shiftbits, Pel minval, Pel maxval)
+static void writeRow(unsigned char* dst, const Pel* src, bool is16bit, unsigned int width,
+                     int shiftbits, Pel minval, Pel maxval)
 {
-  if (shiftbits == 0)
+  unsigned int x = 0;
+#if SIMD_VIDEO_IO && SIMD_X86
+  if (getSimdLevel() >= SIMD_SSE2)
   {
-    return;
+    const __m128i vMin = _mm_set1_epi16(minval);
+    const __m128i vMax = _mm_set1_epi16(maxval);
+    if (!is16bit)
+    {
+      // the low byte of every sample, as the (unsigned char) cast
+      const __m128i vMask = _mm_set1_epi16(0xff);
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i v0 = _mm_and_si128(scaleSamplesSimd(_mm_loadu_si128((const __m128i*)(src + x)),     shiftbits, vMin, vMax), vMask);
+        __m128i v1 = _mm_and_si128(scaleSamplesSimd(_mm_loadu_si128((const __m128i*)(src + x + 8)), shiftbits, vMin, vMax), vMask);
+        _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(v0, v1));
+      }
+    }
+    else
+    {
+      for (; x + 8 <= width; x += 8)
+      {
+        _mm_storeu_si128((__m128i*)(dst + 2*x), scaleSamplesSimd(_mm_loadu_si128((const __m128i*)(src + x)), shiftbits, vMin, vMax));
+      }
+    }
   }
-
-  if (shiftbits > 0)
+#endif
+  if (!is16bit)
   {
-    scalePlane(img, stride, width, height, shiftbits);
+    for (; x < width; x++)
+    {
+      dst[x] = (unsigned char) scaleSample(src[x], shiftbits, minval, maxval);
+    }
   }
   else
   {
-    invScalePlane(img, stride, width, height, -shiftbits, minval, maxval);
+    for (; x < width; x++)
+    {
+      Pel val = scaleSample(src[x], shiftbits, minval, maxval);
+      dst[2*x] = val & 0xff;
+      dst[2*x+1] = (val >> 8) & 0xff;
+    }
   }
 }
 
@@ -224,50 +310,44 @@ void TVideoIOYuv::skipFrames(unsigned int numFrames, unsigned int width, unsigne
 }
 
 /**
- * Read width*height pixels from fd into dst, optionally
- * padding the left and right edges by edge-extension.  Input may be
- * either 8bit or 16bit little-endian lsb-aligned words.
+ * Read width*height pixels from fd into dst, scaling them by
+ * 2<sup>shiftbits</sup> and optionally padding the left and right edges by
+ * edge-extension.  Input may be either 8bit or 16bit little-endian
+ * lsb-aligned words. 16bit rows are read directly into dst and converted in
+ * place, 8bit rows go through buf.
  *
- * @param dst     destination image
- * @param fd      input file stream
- * @param is16bit true if input file carries > 8bit data, false otherwise.
- * @param stride  distance between vertically adjacent pixels of dst.
- * @param width   width of active area in dst.
- * @param height  height of active area in dst.
- * @param pad_x   length of horizontal padding.
- * @param pad_y   length of vertical padding.
+ * @param dst       destination image
+ * @param fd        input file stream
+ * @param is16bit   true if input file carries > 8bit data, false otherwise.
+ * @param stride    distance between vertically adjacent pixels of dst.
+ * @param width     width of active area in dst.
+ * @param height    height of active area in dst.
+ * @param pad_x     length of horizontal padding.
+ * @param pad_y     length of vertical padding.
+ * @param shiftbits number of bits to scale by, see scaleSample()
+ * @param minval    minimum clipping value when dividing.
+ * @param maxval    maximum clipping value when dividing.
+ * @param buf       row buffer of at least width bytes
  * @return true for success, false in case of error
  */
 static bool readPlane(Pel* dst, istream& fd, bool is16bit,
                       unsigned int stride,
                       unsigned int width, unsigned int height,
-                      unsigned int pad_x, unsigned int pad_y)
+                      unsigned int pad_x, unsigned int pad_y,
+                      int shiftbits, Pel minval, Pel maxval,
+                      unsigned char* buf)
 {
   int read_len = width * (is16bit ? 2 : 1);
-  unsigned char *buf = new unsigned char[read_len];
   for (int y = 0; y < height; y++)
   {
-    fd.read(reinterpret_cast<char*>(buf), read_len);
+    unsigned char* src = is16bit ? reinterpret_cast<unsigned char*>(dst) : buf;
+    fd.read(reinterpret_cast<char*>(src), read_len);
     if (fd.eof() || fd.fail() )
     {
-      delete[] buf;
       return false;
     }
 
-    if (!is16bit)
-    {
-      for (int x = 0; x < width; x++)
-      {
-        dst[x] = buf[x];
-      }
-    }
-    else
-    {
-      for (int x = 0; x < width; x++)
-      {
-        dst[x] = (buf[2*x+1] << 8) | buf[2*x];
-      }
-    }
+    readRow(dst, src, is16bit, width, shiftbits, minval, maxval);
 
     for (int x = width; x < width + pad_x; x++)
     {
@@ -277,63 +357,67 @@ static bool readPlane(Pel* dst, istream& fd, bool is16bit,
   }
   for (int y = height; y < height + pad_y; y++)
   {
-    for (int x = 0; x < width + pad_x; x++)
-    {
-      dst[x] = (dst - stride)[x];
-    }
+    ::memcpy(dst, dst - stride, (width + pad_x) * sizeof(Pel));
     dst += stride;
   }
-  delete[] buf;
   return true;
 }
 
 /**
- * Write width*height pixels info fd from src.
+ * Write width*height pixels info fd from src, scaling them by
+ * 2<sup>shiftbits</sup>.
  *
- * @param fd      output file stream
- * @param src     source image
- * @param is16bit true if input file carries > 8bit data, false otherwise.
- * @param stride  distance between vertically adjacent pixels of src.
- * @param width   width of active area in src.
- * @param height  height of active area in src.
+ * @param fd        output file stream
+ * @param src       source image
+ * @param is16bit   true if input file carries > 8bit data, false otherwise.
+ * @param stride    distance between vertically adjacent pixels of src.
+ * @param width     width of active area in src.
+ * @param height    height of active area in src.
+ * @param shiftbits number of bits to scale by, see scaleSample()
+ * @param minval    minimum clipping value when dividing.
+ * @param maxval    maximum clipping value when dividing.
+ * @param buf       row buffer of at least 2*width bytes
  * @return true for success, false in case of error
  */
 static bool writePlane(ostream& fd, Pel* src, bool is16bit,
                        unsigned int stride,
-                       unsigned int width, unsigned int height)
+                       unsigned int width, unsigned int height,
+                       int shiftbits, Pel minval, Pel maxval,
+                       unsigned char* buf)
 {
   int write_len = width * (is16bit ? 2 : 1);
-  unsigned char *buf = new unsigned char[write_len];
   for (int y = 0; y < height; y++)
   {
-    if (!is16bit) 
-    {
-      for (int x = 0; x < width; x++) 
-      {
-        buf[x] = (unsigned char) src[x];
-      }
-    }
-    else 
-    {
-      for (int x = 0; x < width; x++) 
-      {
-        buf[2*x] = src[x] & 0xff;
-        buf[2*x+1] = (src[x] >> 8) & 0xff;
-      }
-    }
+    writeRow(buf, src, is16bit, width, shiftbits, minval, maxval);
 
     fd.write(reinterpret_cast<char*>(buf), write_len);
     if (fd.eof() || fd.fail() )
     {
-      delete[] buf;
       return false;
     }
     src += stride;
   }
-  delete[] buf;
   return true;
 }
 
+/**
+ * Get the row buffer of the file samples, it is kept across frames and only
+ * grows.
+ *
+ * @param size  number of bytes required
+ * @return the buffer
+ */
+unsigned char* TVideoIOYuv::getFileBuffer(unsigned int size)
+{
+  if (size > m_fileBufferSize)
+  {
+    delete[] m_fileBuffer;
+    m_fileBuffer = new unsigned char[size];
+    m_fileBufferSize = size;
+  }
+  return m_fileBuffer;
+}
+
 /**
  * Read one Y'CbCr frame, performing any required input scaling to change
  * from the bitdepth of the input file to the internal bit-depth.
@@ -357,11 +441,10 @@ bool TVideoIOYuv::read ( TComPicYuv*  pPicYuv, Int aiPad[2] )
   // compute actual YUV width & height excluding padding size
   unsigned int pad_h = aiPad[0];
   unsigned int pad_v = aiPad[1];
-  unsigned int width_full = pPicYuv->getWidth();
-  unsigned int height_full = pPicYuv->getHeight();
-  unsigned int width  = width_full - pad_h;
-  unsigned int height = height_full - pad_v;
+  unsigned int width  = pPicYuv->getWidth() - pad_h;
+  unsigned int height = pPicYuv->getHeight() - pad_v;
   bool is16bit = m_fileBitdepth > 8;
+  unsigned char* buf = getFileBuffer(width);
 
   int desired_bitdepth = m_fileBitdepth + m_bitdepthShift;
   Pel minval = 0;
@@ -375,32 +458,29 @@ bool TVideoIOYuv::read ( TComPicYuv*  pPicYuv, Int aiPad[2] )
   }
 #endif
   
-  if (! readPlane(pPicYuv->getLumaAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v))
+  if (! readPlane(pPicYuv->getLumaAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v, m_bitdepthShift, minval, maxval, buf))
     return false;
-  scalePlane(pPicYuv->getLumaAddr(), iStride, width_full, height_full, m_bitdepthShift, minval, maxval);
 
   iStride >>= 1;
-  width_full >>= 1;
-  height_full >>= 1;
   width >>= 1;
   height >>= 1;
   pad_h >>= 1;
   pad_v >>= 1;
 
-  if (! readPlane(pPicYuv->getCbAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v))
+  if (! readPlane(pPicYuv->getCbAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v, m_bitdepthShift, minval, maxval, buf))
     return false;
-  scalePlane(pPicYuv->getCbAddr(), iStride, width_full, height_full, m_bitdepthShift, minval, maxval);
 
-  if (! readPlane(pPicYuv->getCrAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v))
+  if (! readPlane(pPicYuv->getCrAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v, m_bitdepthShift, minval, maxval, buf))
     return false;
-  scalePlane(pPicYuv->getCrAddr(), iStride, width_full, height_full, m_bitdepthShift, minval, maxval);
 
   return true;
 }
 
 /**
- * Write one Y'CbCr frame. No bit-depth conversion is performed, pcPicYuv is
- * assumed to be at TVideoIO::m_fileBitdepth depth.
+ * Write one Y'CbCr frame, performing any required output scaling to change
+ * from the internal bit-depth to the bitdepth of the output file. The
+ * scaling is done row by row on the way to the file, pPicYuv is not
+ * modified.
  *
  * @param pPicYuv     input picture YUV buffer class pointer
  * @param aiPad       source padding size, aiPad[0] = horizontal, aiPad[1] = vertical
@@ -413,60 +493,35 @@ bool TVideoIOYuv::write( TComPicYuv* pPicYuv, Int aiPad[2] )
   unsigned int width  = pPicYuv->getWidth() - aiPad[0];
   unsigned int height = pPicYuv->getHeight() - aiPad[1];
   bool is16bit = m_fileBitdepth > 8;
-  TComPicYuv *dstPicYuv = NULL;
-  bool retval = true;
-
-  if (m_bitdepthShift != 0)
-  {
-    dstPicYuv = new TComPicYuv;
-    dstPicYuv->create( pPicYuv->getWidth(), pPicYuv->getHeight(), 1, 1, 0 );
-    pPicYuv->copyToPic(dstPicYuv);
+  unsigned char* buf = getFileBuffer(2 * width);
 
-    Pel minval = 0;
-    Pel maxval = (1 << m_fileBitdepth) - 1;
+  Pel minval = 0;
+  Pel maxval = (1 << m_fileBitdepth) - 1;
 #if CLIP_TO_709_RANGE
-    if (-m_bitdepthShift < 0 && m_fileBitdepth >= 8)
-    {
-      /* ITU-R BT.709 compliant clipping for converting say 10b to 8b */
-      minval = 1 << (m_fileBitdepth - 8);
-      maxval = (0xff << (m_fileBitdepth - 8)) -1;
-    }
-#endif
-    scalePlane(dstPicYuv->getLumaAddr(), dstPicYuv->getStride(), dstPicYuv->getWidth(), dstPicYuv->getHeight(), -m_bitdepthShift, minval, maxval);
-    scalePlane(dstPicYuv->getCbAddr(), dstPicYuv->getCStride(), dstPicYuv->getWidth()>>1, dstPicYuv->getHeight()>>1, -m_bitdepthShift, minval, maxval);
-    scalePlane(dstPicYuv->getCrAddr(), dstPicYuv->getCStride(), dstPicYuv->getWidth()>>1, dstPicYuv->getHeight()>>1, -m_bitdepthShift, minval, maxval);
-  }
-  else
+  if (-m_bitdepthShift < 0 && m_fileBitdepth >= 8)
   {
-    dstPicYuv = pPicYuv;
+    /* ITU-R BT.709 compliant clipping for converting say 10b to 8b */
+    minval = 1 << (m_fileBitdepth - 8);
+    maxval = (0xff << (m_fileBitdepth - 8)) -1;
   }
+#endif
   
-  if (! writePlane(m_cHandle, dstPicYuv->getLumaAddr(), is16bit, iStride, width, height))
+  if (! writePlane(m_cHandle, pPicYuv->getLumaAddr(), is16bit, iStride, width, height, -m_bitdepthShift, minval, maxval, buf))
   {
-    retval=false; 
-    goto exit;
+    return false;
   }
 
   width >>= 1;
   height >>= 1;
   iStride >>= 1;
-  if (! writePlane(m_cHandle, dstPicYuv->getCbAddr(), is16bit, iStride, width, height))
+  if (! writePlane(m_cHandle, pPicYuv->getCbAddr(), is16bit, iStride, width, height, -m_bitdepthShift, minval, maxval, buf))
   {
-    retval=false; 
-    goto exit;
+    return false;
   }
-  if (! writePlane(m_cHandle, dstPicYuv->getCrAddr(), is16bit, iStride, width, height))
+  if (! writePlane(m_cHandle, pPicYuv->getCrAddr(), is16bit, iStride, width, height, -m_bitdepthShift, minval, maxval, buf))
   {
-    retval=false; 
-    goto exit;
+    return false;
   }
   
-exit:
-  if (m_bitdepthShift != 0)
-  {
-    dstPicYuv->destroy();
-    delete dstPicYuv;
-  }  
-  return retval;
+  return true;
 }
-
@@ -57,10 +57,17 @@ private:
   fstream   m_cHandle;                                      ///< file handle
   unsigned int m_fileBitdepth; ///< bitdepth of input/output video file
   int m_bitdepthShift;  ///< number of bits to increase or decrease image by before/after write/read
+  unsigned char* m_fileBuffer;      ///< row of file samples, kept across frames
+  unsigned int   m_fileBufferSize;  ///< size of m_fileBuffer in bytes
+  
+  unsigned char* getFileBuffer(unsigned int size);
+  
+  TVideoIOYuv( const TVideoIOYuv& );                        ///< not copyable, m_fileBuffer is owned
+  TVideoIOYuv& operator= ( const TVideoIOYuv& );
   
 public:
-  TVideoIOYuv()           {}
-  virtual ~TVideoIOYuv()  {}
+  TVideoIOYuv() : m_fileBuffer(NULL), m_fileBufferSize(0) {}
+  virtual ~TVideoIOYuv()  { delete[] m_fileBuffer; }
   
   Void  open  ( char* pchFile, Bool bWriteMode, unsigned int fileBitDepth, unsigned int internalBitDepth ); ///< open or create file
   Void  close ();                                           ///< close file